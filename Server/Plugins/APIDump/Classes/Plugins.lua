@@ -530,6 +530,16 @@ cPluginManager.AddHook(cPluginManager.HOOK_CHAT, OnChatMessage);
 				},
 				Notes = "Returns the {{cPlugin}} object for the calling plugin. This is the same object that the Initialize function receives as the argument.",
 			},
+			GetHookProfilerStats =
+			{
+				Returns =
+				{
+					{
+						Type = "string",
+					},
+				},
+				Notes = "Returns the plugin hook timing statistics collected since the hook profiler was last enabled, as a human-readable table. Each line lists a plugin and a hook type with the number of calls and their total, average, maximum and 99th percentile duration. See also {{cPluginManager}}:SetHookProfilerEnabled().",
+			},
 			GetNumLoadedPlugins =
 			{
 				Returns =
@@ -629,6 +639,16 @@ cPluginManager.AddHook(cPluginManager.HOOK_CHAT, OnChatMessage);
 				},
 				Notes = "Returns true if console Command is already bound (by any plugin)",
 			},
+			IsHookProfilerEnabled =
+			{
+				Returns =
+				{
+					{
+						Type = "boolean",
+					},
+				},
+				Notes = "Returns true if the plugins' hook calls are being timed by the hook profiler.",
+			},
 			IsPluginLoaded =
 			{
 				Params =
@@ -656,6 +676,32 @@ cPluginManager.AddHook(cPluginManager.HOOK_CHAT, OnChatMessage);
 				IsStatic = true,
 				Notes = "Logs a current stack trace of the Lua engine to the server console log. Same format as is used when the plugin fails.",
 			},
+			PostStateMessage =
+			{
+				IsStatic = true,
+				Params =
+				{
+					{
+						Name = "WorldName",
+						Type = "string",
+					},
+					{
+						Name = "Channel",
+						Type = "string",
+					},
+					{
+						Name = "Payload",
+						Type = "string",
+					},
+				},
+				Returns =
+				{
+					{
+						Type = "boolean",
+					},
+				},
+				Notes = "Queues a message for another Lua state of the calling plugin, when the plugin uses per-world Lua states (PerWorldStates in Info.lua). WorldName selects the world whose state receives the message, an empty string selects the main state. The message is delivered to the OnStateMessage(Channel, Payload, SenderWorldName) global function of the receiving state on that world's next tick (on the next server tick for the main state). Returns false if the plugin doesn't use per-world states, or there's no such world.",
+			},
 			RefreshPluginList =
 			{
 				Notes = "Refreshes the list of plugins to include all folders inside the Plugins folder (potentially new disabled plugins)",
@@ -664,6 +710,17 @@ cPluginManager.AddHook(cPluginManager.HOOK_CHAT, OnChatMessage);
 			{
 				Notes = "Reloads all active plugins",
 			},
+			SetHookProfilerEnabled =
+			{
+				Params =
+				{
+					{
+						Name = "IsEnabled",
+						Type = "boolean",
+					},
+				},
+				Notes = "Starts or stops timing the plugins' hook calls. Starting resets the statistics collected so far. While stopped, the hook calls aren't timed at all. The statistics can be read using {{cPluginManager}}:GetHookProfilerStats() or the \"hookstats\" console command.",
+			},
 			UnloadPlugin =
 			{
 				Params =
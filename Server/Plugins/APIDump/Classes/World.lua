@@ -1129,6 +1129,24 @@ function OnAllChunksAvailable()</pre> All return values from the callbacks are i
 				},
 				Notes = "Digs up the specified block and spawns the appropriate pickups for it. The optional Digger parameter specifies the {{cEntity|entity}} who dug the block, usually a {{cPlayer|player}}. The optional Tool parameter specifies the tool used to dig the block, not present means an empty hand. Returns true on success, false if the chunk is not present. See also DigBlock() for the pickup-less version.",
 			},
+			ExportTickTrace =
+			{
+				Params =
+				{
+					{
+						Name = "FileName",
+						Type = "string",
+					},
+				},
+				Returns =
+				{
+					{
+						Name = "IsSuccess",
+						Type = "boolean",
+					},
+				},
+				Notes = "Writes the ticks recorded by the tick profiler into the specified file, in the Chrome trace event format. The file can be opened in chrome://tracing or Perfetto to inspect the individual tick phases and the slowest chunks on a timeline. Returns true on success, false if the file cannot be written. See also SetTickProfilerEnabled().",
+			},
 			FastSetBlock =
 			{
 				{
@@ -2017,6 +2035,16 @@ function OnAllChunksAvailable()</pre> All return values from the callbacks are i
 				},
 				Notes = "Returns the number of chunks queued up for saving",
 			},
+			GetTickProfilerStats =
+			{
+				Returns =
+				{
+					{
+						Type = "string",
+					},
+				},
+				Notes = "Returns a human-readable summary of the ticks recorded by the tick profiler: the average and maximum duration of each tick phase, the slowest ticks and the slowest chunks. See also SetTickProfilerEnabled().",
+			},
 			GetTicksUntilWeatherChange =
 			{
 				Returns =
@@ -2385,6 +2413,16 @@ function OnAllChunksAvailable()</pre> All return values from the callbacks are i
 				},
 				Notes = "Returns whether or not saving chunk data is enabled. If disabled, the world will keep dirty chunks in memory forever, and will simply regenerate non-dirty chunks that are unloaded.",
 			},
+			IsTickProfilerEnabled =
+			{
+				Returns =
+				{
+					{
+						Type = "boolean",
+					},
+				},
+				Notes = "Returns true if the durations of the world's tick phases are being recorded by the tick profiler.",
+			},
 			IsTrapdoorOpen =
 			{
 				Params =
@@ -3132,6 +3170,17 @@ function OnAllChunksAvailable()</pre> All return values from the callbacks are i
 				},
 				Notes = "Sets the default spawn at the specified coords. Returns false if the new spawn couldn't be stored in the INI file.",
 			},
+			SetTickProfilerEnabled =
+			{
+				Params =
+				{
+					{
+						Name = "IsEnabled",
+						Type = "boolean",
+					},
+				},
+				Notes = "Starts or stops recording the durations of the world's tick phases (plugins, chunk data, entities, chunks, mobs, clients, simulators etc.) and of the slowest chunks. The last 1200 ticks are kept. Starting discards the ticks recorded so far. The recorded ticks can be read using GetTickProfilerStats(), ExportTickTrace() or the \"tickstats\" and \"ticktrace\" console commands.",
+			},
 			SetTicksUntilWeatherChange =
 			{
 				Params =
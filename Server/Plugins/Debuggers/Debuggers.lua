@@ -46,8 +46,10 @@ function Initialize(a_Plugin)
 	-- Bind all the console commands:
 	RegisterPluginInfoConsoleCommands();
 
-	a_Plugin:AddWebTab("Debuggers",  HandleRequest_Debuggers)
-	a_Plugin:AddWebTab("StressTest", HandleRequest_StressTest)
+	a_Plugin:AddWebTab("Debuggers",     HandleRequest_Debuggers)
+	a_Plugin:AddWebTab("StressTest",    HandleRequest_StressTest)
+	a_Plugin:AddWebTab("Hook profiler", HandleRequest_HookProfiler)
+	a_Plugin:AddWebTab("Tick profiler", HandleRequest_TickProfiler)
 
 	-- Enable the following line for BlockArea / Generator interface testing:
 	-- PluginManager:AddHook(Plugin, cPluginManager.HOOK_CHUNK_GENERATED);
@@ -1493,6 +1495,61 @@ end
 
 
 
+--- Shows the plugin hook timing statistics, with buttons for starting and stopping the hook profiler
+function HandleRequest_HookProfiler(a_Request)
+	local PM = cPluginManager:Get()
+	if (a_Request.PostParams["start"] ~= nil) then
+		PM:SetHookProfilerEnabled(true)
+	elseif (a_Request.PostParams["stop"] ~= nil) then
+		PM:SetHookProfilerEnabled(false)
+	end
+
+	local Button
+	if (PM:IsHookProfilerEnabled()) then
+		Button = "<input type='submit' name='stop' value='Stop'/> <input type='submit' name='start' value='Restart'/>"
+	else
+		Button = "<input type='submit' name='start' value='Start'/>"
+	end
+	return "<form method='POST'>" .. Button .. " <input type='submit' value='Refresh'/></form>" ..
+		"<pre>" .. cWebAdmin:GetHTMLEscapedString(PM:GetHookProfilerStats()) .. "</pre>"
+end
+
+
+
+
+
+--- Shows each world's tick phase statistics, with buttons for starting and stopping each world's tick profiler
+function HandleRequest_TickProfiler(a_Request)
+	local WorldName = a_Request.PostParams["world"]
+	if (WorldName ~= nil) then
+		local World = cRoot:Get():GetWorld(WorldName)
+		if (World ~= nil) then
+			World:SetTickProfilerEnabled(a_Request.PostParams["start"] ~= nil)
+		end
+	end
+
+	local Content = {}
+	cRoot:Get():ForEachWorld(
+		function(a_World)
+			local Name = cWebAdmin:GetHTMLEscapedString(a_World:GetName())
+			local Button
+			if (a_World:IsTickProfilerEnabled()) then
+				Button = "<input type='submit' name='stop' value='Stop'/> <input type='submit' name='start' value='Restart'/>"
+			else
+				Button = "<input type='submit' name='start' value='Start'/>"
+			end
+			table.insert(Content, "<h4>" .. Name .. "</h4>")
+			table.insert(Content, "<form method='POST'><input type='hidden' name='world' value='" .. Name .. "'/>" .. Button .. "</form>")
+			table.insert(Content, "<pre>" .. cWebAdmin:GetHTMLEscapedString(a_World:GetTickProfilerStats()) .. "</pre>")
+		end
+	)
+	return table.concat(Content, "\n")
+end
+
+
+
+
+
 function OnPluginMessage(a_Client, a_Channel, a_Message)
 	LOGINFO("Received a plugin message from client " .. a_Client:GetUsername() .. ": channel '" .. a_Channel .. "', message '" .. a_Message .. "'");
 
@@ -1063,7 +1063,7 @@ static int tolua_cPluginManager_AddHook_FnRef(cPluginManager * a_PluginManager,
 		S.LogStackTrace();
 		return 0;
 	}
-	if (!Plugin->AddHookCallback(HookType, std::move(callback)))
+	if (!Plugin->AddHookCallback(S, HookType, std::move(callback)))
 	{
 		LOGWARNING("cPluginManager.AddHook(): Cannot add hook %d, unknown error.", HookType);
 		S.LogStackTrace();
@@ -1516,6 +1516,40 @@ static int tolua_cPluginManager_CallPlugin(lua_State * tolua_S)
 
 
 
+static int tolua_cPluginManager_PostStateMessage(lua_State * tolua_S)
+{
+	/*
+	Function signature:
+	cPluginManager:PostStateMessage("WorldName", "Channel", "Payload") -> bool
+	*/
+
+	// Check the parameters:
+	cLuaState L(tolua_S);
+	if (
+		!L.CheckParamStaticSelf("cPluginManager") ||
+		!L.CheckParamString(2, 4) ||
+		!L.CheckParamEnd(5)
+	)
+	{
+		return 0;
+	}
+	cPluginLua * Plugin = cManualBindings::GetLuaPlugin(L);
+	if (Plugin == nullptr)
+	{
+		return 0;
+	}
+
+	// Queue the message into the target LuaState of the same plugin:
+	AString WorldName, Channel, Payload;
+	L.GetStackValues(2, WorldName, Channel, Payload);
+	L.Push(Plugin->PostStateMessage(L, WorldName, Channel, Payload));
+	return 1;
+}
+
+
+
+
+
 static int tolua_cPluginManager_ExecuteConsoleCommand(lua_State * tolua_S)
 {
 	/*
@@ -4495,6 +4529,7 @@ void cManualBindings::Bind(lua_State * tolua_S)
 			tolua_function(tolua_S, "GetCurrentPlugin",      tolua_cPluginManager_GetCurrentPlugin);
 			tolua_function(tolua_S, "GetPlugin",             tolua_cPluginManager_GetPlugin);
 			tolua_function(tolua_S, "LogStackTrace",         tolua_cPluginManager_LogStackTrace);
+			tolua_function(tolua_S, "PostStateMessage",      tolua_cPluginManager_PostStateMessage);
 		tolua_endmodule(tolua_S);
 
 		tolua_beginmodule(tolua_S, "cRoot");
@@ -17,6 +17,9 @@
 #include "../Item.h"
 #include "../Root.h"
 #include "../WebAdmin.h"
+#include "../World.h"
+#include "../Entities/Player.h"
+#include "../Entities/ProjectileEntity.h"
 
 extern "C"
 {
@@ -30,6 +33,31 @@ extern "C"
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+// cPluginLua::cStateMessageQueue:
+
+void cPluginLua::cStateMessageQueue::Push(sStateMessage && a_Message)
+{
+	cCSLock Lock(m_CS);
+	m_Messages.push_back(std::move(a_Message));
+}
+
+
+
+
+
+std::vector<cPluginLua::sStateMessage> cPluginLua::cStateMessageQueue::TakeAll(void)
+{
+	std::vector<sStateMessage> res;
+	cCSLock Lock(m_CS);
+	std::swap(res, m_Messages);
+	return res;
+}
+
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // cPluginLua:
 
@@ -38,6 +66,10 @@ cPluginLua::cPluginLua(const AString & a_PluginDirectory, cDeadlockDetect & a_De
 	m_LuaState(Printf("plugin %s", a_PluginDirectory.c_str())),
 	m_DeadlockDetect(a_DeadlockDetect)
 {
+	for (auto & NumHooks: m_NumMainHooks)
+	{
+		NumHooks = 0;
+	}
 	m_LuaState.TrackInDeadlockDetect(a_DeadlockDetect);
 }
 
@@ -68,8 +100,15 @@ void cPluginLua::Close(void)
 	// Remove the web tabs:
 	ClearWebTabs();
 
+	// Close the per-world Lua engines:
+	CloseWorldStates();
+
 	// Release all the references in the hook map:
 	m_HookMap.clear();
+	for (auto & NumHooks: m_NumMainHooks)
+	{
+		NumHooks.store(0, std::memory_order_release);
+	}
 
 	// Close the Lua engine:
 	op().Close();
@@ -84,27 +123,84 @@ bool cPluginLua::Load(void)
 	cOperation op(*this);
 	if (!op().IsValid())
 	{
-		m_LuaState.Create();
-		m_LuaState.RegisterAPILibs();
-
-		// Inject the identification global variables into the state:
-		lua_pushlightuserdata(m_LuaState, this);
-		lua_setglobal(m_LuaState, LUA_PLUGIN_INSTANCE_VAR_NAME);
-		lua_pushstring(m_LuaState, GetName().c_str());
-		lua_setglobal(m_LuaState, LUA_PLUGIN_NAME_VAR_NAME);
-
-		// Add the plugin's folder to the package.path and package.cpath variables (#693):
-		m_LuaState.AddPackagePath("path", GetLocalFolder() + "/?.lua");
-		#ifdef _WIN32
-			m_LuaState.AddPackagePath("cpath", GetLocalFolder() + "\\?.dll");
-		#else
-			m_LuaState.AddPackagePath("cpath", GetLocalFolder() + "/?.so");
-		#endif
-
-		tolua_pushusertype(m_LuaState, this, "cPluginLua");
-		lua_setglobal(m_LuaState, "g_Plugin");
+		PrepareLuaState(m_LuaState);
+	}
+
+	if (!LoadPluginFiles(m_LuaState))
+	{
+		Close();
+		return false;
+	}
+
+	// Call the Initialize function:
+	bool res = false;
+	if (!m_LuaState.Call("Initialize", this, cLuaState::Return, res))
+	{
+		SetLoadError("Cannot call the Initialize() function.");
+		LOGWARNING("Error in plugin %s: Cannot call the Initialize() function. Plugin is temporarily disabled.", GetName().c_str());
+		Close();
+		return false;
+	}
+	if (!res)
+	{
+		SetLoadError("The Initialize() function failed.");
+		LOGINFO("Plugin %s: Initialize() call failed, plugin is temporarily disabled.", GetName().c_str());
+		Close();
+		return false;
+	}
+
+	// If the plugin opted into the per-world mode, load it once more into a separate LuaState for each world:
+	bool PerWorldStates = false;
+	if (m_LuaState.GetNamedGlobal("g_PluginInfo.PerWorldStates", PerWorldStates) && PerWorldStates)
+	{
+		if (!LoadWorldStates())
+		{
+			Close();
+			return false;
+		}
+
+		// The messages between the states are delivered on ticks, make sure they get called:
+		cPluginManager::Get()->AddHook(this, cPluginManager::HOOK_TICK);
+		cPluginManager::Get()->AddHook(this, cPluginManager::HOOK_WORLD_TICK);
 	}
 
+	m_Status = cPluginManager::psLoaded;
+	return true;
+}
+
+
+
+
+
+void cPluginLua::PrepareLuaState(cLuaState & a_LuaState)
+{
+	a_LuaState.Create();
+	a_LuaState.RegisterAPILibs();
+
+	// Inject the identification global variables into the state:
+	lua_pushlightuserdata(a_LuaState, this);
+	lua_setglobal(a_LuaState, LUA_PLUGIN_INSTANCE_VAR_NAME);
+	lua_pushstring(a_LuaState, GetName().c_str());
+	lua_setglobal(a_LuaState, LUA_PLUGIN_NAME_VAR_NAME);
+
+	// Add the plugin's folder to the package.path and package.cpath variables (#693):
+	a_LuaState.AddPackagePath("path", GetLocalFolder() + "/?.lua");
+	#ifdef _WIN32
+		a_LuaState.AddPackagePath("cpath", GetLocalFolder() + "\\?.dll");
+	#else
+		a_LuaState.AddPackagePath("cpath", GetLocalFolder() + "/?.so");
+	#endif
+
+	tolua_pushusertype(a_LuaState, this, "cPluginLua");
+	lua_setglobal(a_LuaState, "g_Plugin");
+}
+
+
+
+
+
+bool cPluginLua::LoadPluginFiles(cLuaState & a_LuaState)
+{
 	std::string PluginPath = GetLocalFolder() + "/";
 
 	// List all Lua files for this plugin. Info.lua has a special handling - make it the last to load:
@@ -133,7 +229,6 @@ bool cPluginLua::Load(void)
 	{
 		SetLoadError("No lua files found, plugin is probably missing.");
 		LOGWARNING("No lua files found: plugin %s is missing.", GetName().c_str());
-		Close();
 		return false;
 	}
 
@@ -141,43 +236,108 @@ bool cPluginLua::Load(void)
 	for (AStringVector::const_iterator itr = LuaFiles.begin(), end = LuaFiles.end(); itr != end; ++itr)
 	{
 		AString Path = PluginPath + *itr;
-		if (!m_LuaState.LoadFile(Path))
+		if (!a_LuaState.LoadFile(Path))
 		{
 			SetLoadError(Printf("Failed to load file %s.", itr->c_str()));
-			Close();
 			return false;
 		}
 	}  // for itr - Files[]
 	if (HasInfoLua)
 	{
 		AString Path = PluginPath + "Info.lua";
-		if (!m_LuaState.LoadFile(Path))
+		if (!a_LuaState.LoadFile(Path))
 		{
 			SetLoadError("Failed to load file Info.lua.");
-			Close();
 			return false;
 		}
 	}
+	return true;
+}
 
-	// Call the Initialize function:
-	bool res = false;
-	if (!m_LuaState.Call("Initialize", this, cLuaState::Return, res))
+
+
+
+
+bool cPluginLua::LoadWorldStates(void)
+{
+	return cRoot::Get()->ForEachWorld([this](cWorld & a_World)
+		{
+			auto WorldState = std::make_shared<sWorldState>(a_World.GetName(), GetFolderName());
+			auto & LuaState = WorldState->m_LuaState;
+			LuaState.TrackInDeadlockDetect(m_DeadlockDetect);
+			cLuaState::cLock Lock(LuaState);
+			PrepareLuaState(LuaState);
+			lua_pushstring(LuaState, a_World.GetName().c_str());
+			lua_setglobal(LuaState, LUA_PLUGIN_WORLD_VAR_NAME);
+
+			// Register the state before initializing it, so that the hooks added by InitializeWorld() can find it:
+			{
+				cCSLock CSLock(m_CSWorldStates);
+				m_WorldStates[&a_World] = WorldState;
+			}
+
+			if (!LoadPluginFiles(LuaState))
+			{
+				return true;
+			}
+			bool res = false;
+			if (!LuaState.Call("InitializeWorld", this, &a_World, cLuaState::Return, res))
+			{
+				SetLoadError(Printf("Cannot call the InitializeWorld() function for world %s.", a_World.GetName().c_str()));
+				LOGWARNING("Error in plugin %s: Cannot call the InitializeWorld() function for world %s. Plugin is temporarily disabled.",
+					GetName().c_str(), a_World.GetName().c_str()
+				);
+				return true;
+			}
+			if (!res)
+			{
+				SetLoadError(Printf("The InitializeWorld() function failed for world %s.", a_World.GetName().c_str()));
+				LOGINFO("Plugin %s: InitializeWorld() call failed for world %s, plugin is temporarily disabled.",
+					GetName().c_str(), a_World.GetName().c_str()
+				);
+				return true;
+			}
+			return false;
+		}
+	);
+}
+
+
+
+
+
+void cPluginLua::CloseWorldStates(void)
+{
+	std::map<const cWorld *, sWorldStatePtr> WorldStates;
 	{
-		SetLoadError("Cannot call the Initialize() function.");
-		LOGWARNING("Error in plugin %s: Cannot call the Initialize() function. Plugin is temporarily disabled.", GetName().c_str());
-		Close();
-		return false;
+		cCSLock Lock(m_CSWorldStates);
+		std::swap(WorldStates, m_WorldStates);
 	}
-	if (!res)
+	for (auto & WorldState: WorldStates)
 	{
-		SetLoadError("The Initialize() function failed.");
-		LOGINFO("Plugin %s: Initialize() call failed, plugin is temporarily disabled.", GetName().c_str());
-		Close();
-		return false;
+		auto & LuaState = WorldState.second->m_LuaState;
+		{
+			cLuaState::cLock Lock(LuaState);
+			WorldState.second->m_HookMap.clear();
+			LuaState.Close();
+		}
+		LuaState.UntrackInDeadlockDetect(m_DeadlockDetect);
 	}
+}
 
-	m_Status = cPluginManager::psLoaded;
-	return true;
+
+
+
+
+cPluginLua::sWorldStatePtr cPluginLua::GetWorldState(const cWorld * a_World)
+{
+	cCSLock Lock(m_CSWorldStates);
+	auto itr = m_WorldStates.find(a_World);
+	if (itr == m_WorldStates.end())
+	{
+		return nullptr;
+	}
+	return itr->second;
 }
 
 
@@ -211,6 +371,10 @@ void cPluginLua::OnDisable(void)
 
 void cPluginLua::Tick(float a_Dt)
 {
+	{
+		cOperation op(*this);
+		DeliverStateMessages(op(), m_MainMessages);
+	}
 	CallSimpleHooks(cPluginManager::HOOK_TICK, a_Dt);
 }
 
@@ -220,7 +384,7 @@ void cPluginLua::Tick(float a_Dt)
 
 bool cPluginLua::OnBlockSpread(cWorld & a_World, int a_BlockX, int a_BlockY, int a_BlockZ, eSpreadSource a_Source)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_BLOCK_SPREAD, &a_World, a_BlockX, a_BlockY, a_BlockZ, a_Source);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_BLOCK_SPREAD, &a_World, a_BlockX, a_BlockY, a_BlockZ, a_Source);
 }
 
 
@@ -253,7 +417,7 @@ bool cPluginLua::OnBlockToPickups(
 
 bool cPluginLua::OnBrewingCompleted(cWorld & a_World, cBrewingstandEntity & a_Brewingstand)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_BREWING_COMPLETED, &a_World, &a_Brewingstand);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_BREWING_COMPLETED, &a_World, &a_Brewingstand);
 }
 
 
@@ -262,7 +426,7 @@ bool cPluginLua::OnBrewingCompleted(cWorld & a_World, cBrewingstandEntity & a_Br
 
 bool cPluginLua::OnBrewingCompleting(cWorld & a_World, cBrewingstandEntity & a_Brewingstand)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_BREWING_COMPLETING, &a_World, &a_Brewingstand);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_BREWING_COMPLETING, &a_World, &a_Brewingstand);
 }
 
 
@@ -295,7 +459,7 @@ bool cPluginLua::OnChat(cPlayer & a_Player, AString & a_Message)
 
 bool cPluginLua::OnChunkAvailable(cWorld & a_World, int a_ChunkX, int a_ChunkZ)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_CHUNK_AVAILABLE, &a_World, a_ChunkX, a_ChunkZ);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_CHUNK_AVAILABLE, &a_World, a_ChunkX, a_ChunkZ);
 }
 
 
@@ -304,7 +468,7 @@ bool cPluginLua::OnChunkAvailable(cWorld & a_World, int a_ChunkX, int a_ChunkZ)
 
 bool cPluginLua::OnChunkGenerated(cWorld & a_World, int a_ChunkX, int a_ChunkZ, cChunkDesc * a_ChunkDesc)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_CHUNK_GENERATED, &a_World, a_ChunkX, a_ChunkZ, a_ChunkDesc);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_CHUNK_GENERATED, &a_World, a_ChunkX, a_ChunkZ, a_ChunkDesc);
 }
 
 
@@ -313,7 +477,7 @@ bool cPluginLua::OnChunkGenerated(cWorld & a_World, int a_ChunkX, int a_ChunkZ,
 
 bool cPluginLua::OnChunkGenerating(cWorld & a_World, int a_ChunkX, int a_ChunkZ, cChunkDesc * a_ChunkDesc)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_CHUNK_GENERATING, &a_World, a_ChunkX, a_ChunkZ, a_ChunkDesc);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_CHUNK_GENERATING, &a_World, a_ChunkX, a_ChunkZ, a_ChunkDesc);
 }
 
 
@@ -322,7 +486,7 @@ bool cPluginLua::OnChunkGenerating(cWorld & a_World, int a_ChunkX, int a_ChunkZ,
 
 bool cPluginLua::OnChunkUnloaded(cWorld & a_World, int a_ChunkX, int a_ChunkZ)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_CHUNK_UNLOADED, &a_World, a_ChunkX, a_ChunkZ);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_CHUNK_UNLOADED, &a_World, a_ChunkX, a_ChunkZ);
 }
 
 
@@ -331,7 +495,7 @@ bool cPluginLua::OnChunkUnloaded(cWorld & a_World, int a_ChunkX, int a_ChunkZ)
 
 bool cPluginLua::OnChunkUnloading(cWorld & a_World, int a_ChunkX, int a_ChunkZ)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_CHUNK_UNLOADING, &a_World, a_ChunkX, a_ChunkZ);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_CHUNK_UNLOADING, &a_World, a_ChunkX, a_ChunkZ);
 }
 
 
@@ -340,7 +504,7 @@ bool cPluginLua::OnChunkUnloading(cWorld & a_World, int a_ChunkX, int a_ChunkZ)
 
 bool cPluginLua::OnCollectingPickup(cPlayer & a_Player, cPickup & a_Pickup)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_COLLECTING_PICKUP, &a_Player, &a_Pickup);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_COLLECTING_PICKUP, &a_Player, &a_Pickup);
 }
 
 
@@ -349,7 +513,7 @@ bool cPluginLua::OnCollectingPickup(cPlayer & a_Player, cPickup & a_Pickup)
 
 bool cPluginLua::OnCraftingNoRecipe(cPlayer & a_Player, cCraftingGrid & a_Grid, cCraftingRecipe & a_Recipe)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_CRAFTING_NO_RECIPE, &a_Player, &a_Grid, &a_Recipe);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_CRAFTING_NO_RECIPE, &a_Player, &a_Grid, &a_Recipe);
 }
 
 
@@ -367,7 +531,7 @@ bool cPluginLua::OnDisconnect(cClientHandle & a_Client, const AString & a_Reason
 
 bool cPluginLua::OnEntityAddEffect(cEntity & a_Entity, int a_EffectType, int a_EffectDurationTicks, int a_EffectIntensity, double a_DistanceModifier)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_ENTITY_ADD_EFFECT, &a_Entity, a_EffectType, a_EffectDurationTicks, a_EffectIntensity, a_DistanceModifier);
+	return CallWorldHooks(a_Entity.GetWorld(), cPluginManager::HOOK_ENTITY_ADD_EFFECT, &a_Entity, a_EffectType, a_EffectDurationTicks, a_EffectIntensity, a_DistanceModifier);
 }
 
 
@@ -507,7 +671,7 @@ bool cPluginLua::OnHandshake(cClientHandle & a_Client, const AString & a_Usernam
 
 bool cPluginLua::OnHopperPullingItem(cWorld & a_World, cHopperEntity & a_Hopper, int a_DstSlotNum, cBlockEntityWithItems & a_SrcEntity, int a_SrcSlotNum)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_HOPPER_PULLING_ITEM, &a_World, &a_Hopper, a_DstSlotNum, &a_SrcEntity, a_SrcSlotNum);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_HOPPER_PULLING_ITEM, &a_World, &a_Hopper, a_DstSlotNum, &a_SrcEntity, a_SrcSlotNum);
 }
 
 
@@ -516,7 +680,7 @@ bool cPluginLua::OnHopperPullingItem(cWorld & a_World, cHopperEntity & a_Hopper,
 
 bool cPluginLua::OnHopperPushingItem(cWorld & a_World, cHopperEntity & a_Hopper, int a_SrcSlotNum, cBlockEntityWithItems & a_DstEntity, int a_DstSlotNum)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_HOPPER_PUSHING_ITEM, &a_World, &a_Hopper, a_SrcSlotNum, &a_DstEntity, a_DstSlotNum);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_HOPPER_PUSHING_ITEM, &a_World, &a_Hopper, a_SrcSlotNum, &a_DstEntity, a_DstSlotNum);
 }
 
 
@@ -549,7 +713,7 @@ bool cPluginLua::OnKilled(cEntity & a_Victim, TakeDamageInfo & a_TDI, AString &
 
 bool cPluginLua::OnKilling(cEntity & a_Victim, cEntity * a_Killer, TakeDamageInfo & a_TDI)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_KILLING, &a_Victim, a_Killer, &a_TDI);
+	return CallWorldHooks(a_Victim.GetWorld(), cPluginManager::HOOK_KILLING, &a_Victim, a_Killer, &a_TDI);
 }
 
 
@@ -576,7 +740,7 @@ bool cPluginLua::OnLoginForge(cClientHandle & a_Client, const AStringMap & a_Mod
 
 bool cPluginLua::OnPlayerAnimation(cPlayer & a_Player, int a_Animation)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_ANIMATION, &a_Player, a_Animation);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_ANIMATION, &a_Player, a_Animation);
 }
 
 
@@ -585,7 +749,7 @@ bool cPluginLua::OnPlayerAnimation(cPlayer & a_Player, int a_Animation)
 
 bool cPluginLua::OnPlayerBreakingBlock(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_BREAKING_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_BlockType, a_BlockMeta);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_BREAKING_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_BlockType, a_BlockMeta);
 }
 
 
@@ -594,7 +758,7 @@ bool cPluginLua::OnPlayerBreakingBlock(cPlayer & a_Player, int a_BlockX, int a_B
 
 bool cPluginLua::OnPlayerBrokenBlock(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_BROKEN_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_BlockType, a_BlockMeta);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_BROKEN_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_BlockType, a_BlockMeta);
 }
 
 
@@ -612,7 +776,7 @@ bool cPluginLua::OnPlayerDestroyed(cPlayer & a_Player)
 
 bool cPluginLua::OnPlayerEating(cPlayer & a_Player)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_EATING, &a_Player);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_EATING, &a_Player);
 }
 
 
@@ -621,7 +785,7 @@ bool cPluginLua::OnPlayerEating(cPlayer & a_Player)
 
 bool cPluginLua::OnPlayerFoodLevelChange(cPlayer & a_Player, int a_NewFoodLevel)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_FOOD_LEVEL_CHANGE, &a_Player, a_NewFoodLevel);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_FOOD_LEVEL_CHANGE, &a_Player, a_NewFoodLevel);
 }
 
 
@@ -631,7 +795,7 @@ bool cPluginLua::OnPlayerFoodLevelChange(cPlayer & a_Player, int a_NewFoodLevel)
 bool cPluginLua::OnPlayerFished(cPlayer & a_Player, const cItems & a_Reward)
 {
 	cItems reward(a_Reward);
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_FISHED, &a_Player, &reward);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_FISHED, &a_Player, &reward);
 }
 
 
@@ -640,7 +804,7 @@ bool cPluginLua::OnPlayerFished(cPlayer & a_Player, const cItems & a_Reward)
 
 bool cPluginLua::OnPlayerFishing(cPlayer & a_Player, cItems & a_Reward)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_FISHING, &a_Player, &a_Reward);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_FISHING, &a_Player, &a_Reward);
 }
 
 
@@ -658,7 +822,7 @@ bool cPluginLua::OnPlayerJoined(cPlayer & a_Player)
 
 bool cPluginLua::OnPlayerLeftClick(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, char a_Status)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_LEFT_CLICK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_Status);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_LEFT_CLICK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_Status);
 }
 
 
@@ -667,7 +831,7 @@ bool cPluginLua::OnPlayerLeftClick(cPlayer & a_Player, int a_BlockX, int a_Block
 
 bool cPluginLua::OnPlayerMoving(cPlayer & a_Player, const Vector3d & a_OldPosition, const Vector3d & a_NewPosition, bool a_PreviousIsOnGround)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_MOVING, &a_Player, a_OldPosition, a_NewPosition, a_PreviousIsOnGround);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_MOVING, &a_Player, a_OldPosition, a_NewPosition, a_PreviousIsOnGround);
 }
 
 
@@ -676,7 +840,7 @@ bool cPluginLua::OnPlayerMoving(cPlayer & a_Player, const Vector3d & a_OldPositi
 
 bool cPluginLua::OnEntityTeleport(cEntity & a_Entity, const Vector3d & a_OldPosition, const Vector3d & a_NewPosition)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_ENTITY_TELEPORT, &a_Entity, a_OldPosition, a_NewPosition);
+	return CallWorldHooks(a_Entity.GetWorld(), cPluginManager::HOOK_ENTITY_TELEPORT, &a_Entity, a_OldPosition, a_NewPosition);
 }
 
 
@@ -685,7 +849,7 @@ bool cPluginLua::OnEntityTeleport(cEntity & a_Entity, const Vector3d & a_OldPosi
 
 bool cPluginLua::OnPlayerOpeningWindow(cPlayer & a_Player, cWindow & a_Window)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_OPENING_WINDOW, &a_Player, &a_Window);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_OPENING_WINDOW, &a_Player, &a_Window);
 }
 
 
@@ -694,7 +858,7 @@ bool cPluginLua::OnPlayerOpeningWindow(cPlayer & a_Player, cWindow & a_Window)
 
 bool cPluginLua::OnPlayerPlacedBlock(cPlayer & a_Player, const sSetBlock & a_BlockChange)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_PLACED_BLOCK,
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_PLACED_BLOCK,
 		&a_Player,
 		a_BlockChange.GetX(), a_BlockChange.GetY(), a_BlockChange.GetZ(),
 		a_BlockChange.m_BlockType, a_BlockChange.m_BlockMeta
@@ -707,7 +871,7 @@ bool cPluginLua::OnPlayerPlacedBlock(cPlayer & a_Player, const sSetBlock & a_Blo
 
 bool cPluginLua::OnPlayerPlacingBlock(cPlayer & a_Player, const sSetBlock & a_BlockChange)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_PLACING_BLOCK,
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_PLACING_BLOCK,
 		&a_Player,
 		a_BlockChange.GetX(), a_BlockChange.GetY(), a_BlockChange.GetZ(),
 		a_BlockChange.m_BlockType, a_BlockChange.m_BlockMeta
@@ -720,7 +884,7 @@ bool cPluginLua::OnPlayerPlacingBlock(cPlayer & a_Player, const sSetBlock & a_Bl
 
 bool cPluginLua::OnPlayerCrouched(cPlayer & a_Player)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_CROUCHED,
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_CROUCHED,
 		&a_Player);
 }
 
@@ -730,7 +894,7 @@ bool cPluginLua::OnPlayerCrouched(cPlayer & a_Player)
 
 bool cPluginLua::OnPlayerRightClick(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, int a_CursorX, int a_CursorY, int a_CursorZ)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_RIGHT_CLICK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_RIGHT_CLICK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ);
 }
 
 
@@ -739,7 +903,7 @@ bool cPluginLua::OnPlayerRightClick(cPlayer & a_Player, int a_BlockX, int a_Bloc
 
 bool cPluginLua::OnPlayerRightClickingEntity(cPlayer & a_Player, cEntity & a_Entity)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_RIGHT_CLICKING_ENTITY, &a_Player, &a_Entity);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_RIGHT_CLICKING_ENTITY, &a_Player, &a_Entity);
 }
 
 
@@ -748,7 +912,7 @@ bool cPluginLua::OnPlayerRightClickingEntity(cPlayer & a_Player, cEntity & a_Ent
 
 bool cPluginLua::OnPlayerShooting(cPlayer & a_Player)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_SHOOTING, &a_Player);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_SHOOTING, &a_Player);
 }
 
 
@@ -766,7 +930,7 @@ bool cPluginLua::OnPlayerSpawned(cPlayer & a_Player)
 
 bool cPluginLua::OnPlayerTossingItem(cPlayer & a_Player)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_TOSSING_ITEM, &a_Player);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_TOSSING_ITEM, &a_Player);
 }
 
 
@@ -775,7 +939,7 @@ bool cPluginLua::OnPlayerTossingItem(cPlayer & a_Player)
 
 bool cPluginLua::OnPlayerUsedBlock(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, int a_CursorX, int a_CursorY, int a_CursorZ, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_USED_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ, a_BlockType, a_BlockMeta);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_USED_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ, a_BlockType, a_BlockMeta);
 }
 
 
@@ -784,7 +948,7 @@ bool cPluginLua::OnPlayerUsedBlock(cPlayer & a_Player, int a_BlockX, int a_Block
 
 bool cPluginLua::OnPlayerUsedItem(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, int a_CursorX, int a_CursorY, int a_CursorZ)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_USED_ITEM, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_USED_ITEM, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ);
 }
 
 
@@ -793,7 +957,7 @@ bool cPluginLua::OnPlayerUsedItem(cPlayer & a_Player, int a_BlockX, int a_BlockY
 
 bool cPluginLua::OnPlayerUsingBlock(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, int a_CursorX, int a_CursorY, int a_CursorZ, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_USING_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ, a_BlockType, a_BlockMeta);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_USING_BLOCK, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ, a_BlockType, a_BlockMeta);
 }
 
 
@@ -802,7 +966,7 @@ bool cPluginLua::OnPlayerUsingBlock(cPlayer & a_Player, int a_BlockX, int a_Bloc
 
 bool cPluginLua::OnPlayerUsingItem(cPlayer & a_Player, int a_BlockX, int a_BlockY, int a_BlockZ, char a_BlockFace, int a_CursorX, int a_CursorY, int a_CursorZ)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PLAYER_USING_ITEM, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PLAYER_USING_ITEM, &a_Player, a_BlockX, a_BlockY, a_BlockZ, a_BlockFace, a_CursorX, a_CursorY, a_CursorZ);
 }
 
 
@@ -842,7 +1006,7 @@ bool cPluginLua::OnPluginsLoaded(void)
 
 bool cPluginLua::OnPostCrafting(cPlayer & a_Player, cCraftingGrid & a_Grid, cCraftingRecipe & a_Recipe)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_POST_CRAFTING, &a_Player, &a_Grid, &a_Recipe);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_POST_CRAFTING, &a_Player, &a_Grid, &a_Recipe);
 }
 
 
@@ -851,7 +1015,7 @@ bool cPluginLua::OnPostCrafting(cPlayer & a_Player, cCraftingGrid & a_Grid, cCra
 
 bool cPluginLua::OnPreCrafting(cPlayer & a_Player, cCraftingGrid & a_Grid, cCraftingRecipe & a_Recipe)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PRE_CRAFTING, &a_Player, &a_Grid, &a_Recipe);
+	return CallWorldHooks(a_Player.GetWorld(), cPluginManager::HOOK_PRE_CRAFTING, &a_Player, &a_Grid, &a_Recipe);
 }
 
 
@@ -860,7 +1024,7 @@ bool cPluginLua::OnPreCrafting(cPlayer & a_Player, cCraftingGrid & a_Grid, cCraf
 
 bool cPluginLua::OnProjectileHitBlock(cProjectileEntity & a_Projectile, int a_BlockX, int a_BlockY, int a_BlockZ, eBlockFace a_Face, const Vector3d & a_BlockHitPos)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PROJECTILE_HIT_BLOCK, &a_Projectile, a_BlockX, a_BlockY, a_BlockZ, a_Face, a_BlockHitPos);
+	return CallWorldHooks(a_Projectile.GetWorld(), cPluginManager::HOOK_PROJECTILE_HIT_BLOCK, &a_Projectile, a_BlockX, a_BlockY, a_BlockZ, a_Face, a_BlockHitPos);
 }
 
 
@@ -869,7 +1033,7 @@ bool cPluginLua::OnProjectileHitBlock(cProjectileEntity & a_Projectile, int a_Bl
 
 bool cPluginLua::OnProjectileHitEntity(cProjectileEntity & a_Projectile, cEntity & a_HitEntity)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_PROJECTILE_HIT_ENTITY, &a_Projectile, &a_HitEntity);
+	return CallWorldHooks(a_Projectile.GetWorld(), cPluginManager::HOOK_PROJECTILE_HIT_ENTITY, &a_Projectile, &a_HitEntity);
 }
 
 
@@ -902,7 +1066,7 @@ bool cPluginLua::OnServerPing(cClientHandle & a_ClientHandle, AString & a_Server
 
 bool cPluginLua::OnSpawnedEntity(cWorld & a_World, cEntity & a_Entity)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_SPAWNED_ENTITY, &a_World, &a_Entity);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_SPAWNED_ENTITY, &a_World, &a_Entity);
 }
 
 
@@ -911,7 +1075,7 @@ bool cPluginLua::OnSpawnedEntity(cWorld & a_World, cEntity & a_Entity)
 
 bool cPluginLua::OnSpawnedMonster(cWorld & a_World, cMonster & a_Monster)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_SPAWNED_MONSTER, &a_World, &a_Monster);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_SPAWNED_MONSTER, &a_World, &a_Monster);
 }
 
 
@@ -920,7 +1084,7 @@ bool cPluginLua::OnSpawnedMonster(cWorld & a_World, cMonster & a_Monster)
 
 bool cPluginLua::OnSpawningEntity(cWorld & a_World, cEntity & a_Entity)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_SPAWNING_ENTITY, &a_World, &a_Entity);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_SPAWNING_ENTITY, &a_World, &a_Entity);
 }
 
 
@@ -929,7 +1093,7 @@ bool cPluginLua::OnSpawningEntity(cWorld & a_World, cEntity & a_Entity)
 
 bool cPluginLua::OnSpawningMonster(cWorld & a_World, cMonster & a_Monster)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_SPAWNING_MONSTER, &a_World, &a_Monster);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_SPAWNING_MONSTER, &a_World, &a_Monster);
 }
 
 
@@ -938,7 +1102,7 @@ bool cPluginLua::OnSpawningMonster(cWorld & a_World, cMonster & a_Monster)
 
 bool cPluginLua::OnTakeDamage(cEntity & a_Receiver, TakeDamageInfo & a_TDI)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_TAKE_DAMAGE, &a_Receiver, &a_TDI);
+	return CallWorldHooks(a_Receiver.GetWorld(), cPluginManager::HOOK_TAKE_DAMAGE, &a_Receiver, &a_TDI);
 }
 
 
@@ -952,7 +1116,7 @@ bool cPluginLua::OnUpdatedSign(
 	cPlayer * a_Player
 )
 {
-	return CallSimpleHooks(cPluginManager::HOOK_UPDATED_SIGN, &a_World, a_BlockX, a_BlockY, a_BlockZ, a_Line1, a_Line2, a_Line3, a_Line4, a_Player);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_UPDATED_SIGN, &a_World, a_BlockX, a_BlockY, a_BlockZ, a_Line1, a_Line2, a_Line3, a_Line4, a_Player);
 }
 
 
@@ -990,7 +1154,7 @@ bool cPluginLua::OnUpdatingSign(
 
 bool cPluginLua::OnWeatherChanged(cWorld & a_World)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_WEATHER_CHANGED, &a_World);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_WEATHER_CHANGED, &a_World);
 }
 
 
@@ -1023,7 +1187,7 @@ bool cPluginLua::OnWeatherChanging(cWorld & a_World, eWeather & a_NewWeather)
 
 bool cPluginLua::OnWorldStarted(cWorld & a_World)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_WORLD_STARTED, &a_World);
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_WORLD_STARTED, &a_World);
 }
 
 
@@ -1032,7 +1196,13 @@ bool cPluginLua::OnWorldStarted(cWorld & a_World)
 
 bool cPluginLua::OnWorldTick(cWorld & a_World, std::chrono::milliseconds a_Dt, std::chrono::milliseconds a_LastTickDurationMSec)
 {
-	return CallSimpleHooks(cPluginManager::HOOK_WORLD_TICK, &a_World, a_Dt, a_LastTickDurationMSec);
+	auto WorldState = GetWorldState(&a_World);
+	if (WorldState != nullptr)
+	{
+		cLuaState::cLock Lock(WorldState->m_LuaState);
+		DeliverStateMessages(WorldState->m_LuaState, WorldState->m_Messages);
+	}
+	return CallWorldHooks(&a_World, cPluginManager::HOOK_WORLD_TICK, &a_World, a_Dt, a_LastTickDurationMSec);
 }
 
 
@@ -1146,10 +1316,150 @@ const char * cPluginLua::GetHookFnName(int a_HookType)
 
 
 
-bool cPluginLua::AddHookCallback(int a_HookType, cLuaState::cCallbackPtr && a_Callback)
+bool cPluginLua::IsWorldScopedHook(int a_HookType)
 {
-	m_HookMap[a_HookType].push_back(std::move(a_Callback));
-	return true;
+	switch (a_HookType)
+	{
+		case cPluginManager::HOOK_BLOCK_SPREAD:
+		case cPluginManager::HOOK_BREWING_COMPLETED:
+		case cPluginManager::HOOK_BREWING_COMPLETING:
+		case cPluginManager::HOOK_CHUNK_AVAILABLE:
+		case cPluginManager::HOOK_CHUNK_GENERATED:
+		case cPluginManager::HOOK_CHUNK_GENERATING:
+		case cPluginManager::HOOK_CHUNK_UNLOADED:
+		case cPluginManager::HOOK_CHUNK_UNLOADING:
+		case cPluginManager::HOOK_COLLECTING_PICKUP:
+		case cPluginManager::HOOK_CRAFTING_NO_RECIPE:
+		case cPluginManager::HOOK_ENTITY_ADD_EFFECT:
+		case cPluginManager::HOOK_ENTITY_TELEPORT:
+		case cPluginManager::HOOK_HOPPER_PULLING_ITEM:
+		case cPluginManager::HOOK_HOPPER_PUSHING_ITEM:
+		case cPluginManager::HOOK_KILLING:
+		case cPluginManager::HOOK_PLAYER_ANIMATION:
+		case cPluginManager::HOOK_PLAYER_BREAKING_BLOCK:
+		case cPluginManager::HOOK_PLAYER_BROKEN_BLOCK:
+		case cPluginManager::HOOK_PLAYER_CROUCHED:
+		case cPluginManager::HOOK_PLAYER_EATING:
+		case cPluginManager::HOOK_PLAYER_FISHED:
+		case cPluginManager::HOOK_PLAYER_FISHING:
+		case cPluginManager::HOOK_PLAYER_FOOD_LEVEL_CHANGE:
+		case cPluginManager::HOOK_PLAYER_LEFT_CLICK:
+		case cPluginManager::HOOK_PLAYER_MOVING:
+		case cPluginManager::HOOK_PLAYER_OPENING_WINDOW:
+		case cPluginManager::HOOK_PLAYER_PLACED_BLOCK:
+		case cPluginManager::HOOK_PLAYER_PLACING_BLOCK:
+		case cPluginManager::HOOK_PLAYER_RIGHT_CLICK:
+		case cPluginManager::HOOK_PLAYER_RIGHT_CLICKING_ENTITY:
+		case cPluginManager::HOOK_PLAYER_SHOOTING:
+		case cPluginManager::HOOK_PLAYER_TOSSING_ITEM:
+		case cPluginManager::HOOK_PLAYER_USED_BLOCK:
+		case cPluginManager::HOOK_PLAYER_USED_ITEM:
+		case cPluginManager::HOOK_PLAYER_USING_BLOCK:
+		case cPluginManager::HOOK_PLAYER_USING_ITEM:
+		case cPluginManager::HOOK_POST_CRAFTING:
+		case cPluginManager::HOOK_PRE_CRAFTING:
+		case cPluginManager::HOOK_PROJECTILE_HIT_BLOCK:
+		case cPluginManager::HOOK_PROJECTILE_HIT_ENTITY:
+		case cPluginManager::HOOK_SPAWNED_ENTITY:
+		case cPluginManager::HOOK_SPAWNED_MONSTER:
+		case cPluginManager::HOOK_SPAWNING_ENTITY:
+		case cPluginManager::HOOK_SPAWNING_MONSTER:
+		case cPluginManager::HOOK_TAKE_DAMAGE:
+		case cPluginManager::HOOK_UPDATED_SIGN:
+		case cPluginManager::HOOK_WEATHER_CHANGED:
+		case cPluginManager::HOOK_WORLD_STARTED:
+		case cPluginManager::HOOK_WORLD_TICK:
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+
+
+bool cPluginLua::AddHookCallback(cLuaState & a_RegisteringState, int a_HookType, cLuaState::cCallbackPtr && a_Callback)
+{
+	// The main LuaState has no world name, it takes any hook:
+	AString WorldName;
+	if (!a_RegisteringState.GetNamedGlobal(LUA_PLUGIN_WORLD_VAR_NAME, WorldName))
+	{
+		m_HookMap[a_HookType].push_back(std::move(a_Callback));
+		m_NumMainHooks[static_cast<size_t>(a_HookType)].fetch_add(1, std::memory_order_release);
+		return true;
+	}
+
+	// A per-world LuaState only receives the hooks called for its own world:
+	if (!IsWorldScopedHook(a_HookType))
+	{
+		LOGWARNING("Plugin %s: hook %d is not called per world, it can only be added from the plugin's main LuaState (Initialize()).",
+			GetName().c_str(), a_HookType
+		);
+		return false;
+	}
+	cCSLock Lock(m_CSWorldStates);
+	for (auto & WorldState: m_WorldStates)
+	{
+		if (WorldState.second->m_WorldName == WorldName)
+		{
+			// The registering state is executing this, so its lock is already held:
+			WorldState.second->m_HookMap[a_HookType].push_back(std::move(a_Callback));
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+
+
+bool cPluginLua::PostStateMessage(cLuaState & a_SenderState, const AString & a_TargetWorldName, const AString & a_Channel, const AString & a_Payload)
+{
+	sStateMessage Message;
+	Message.m_Channel = a_Channel;
+	Message.m_Payload = a_Payload;
+	a_SenderState.GetNamedGlobal(LUA_PLUGIN_WORLD_VAR_NAME, Message.m_SenderWorldName);  // Stays empty for the main LuaState
+
+	cCSLock Lock(m_CSWorldStates);
+	if (m_WorldStates.empty())
+	{
+		// Not in the per-world mode, there's no other LuaState to talk to
+		return false;
+	}
+	if (a_TargetWorldName.empty())
+	{
+		m_MainMessages.Push(std::move(Message));
+		return true;
+	}
+	for (auto & WorldState: m_WorldStates)
+	{
+		if (WorldState.second->m_WorldName == a_TargetWorldName)
+		{
+			WorldState.second->m_Messages.Push(std::move(Message));
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+
+
+void cPluginLua::DeliverStateMessages(cLuaState & a_LuaState, cStateMessageQueue & a_Queue)
+{
+	auto Messages = a_Queue.TakeAll();
+	if (Messages.empty() || !a_LuaState.IsValid() || !a_LuaState.HasFunction("OnStateMessage"))
+	{
+		return;
+	}
+	for (const auto & Message: Messages)
+	{
+		a_LuaState.Call("OnStateMessage", Message.m_Channel, Message.m_Payload, Message.m_SenderWorldName);
+	}
 }
 
 
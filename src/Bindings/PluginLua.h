@@ -16,6 +16,9 @@
 #define LUA_PLUGIN_NAME_VAR_NAME     "_CuberiteInternal_PluginName"
 #define LUA_PLUGIN_INSTANCE_VAR_NAME "_CuberiteInternal_PluginInstance"
 
+// Name of the global variable holding the world name in the per-world LuaStates; not present in the main LuaState
+#define LUA_PLUGIN_WORLD_VAR_NAME    "_CuberiteInternal_WorldName"
+
 
 
 
@@ -141,9 +144,19 @@ public:
 	/** Returns the name of Lua function that should handle the specified hook type in the older (#121) API */
 	static const char * GetHookFnName(int a_HookType);
 
+	/** Returns true if the specified hook type is dispatched per world and thus can be registered from a per-world LuaState. */
+	static bool IsWorldScopedHook(int a_HookType);
+
 	/** Adds a Lua callback to be called for the specified hook.
+	a_RegisteringState is the LuaState from which the hook is being registered, the callback is stored with that state's hooks.
 	Returns true if the hook was added successfully. */
-	bool AddHookCallback(int a_HookType, cLuaState::cCallbackPtr && a_Callback);
+	bool AddHookCallback(cLuaState & a_RegisteringState, int a_HookType, cLuaState::cCallbackPtr && a_Callback);
+
+	/** Queues a message for the LuaState of the specified world, or the main LuaState if a_TargetWorldName is empty.
+	a_SenderState is the LuaState posting the message, its world name is passed on to the receiver.
+	The message is delivered to the OnStateMessage() global function on the target world's next tick (server tick for the main state).
+	Returns false if the plugin doesn't use per-world LuaStates or there's no such world. */
+	bool PostStateMessage(cLuaState & a_SenderState, const AString & a_TargetWorldName, const AString & a_Channel, const AString & a_Payload);
 
 	/** Calls a function in this plugin's LuaState with parameters copied over from a_ForeignState.
 	The values that the function returns are placed onto a_ForeignState.
@@ -169,6 +182,51 @@ protected:
 	/** Maps hook types into arrays of Lua function references to call for each hook type */
 	typedef std::map<int, cLuaCallbacks> cHookMap;
 
+	/** A message passed between the plugin's LuaStates via PostStateMessage(). */
+	struct sStateMessage
+	{
+		AString m_Channel;
+		AString m_Payload;
+
+		/** Name of the world whose LuaState sent the message, empty for the main LuaState. */
+		AString m_SenderWorldName;
+	};
+
+	/** Thread-safe queue of messages waiting for delivery into a single LuaState.
+	Has its own lock so that posting never waits for the receiving LuaState. */
+	class cStateMessageQueue
+	{
+	public:
+		void Push(sStateMessage && a_Message);
+
+		/** Removes and returns all the queued messages. */
+		std::vector<sStateMessage> TakeAll(void);
+
+	protected:
+		cCriticalSection m_CS;
+		std::vector<sStateMessage> m_Messages;
+	};
+
+	/** A LuaState dedicated to a single world, used when the plugin opts into the per-world mode. */
+	struct sWorldState
+	{
+		sWorldState(const AString & a_WorldName, const AString & a_PluginDirectory):
+			m_WorldName(a_WorldName),
+			m_LuaState(Printf("plugin %s, world %s", a_PluginDirectory.c_str(), a_WorldName.c_str()))
+		{
+		}
+
+		AString m_WorldName;
+		cLuaState m_LuaState;
+
+		/** World-scoped hooks registered from this LuaState. Protected by m_LuaState's lock. */
+		cHookMap m_HookMap;
+
+		/** Messages waiting to be delivered into m_LuaState. */
+		cStateMessageQueue m_Messages;
+	};
+	typedef std::shared_ptr<sWorldState> sWorldStatePtr;
+
 
 	/** The plugin's Lua state. */
 	cLuaState m_LuaState;
@@ -176,9 +234,23 @@ protected:
 	/** Hooks that the plugin has registered. */
 	cHookMap m_HookMap;
 
+	/** Number of callbacks in m_HookMap for each hook type.
+	Read without m_LuaState's lock by CallWorldHooks(), so that the worlds don't serialize on the main LuaState
+	for the hooks that are only handled in the per-world LuaStates. Written under m_LuaState's lock. */
+	std::array<std::atomic<size_t>, cPluginManager::HOOK_NUM_HOOKS> m_NumMainHooks;
+
 	/** The DeadlockDetect object to which the plugin's CS is tracked. */
 	cDeadlockDetect & m_DeadlockDetect;
 
+	/** The per-world LuaStates, empty unless the plugin sets g_PluginInfo.PerWorldStates in its Info.lua.
+	Each world's hooks and messages are handled under that world's LuaState lock, so the worlds don't serialize on m_LuaState.
+	Protected by m_CSWorldStates, which is only held while looking up a state, never while calling into Lua. */
+	std::map<const cWorld *, sWorldStatePtr> m_WorldStates;
+	cCriticalSection m_CSWorldStates;
+
+	/** Messages waiting to be delivered into the main LuaState. */
+	cStateMessageQueue m_MainMessages;
+
 
 	/** Releases all Lua references, notifies and removes all m_Resettables[] and closes the m_LuaState. */
 	void Close(void);
@@ -186,6 +258,27 @@ protected:
 	/** Removes all WebTabs currently registered for this plugin from the WebAdmin. */
 	void ClearWebTabs(void);
 
+	/** Creates a_LuaState and injects the plugin identification globals and package paths into it. */
+	void PrepareLuaState(cLuaState & a_LuaState);
+
+	/** Loads all the plugin's Lua files into a_LuaState, Info.lua last.
+	Returns false and sets the load error on failure. */
+	bool LoadPluginFiles(cLuaState & a_LuaState);
+
+	/** Creates, loads and initializes a LuaState for each world, by calling InitializeWorld(Plugin, World) in each.
+	Returns false and sets the load error on failure. */
+	bool LoadWorldStates(void);
+
+	/** Releases the hooks and closes all the per-world LuaStates. */
+	void CloseWorldStates(void);
+
+	/** Returns the per-world LuaState for the specified world, or nullptr if the plugin doesn't use one for that world. */
+	sWorldStatePtr GetWorldState(const cWorld * a_World);
+
+	/** Delivers all messages from a_Queue into a_LuaState's OnStateMessage() function.
+	The caller must hold a_LuaState's lock. */
+	void DeliverStateMessages(cLuaState & a_LuaState, cStateMessageQueue & a_Queue);
+
 	/** Calls a hook that has the simple format - single bool return value specifying whether the chain should continue.
 	The advanced hook types that need more processing implement a similar loop manually instead.
 	Returns true if any of hook calls wants to abort the hook (returned true), false if all hook calls returned false. */
@@ -193,9 +286,39 @@ protected:
 	bool CallSimpleHooks(int a_HookType, Args && ... a_Args)
 	{
 		cOperation op(*this);
-		auto & hooks = m_HookMap[a_HookType];
+		return CallHookCallbacks(m_HookMap[a_HookType], std::forward<Args>(a_Args)...);
+	}
+
+	/** Calls a world-scoped hook that has the simple format.
+	The hooks registered from the main LuaState are called first, then those registered from a_World's own LuaState, if any.
+	The main LuaState is only locked if it has any callbacks for the hook.
+	Returns true if any of hook calls wants to abort the hook (returned true), false if all hook calls returned false. */
+	template <typename... Args>
+	bool CallWorldHooks(const cWorld * a_World, int a_HookType, Args && ... a_Args)
+	{
+		if (
+			(m_NumMainHooks[static_cast<size_t>(a_HookType)].load(std::memory_order_acquire) > 0) &&
+			CallSimpleHooks(a_HookType, a_Args...)
+		)
+		{
+			return true;
+		}
+		auto WorldState = GetWorldState(a_World);
+		if (WorldState == nullptr)
+		{
+			return false;
+		}
+		cLuaState::cLock Lock(WorldState->m_LuaState);
+		return CallHookCallbacks(WorldState->m_HookMap[a_HookType], a_Args...);
+	}
+
+	/** Calls the callbacks in a_Hooks in sequence, until one of them returns true.
+	The caller must hold the lock of the LuaState in which the callbacks reside. */
+	template <typename... Args>
+	static bool CallHookCallbacks(cLuaCallbacks & a_Hooks, Args && ... a_Args)
+	{
 		bool res = false;
-		for (auto & hook: hooks)
+		for (auto & hook: a_Hooks)
 		{
 			hook->Call(std::forward<Args>(a_Args)..., cLuaState::Return, res);
 			if (res)
@@ -27,7 +27,8 @@ cPluginManager * cPluginManager::Get(void)
 
 cPluginManager::cPluginManager(cDeadlockDetect & a_DeadlockDetect) :
 	m_bReloadPlugins(false),
-	m_DeadlockDetect(a_DeadlockDetect)
+	m_DeadlockDetect(a_DeadlockDetect),
+	m_IsHookProfilerEnabled(false)
 {
 }
 
@@ -228,7 +229,47 @@ bool cPluginManager::GenericCallHook(PluginHook a_HookName, HookFunction a_HookF
 		return false;
 	}
 
-	return std::any_of(Plugins->second.begin(), Plugins->second.end(), a_HookFunction);
+	if (!m_IsHookProfilerEnabled)
+	{
+		return std::any_of(Plugins->second.begin(), Plugins->second.end(), a_HookFunction);
+	}
+
+	// Time each plugin's hook call separately:
+	return std::any_of(Plugins->second.begin(), Plugins->second.end(), [&](cPlugin * a_Plugin)
+		{
+			auto Start = std::chrono::steady_clock::now();
+			bool Res = a_HookFunction(a_Plugin);
+			RecordHookCall(*a_Plugin, a_HookName, std::chrono::steady_clock::now() - Start);
+			return Res;
+		}
+	);
+}
+
+
+
+
+
+void cPluginManager::RecordHookCall(const cPlugin & a_Plugin, PluginHook a_HookName, std::chrono::nanoseconds a_Duration)
+{
+	// Histogram bucket: the number of bits needed for the duration in microseconds
+	auto Microseconds = static_cast<UInt64>(std::chrono::duration_cast<std::chrono::microseconds>(a_Duration).count());
+	size_t Bucket = 0;
+	while ((Microseconds > 0) && (Bucket < 31))
+	{
+		Microseconds >>= 1;
+		Bucket += 1;
+	}
+
+	cCSLock Lock(m_CSHookStats);
+	auto & Stats = m_HookStats[std::make_pair(&a_Plugin, static_cast<int>(a_HookName))];
+	if (Stats.m_NumCalls == 0)
+	{
+		Stats.m_PluginName = a_Plugin.GetName();
+	}
+	Stats.m_NumCalls += 1;
+	Stats.m_TotalTime += a_Duration;
+	Stats.m_MaxTime = std::max(Stats.m_MaxTime, a_Duration);
+	Stats.m_Histogram[Bucket] += 1;
 }
 
 
@@ -1726,6 +1767,82 @@ size_t cPluginManager::GetNumLoadedPlugins(void) const
 
 
 
+void cPluginManager::SetHookProfilerEnabled(bool a_Enabled)
+{
+	if (a_Enabled)
+	{
+		cCSLock Lock(m_CSHookStats);
+		m_HookStats.clear();
+	}
+	m_IsHookProfilerEnabled = a_Enabled;
+}
+
+
+
+
+
+AString cPluginManager::GetHookProfilerStats(void) const
+{
+	using cMilliseconds = std::chrono::duration<double, std::milli>;
+
+	// Copy the stats out of the lock and sort them by the total time, most expensive first:
+	std::vector<std::pair<int, sHookStats>> Stats;
+	{
+		cCSLock Lock(m_CSHookStats);
+		Stats.reserve(m_HookStats.size());
+		for (const auto & Entry: m_HookStats)
+		{
+			Stats.emplace_back(Entry.first.second, Entry.second);
+		}
+	}
+	std::sort(Stats.begin(), Stats.end(), [](const decltype(Stats)::value_type & a_First, const decltype(Stats)::value_type & a_Second)
+		{
+			return (a_First.second.m_TotalTime > a_Second.second.m_TotalTime);
+		}
+	);
+
+	AString res = Printf("Hook profiler is %s.\n", m_IsHookProfilerEnabled ? "enabled" : "disabled");
+	if (Stats.empty())
+	{
+		res.append("No hook calls recorded.\n");
+		return res;
+	}
+	res.append(Printf("%-24s %-28s %10s %12s %10s %10s %10s\n", "Plugin", "Hook", "Calls", "Total [ms]", "Avg [ms]", "Max [ms]", "p99 [ms]"));
+	for (const auto & Entry: Stats)
+	{
+		const auto & HookStats = Entry.second;
+		const char * HookName = cPluginLua::GetHookFnName(Entry.first);
+
+		// Estimate the 99th percentile as the upper bound of the histogram bucket containing it, capped by the max:
+		auto p99 = HookStats.m_MaxTime;
+		UInt64 NumCalls = 0;
+		for (size_t Bucket = 0; Bucket < HookStats.m_Histogram.size(); Bucket++)
+		{
+			NumCalls += HookStats.m_Histogram[Bucket];
+			if (NumCalls * 100 >= HookStats.m_NumCalls * 99)
+			{
+				p99 = std::min<std::chrono::nanoseconds>(p99, std::chrono::microseconds(UInt64(1) << Bucket));
+				break;
+			}
+		}
+
+		res.append(Printf("%-24s %-28s %10llu %12.3f %10.3f %10.3f %10.3f\n",
+			HookStats.m_PluginName,
+			(HookName != nullptr) ? AString(HookName) : Printf("Hook #%d", Entry.first),
+			static_cast<unsigned long long>(HookStats.m_NumCalls),
+			cMilliseconds(HookStats.m_TotalTime).count(),
+			cMilliseconds(HookStats.m_TotalTime).count() / HookStats.m_NumCalls,
+			cMilliseconds(HookStats.m_MaxTime).count(),
+			cMilliseconds(p99).count()
+		));
+	}
+	return res;
+}
+
+
+
+
+
 AStringVector cPluginManager::GetFoldersToLoad(cSettingsRepositoryInterface & a_Settings)
 {
 	// Check if the Plugins section exists.
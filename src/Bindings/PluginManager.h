@@ -225,6 +225,17 @@ public:
 	/** Returns the number of plugins that are psLoaded. */
 	size_t GetNumLoadedPlugins(void) const;  // tolua_export
 
+	/** Enables or disables timing of the plugins' hook calls. Enabling resets the statistics collected so far.
+	While disabled, the hook calls aren't timed at all. */
+	void SetHookProfilerEnabled(bool a_Enabled);  // tolua_export
+
+	/** Returns true if the plugins' hook calls are being timed. */
+	bool IsHookProfilerEnabled(void) const { return m_IsHookProfilerEnabled; }  // tolua_export
+
+	/** Returns the hook timing statistics collected since the profiler was enabled, as a human-readable table.
+	There's one line per plugin and hook type, sorted by the total time spent in the hook. */
+	AString GetHookProfilerStats(void) const;  // tolua_export
+
 	// Calls for individual hooks. Each returns false if the action is to continue or true if the plugin wants to abort
 	bool CallHookBlockSpread              (cWorld & a_World, int a_BlockX, int a_BlockY, int a_BlockZ, eSpreadSource a_Source);
 	bool CallHookBlockToPickups           (cWorld & a_World, Vector3i a_BlockPos, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta, const cBlockEntity * a_BlockEntity, const cEntity * a_Digger, const cItem * a_Tool, cItems & a_Pickups);
@@ -404,6 +415,25 @@ private:
 	typedef std::map<int, cPluginManager::PluginList> HookMap;
 	typedef std::map<AString, cCommandReg> CommandMap;
 
+	/** Timing statistics of a single plugin's calls of a single hook type. */
+	struct sHookStats
+	{
+		/** Name of the plugin, copied when the first call is recorded, so that the stats don't need to read the plugin. */
+		AString m_PluginName;
+
+		UInt64 m_NumCalls = 0;
+		std::chrono::nanoseconds m_TotalTime{0};
+		std::chrono::nanoseconds m_MaxTime{0};
+
+		/** Number of calls by their duration; bucket N counts the calls that took less than 2^N microseconds
+		(and at least 2^(N - 1) microseconds). Used for estimating the percentiles. */
+		std::array<UInt64, 32> m_Histogram{};
+	};
+
+	/** Hook statistics, keyed by plugin and hook type.
+	The plugin objects are kept in m_Plugins until the plugin manager is destroyed, even when unloaded, so the pointers are stable. */
+	typedef std::map<std::pair<const cPlugin *, int>, sHookStats> HookStatsMap;
+
 
 	/** FolderNames of plugins that should be unloaded.
 	The plugins will be unloaded within the next call to Tick(), to avoid multithreading issues.
@@ -426,6 +456,16 @@ private:
 	/** The deadlock detect in which all plugins should track their CSs. */
 	cDeadlockDetect & m_DeadlockDetect;
 
+	/** Set while the hook calls are being timed. Atomic so that the hook calls can check it without locking. */
+	std::atomic<bool> m_IsHookProfilerEnabled;
+
+	/** The hook timing statistics collected since the profiler was last enabled.
+	Protected against multithreaded access by m_CSHookStats, the hooks are called from multiple threads. */
+	HookStatsMap m_HookStats;
+
+	/** Protects m_HookStats against multithreaded access. */
+	mutable cCriticalSection m_CSHookStats;
+
 
 	cPluginManager(cDeadlockDetect & a_DeadlockDetect);
 	virtual ~cPluginManager();
@@ -453,6 +493,9 @@ private:
 	Accessible only from within PluginManager.cpp */
 	template <typename HookFunction>
 	bool GenericCallHook(PluginHook a_HookName, HookFunction a_HookFunction);
+
+	/** Adds a single hook call of the specified duration into m_HookStats. */
+	void RecordHookCall(const cPlugin & a_Plugin, PluginHook a_HookName, std::chrono::nanoseconds a_Duration);
 } ;  // tolua_export
 
 
@@ -5,6 +5,7 @@
 
 #include "Globals.h"
 #include "HopperEntity.h"
+#include "../BoundingBox.h"
 #include "../Chunk.h"
 #include "../Entities/Player.h"
 #include "../Entities/Pickup.h"
@@ -278,8 +279,10 @@ bool cHopperEntity::MovePickupsIn(cChunk & a_Chunk, Int64 a_CurrentTick)
 		cItemGrid & m_Contents;
 	};
 
+	// Only pickups within half a block of the center of the block above the hopper are sucked in:
 	cHopperPickupSearchCallback HopperPickupSearchCallback(Vector3i(GetPosX(), GetPosY(), GetPosZ()), m_Contents);
-	a_Chunk.ForEachEntity(HopperPickupSearchCallback);
+	const Vector3d SearchCenter(GetPosX() + 0.5, GetPosY() + 1, GetPosZ() + 0.5);
+	a_Chunk.ForEachEntityInBox(cBoundingBox(SearchCenter, 1), HopperPickupSearchCallback);
 
 	return HopperPickupSearchCallback.FoundPickupsAbove();
 }
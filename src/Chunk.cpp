@@ -37,7 +37,6 @@
 #include "Bindings/PluginManager.h"
 #include "Blocks/BlockHandler.h"
 #include "Simulator/FluidSimulator.h"
-#include "MobCensus.h"
 #include "MobSpawner.h"
 #include "BlockInServerPluginInterface.h"
 #include "SetChunkData.h"
@@ -65,6 +64,8 @@ cChunk::cChunk(
 	m_IsDirty(false),
 	m_IsSaving(false),
 	m_HasLoadFailed(false),
+	m_IsInMobCensus(false),
+	m_EntityGrid(a_ChunkX, a_ChunkZ),
 	m_StayCount(0),
 	m_PosX(a_ChunkX),
 	m_PosZ(a_ChunkZ),
@@ -110,7 +111,11 @@ cChunk::~cChunk()
 
 	m_BlockEntities.clear();
 
+	// The chunk's mobs are no longer to be counted:
+	SetInMobCensus(false);
+
 	// Remove and destroy all entities that are not players:
+	m_EntityGrid.Clear();
 	cEntityList Entities;
 	std::swap(Entities, m_Entities);  // Need another list because cEntity destructors check if they've been removed from chunk
 	for (auto & Entity : Entities)
@@ -157,6 +162,7 @@ void cChunk::SetPresence(cChunk::ePresence a_Presence)
 	{
 		m_World->GetChunkMap()->ChunkValidated();
 	}
+	UpdateMobCensus();
 }
 
 
@@ -202,6 +208,70 @@ bool cChunk::HasPlayerEntities()
 
 
 
+void cChunk::UpdateMobCensus(void)
+{
+	// We do count every Mobs in the world. But we are assuming that every chunk not loaded by any client
+	// doesn't affect us. Normally they should not have mobs because every "too far" mobs despawn
+	// If they have (f.i. when player disconnect) we assume we don't have to make them live or despawn
+	SetInMobCensus(IsValid() && HasAnyClients());
+}
+
+
+
+
+
+void cChunk::SetInMobCensus(bool a_ShouldBeInCensus)
+{
+	if (m_IsInMobCensus == a_ShouldBeInCensus)
+	{
+		return;
+	}
+
+	auto & Census = m_World->GetMobCensus();
+	if (a_ShouldBeInCensus)
+	{
+		Census.AddSpawnableChunk();
+	}
+	else
+	{
+		Census.RemoveSpawnableChunk();
+	}
+
+	// Set the flag first when adding and last when removing, so that UpdateMobCensusEntity() accepts the mobs:
+	m_IsInMobCensus = true;
+	for (const auto & Entity : m_Entities)
+	{
+		UpdateMobCensusEntity(*Entity, a_ShouldBeInCensus);
+	}
+	m_IsInMobCensus = a_ShouldBeInCensus;
+}
+
+
+
+
+
+void cChunk::UpdateMobCensusEntity(const cEntity & a_Entity, bool a_IsAdded)
+{
+	if (!m_IsInMobCensus || !a_Entity.IsMob())
+	{
+		return;
+	}
+
+	auto Family = static_cast<const cMonster &>(a_Entity).GetMobFamily();
+	if (a_IsAdded)
+	{
+		m_World->GetMobCensus().AddMob(Family);
+	}
+	else
+	{
+		m_World->GetMobCensus().RemoveMob(Family);
+	}
+}
+
+
+
+
+
 bool cChunk::CanUnload(void)
 {
 	return
@@ -500,37 +570,6 @@ void cChunk::Stay(bool a_Stay)
 
 
 
-void cChunk::CollectMobCensus(cMobCensus & toFill)
-{
-	toFill.CollectSpawnableChunk(*this);
-	std::vector<Vector3d> PlayerPositions;
-	PlayerPositions.reserve(m_LoadedByClient.size());
-	for (auto ClientHandle : m_LoadedByClient)
-	{
-		const cPlayer * currentPlayer = ClientHandle->GetPlayer();
-		PlayerPositions.push_back(currentPlayer->GetPosition());
-	}
-
-	Vector3d currentPosition;
-	for (auto & entity : m_Entities)
-	{
-		// LOGD("Counting entity #%i (%s)", (*itr)->GetUniqueID(), (*itr)->GetClass());
-		if (entity->IsMob())
-		{
-			auto & Monster = static_cast<cMonster &>(*entity);
-			currentPosition = Monster.GetPosition();
-			for (const auto & PlayerPos : PlayerPositions)
-			{
-				toFill.CollectMob(Monster, *this, (currentPosition - PlayerPos).SqrLength());
-			}
-		}
-	}  // for itr - m_Entitites[]
-}
-
-
-
-
-
 void cChunk::GetThreeRandomNumbers(int & a_X, int & a_Y, int & a_Z, int a_MaxX, int a_MaxY, int a_MaxZ)
 {
 	ASSERT(
@@ -704,6 +743,8 @@ void cChunk::Tick(std::chrono::milliseconds a_Dt)
 
 			// This block is very similar to RemoveEntity, except it uses an iterator to avoid scanning the whole m_Entities
 			// The entity moved out of the chunk, move it to the neighbor
+			UpdateMobCensusEntity(**itr, false);
+			m_EntityGrid.Remove(**itr);
 			(*itr)->SetParentChunk(nullptr);
 			MoveEntityToNewChunk(std::move(*itr));
 
@@ -1628,29 +1669,28 @@ void cChunk::CollectPickupsByPlayer(cPlayer & a_Player)
 	auto BoundingBox = a_Player.GetBoundingBox();
 	BoundingBox.Expand(1, 0.5, 1);
 
-	for (auto & Entity : m_Entities)
-	{
-		if ((!Entity->IsPickup()) && (!Entity->IsProjectile()))
+	// Gather the candidates from the nearby grid cells first, collecting calls plugin hooks that may move entities around:
+	std::vector<cEntity *> Collectables;
+	m_EntityGrid.ForEachEntityInBox(BoundingBox, [&](cEntity & a_Entity)
 		{
-			continue;  // Only pickups and projectiles can be picked up
+			if ((a_Entity.IsPickup() || a_Entity.IsProjectile()) && BoundingBox.IsInside(a_Entity.GetPosition()))
+			{
+				Collectables.push_back(&a_Entity);
+			}
+			return false;
 		}
+	);
 
-		if (BoundingBox.IsInside(Entity->GetPosition()))
+	for (auto Entity : Collectables)
+	{
+		MarkDirty();
+		if (Entity->IsPickup())
 		{
-			/*
-			LOG("Pickup %d being collected by player \"%s\", distance %f",
-				(*itr)->GetUniqueID(), a_Player->GetName().c_str(), SqrDist
-			);
-			*/
-			MarkDirty();
-			if (Entity->IsPickup())
-			{
-				static_cast<cPickup &>(*Entity).CollectedBy(a_Player);
-			}
-			else
-			{
-				static_cast<cProjectileEntity &>(*Entity).CollectedBy(a_Player);
-			}
+			static_cast<cPickup &>(*Entity).CollectedBy(a_Player);
+		}
+		else
+		{
+			static_cast<cProjectileEntity &>(*Entity).CollectedBy(a_Player);
 		}
 	}
 }
@@ -1707,6 +1747,7 @@ bool cChunk::AddClient(cClientHandle * a_Client)
 	}
 
 	m_LoadedByClient.push_back(a_Client);
+	UpdateMobCensus();
 	return true;
 }
 
@@ -1721,6 +1762,7 @@ void cChunk::RemoveClient(cClientHandle * a_Client)
 	ASSERT(std::distance(itr, m_LoadedByClient.end()) <= 1);
 	// Note: itr can equal m_LoadedByClient.end()
 	m_LoadedByClient.erase(itr, m_LoadedByClient.end());
+	UpdateMobCensus();
 
 	if (!a_Client->IsDestroyed())
 	{
@@ -1774,6 +1816,8 @@ void cChunk::AddEntity(OwnedEntity a_Entity)
 
 	ASSERT(EntityPtr->GetParentChunk() == nullptr);
 	EntityPtr->SetParentChunk(this);
+	m_EntityGrid.Add(*EntityPtr);
+	UpdateMobCensusEntity(*EntityPtr, true);
 }
 
 
@@ -1785,6 +1829,8 @@ OwnedEntity cChunk::RemoveEntity(cEntity & a_Entity)
 	ASSERT(a_Entity.GetParentChunk() == this);
 	ASSERT(!a_Entity.IsTicking());
 	a_Entity.SetParentChunk(nullptr);
+	m_EntityGrid.Remove(a_Entity);
+	UpdateMobCensusEntity(a_Entity, false);
 
 	// Mark as dirty if it was a server-generated entity:
 	if (!a_Entity.IsPlayer())
@@ -1854,24 +1900,44 @@ bool cChunk::ForEachEntity(cEntityCallback a_Callback)
 
 bool cChunk::ForEachEntityInBox(const cBoundingBox & a_Box, cEntityCallback a_Callback)
 {
-	// The entity list is locked by the parent chunkmap's CS
-	for (const auto & Entity : m_Entities)
-	{
-		if (!Entity->IsTicking())
+	// The entity grid is locked by the parent chunkmap's CS
+	return m_EntityGrid.ForEachEntityInBox(a_Box, [&](cEntity & a_Entity)
 		{
-			continue;
+			return (a_Entity.IsTicking() && a_Callback(a_Entity));
 		}
-		if (!Entity->GetBoundingBox().DoesIntersect(a_Box))
-		{
-			// The entity is not in the specified box
-			continue;
-		}
-		if (a_Callback(*Entity))
-		{
-			return false;
-		}
-	}  // for itr - m_Entitites[]
-	return true;
+	);
+}
+
+
+
+
+
+void cChunk::EntityMoved(cEntity & a_Entity, Vector3d a_OldPosition)
+{
+	// Entities may be moved from outside the chunkmap's CS (e.g. players ticked by their client handle), lock it here.
+	// The entity read its parent chunk without the lock, so it may have been moved to another chunk in the meantime;
+	// that chunk has added the entity to its own grid already:
+	cCSLock Lock(m_ChunkMap->GetCS());
+	if (a_Entity.GetParentChunk() != this)
+	{
+		return;
+	}
+	m_EntityGrid.Move(a_Entity, a_OldPosition);
+}
+
+
+
+
+
+void cChunk::EntityResized(cEntity & a_Entity)
+{
+	cCSLock Lock(m_ChunkMap->GetCS());
+	if (a_Entity.GetParentChunk() != this)
+	{
+		// Moved to another chunk since reading its parent chunk, see EntityMoved()
+		return;
+	}
+	m_EntityGrid.Resized(a_Entity);
 }
 
 
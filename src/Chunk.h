@@ -4,6 +4,7 @@
 #include "BlockEntities/BlockEntity.h"
 #include "Entities/Entity.h"
 #include "ChunkData.h"
+#include "EntityGrid.h"
 
 #include "Simulator/FireSimulator.h"
 #include "Simulator/SandSimulator.h"
@@ -35,7 +36,6 @@ class cFlowerPotEntity;
 class cBlockArea;
 class cBlockArea;
 class cFluidSimulatorData;
-class cMobCensus;
 class cMobSpawner;
 class cSetChunkData;
 
@@ -138,9 +138,6 @@ public:
 	before the chunk is unloadable again. */
 	void Stay(bool a_Stay = true);
 
-	/** Recence all mobs proximities to players in order to know what to do with them */
-	void CollectMobCensus(cMobCensus & toFill);
-
 	/** Try to Spawn Monsters inside chunk */
 	void SpawnMobs(cMobSpawner & a_MobSpawner);
 
@@ -272,6 +269,12 @@ public:
 	Returns true if all entities processed, false if the callback aborted by returning true. */
 	bool ForEachEntityInBox(const cBoundingBox & a_Box, cEntityCallback a_Callback);  // Lua-accessible
 
+	/** Called by an entity of this chunk after its position has changed so that it may now belong to a different cell of the entity grid. */
+	void EntityMoved(cEntity & a_Entity, Vector3d a_OldPosition);
+
+	/** Called by an entity of this chunk after its width or height has changed. */
+	void EntityResized(cEntity & a_Entity);
+
 	/** Calls the callback if the entity with the specified ID is found, with the entity object as the callback param. Returns true if entity found. */
 	bool DoWithEntityByID(UInt32 a_EntityID, cEntityCallback a_Callback, bool & a_CallbackResult);  // Lua-accessible
 
@@ -609,6 +612,9 @@ private:
 	bool m_IsSaving;       // True if the chunk is being saved
 	bool m_HasLoadFailed;  // True if chunk failed to load and hasn't been generated yet since then
 
+	/** True if the chunk's mobs are currently counted in the world's mob census (the chunk is valid and has clients) */
+	bool m_IsInMobCensus;
+
 	std::vector<Vector3i> m_ToTickBlocks;
 	sSetBlockVector       m_PendingSendBlocks;  ///< Blocks that have changed and need to be sent to all clients
 
@@ -617,6 +623,9 @@ private:
 	std::vector<OwnedEntity> m_Entities;
 	cBlockEntities               m_BlockEntities;
 
+	/** Spatial index of m_Entities, used for the proximity queries such as ForEachEntityInBox(). */
+	cEntityGrid m_EntityGrid;
+
 	/** Number of times the chunk has been requested to stay (by various cChunkStay objects); if zero, the chunk can be unloaded */
 	int m_StayCount;
 
@@ -694,6 +703,17 @@ private:
 
 	/** Check m_Entities for cPlayer objects. */
 	bool HasPlayerEntities();
+
+	/** Adds or removes this chunk and all its mobs to / from the world's mob census,
+	if the chunk's eligibility for spawning (valid and loaded by a client) has changed since the last call. */
+	void UpdateMobCensus(void);
+
+	/** Adds (a_ShouldBeInCensus == true) or removes this chunk and all its mobs to / from the world's mob census.
+	Does nothing if the chunk already is in the requested state. */
+	void SetInMobCensus(bool a_ShouldBeInCensus);
+
+	/** If a_Entity is a mob and this chunk is counted in the mob census, adds (a_IsAdded == true) or removes the mob to / from the census. */
+	void UpdateMobCensusEntity(const cEntity & a_Entity, bool a_IsAdded);
 };
 
 typedef cChunk * cChunkPtr;
@@ -37,6 +37,19 @@ namespace
 		int Index = 0;    // Index into a single sChunkSection
 	};
 
+	/** Copies the block data of a_Src into a_Dest, leaving a_Dest's reference count untouched. */
+	void CopySectionData(cChunkData::sChunkSection & a_Dest, const cChunkData::sChunkSection & a_Src)
+	{
+		memcpy(a_Dest.m_BlockTypes,    a_Src.m_BlockTypes,    sizeof(a_Dest.m_BlockTypes));
+		memcpy(a_Dest.m_BlockMetas,    a_Src.m_BlockMetas,    sizeof(a_Dest.m_BlockMetas));
+		memcpy(a_Dest.m_BlockLight,    a_Src.m_BlockLight,    sizeof(a_Dest.m_BlockLight));
+		memcpy(a_Dest.m_BlockSkyLight, a_Src.m_BlockSkyLight, sizeof(a_Dest.m_BlockSkyLight));
+	}
+
+
+
+
+
 	sSectionIndices IndicesFromRelPos(Vector3i a_RelPos)
 	{
 		ASSERT(cChunkDef::IsValidRelPos(a_RelPos));
@@ -93,12 +106,26 @@ void cChunkData::Assign(const cChunkData & a_Other)
 	}
 
 	Clear();
+
+	// Sections can only be shared if either pool can free them:
+	bool CanShare = (m_Pool == a_Other.m_Pool);
 	for (size_t i = 0; i < NumSections; ++i)
 	{
-		if (a_Other.m_Sections[i] != nullptr)
+		auto Section = a_Other.m_Sections[i];
+		if (Section == nullptr)
+		{
+			continue;
+		}
+		if (CanShare)
+		{
+			// The other instance holds a reference for the whole call, so a relaxed increment is enough:
+			Section->m_RefCount.fetch_add(1, std::memory_order_relaxed);
+			m_Sections[i] = Section;
+		}
+		else
 		{
 			m_Sections[i] = Allocate();
-			*m_Sections[i] = *a_Other.m_Sections[i];
+			CopySectionData(*m_Sections[i], *Section);
 		}
 	}
 }
@@ -178,7 +205,7 @@ void cChunkData::SetBlock(Vector3i a_RelPos, BLOCKTYPE a_Block)
 		}
 		ZeroSection(m_Sections[Idxs.Section]);
 	}
-	m_Sections[Idxs.Section]->m_BlockTypes[Idxs.Index] = a_Block;
+	Unshare(static_cast<size_t>(Idxs.Section))->m_BlockTypes[Idxs.Index] = a_Block;
 }
 
 
@@ -230,9 +257,10 @@ bool cChunkData::SetMeta(Vector3i a_RelPos, NIBBLETYPE a_Nibble)
 		}
 		ZeroSection(m_Sections[Idxs.Section]);
 	}
-	NIBBLETYPE oldval = m_Sections[Idxs.Section]->m_BlockMetas[Idxs.Index / 2] >> ((Idxs.Index & 1) * 4) & 0xf;
-	m_Sections[Idxs.Section]->m_BlockMetas[Idxs.Index / 2] = static_cast<NIBBLETYPE>(
-		(m_Sections[Idxs.Section]->m_BlockMetas[Idxs.Index / 2] & (0xf0 >> ((Idxs.Index & 1) * 4))) |  // The untouched nibble
+	auto Section = Unshare(static_cast<size_t>(Idxs.Section));
+	NIBBLETYPE oldval = Section->m_BlockMetas[Idxs.Index / 2] >> ((Idxs.Index & 1) * 4) & 0xf;
+	Section->m_BlockMetas[Idxs.Index / 2] = static_cast<NIBBLETYPE>(
+		(Section->m_BlockMetas[Idxs.Index / 2] & (0xf0 >> ((Idxs.Index & 1) * 4))) |  // The untouched nibble
 		((a_Nibble & 0x0f) << ((Idxs.Index & 1) * 4))  // The nibble being set
 	);
 	return oldval != a_Nibble;
@@ -438,10 +466,11 @@ void cChunkData::FillBlockTypes(BLOCKTYPE a_Value)
 		}
 	}
 
-	for (auto Section : m_Sections)
+	for (size_t i = 0; i < NumSections; i++)
 	{
-		if (Section != nullptr)
+		if (m_Sections[i] != nullptr)
 		{
+			auto Section = Unshare(i);
 			std::fill(std::begin(Section->m_BlockTypes), std::end(Section->m_BlockTypes), a_Value);
 		}
 	}
@@ -469,10 +498,11 @@ void cChunkData::FillMetas(NIBBLETYPE a_Value)
 	}
 
 	NIBBLETYPE NewMeta = static_cast<NIBBLETYPE>((a_Value << 4) | a_Value);
-	for (auto Section : m_Sections)
+	for (size_t i = 0; i < NumSections; i++)
 	{
-		if (Section != nullptr)
+		if (m_Sections[i] != nullptr)
 		{
+			auto Section = Unshare(i);
 			std::fill(std::begin(Section->m_BlockMetas), std::end(Section->m_BlockMetas), NewMeta);
 		}
 	}
@@ -500,10 +530,11 @@ void cChunkData::FillBlockLight(NIBBLETYPE a_Value)
 	}
 
 	NIBBLETYPE NewLight = static_cast<NIBBLETYPE>((a_Value << 4) | a_Value);
-	for (auto Section : m_Sections)
+	for (size_t i = 0; i < NumSections; i++)
 	{
-		if (Section != nullptr)
+		if (m_Sections[i] != nullptr)
 		{
+			auto Section = Unshare(i);
 			std::fill(std::begin(Section->m_BlockLight), std::end(Section->m_BlockLight), NewLight);
 		}
 	}
@@ -531,10 +562,11 @@ void cChunkData::FillSkyLight(NIBBLETYPE a_Value)
 	}
 
 	NIBBLETYPE NewSkyLight = static_cast<NIBBLETYPE>((a_Value << 4) | a_Value);
-	for (auto Section : m_Sections)
+	for (size_t i = 0; i < NumSections; i++)
 	{
-		if (Section != nullptr)
+		if (m_Sections[i] != nullptr)
 		{
+			auto Section = Unshare(i);
 			std::fill(std::begin(Section->m_BlockSkyLight), std::end(Section->m_BlockSkyLight), NewSkyLight);
 		}
 	}
@@ -553,7 +585,7 @@ void cChunkData::SetBlockTypes(const BLOCKTYPE * a_Src)
 		// If the section is already allocated, copy the data into it:
 		if (m_Sections[i] != nullptr)
 		{
-			memcpy(m_Sections[i]->m_BlockTypes, &a_Src[i * SectionBlockCount], sizeof(m_Sections[i]->m_BlockTypes));
+			memcpy(Unshare(i)->m_BlockTypes, &a_Src[i * SectionBlockCount], sizeof(m_Sections[i]->m_BlockTypes));
 			continue;
 		}
 
@@ -586,7 +618,7 @@ void cChunkData::SetMetas(const NIBBLETYPE * a_Src)
 		// If the section is already allocated, copy the data into it:
 		if (m_Sections[i] != nullptr)
 		{
-			memcpy(m_Sections[i]->m_BlockMetas, &a_Src[i * SectionBlockCount / 2], sizeof(m_Sections[i]->m_BlockMetas));
+			memcpy(Unshare(i)->m_BlockMetas, &a_Src[i * SectionBlockCount / 2], sizeof(m_Sections[i]->m_BlockMetas));
 			continue;
 		}
 
@@ -622,7 +654,7 @@ void cChunkData::SetBlockLight(const NIBBLETYPE * a_Src)
 		// If the section is already allocated, copy the data into it:
 		if (m_Sections[i] != nullptr)
 		{
-			memcpy(m_Sections[i]->m_BlockLight, &a_Src[i * SectionBlockCount / 2], sizeof(m_Sections[i]->m_BlockLight));
+			memcpy(Unshare(i)->m_BlockLight, &a_Src[i * SectionBlockCount / 2], sizeof(m_Sections[i]->m_BlockLight));
 			continue;
 		}
 
@@ -658,7 +690,7 @@ void cChunkData::SetSkyLight(const NIBBLETYPE * a_Src)
 		// If the section is already allocated, copy the data into it:
 		if (m_Sections[i] != nullptr)
 		{
-			memcpy(m_Sections[i]->m_BlockSkyLight, &a_Src[i * SectionBlockCount / 2], sizeof(m_Sections[i]->m_BlockSkyLight));
+			memcpy(Unshare(i)->m_BlockSkyLight, &a_Src[i * SectionBlockCount / 2], sizeof(m_Sections[i]->m_BlockSkyLight));
 			continue;
 		}
 
@@ -701,7 +733,12 @@ UInt32 cChunkData::NumPresentSections() const
 
 cChunkData::sChunkSection * cChunkData::Allocate(void)
 {
-	return m_Pool.Allocate();
+	auto Section = m_Pool.Allocate();
+	if (Section != nullptr)
+	{
+		Section->m_RefCount.store(1, std::memory_order_relaxed);
+	}
+	return Section;
 }
 
 
@@ -710,7 +747,38 @@ cChunkData::sChunkSection * cChunkData::Allocate(void)
 
 void cChunkData::Free(cChunkData::sChunkSection * a_Section)
 {
-	m_Pool.Free(a_Section);
+	if (a_Section == nullptr)
+	{
+		return;
+	}
+
+	// The release makes this instance's reads happen before the last owner's free or in-place writes:
+	if (a_Section->m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		m_Pool.Free(a_Section);
+	}
+}
+
+
+
+
+
+cChunkData::sChunkSection * cChunkData::Unshare(size_t a_SectionNum)
+{
+	auto Section = m_Sections[a_SectionNum];
+	ASSERT(Section != nullptr);
+
+	// Once the count drops to 1, no other instance can add a reference, because that requires reading this instance:
+	if (Section->m_RefCount.load(std::memory_order_acquire) == 1)
+	{
+		return Section;
+	}
+
+	auto Copy = Allocate();
+	CopySectionData(*Copy, *Section);
+	Free(Section);
+	m_Sections[a_SectionNum] = Copy;
+	return Copy;
 }
 
 
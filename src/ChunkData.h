@@ -30,6 +30,9 @@ public:
 		NIBBLETYPE m_BlockMetas[SectionBlockCount / 2];
 		NIBBLETYPE m_BlockLight[SectionBlockCount / 2];
 		NIBBLETYPE m_BlockSkyLight[SectionBlockCount / 2];
+
+		/** Number of cChunkData instances sharing this section. Managed by cChunkData; a shared section is never written to. */
+		std::atomic<UInt32> m_RefCount;
 	};
 
 	cChunkData(cAllocationPool<sChunkSection> & a_Pool);
@@ -42,7 +45,11 @@ public:
 		return *this;
 	}
 
-	/** Copy assign from another cChunkData */
+	/** Copy assign from another cChunkData.
+	If the pools are compatible, the sections are shared rather than copied, and each instance makes its own copy
+	of a shared section only once it writes into it. This makes taking a snapshot of a chunk cheap enough to be done
+	while the chunkmap is locked, with the snapshot then read by another thread after the lock is released.
+	The sharing itself is thread-safe, but a single instance still mustn't be accessed from multiple threads at once. */
 	void Assign(const cChunkData & a_Other);
 
 	/** Move assign from another cChunkData */
@@ -124,10 +131,16 @@ private:
 	/** Allocates a new section. Entry-point to custom allocators. */
 	sChunkSection * Allocate(void);
 
-	/** Frees the specified section, previously allocated using Allocate().
+	/** Releases this instance's reference to the specified section, previously allocated using Allocate() or shared by Assign().
+	The section is returned to the pool once no instance references it anymore.
 	Note that a_Section may be nullptr. */
 	void Free(sChunkSection * a_Section);
 
+	/** Returns the specified section, ready to be written into.
+	If the section is shared with another instance, it is replaced with a private copy first.
+	The section must be present. */
+	sChunkSection * Unshare(size_t a_SectionNum);
+
 	/** Sets the data in the specified section to their default values. */
 	void ZeroSection(sChunkSection * a_Section) const;
 
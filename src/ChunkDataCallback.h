@@ -101,7 +101,9 @@ protected:
 
 
 
-/** A simple implementation of the cChunkDataCallback interface that just copies the cChunkData */
+/** A simple implementation of the cChunkDataCallback interface that just copies the cChunkData.
+The copy shares the sections with the chunk (see cChunkData::Assign()), so it is cheap to take while the chunkmap is locked,
+and the data can then be processed after the lock is released. */
 class cChunkDataCopyCollector :
 	public cChunkDataCallback
 {
@@ -2,6 +2,8 @@
 #include "ChunkGeneratorThread.h"
 #include "Generating/ChunkGenerator.h"
 #include "Generating/ChunkDesc.h"
+#include "IniFile.h"
+#include "Metrics.h"
 
 
 
@@ -17,11 +19,74 @@ const size_t QUEUE_SKIP_LIMIT = 500;
 
 
 
+/** A thread that generates the chunks from the queue of its cChunkGeneratorThread, using its own generator instance. */
+class cChunkGeneratorThread::cHelperThread:
+	public cIsThread
+{
+	using Super = cIsThread;
+
+public:
+
+	cHelperThread(cChunkGeneratorThread & a_Parent, std::unique_ptr<cChunkGenerator> a_Generator):
+		Super("cChunkGeneratorThread helper"),
+		m_Parent(a_Parent),
+		m_Generator(std::move(a_Generator))
+	{
+	}
+
+protected:
+
+	cChunkGeneratorThread & m_Parent;
+
+	/** The generator used by this helper, created from the same settings as the parent's. */
+	std::unique_ptr<cChunkGenerator> m_Generator;
+
+
+	// cIsThread override:
+	virtual void Execute(void) override
+	{
+		while (!m_Parent.m_ShouldHelpersTerminate)
+		{
+			cCSLock Lock(m_Parent.m_CS);
+			if (m_Parent.m_Queue.empty())
+			{
+				cCSUnlock Unlock(Lock);
+				m_Parent.m_evtHelpers.Wait();
+				continue;
+			}
+			auto Item = m_Parent.m_Queue.front();
+			bool SkipEnabled = (m_Parent.m_Queue.size() > QUEUE_SKIP_LIMIT);
+			m_Parent.m_Queue.pop_front();
+			bool HasMoreItems = !m_Parent.m_Queue.empty();
+			Lock.Unlock();
+			m_Parent.m_evtRemoved.Set();
+
+			// The queueing may have set the event only once for several items, wake up another helper for the rest:
+			if (HasMoreItems)
+			{
+				m_Parent.m_evtHelpers.Set();
+			}
+
+			m_Parent.ProcessItem(*m_Generator, Item, SkipEnabled);
+		}
+
+		// Pass the termination on to the next helper, each Set() wakes up only one of them:
+		m_Parent.m_evtHelpers.Set();
+	}
+};
+
+
+
+
+
 cChunkGeneratorThread::cChunkGeneratorThread(void) :
 	Super("cChunkGeneratorThread"),
+	m_ShouldHelpersTerminate(false),
 	m_Generator(nullptr),
 	m_PluginInterface(nullptr),
-	m_ChunkSink(nullptr)
+	m_ChunkSink(nullptr),
+	m_ChunksGeneratedMetric(nullptr),
+	m_GeneratingMicrosecondsMetric(nullptr)
 {
 }
 
@@ -38,10 +103,18 @@ cChunkGeneratorThread::~cChunkGeneratorThread()
 
 
 
-bool cChunkGeneratorThread::Initialize(cPluginInterface & a_PluginInterface, cChunkSink & a_ChunkSink, cIniFile & a_IniFile)
+bool cChunkGeneratorThread::Initialize(cPluginInterface & a_PluginInterface, cChunkSink & a_ChunkSink, cIniFile & a_IniFile, const AString & a_WorldName)
 {
 	m_PluginInterface = &a_PluginInterface;
 	m_ChunkSink = &a_ChunkSink;
+	m_ChunksGeneratedMetric = &cMetrics::Get().GetCounter(
+		"cuberite_chunks_generated_total", "Number of chunks generated.",
+		cMetrics::Label("world", a_WorldName)
+	);
+	m_GeneratingMicrosecondsMetric = &cMetrics::Get().GetCounter(
+		"cuberite_chunk_generating_microseconds_total", "Time the generator threads spent generating the chunks, including the plugin hooks, in microseconds.",
+		cMetrics::Label("world", a_WorldName)
+	);
 
 	m_Generator = cChunkGenerator::CreateFromIniFile(a_IniFile);
 	if (m_Generator == nullptr)
@@ -49,6 +122,9 @@ bool cChunkGeneratorThread::Initialize(cPluginInterface & a_PluginInterface, cCh
 		LOGERROR("Generator could not start, aborting the server");
 		return false;
 	}
+
+	// Creating the generator has filled in the defaults, so the helpers' generators will use exactly the same settings:
+	m_GeneratorSettings = cpp14::make_unique<cIniFile>(a_IniFile);
 	return true;
 }
 
@@ -58,6 +134,7 @@ bool cChunkGeneratorThread::Initialize(cPluginInterface & a_PluginInterface, cCh
 
 void cChunkGeneratorThread::Stop(void)
 {
+	StopHelpers();
 	m_ShouldTerminate = true;
 	m_Event.Set();
 	m_evtRemoved.Set();  // Wake up anybody waiting for empty queue
@@ -69,6 +146,49 @@ void cChunkGeneratorThread::Stop(void)
 
 
 
+void cChunkGeneratorThread::StartHelpers(unsigned a_NumHelpers)
+{
+	ASSERT(m_Helpers.empty());
+	ASSERT(m_GeneratorSettings != nullptr);
+
+	m_ShouldHelpersTerminate = false;
+	for (unsigned i = 0; i < a_NumHelpers; i++)
+	{
+		// CreateFromIniFile() may write to the settings, give it a copy:
+		cIniFile Settings(*m_GeneratorSettings);
+		auto Generator = cChunkGenerator::CreateFromIniFile(Settings);
+		if (Generator == nullptr)
+		{
+			break;
+		}
+		m_Helpers.push_back(cpp14::make_unique<cHelperThread>(*this, std::move(Generator)));
+		m_Helpers.back()->Start();
+	}
+}
+
+
+
+
+
+void cChunkGeneratorThread::StopHelpers(void)
+{
+	if (m_Helpers.empty())
+	{
+		return;
+	}
+	m_ShouldHelpersTerminate = true;
+	m_evtHelpers.Set();
+	for (auto & Helper: m_Helpers)
+	{
+		Helper->Stop();
+	}
+	m_Helpers.clear();
+}
+
+
+
+
+
 void cChunkGeneratorThread::QueueGenerateChunk(
 	cChunkCoords a_Coords,
 	bool a_ForceRegeneration,
@@ -89,6 +209,7 @@ void cChunkGeneratorThread::QueueGenerateChunk(
 	}
 
 	m_Event.Set();
+	m_evtHelpers.Set();
 }
 
 
@@ -140,6 +261,24 @@ int cChunkGeneratorThread::GetSeed() const
 
 
 
+UInt64 cChunkGeneratorThread::GetNumChunksGenerated(void) const
+{
+	return (m_ChunksGeneratedMetric == nullptr) ? 0 : m_ChunksGeneratedMetric->GetValue();
+}
+
+
+
+
+
+UInt64 cChunkGeneratorThread::GetGeneratingMicroseconds(void) const
+{
+	return (m_GeneratingMicrosecondsMetric == nullptr) ? 0 : m_GeneratingMicrosecondsMetric->GetValue();
+}
+
+
+
+
+
 EMCSBiome cChunkGeneratorThread::GetBiomeAt(int a_BlockX, int a_BlockZ)
 {
 	ASSERT(m_Generator != nullptr);
@@ -204,50 +343,63 @@ void cChunkGeneratorThread::Execute(void)
 			LastReportTick = clock();
 		}
 
-		// Skip the chunk if it's already generated and regeneration is not forced. Report as success:
-		if (!item.m_ForceRegeneration && m_ChunkSink->IsChunkValid(item.m_Coords))
+		if (ProcessItem(*m_Generator, item, SkipEnabled))
 		{
-			LOGD("Chunk %s already generated, skipping generation", item.m_Coords.ToString().c_str());
-			if (item.m_Callback != nullptr)
-			{
-				item.m_Callback->Call(item.m_Coords, true);
-			}
-			continue;
+			NumChunksGenerated++;
 		}
+	}  // while (!bStop)
+}
+
+
+
+
 
-		// Skip the chunk if the generator is overloaded:
-		if (SkipEnabled && !m_ChunkSink->HasChunkAnyClients(item.m_Coords))
+bool cChunkGeneratorThread::ProcessItem(cChunkGenerator & a_Generator, const QueueItem & a_Item, bool a_SkipEnabled)
+{
+	// Skip the chunk if it's already generated and regeneration is not forced. Report as success:
+	if (!a_Item.m_ForceRegeneration && m_ChunkSink->IsChunkValid(a_Item.m_Coords))
+	{
+		LOGD("Chunk %s already generated, skipping generation", a_Item.m_Coords.ToString().c_str());
+		if (a_Item.m_Callback != nullptr)
 		{
-			LOGWARNING("Chunk generator overloaded, skipping chunk %s", item.m_Coords.ToString().c_str());
-			if (item.m_Callback != nullptr)
-			{
-				item.m_Callback->Call(item.m_Coords, false);
-			}
-			continue;
+			a_Item.m_Callback->Call(a_Item.m_Coords, true);
 		}
+		return false;
+	}
 
-		// Generate the chunk:
-		DoGenerate(item.m_Coords);
-		if (item.m_Callback != nullptr)
+	// Skip the chunk if the generator is overloaded:
+	if (a_SkipEnabled && !m_ChunkSink->HasChunkAnyClients(a_Item.m_Coords))
+	{
+		LOGWARNING("Chunk generator overloaded, skipping chunk %s", a_Item.m_Coords.ToString().c_str());
+		if (a_Item.m_Callback != nullptr)
 		{
-			item.m_Callback->Call(item.m_Coords, true);
+			a_Item.m_Callback->Call(a_Item.m_Coords, false);
 		}
-		NumChunksGenerated++;
-	}  // while (!bStop)
+		return false;
+	}
+
+	// Generate the chunk:
+	DoGenerate(a_Generator, a_Item.m_Coords);
+	if (a_Item.m_Callback != nullptr)
+	{
+		a_Item.m_Callback->Call(a_Item.m_Coords, true);
+	}
+	return true;
 }
 
 
 
 
 
-void cChunkGeneratorThread::DoGenerate(cChunkCoords a_Coords)
+void cChunkGeneratorThread::DoGenerate(cChunkGenerator & a_Generator, cChunkCoords a_Coords)
 {
 	ASSERT(m_PluginInterface != nullptr);
 	ASSERT(m_ChunkSink != nullptr);
 
+	auto StartTime = std::chrono::steady_clock::now();
 	cChunkDesc ChunkDesc(a_Coords);
 	m_PluginInterface->CallHookChunkGenerating(ChunkDesc);
-	m_Generator->Generate(ChunkDesc);
+	a_Generator.Generate(ChunkDesc);
 	m_PluginInterface->CallHookChunkGenerated(ChunkDesc);
 
 	#ifdef _DEBUG
@@ -255,6 +407,9 @@ void cChunkGeneratorThread::DoGenerate(cChunkCoords a_Coords)
 		ChunkDesc.VerifyHeightmap();
 	#endif
 
+	m_ChunksGeneratedMetric->Add();
+	m_GeneratingMicrosecondsMetric->Add(static_cast<UInt64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count()));
+
 	m_ChunkSink->OnChunkGenerated(ChunkDesc);
 }
 
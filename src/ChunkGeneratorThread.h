@@ -10,6 +10,7 @@
 class cIniFile;
 class cChunkDesc;
 class cChunkGenerator;
+class cMetricCounter;
 
 
 
@@ -20,6 +21,8 @@ The requests are not added to the queue if there is already a request with the s
 Before generating, the thread checks if the chunk hasn't been already generated.
 It is theoretically possible to have multiple generator threads by having multiple instances of this object,
 but then it MAY happen that the chunk is generated twice.
+To use more cores for a single world, StartHelpers() adds threads that take the chunks from the same queue,
+each generating with its own generator instance, so that a chunk is still generated only once.
 If the generator queue is overloaded, the generator skips chunks with no clients in them. */
 class cChunkGeneratorThread :
 	public cIsThread
@@ -76,11 +79,21 @@ public:
 	cChunkGeneratorThread (void);
 	virtual ~cChunkGeneratorThread() override;
 
-	/** Read settings from the ini file and initialize in preperation for being started. */
-	bool Initialize(cPluginInterface & a_PluginInterface, cChunkSink & a_ChunkSink, cIniFile & a_IniFile);
+	/** Read settings from the ini file and initialize in preperation for being started.
+	a_WorldName is used to label the generator's metrics. */
+	bool Initialize(cPluginInterface & a_PluginInterface, cChunkSink & a_ChunkSink, cIniFile & a_IniFile, const AString & a_WorldName);
 
 	void Stop(void);
 
+	/** Starts a_NumHelpers additional threads that generate the chunks from the same queue in parallel with this thread.
+	Each helper creates its own generator from the same settings as this thread's generator, so they all generate the same chunks.
+	The generators are not thread-safe and their caches are per-instance, so each helper costs another generator's worth of memory.
+	Used by the pregenerator; must not be called again before StopHelpers(). */
+	void StartHelpers(unsigned a_NumHelpers);
+
+	/** Stops all the helper threads started by StartHelpers(). Their unfinished chunks stay in the queue for this thread. */
+	void StopHelpers(void);
+
 	/** Queues the chunk for generation
 	If a-ForceGenerate is set, the chunk is regenerated even if the data is already present in the chunksink.
 	a_Callback is called after the chunk is generated. If the chunk was already present, the callback is still called, even if not regenerating.
@@ -97,12 +110,20 @@ public:
 
 	int GetSeed() const;
 
+	/** Returns the number of chunks generated by this thread so far. */
+	UInt64 GetNumChunksGenerated(void) const;
+
+	/** Returns the total time this thread has spent generating the chunks so far, including the plugin hooks, in microseconds. */
+	UInt64 GetGeneratingMicroseconds(void) const;
+
 	/** Returns the biome at the specified coords. Used by ChunkMap if an invalid chunk is queried for biome */
 	EMCSBiome GetBiomeAt(int a_BlockX, int a_BlockZ);
 
 
 private:
 
+	class cHelperThread;
+
 	struct QueueItem
 	{
 		/** The chunk coords */
@@ -137,21 +158,45 @@ private:
 	/** Set when an item is removed from the queue. */
 	cEvent m_evtRemoved;
 
+	/** Set when an item is added to the queue, while more items remain after a helper takes one, or when the helpers should terminate.
+	Separate from m_Event, so that this thread can't swallow the wakeups meant for the helpers. */
+	cEvent m_evtHelpers;
+
+	/** Set by StopHelpers() to tell the helper threads to terminate. */
+	std::atomic<bool> m_ShouldHelpersTerminate;
+
 	/** The actual chunk generator engine used. */
 	std::unique_ptr<cChunkGenerator> m_Generator;
 
+	/** The generator settings, as completed with the defaults by creating m_Generator, used to create the helpers' generators. */
+	std::unique_ptr<cIniFile> m_GeneratorSettings;
+
+	/** The helper threads started by StartHelpers(). */
+	std::vector<std::unique_ptr<cHelperThread>> m_Helpers;
+
 	/** The plugin interface that may modify the generated chunks */
 	cPluginInterface * m_PluginInterface;
 
 	/** The destination where the generated chunks are sent */
 	cChunkSink * m_ChunkSink;
 
+	/** Counts the chunks generated, exported through cMetrics. Set in Initialize(). */
+	cMetricCounter * m_ChunksGeneratedMetric;
+
+	/** Counts the time spent generating the chunks, in microseconds, exported through cMetrics. Set in Initialize(). */
+	cMetricCounter * m_GeneratingMicrosecondsMetric;
+
 
 	// cIsThread override:
 	virtual void Execute(void) override;
 
-	/** Generates the specified chunk and sets it into the chunksink. */
-	void DoGenerate(cChunkCoords a_Coords);
+	/** Processes a single item taken off the queue using the specified generator: skips it if it's already generated
+	or if it has no clients while the generator is overloaded, otherwise generates it. Calls the item's callback.
+	Returns true if the chunk was generated. */
+	bool ProcessItem(cChunkGenerator & a_Generator, const QueueItem & a_Item, bool a_SkipEnabled);
+
+	/** Generates the specified chunk using the specified generator and sets it into the chunksink. */
+	void DoGenerate(cChunkGenerator & a_Generator, cChunkCoords a_Coords);
 };
 
 
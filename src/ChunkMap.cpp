@@ -13,7 +13,6 @@
 #include "Bindings/PluginManager.h"
 #include "Entities/TNTEntity.h"
 #include "Blocks/BlockHandler.h"
-#include "MobCensus.h"
 #include "MobSpawner.h"
 #include "BoundingBox.h"
 #include "SetChunkData.h"
@@ -2046,25 +2045,6 @@ void cChunkMap::SetNextBlockToTick(const Vector3i a_BlockPos)
 
 
 
-void cChunkMap::CollectMobCensus(cMobCensus & a_ToFill)
-{
-	cCSLock Lock(m_CSChunks);
-	for (const auto & Chunk : m_Chunks)
-	{
-		// We do count every Mobs in the world. But we are assuming that every chunk not loaded by any client
-		// doesn't affect us. Normally they should not have mobs because every "too far" mobs despawn
-		// If they have (f.i. when player disconnect) we assume we don't have to make them live or despawn
-		if (Chunk.second->IsValid() && Chunk.second->HasAnyClients())
-		{
-			Chunk.second->CollectMobCensus(a_ToFill);
-		}
-	}
-}
-
-
-
-
-
 void cChunkMap::SpawnMobs(cMobSpawner & a_MobSpawner)
 {
 	cCSLock Lock(m_CSChunks);
@@ -2084,13 +2064,26 @@ void cChunkMap::SpawnMobs(cMobSpawner & a_MobSpawner)
 
 void cChunkMap::Tick(std::chrono::milliseconds a_Dt)
 {
+	// Time the individual chunks only if the tick profiler is recording, to find the outliers:
+	auto & Profiler = m_World->GetTickProfiler();
+	bool ShouldTimeChunks = Profiler.IsRecordingTick();
+
 	cCSLock Lock(m_CSChunks);
 	for (const auto & Chunk : m_Chunks)
 	{
 		// Only tick chunks that are valid and should be ticked:
 		if (Chunk.second->IsValid() && Chunk.second->ShouldBeTicked())
 		{
-			Chunk.second->Tick(a_Dt);
+			if (ShouldTimeChunks)
+			{
+				auto Start = std::chrono::steady_clock::now();
+				Chunk.second->Tick(a_Dt);
+				Profiler.ChunkTicked(Chunk.second->GetPosX(), Chunk.second->GetPosZ(), Start, std::chrono::steady_clock::now());
+			}
+			else
+			{
+				Chunk.second->Tick(a_Dt);
+			}
 		}
 	}
 }
@@ -2139,6 +2132,27 @@ void cChunkMap::UnloadUnusedChunks(void)
 
 
 
+void cChunkMap::UnloadUnusedChunks(const cChunkCoordsVector & a_Chunks)
+{
+	cCSLock Lock(m_CSChunks);
+	for (const auto & Coords: a_Chunks)
+	{
+		auto itr = m_Chunks.find({Coords.m_ChunkX, Coords.m_ChunkZ});
+		if (
+			(itr != m_Chunks.end()) &&
+			(itr->second->CanUnload()) &&  // Can unload
+			!cPluginManager::Get()->CallHookChunkUnloading(*GetWorld(), Coords.m_ChunkX, Coords.m_ChunkZ)  // Plugins agree
+		)
+		{
+			m_Chunks.erase(itr);
+		}
+	}
+}
+
+
+
+
+
 void cChunkMap::SaveAllChunks(void)
 {
 	cCSLock Lock(m_CSChunks);
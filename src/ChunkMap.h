@@ -35,7 +35,6 @@ class cCommandBlockEntity;
 class cMobHeadEntity;
 class cFlowerPotEntity;
 class cBlockArea;
-class cMobCensus;
 class cMobSpawner;
 class cSetChunkData;
 class cBoundingBox;
@@ -378,9 +377,6 @@ public:
 	Only one block coord per chunk may be set, a second call overwrites the first call */
 	void SetNextBlockToTick(const Vector3i a_BlockPos);
 
-	/** Make a Mob census, of all mobs, their family, their chunk and their distance to closest player */
-	void CollectMobCensus(cMobCensus & a_ToFill);
-
 	/** Try to Spawn Monsters inside all Chunks */
 	void SpawnMobs(cMobSpawner & a_MobSpawner);
 
@@ -390,6 +386,10 @@ public:
 	void TickBlock(const Vector3i a_BlockPos);
 
 	void UnloadUnusedChunks(void);
+
+	/** Unloads those of the specified chunks that can be unloaded (unused, saved, not in a ChunkStay) and that the plugins agree to unload. */
+	void UnloadUnusedChunks(const cChunkCoordsVector & a_Chunks);
+
 	void SaveAllChunks(void);
 
 	cWorld * GetWorld(void) { return m_World; }
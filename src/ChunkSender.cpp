@@ -14,6 +14,7 @@
 #include "Protocol/ChunkDataSerializer.h"
 #include "ClientHandle.h"
 #include "Chunk.h"
+#include "Metrics.h"
 
 
 
@@ -61,7 +62,11 @@ public:
 
 cChunkSender::cChunkSender(cWorld & a_World) :
 	Super("ChunkSender"),
-	m_World(a_World)
+	m_World(a_World),
+	m_ChunksSentMetric(cMetrics::Get().GetCounter(
+		"cuberite_chunks_sent_total", "Number of chunks sent to the clients.",
+		cMetrics::Label("world", a_World.GetName())
+	))
 {
 }
 
@@ -170,6 +175,16 @@ void cChunkSender::RemoveClient(cClientHandle * a_Client)
 
 
 
+size_t cChunkSender::GetQueueLength(void)
+{
+	cCSLock Lock(m_CS);
+	return m_ChunkInfo.size();
+}
+
+
+
+
+
 void cChunkSender::Execute(void)
 {
 	while (!m_ShouldTerminate)
@@ -251,6 +266,7 @@ void cChunkSender::SendChunk(int a_ChunkX, int a_ChunkZ, std::unordered_set<cCli
 	{
 		// Send:
 		Client->SendChunkData(a_ChunkX, a_ChunkZ, Data);
+		m_ChunksSentMetric.Add();
 
 		// Send block-entity packets:
 		for (const auto & Pos : m_BlockEntities)
@@ -37,6 +37,7 @@ Note that it may be called by world's BroadcastToChunk() if the client is still
 
 class cWorld;
 class cClientHandle;
+class cMetricCounter;
 
 
 
@@ -78,6 +79,9 @@ public:
 	/** Removes the a_Client from all waiting chunk send operations */
 	void RemoveClient(cClientHandle * a_Client);
 
+	/** Returns the number of chunks waiting to be sent. */
+	size_t GetQueueLength(void);
+
 protected:
 
 	struct sChunkQueue
@@ -112,6 +116,9 @@ protected:
 
 	cWorld & m_World;
 
+	/** Counts the chunks sent to the clients, exported through cMetrics. */
+	cMetricCounter & m_ChunksSentMetric;
+
 	cCriticalSection  m_CS;
 	std::priority_queue<sChunkQueue> m_SendChunks;
 	std::unordered_map<cChunkCoords, sSendChunk, cChunkCoordsHash> m_ChunkInfo;
@@ -33,6 +33,7 @@
 #include "Protocol/ProtocolRecognizer.h"
 #include "CompositeChat.h"
 #include "Items/ItemSword.h"
+#include "Metrics.h"
 
 #include "mbedtls/md5.h"
 
@@ -55,6 +56,39 @@ static const std::chrono::milliseconds PING_TIME_MS = std::chrono::milliseconds(
 
 
 
+/** Returns the counter of the bytes received from all the clients. */
+static cMetricCounter & GetBytesReceivedMetric(void)
+{
+	static cMetricCounter & Metric = cMetrics::Get().GetCounter("cuberite_network_received_bytes_total", "Number of bytes received from the clients.");
+	return Metric;
+}
+
+
+
+
+
+/** Returns the counter of the bytes sent to all the clients. */
+static cMetricCounter & GetBytesSentMetric(void)
+{
+	static cMetricCounter & Metric = cMetrics::Get().GetCounter("cuberite_network_sent_bytes_total", "Number of bytes sent to the clients.");
+	return Metric;
+}
+
+
+
+
+
+/** Returns the gauge of the bytes queued in all the clients' outgoing buffers, waiting for the next tick to be sent. */
+static cMetricGauge & GetSendBacklogMetric(void)
+{
+	static cMetricGauge & Metric = cMetrics::Get().GetGauge("cuberite_network_send_backlog_bytes", "Number of bytes queued for sending to the clients.");
+	return Metric;
+}
+
+
+
+
+
 int cClientHandle::s_ClientCount = 0;
 
 
@@ -141,6 +175,12 @@ cClientHandle::~cClientHandle()
 
 	m_Protocol.reset();
 
+	// The data that never got sent is no longer part of the backlog:
+	{
+		cCSLock Lock(m_CSOutgoingData);
+		GetSendBacklogMetric().Add(-static_cast<Int64>(m_OutgoingData.size()));
+	}
+
 	LOGD("ClientHandle at %p deleted", static_cast<void *>(this));
 }
 
@@ -2023,6 +2063,7 @@ void cClientHandle::SendData(const char * a_Data, size_t a_Size)
 
 	cCSLock Lock(m_CSOutgoingData);
 	m_OutgoingData.append(a_Data, a_Size);
+	GetSendBacklogMetric().Add(static_cast<Int64>(a_Size));
 }
 
 
@@ -2702,9 +2743,9 @@ void cClientHandle::SendInventorySlot(char a_WindowID, short a_SlotNum, const cI
 
 
 
-void cClientHandle::SendMapData(const cMap & a_Map, int a_DataStartX, int a_DataStartY)
+void cClientHandle::SendMapData(const cMap & a_Map, unsigned a_DataStartX, unsigned a_DataStartY, unsigned a_DataWidth, unsigned a_DataHeight)
 {
-	m_Protocol->SendMapData(a_Map, a_DataStartX, a_DataStartY);
+	m_Protocol->SendMapData(a_Map, a_DataStartX, a_DataStartY, a_DataWidth, a_DataHeight);
 }
 
 
@@ -3354,10 +3395,12 @@ void cClientHandle::ProcessProtocolInOut(void)
 		cCSLock Lock(m_CSOutgoingData);
 		std::swap(OutgoingData, m_OutgoingData);
 	}
+	GetSendBacklogMetric().Add(-static_cast<Int64>(OutgoingData.size()));
 	auto link = m_Link;
 	if ((link != nullptr) && !OutgoingData.empty())
 	{
 		link->Send(OutgoingData.data(), OutgoingData.size());
+		GetBytesSentMetric().Add(OutgoingData.size());
 	}
 }
 
@@ -3379,6 +3422,8 @@ void cClientHandle::OnReceivedData(const char * a_Data, size_t a_Length)
 	// Reset the timeout:
 	m_TicksSinceLastPacket = 0;
 
+	GetBytesReceivedMetric().Add(a_Length);
+
 	// Queue the incoming data to be processed in the tick thread:
 	cCSLock Lock(m_CSIncomingData);
 	m_IncomingData.append(a_Data, a_Length);
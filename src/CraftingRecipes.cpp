@@ -196,7 +196,7 @@ void cCraftingGrid::Dump(void)
 {
 	for (int y = 0; y < m_Height; y++) for (int x = 0; x < m_Width; x++)
 	{
-		#ifdef _DEBUG
+		#if defined(_DEBUG) || defined(TEST_GLOBALS)
 		int idx = x + m_Width * y;
 		#endif
 		LOGD("Slot (%d, %d): Type %d, health %d, count %d",
@@ -362,6 +362,7 @@ void cCraftingRecipes::ClearRecipes(void)
 		delete *itr;
 	}
 	m_Recipes.clear();
+	m_RecipeIndex.clear();
 }
 
 
@@ -427,6 +428,7 @@ void cCraftingRecipes::AddRecipeLine(int a_LineNum, const AString & a_RecipeLine
 
 	NormalizeIngredients(Recipe.get());
 
+	m_RecipeIndex[GetRecipeSignature(*Recipe)].push_back(Recipe.get());
 	m_Recipes.push_back(Recipe.release());
 }
 
@@ -584,6 +586,53 @@ void cCraftingRecipes::NormalizeIngredients(cCraftingRecipes::cRecipe * a_Recipe
 
 
 
+cCraftingRecipes::cRecipeSignature cCraftingRecipes::GetRecipeSignature(const cRecipe & a_Recipe)
+{
+	// Each "anywhere" ingredient occupies a cell of its own, regular ingredients sharing coords occupy a single cell:
+	bool IsOccupied[MAX_GRID_WIDTH][MAX_GRID_HEIGHT];
+	memset(IsOccupied, 0, sizeof(IsOccupied));
+	int NumCells = 0;
+	short MinItemType = std::numeric_limits<short>::max();
+	for (cRecipeSlots::const_iterator itr = a_Recipe.m_Ingredients.begin(); itr != a_Recipe.m_Ingredients.end(); ++itr)
+	{
+		MinItemType = std::min(itr->m_Item.m_ItemType, MinItemType);
+		if ((itr->x < 0) || (itr->y < 0))
+		{
+			NumCells += 1;
+		}
+		else if ((itr->x < MAX_GRID_WIDTH) && (itr->y < MAX_GRID_HEIGHT) && !IsOccupied[itr->x][itr->y])
+		{
+			IsOccupied[itr->x][itr->y] = true;
+			NumCells += 1;
+		}
+	}  // for itr - a_Recipe.m_Ingredients[]
+	return cRecipeSignature(NumCells, MinItemType);
+}
+
+
+
+
+
+cCraftingRecipes::cRecipeSignature cCraftingRecipes::GetGridSignature(const cItem * a_CraftingGrid, int a_GridWidth, int a_GridHeight, int a_GridStride)
+{
+	int NumCells = 0;
+	short MinItemType = std::numeric_limits<short>::max();
+	for (int y = 0; y < a_GridHeight; y++) for (int x = 0; x < a_GridWidth; x++)
+	{
+		const cItem & Item = a_CraftingGrid[x + y * a_GridStride];
+		if (!Item.IsEmpty())
+		{
+			MinItemType = std::min(Item.m_ItemType, MinItemType);
+			NumCells += 1;
+		}
+	}
+	return cRecipeSignature(NumCells, MinItemType);
+}
+
+
+
+
+
 cCraftingRecipes::cRecipe * cCraftingRecipes::FindRecipe(const cItem * a_CraftingGrid, int a_GridWidth, int a_GridHeight)
 {
 	ASSERT(a_GridWidth <= MAX_GRID_WIDTH);
@@ -629,7 +678,14 @@ cCraftingRecipes::cRecipe * cCraftingRecipes::FindRecipe(const cItem * a_Craftin
 
 cCraftingRecipes::cRecipe * cCraftingRecipes::FindRecipeCropped(const cItem * a_CraftingGrid, int a_GridWidth, int a_GridHeight, int a_GridStride)
 {
-	for (cRecipes::const_iterator itr = m_Recipes.begin(); itr != m_Recipes.end(); ++itr)
+	// Only the recipes with the same signature as the grid can possibly match:
+	auto Candidates = m_RecipeIndex.find(GetGridSignature(a_CraftingGrid, a_GridWidth, a_GridHeight, a_GridStride));
+	if (Candidates == m_RecipeIndex.end())
+	{
+		return nullptr;
+	}
+
+	for (cRecipes::const_iterator itr = Candidates->second.begin(); itr != Candidates->second.end(); ++itr)
 	{
 		// Both the crafting grid and the recipes are normalized. The only variable possible is the "anywhere" items.
 		// This still means that the "anywhere" item may be the one that is offsetting the grid contents to the right or downwards, so we need to check all possible positions.
@@ -647,7 +703,7 @@ cCraftingRecipes::cRecipe * cCraftingRecipes::FindRecipeCropped(const cItem * a_
 				return Recipe;
 			}
 		}  // for y, for x
-	}  // for itr - m_Recipes[]
+	}  // for itr - Candidates[]
 
 	// No matching recipe found
 	return nullptr;
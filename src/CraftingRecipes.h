@@ -139,8 +139,15 @@ protected:
 	} ;
 	typedef std::vector<cRecipe *> cRecipes;
 
+	/** Signature of a recipe or of a cropped crafting grid: the number of occupied grid cells and the lowest item type present.
+	A grid can only match recipes that have the same signature, since each ingredient consumes exactly one non-empty cell. */
+	typedef std::pair<int, short> cRecipeSignature;
+
 	cRecipes m_Recipes;
 
+	/** Recipes grouped by their signature, each group keeps the order of m_Recipes. Owns nothing, the recipes are owned by m_Recipes. */
+	std::map<cRecipeSignature, cRecipes> m_RecipeIndex;
+
 	void LoadRecipes(void);
 	void ClearRecipes(void);
 
@@ -156,6 +163,12 @@ protected:
 	/** Moves the recipe to top-left corner, sets its MinWidth / MinHeight */
 	void NormalizeIngredients(cRecipe * a_Recipe);
 
+	/** Returns the signature under which the recipe is stored in m_RecipeIndex */
+	static cRecipeSignature GetRecipeSignature(const cRecipe & a_Recipe);
+
+	/** Returns the signature of the (cropped) crafting grid, used for looking up the candidate recipes in m_RecipeIndex */
+	static cRecipeSignature GetGridSignature(const cItem * a_CraftingGrid, int a_GridWidth, int a_GridHeight, int a_GridStride);
+
 	/** Finds a recipe matching the crafting grid. Returns a newly allocated recipe (with all its coords set) or nullptr if not found. Caller must delete return value! */
 	cRecipe * FindRecipe(const cItem * a_CraftingGrid, int a_GridWidth, int a_GridHeight);
 
@@ -1069,8 +1069,8 @@ void cEntity::HandlePhysics(std::chrono::milliseconds a_Dt, cChunk & a_Chunk)
 		NextSpeed.z *= 0.25;
 	}
 
-	// Get water direction
-	Vector3f WaterDir = m_World->GetWaterSimulator()->GetFlowingDirection(BlockX, BlockY, BlockZ);
+	// Get water direction, reading straight from the chunk we're in rather than going through the world:
+	Vector3f WaterDir = m_World->GetWaterSimulator()->GetFlowingDirection(*NextChunk, {RelBlockX, BlockY, RelBlockZ});
 
 	m_WaterSpeed *= 0.9;  // Reduce speed each tick
 
@@ -1096,7 +1096,7 @@ void cEntity::HandlePhysics(std::chrono::milliseconds a_Dt, cChunk & a_Chunk)
 		Vector3i HitBlockCoords;
 		eBlockFace HitBlockFace;
 		Vector3d wantNextPos = NextPos + NextSpeed * DtSec.count();
-		auto isHit = cLineBlockTracer::FirstSolidHitTrace(*GetWorld(), NextPos, wantNextPos, HitCoords, HitBlockCoords, HitBlockFace);
+		auto isHit = cLineBlockTracer::FirstSolidHitTrace(*NextChunk, NextPos, wantNextPos, HitCoords, HitBlockCoords, HitBlockFace);
 		if (isHit)
 		{
 			// Set our position to where the block was hit:
@@ -2073,6 +2073,11 @@ void cEntity::SetHeadYaw(double a_HeadYaw)
 void cEntity::SetHeight(double a_Height)
 {
 	m_Height = a_Height;
+	auto ParentChunk = m_ParentChunk;
+	if (ParentChunk != nullptr)
+	{
+		ParentChunk->EntityResized(*this);
+	}
 }
 
 
@@ -2162,6 +2167,11 @@ void cEntity::SetSpeedZ(double a_SpeedZ)
 void cEntity::SetWidth(double a_Width)
 {
 	m_Width = a_Width;
+	auto ParentChunk = m_ParentChunk;
+	if (ParentChunk != nullptr)
+	{
+		ParentChunk->EntityResized(*this);
+	}
 }
 
 
@@ -2267,6 +2277,14 @@ void cEntity::SetPosition(const Vector3d & a_Position)
 
 	m_LastPosition = m_Position;
 	m_Position = {ClampedPosX, ClampedPosY, ClampedPosZ};
+
+	// Keep the chunk's entity grid up to date; crossing a cell boundary is rare, so check for it cheaply first.
+	// The parent chunk is read only once, the chunk re-checks it under the chunkmap's lock:
+	auto ParentChunk = m_ParentChunk;
+	if ((ParentChunk != nullptr) && cEntityGrid::AreInDifferentCells(m_LastPosition, m_Position))
+	{
+		ParentChunk->EntityMoved(*this, m_LastPosition);
+	}
 }
 
 
@@ -1814,34 +1814,7 @@ void cPlayer::SetVisible(bool a_bVisible)
 
 bool cPlayer::HasPermission(const AString & a_Permission)
 {
-	if (a_Permission.empty())
-	{
-		// Empty permission request is always granted
-		return true;
-	}
-
-	AStringVector Split = StringSplit(a_Permission, ".");
-
-	// Iterate over all restrictions; if any matches, then return failure:
-	for (auto & Restriction: m_SplitRestrictions)
-	{
-		if (PermissionMatches(Split, Restriction))
-		{
-			return false;
-		}
-	}  // for Restriction - m_SplitRestrictions[]
-
-	// Iterate over all granted permissions; if any matches, then return success:
-	for (auto & Permission: m_SplitPermissions)
-	{
-		if (PermissionMatches(Split, Permission))
-		{
-			return true;
-		}
-	}  // for Permission - m_SplitPermissions[]
-
-	// No granted permission matches
-	return false;
+	return m_PermissionChecker.HasPermission(a_Permission);
 }
 
 
@@ -2655,21 +2628,8 @@ void cPlayer::LoadRank(void)
 	m_Restrictions = RankMgr->GetPlayerRestrictions(m_UUID);
 	RankMgr->GetRankVisuals(m_Rank, m_MsgPrefix, m_MsgSuffix, m_MsgNameColorCode);
 
-	// Break up the individual permissions on each dot, into m_SplitPermissions:
-	m_SplitPermissions.clear();
-	m_SplitPermissions.reserve(m_Permissions.size());
-	for (auto & Permission: m_Permissions)
-	{
-		m_SplitPermissions.push_back(StringSplit(Permission, "."));
-	}  // for Permission - m_Permissions[]
-
-	// Break up the individual restrictions on each dot, into m_SplitRestrictions:
-	m_SplitRestrictions.clear();
-	m_SplitRestrictions.reserve(m_Restrictions.size());
-	for (auto & Restriction: m_Restrictions)
-	{
-		m_SplitRestrictions.push_back(StringSplit(Restriction, "."));
-	}  // for itr - m_Restrictions[]
+	// Compile the permissions and restrictions, and forget the decisions based on the previous rank:
+	m_PermissionChecker.SetPermissions(m_Permissions, m_Restrictions);
 }
 
 
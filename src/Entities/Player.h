@@ -8,6 +8,7 @@
 #include "../Items/ItemHandler.h"
 
 #include "../Statistics.h"
+#include "../PermissionTrie.h"
 
 #include "../UUID.h"
 
@@ -602,8 +603,6 @@ public:
 
 protected:
 
-	typedef std::vector<std::vector<AString> > AStringVectorVector;
-
 	/** The name of the rank assigned to this player. */
 	AString m_Rank;
 
@@ -613,13 +612,9 @@ protected:
 	/** All the restrictions that this player has, based on their rank. */
 	AStringVector m_Restrictions;
 
-	/** All the permissions that this player has, based on their rank, split into individual dot-delimited parts.
-	This is used mainly by the HasPermission() function to optimize the lookup. */
-	AStringVectorVector m_SplitPermissions;
-
-	/** All the restrictions that this player has, based on their rank, split into individual dot-delimited parts.
-	This is used mainly by the HasPermission() function to optimize the lookup. */
-	AStringVectorVector m_SplitRestrictions;
+	/** Decides the player's permissions from m_Permissions and m_Restrictions, compiled by LoadRank().
+	This is used by the HasPermission() function to optimize the lookup. */
+	cPermissionChecker m_PermissionChecker;
 
 
 	// Message visuals:
@@ -383,9 +383,11 @@ void cProjectileEntity::HandlePhysics(std::chrono::milliseconds a_Dt, cChunk & a
 	const Vector3d Pos = GetPosition();
 	const Vector3d NextPos = Pos + DeltaSpeed;
 
-	// Test for entity collisions:
+	// Test for entity collisions, only the entities near the trajectory can be hit:
 	cProjectileEntityCollisionCallback EntityCollisionCallback(this, Pos, NextPos);
-	a_Chunk.ForEachEntity(EntityCollisionCallback);
+	auto TraceBox = cBoundingBox(Pos, 0, 0).Union(cBoundingBox(NextPos, 0, 0));
+	TraceBox.Expand(GetWidth() / 2, GetHeight() / 2, GetWidth() / 2);
+	a_Chunk.ForEachEntityInBox(TraceBox, EntityCollisionCallback);
 	if (EntityCollisionCallback.HasHit())
 	{
 		// An entity was hit:
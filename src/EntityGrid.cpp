@@ -0,0 +1,216 @@
+// EntityGrid.cpp
+
+// Implements the cEntityGrid class representing a spatial index of the entities within a single chunk
+
+#include "Globals.h"
+#include "EntityGrid.h"
+#include "BoundingBox.h"
+#include "Entities/Entity.h"
+
+
+
+
+
+cEntityGrid::cEntityGrid(int a_ChunkX, int a_ChunkZ) :
+	m_BaseX(a_ChunkX * cChunkDef::Width),
+	m_BaseZ(a_ChunkZ * cChunkDef::Width),
+	m_MaxHalfWidth(0),
+	m_MaxHeight(0),
+	m_NumEntities(0)
+{
+}
+
+
+
+
+
+void cEntityGrid::Add(cEntity & a_Entity)
+{
+	m_Cells[GetCellIndex(GetCellCoords(a_Entity.GetPosition()))].push_back(&a_Entity);
+	m_NumEntities += 1;
+	UpdateMargins(a_Entity);
+}
+
+
+
+
+
+void cEntityGrid::Remove(cEntity & a_Entity)
+{
+	if (
+		!RemoveFromCell(m_Cells[GetCellIndex(GetCellCoords(a_Entity.GetPosition()))], a_Entity) &&
+		!RemoveFromAnyCell(a_Entity)
+	)
+	{
+		// Not stored in this grid at all, nothing to remove:
+		ASSERT(!"Entity not found in the grid");
+		return;
+	}
+
+	ASSERT(m_NumEntities > 0);
+	m_NumEntities -= 1;
+	if (m_NumEntities == 0)
+	{
+		m_MaxHalfWidth = 0;
+		m_MaxHeight = 0;
+	}
+}
+
+
+
+
+
+void cEntityGrid::Clear(void)
+{
+	for (auto & Cell : m_Cells)
+	{
+		Cell.clear();
+	}
+	m_NumEntities = 0;
+	m_MaxHalfWidth = 0;
+	m_MaxHeight = 0;
+}
+
+
+
+
+
+void cEntityGrid::Move(cEntity & a_Entity, Vector3d a_OldPosition)
+{
+	auto OldIdx = GetCellIndex(GetCellCoords(a_OldPosition));
+	auto NewIdx = GetCellIndex(GetCellCoords(a_Entity.GetPosition()));
+	if (OldIdx == NewIdx)
+	{
+		// Still in the same cell (possibly clamped, when outside the chunk)
+		return;
+	}
+
+	if (!RemoveFromCell(m_Cells[OldIdx], a_Entity) && !RemoveFromAnyCell(a_Entity))
+	{
+		// Not stored in this grid at all, adding it now would leave a dangling pointer once it's gone:
+		ASSERT(!"Entity not found in the grid");
+		return;
+	}
+	m_Cells[NewIdx].push_back(&a_Entity);
+}
+
+
+
+
+
+void cEntityGrid::Resized(const cEntity & a_Entity)
+{
+	UpdateMargins(a_Entity);
+}
+
+
+
+
+
+bool cEntityGrid::ForEachEntityInBox(const cBoundingBox & a_Box, cEntityCallback a_Callback) const
+{
+	// An entity's bounding box spans from its position by the half-width horizontally and by the height upwards,
+	// so its position must be within the query box expanded by those:
+	auto MinCell = GetCellCoords({a_Box.GetMinX() - m_MaxHalfWidth, a_Box.GetMinY() - m_MaxHeight, a_Box.GetMinZ() - m_MaxHalfWidth});
+	auto MaxCell = GetCellCoords({a_Box.GetMaxX() + m_MaxHalfWidth, a_Box.GetMaxY(),               a_Box.GetMaxZ() + m_MaxHalfWidth});
+
+	// Collect the entities first, the callbacks may move entities between the cells (SetPosition() -> Move()).
+	// The intersection test is spelled out instead of GetBoundingBox().DoesIntersect(), and without short-circuiting,
+	// because in chunks full of entities (item farms) this loop visits thousands of them per query:
+	std::vector<cEntity *> Entities;
+	const auto Min = a_Box.GetMin();
+	const auto Max = a_Box.GetMax();
+	for (int y = MinCell.y; y <= MaxCell.y; ++y)
+	{
+		for (int z = MinCell.z; z <= MaxCell.z; ++z)
+		{
+			for (int x = MinCell.x; x <= MaxCell.x; ++x)
+			{
+				for (auto Entity : m_Cells[GetCellIndex({x, y, z})])
+				{
+					const auto & Pos = Entity->GetPosition();
+					const auto HalfWidth = Entity->GetWidth() / 2;
+					const auto Height = Entity->GetHeight();
+					bool IsInX = (Pos.x - HalfWidth <= Max.x) & (Pos.x + HalfWidth >= Min.x);
+					bool IsInY = (Pos.y <= Max.y) & (Pos.y + Height >= Min.y);
+					bool IsInZ = (Pos.z - HalfWidth <= Max.z) & (Pos.z + HalfWidth >= Min.z);
+					if (IsInX & IsInY & IsInZ)
+					{
+						Entities.push_back(Entity);
+					}
+				}  // for Entity - m_Cells[]
+			}  // for x
+		}  // for z
+	}  // for y
+
+	for (auto Entity : Entities)
+	{
+		if (a_Callback(*Entity))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+
+
+Vector3i cEntityGrid::GetCellCoords(Vector3d a_Pos) const
+{
+	return
+	{
+		Clamp(FloorC((a_Pos.x - m_BaseX) / CELL_SIZE), 0, NUM_CELLS_X - 1),
+		Clamp(FloorC(a_Pos.y / CELL_SIZE),            0, NUM_CELLS_Y - 1),
+		Clamp(FloorC((a_Pos.z - m_BaseZ) / CELL_SIZE), 0, NUM_CELLS_Z - 1)
+	};
+}
+
+
+
+
+
+bool cEntityGrid::RemoveFromCell(cCell & a_Cell, const cEntity & a_Entity)
+{
+	auto itr = std::find(a_Cell.begin(), a_Cell.end(), &a_Entity);
+	if (itr == a_Cell.end())
+	{
+		return false;
+	}
+
+	// The order within a cell doesn't matter, swap with the last one for a quick removal:
+	std::swap(*itr, a_Cell.back());
+	a_Cell.pop_back();
+	return true;
+}
+
+
+
+
+
+bool cEntityGrid::RemoveFromAnyCell(const cEntity & a_Entity)
+{
+	for (auto & Cell : m_Cells)
+	{
+		if (RemoveFromCell(Cell, a_Entity))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+
+
+void cEntityGrid::UpdateMargins(const cEntity & a_Entity)
+{
+	m_MaxHalfWidth = std::max(m_MaxHalfWidth, a_Entity.GetWidth() / 2);
+	m_MaxHeight = std::max(m_MaxHeight, a_Entity.GetHeight());
+}
+
+
+
+
@@ -0,0 +1,121 @@
+
+// EntityGrid.h
+
+// Declares the cEntityGrid class representing a spatial index of the entities within a single chunk
+
+
+
+
+
+#pragma once
+
+#include "ChunkDef.h"
+#include "FunctionRef.h"
+
+
+
+
+
+// fwd:
+class cBoundingBox;
+class cEntity;
+
+using cEntityCallback = cFunctionRef<bool(cEntity &)>;
+
+
+
+
+
+/** Spatial index of the entities in a single chunk, used by cChunk to answer proximity queries
+without testing every single entity in the chunk.
+The chunk is divided into cubic cells, each entity is stored in the cell containing its position.
+Entities that have moved out of the chunk but haven't been transferred to the neighbor yet are stored
+in the nearest border cell; queries clamp their cell range the same way, so such entities are still found.
+Protected by the parent chunkmap's CS, same as the rest of the chunk. */
+class cEntityGrid
+{
+public:
+
+	/** Edge length of a single cell, in blocks. */
+	static const int CELL_SIZE = 8;
+
+	static const int NUM_CELLS_X = cChunkDef::Width / CELL_SIZE;
+	static const int NUM_CELLS_Y = cChunkDef::Height / CELL_SIZE;
+	static const int NUM_CELLS_Z = cChunkDef::Width / CELL_SIZE;
+
+
+	cEntityGrid(int a_ChunkX, int a_ChunkZ);
+
+	/** Adds the entity to the cell containing its current position. */
+	void Add(cEntity & a_Entity);
+
+	/** Removes the entity from its cell. The entity must not have moved since the last Add() or Move() call. */
+	void Remove(cEntity & a_Entity);
+
+	/** Removes all entities. */
+	void Clear(void);
+
+	/** Moves the entity into the cell for its current position; a_OldPosition is the position it was stored under. */
+	void Move(cEntity & a_Entity, Vector3d a_OldPosition);
+
+	/** Updates the query margins after the entity's size has changed. */
+	void Resized(const cEntity & a_Entity);
+
+	/** Calls the callback for each entity whose bounding box intersects a_Box.
+	The callback may move the entities, the entities are collected before any callback is called.
+	Returns true if all entities have been enumerated, false if the callback has aborted the enumeration by returning true. */
+	bool ForEachEntityInBox(const cBoundingBox & a_Box, cEntityCallback a_Callback) const;
+
+	/** Returns true if the two positions lie in different cells, regardless of which chunk the cells belong to.
+	Used as a cheap pre-check before asking the chunk to Move() an entity. */
+	static bool AreInDifferentCells(Vector3d a_Pos1, Vector3d a_Pos2)
+	{
+		return (
+			(FloorC(a_Pos1.x / CELL_SIZE) != FloorC(a_Pos2.x / CELL_SIZE)) ||
+			(FloorC(a_Pos1.y / CELL_SIZE) != FloorC(a_Pos2.y / CELL_SIZE)) ||
+			(FloorC(a_Pos1.z / CELL_SIZE) != FloorC(a_Pos2.z / CELL_SIZE))
+		);
+	}
+
+protected:
+
+	using cCell = std::vector<cEntity *>;
+
+	/** The cells, indexed by GetCellIndex(). */
+	std::array<cCell, NUM_CELLS_X * NUM_CELLS_Y * NUM_CELLS_Z> m_Cells;
+
+	/** Block coords of the chunk's XM, ZM corner. */
+	int m_BaseX, m_BaseZ;
+
+	/** The largest half-width and height of any entity stored since the grid was last empty.
+	Queries are expanded by these, since the entities are stored by their position, not by their bounding box. */
+	double m_MaxHalfWidth;
+	double m_MaxHeight;
+
+	/** Number of entities currently stored, used to reset the margins once the grid empties. */
+	size_t m_NumEntities;
+
+
+	/** Returns the cell coords for the specified world position, clamped to the chunk. */
+	Vector3i GetCellCoords(Vector3d a_Pos) const;
+
+	/** Returns the index into m_Cells of the specified cell coords. */
+	static size_t GetCellIndex(Vector3i a_CellCoords)
+	{
+		return static_cast<size_t>(a_CellCoords.x + NUM_CELLS_X * (a_CellCoords.z + NUM_CELLS_Z * a_CellCoords.y));
+	}
+
+	/** Removes the entity from the specified cell. Returns true if it was found there. */
+	static bool RemoveFromCell(cCell & a_Cell, const cEntity & a_Entity);
+
+	/** Removes the entity from whichever cell it is in, for when it isn't in the expected cell,
+	i.e. it has moved without the grid being notified. Returns true if it was found. */
+	bool RemoveFromAnyCell(const cEntity & a_Entity);
+
+	/** Enlarges the query margins so that they accommodate the entity. */
+	void UpdateMargins(const cEntity & a_Entity);
+};
+
+
+
+
@@ -5,7 +5,6 @@
 
 #include "Globals.h"
 #include "BioGen.h"
-#include <iostream>
 #include "IntGen.h"
 #include "ProtIntGen.h"
 #include "../IniFile.h"
@@ -931,6 +930,9 @@ class cBioGenGrown:
 public:
 	cBioGenGrown(int a_Seed)
 	{
+		// The layers are sized to generate an entire tile at once. Each layer only uses the absolute coords,
+		// so the result is the same as if each chunk was generated separately, only without recalculating
+		// the borders that the neighboring chunks share.
 		auto FinalRivers =
 
 			std::make_shared<cIntGenChoice<2, 7>>(a_Seed + 12)
@@ -939,22 +941,22 @@ public:
 			| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
 			| MakeIntGen<cIntGenZoom  <8>>(a_Seed + 10)
 			| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
-			| MakeIntGen<cIntGenZoom  <8>>(a_Seed + 9)
-			| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
-			| MakeIntGen<cIntGenZoom  <8>>(a_Seed + 8)
-			| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
-			| MakeIntGen<cIntGenZoom  <9>>(a_Seed + 4)
-			| MakeIntGen<cIntGenRiver <7>>(a_Seed + 3)
-			| MakeIntGen<cIntGenZoom  <10>>(a_Seed + 2)
-			| MakeIntGen<cIntGenSmooth<8>>(a_Seed + 1);
+			| MakeIntGen<cIntGenZoom  <9>>(a_Seed + 9)
+			| MakeIntGen<cIntGenSmooth<7>>(a_Seed + 5)
+			| MakeIntGen<cIntGenZoom  <11>>(a_Seed + 8)
+			| MakeIntGen<cIntGenSmooth<9>>(a_Seed + 5)
+			| MakeIntGen<cIntGenZoom  <15>>(a_Seed + 4)
+			| MakeIntGen<cIntGenRiver <13>>(a_Seed + 3)
+			| MakeIntGen<cIntGenZoom  <22>>(a_Seed + 2)
+			| MakeIntGen<cIntGenSmooth<20>>(a_Seed + 1);
 
 		auto alteration =
-			std::make_shared<cIntGenZoom     <8>>(a_Seed,
+			std::make_shared<cIntGenZoom     <9>>(a_Seed,
 			std::make_shared<cIntGenLandOcean<6>>(a_Seed, 20
 		));
 
 		auto alteration2 =
-			std::make_shared<cIntGenZoom     <8>>(a_Seed + 1,
+			std::make_shared<cIntGenZoom     <9>>(a_Seed + 1,
 			std::make_shared<cIntGenZoom     <6>>(a_Seed + 2,
 			std::make_shared<cIntGenZoom     <5>>(a_Seed + 1,
 			std::make_shared<cIntGenZoom     <4>>(a_Seed + 2,
@@ -962,19 +964,19 @@ public:
 		)))));
 
 		auto FinalBiomes =
-			std::make_shared<cIntGenSmooth         <8>> (a_Seed + 1,
-			std::make_shared<cIntGenZoom           <10>>(a_Seed + 15,
-			std::make_shared<cIntGenSmooth         <7>> (a_Seed + 1,
-			std::make_shared<cIntGenZoom           <9>> (a_Seed + 16,
-			std::make_shared<cIntGenBeaches        <6>> (
-			std::make_shared<cIntGenZoom           <8>> (a_Seed + 1,
-			std::make_shared<cIntGenAddIslands     <6>> (a_Seed + 2004, 10,
-			std::make_shared<cIntGenAddToOcean     <6>> (a_Seed + 10, 500, biDeepOcean,
-			std::make_shared<cIntGenReplaceRandomly<8>> (a_Seed + 1, biPlains, biSunflowerPlains, 20,
-			std::make_shared<cIntGenMBiomes        <8>> (a_Seed + 5, alteration2,
-			std::make_shared<cIntGenAlternateBiomes<8>> (a_Seed + 1, alteration,
-			std::make_shared<cIntGenBiomeEdges     <8>> (a_Seed + 3,
-			std::make_shared<cIntGenZoom           <10>>(a_Seed + 2,
+			std::make_shared<cIntGenSmooth         <20>>(a_Seed + 1,
+			std::make_shared<cIntGenZoom           <22>>(a_Seed + 15,
+			std::make_shared<cIntGenSmooth         <13>>(a_Seed + 1,
+			std::make_shared<cIntGenZoom           <15>>(a_Seed + 16,
+			std::make_shared<cIntGenBeaches        <9>> (
+			std::make_shared<cIntGenZoom           <11>>(a_Seed + 1,
+			std::make_shared<cIntGenAddIslands     <7>> (a_Seed + 2004, 10,
+			std::make_shared<cIntGenAddToOcean     <7>> (a_Seed + 10, 500, biDeepOcean,
+			std::make_shared<cIntGenReplaceRandomly<9>> (a_Seed + 1, biPlains, biSunflowerPlains, 20,
+			std::make_shared<cIntGenMBiomes        <9>> (a_Seed + 5, alteration2,
+			std::make_shared<cIntGenAlternateBiomes<9>> (a_Seed + 1, alteration,
+			std::make_shared<cIntGenBiomeEdges     <9>> (a_Seed + 3,
+			std::make_shared<cIntGenZoom           <11>>(a_Seed + 2,
 			std::make_shared<cIntGenZoom           <7>> (a_Seed + 4,
 			std::make_shared<cIntGenReplaceRandomly<5>> (a_Seed + 99, biIcePlains, biIcePlainsSpikes, 50,
 			std::make_shared<cIntGenZoom           <5>> (a_Seed + 8,
@@ -996,30 +998,88 @@ public:
 		)))))))))))))))))))))))))))));
 
 		m_Gen =
-			std::make_shared<cIntGenSmooth   <16>>(a_Seed,
-			std::make_shared<cIntGenZoom     <18>>(a_Seed,
-			std::make_shared<cIntGenSmooth   <11>>(a_Seed,
-			std::make_shared<cIntGenZoom     <13>>(a_Seed,
-			std::make_shared<cIntGenMixRivers<8>> (
+			std::make_shared<cIntGenSmooth   <TILE_SIZE>>(a_Seed,
+			std::make_shared<cIntGenZoom     <66>>(a_Seed,
+			std::make_shared<cIntGenSmooth   <35>>(a_Seed,
+			std::make_shared<cIntGenZoom     <37>>(a_Seed,
+			std::make_shared<cIntGenMixRivers<20>>(
 			FinalBiomes, FinalRivers
 		)))));
 	}
 
 	virtual void GenBiomes(cChunkCoords a_ChunkCoords, cChunkDef::BiomeMap & a_Biomes) override
 	{
-		cIntGen<16, 16>::Values vals;
-		m_Gen->GetInts(a_ChunkCoords.m_ChunkX * cChunkDef::Width, a_ChunkCoords.m_ChunkZ * cChunkDef::Width, vals);
+		int TileX = FAST_FLOOR_DIV(a_ChunkCoords.m_ChunkX, TILE_CHUNKS);
+		int TileZ = FAST_FLOOR_DIV(a_ChunkCoords.m_ChunkZ, TILE_CHUNKS);
+		const sTile & Tile = GetTile(TileX, TileZ);
+
+		// Copy the chunk's part of the tile:
+		int OffsetX = (a_ChunkCoords.m_ChunkX - TileX * TILE_CHUNKS) * cChunkDef::Width;
+		int OffsetZ = (a_ChunkCoords.m_ChunkZ - TileZ * TILE_CHUNKS) * cChunkDef::Width;
 		for (int z = 0; z < cChunkDef::Width; z++)
 		{
+			const int * Row = Tile.m_Values + OffsetX + (OffsetZ + z) * TILE_SIZE;
 			for (int x = 0; x < cChunkDef::Width; x++)
 			{
-				cChunkDef::SetBiome(a_Biomes, x, z, static_cast<EMCSBiome>(vals[x + cChunkDef::Width * z]));
+				cChunkDef::SetBiome(a_Biomes, x, z, static_cast<EMCSBiome>(Row[x]));
 			}
 		}
 	}
 
 protected:
-	std::shared_ptr<cIntGen<16, 16>> m_Gen;
+
+	/** Number of chunks along each side of a tile, the area generated at once. */
+	static const int TILE_CHUNKS = 4;
+
+	/** Number of blocks along each side of a tile. */
+	static const int TILE_SIZE = TILE_CHUNKS * cChunkDef::Width;
+
+	/** Number of the most recently used tiles kept (16 KiB each).
+	The generator works in rings around the players, so the cache needs to hold a ring of tiles around the
+	whole view distance, otherwise each tile gets regenerated for each of its chunk rows. */
+	static const size_t NUM_CACHED_TILES = 64;
+
+	/** A generated tile of biomes. */
+	struct sTile
+	{
+		int m_TileX;
+		int m_TileZ;
+		cIntGen<TILE_SIZE, TILE_SIZE>::Values m_Values;
+	};
+
+	std::shared_ptr<cIntGen<TILE_SIZE, TILE_SIZE>> m_Gen;
+
+	/** The most recently used tiles, the most recent first. Holds at most NUM_CACHED_TILES items. */
+	std::list<sTile> m_Tiles;
+
+
+	/** Returns the specified tile, from the cache if available, generating it otherwise. */
+	const sTile & GetTile(int a_TileX, int a_TileZ)
+	{
+		for (auto itr = m_Tiles.begin(), end = m_Tiles.end(); itr != end; ++itr)
+		{
+			if ((itr->m_TileX == a_TileX) && (itr->m_TileZ == a_TileZ))
+			{
+				m_Tiles.splice(m_Tiles.begin(), m_Tiles, itr);
+				return m_Tiles.front();
+			}
+		}
+
+		// Not cached, generate into the least recently used tile, or a new one if the cache is not full yet:
+		if (m_Tiles.size() < NUM_CACHED_TILES)
+		{
+			m_Tiles.emplace_front();
+		}
+		else
+		{
+			m_Tiles.splice(m_Tiles.begin(), m_Tiles, std::prev(m_Tiles.end()));
+		}
+		auto & Tile = m_Tiles.front();
+		Tile.m_TileX = a_TileX;
+		Tile.m_TileZ = a_TileZ;
+		m_Gen->GetInts(a_TileX * TILE_SIZE, a_TileZ * TILE_SIZE, Tile.m_Values);
+		return Tile;
+	}
 };
 
 
@@ -1191,50 +1251,3 @@ cBiomeGenPtr cBiomeGen::CreateBiomeGen(cIniFile & a_IniFile, int a_Seed, bool &
 
 
 
-////////////////////////////////////////////////////////////////////////////////
-// Performance tests:
-
-// Change to 1 to enable the perf test:
-#if 0
-
-class cBioGenPerfTest
-{
-public:
-	cBioGenPerfTest()
-	{
-		std::cout << "BioGen performance tests commencing, please wait..." << std::endl;
-		TestGen("MultiStepMap", std::make_unique<cBioGenMultiStepMap>(1).get());
-		TestGen("Grown",        std::make_unique<cBioGenGrown>(1).get());
-		TestGen("GrownProt",    std::make_unique<cBioGenProtGrown>(1).get());
-		std::cout << "BioGen performance tests complete." << std::endl;
-	}
-
-protected:
-	void TestGen(const AString && a_GenName, cBiomeGen * a_BioGen)
-	{
-		// Initialize the default settings for the generator:
-		cIniFile iniFile;
-		a_BioGen->InitializeBiomeGen(iniFile);
-
-		// Generate the biomes:
-		auto start = std::chrono::system_clock::now();
-		for (int z = 0; z < 100; z++)
-		{
-			for (int x = 0; x < 100; x++)
-			{
-				cChunkDef::BiomeMap biomes;
-				a_BioGen->GenBiomes(x, z, biomes);
-			}  // for x
-		}  // for z
-		auto dur = std::chrono::system_clock::now() - start;
-		double milliseconds = static_cast<double>((std::chrono::duration_cast<std::chrono::milliseconds>(dur)).count());
-
-		std::cout << a_GenName << ": " << 1000.0 * 100.0 * 100.0 / milliseconds << " chunks per second" << std::endl;
-	}
-} g_BioGenPerfTest;
-
-#endif
-
-
-
-
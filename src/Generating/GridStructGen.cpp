@@ -54,7 +54,8 @@ cGridStructGen::cGridStructGen(
 	m_MaxOffsetZ(a_MaxOffsetZ),
 	m_MaxStructureSizeX(a_MaxStructureSizeX),
 	m_MaxStructureSizeZ(a_MaxStructureSizeZ),
-	m_MaxCacheSize(a_MaxCacheSize)
+	m_MaxCacheSize(a_MaxCacheSize),
+	m_CacheCost(0)
 {
 	if (m_GridSizeX == 0)
 	{
@@ -91,7 +92,8 @@ cGridStructGen::cGridStructGen(int a_Seed):
 	m_MaxOffsetZ(128),
 	m_MaxStructureSizeX(128),
 	m_MaxStructureSizeZ(128),
-	m_MaxCacheSize(256)
+	m_MaxCacheSize(256),
+	m_CacheCost(0)
 {
 }
 
@@ -141,75 +143,46 @@ void cGridStructGen::GetStructuresForChunk(int a_ChunkX, int a_ChunkZ, cStructur
 	int MinGridZ = MinBlockZ / m_GridSizeZ;
 	int MaxGridX = (MaxBlockX + m_GridSizeX - 1) / m_GridSizeX;
 	int MaxGridZ = (MaxBlockZ + m_GridSizeZ - 1) / m_GridSizeZ;
-	int MinX = MinGridX * m_GridSizeX;
-	int MaxX = MaxGridX * m_GridSizeX;
-	int MinZ = MinGridZ * m_GridSizeZ;
-	int MaxZ = MaxGridZ * m_GridSizeZ;
 
-	// Walk the cache, move each structure that we want into a_Structures:
-	for (cStructurePtrs::iterator itr = m_Cache.begin(), end = m_Cache.end(); itr != end;)
-	{
-		if (
-			((*itr)->m_GridX >= MinX) && ((*itr)->m_GridX < MaxX) &&
-			((*itr)->m_GridZ >= MinZ) && ((*itr)->m_GridZ < MaxZ)
-		)
-		{
-			// want
-			a_Structures.push_back(*itr);
-			itr = m_Cache.erase(itr);
-		}
-		else
-		{
-			// don't want
-			++itr;
-		}
-	}  // for itr - m_Cache[]
-
-	// Create those structures that haven't been in the cache:
+	// Look up each grid cell in the cache, create the structures that aren't there yet:
 	for (int x = MinGridX; x < MaxGridX; x++)
 	{
 		int GridX = x * m_GridSizeX;
 		for (int z = MinGridZ; z < MaxGridZ; z++)
 		{
 			int GridZ = z * m_GridSizeZ;
-			bool Found = false;
-			for (cStructurePtrs::const_iterator itr = a_Structures.begin(), end = a_Structures.end(); itr != end; ++itr)
+			auto Key = MakeCacheKey(GridX, GridZ);
+			auto itr = m_CacheIndex.find(Key);
+			if (itr != m_CacheIndex.end())
 			{
-				if (((*itr)->m_GridX == GridX) && ((*itr)->m_GridZ == GridZ))
-				{
-					Found = true;
-					break;
-				}
-			}  // for itr - a_Structures[]
-			if (!Found)
+				// Cached, move it to the front of the cache as the most recently used:
+				m_Cache.splice(m_Cache.begin(), m_Cache, itr->second);
+				a_Structures.push_back(*itr->second);
+				continue;
+			}
+
+			int OriginX = GridX + ((m_Noise.IntNoise2DInt(GridX + 3, GridZ + 5) / 7) % (m_MaxOffsetX * 2)) - m_MaxOffsetX;
+			int OriginZ = GridZ + ((m_Noise.IntNoise2DInt(GridX + 5, GridZ + 3) / 7) % (m_MaxOffsetZ * 2)) - m_MaxOffsetZ;
+			cStructurePtr Structure = CreateStructure(GridX, GridZ, OriginX, OriginZ);
+			if (Structure.get() == nullptr)
 			{
-				int OriginX = GridX + ((m_Noise.IntNoise2DInt(GridX + 3, GridZ + 5) / 7) % (m_MaxOffsetX * 2)) - m_MaxOffsetX;
-				int OriginZ = GridZ + ((m_Noise.IntNoise2DInt(GridX + 5, GridZ + 3) / 7) % (m_MaxOffsetZ * 2)) - m_MaxOffsetZ;
-				cStructurePtr Structure = CreateStructure(GridX, GridZ, OriginX, OriginZ);
-				if (Structure.get() == nullptr)
-				{
-					Structure.reset(new cEmptyStructure(GridX, GridZ, OriginX, OriginZ));
-				}
-				a_Structures.push_back(Structure);
+				Structure.reset(new cEmptyStructure(GridX, GridZ, OriginX, OriginZ));
 			}
+			a_Structures.push_back(Structure);
+			m_CacheCost += Structure->GetCacheCost();
+			m_Cache.push_front(std::move(Structure));
+			m_CacheIndex[Key] = m_Cache.begin();
 		}  // for z
 	}  // for x
 
-	// Copy a_Forts into m_Cache to the beginning:
-	cStructurePtrs StructuresCopy (a_Structures);
-	m_Cache.splice(m_Cache.begin(), StructuresCopy, StructuresCopy.begin(), StructuresCopy.end());
-
-	// Trim the cache if it's too long:
-	size_t CacheSize = 0;
-	for (cStructurePtrs::iterator itr = m_Cache.begin(), end = m_Cache.end(); itr != end; ++itr)
+	// Trim the cache from its least-recently-used end if it's too large.
+	// The structures for this chunk are at the front and are kept alive by a_Structures even if they get trimmed:
+	while ((m_CacheCost > m_MaxCacheSize) && !m_Cache.empty())
 	{
-		CacheSize += (*itr)->GetCacheCost();
-		if (CacheSize > m_MaxCacheSize)
-		{
-			// Erase all items from this one till the cache end
-			m_Cache.erase(itr, m_Cache.end());
-			break;
-		}
+		const auto & Oldest = m_Cache.back();
+		m_CacheCost -= Oldest->GetCacheCost();
+		m_CacheIndex.erase(MakeCacheKey(Oldest->m_GridX, Oldest->m_GridZ));
+		m_Cache.pop_back();
 	}
 }
 
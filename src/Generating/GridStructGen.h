@@ -11,6 +11,7 @@
 
 #include "ComposableGenerator.h"
 #include "../Noise/Noise.h"
+#include <unordered_map>
 
 
 
@@ -29,9 +30,11 @@ which it's built (m_OriginX, m_OriginZ).
 This class provides a cache for the structures generated for successive chunks and manages that cache. It
 also provides the cFinishGen override that uses the cache to actually generate the structure into chunk data.
 
+The cache is indexed by the grid coords, so that each chunk only looks up the grid cells that it touches.
 After generating each chunk the cache is checked for size, each item in the cache has a cost associated with
 it and the cache is trimmed (from its least-recently-used end) so that the sum of the cost in the cache is
-less than m_MaxCacheSize
+less than m_MaxCacheSize.
+Each generator instance is used only by its world's generator thread, so the cache needs no locking.
 
 To use this class, declare a descendant class that implements the overridable methods, then create an
 instance of that class. The descendant must provide the CreateStructure() function that is called to generate
@@ -137,6 +140,13 @@ protected:
 	/** Cache for the most recently generated structures, ordered by the recentness. */
 	cStructurePtrs m_Cache;
 
+	/** Index into m_Cache by the structure's grid coords, as returned by MakeCacheKey().
+	Lets GetStructuresForChunk() look up only the grid cells it needs instead of walking the whole cache. */
+	std::unordered_map<Int64, cStructurePtrs::iterator> m_CacheIndex;
+
+	/** Sum of the cache costs of all the structures in m_Cache. */
+	size_t m_CacheCost;
+
 
 	/** Clears everything from the cache */
 	void ClearCache(void);
@@ -146,6 +156,12 @@ protected:
 	around their gridpoint intersects the chunk. */
 	void GetStructuresForChunk(int a_ChunkX, int a_ChunkZ, cStructurePtrs & a_Structures);
 
+	/** Returns the key into m_CacheIndex for the structure at the specified grid coords. */
+	static Int64 MakeCacheKey(int a_GridX, int a_GridZ)
+	{
+		return static_cast<Int64>((static_cast<UInt64>(static_cast<UInt32>(a_GridX)) << 32) | static_cast<UInt32>(a_GridZ));
+	}
+
 	// Functions for the descendants to override:
 	/** Create a new structure at the specified gridpoint */
 	virtual cStructurePtr CreateStructure(int a_GridX, int a_GridZ, int a_OriginX, int a_OriginZ) = 0;
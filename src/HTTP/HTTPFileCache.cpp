@@ -0,0 +1,191 @@
+
+// HTTPFileCache.cpp
+
+// Implements the cHTTPFileCache class that keeps the static files served over HTTP in memory, together with their validators
+
+#include "Globals.h"
+#include "HTTPFileCache.h"
+#include "HTTPMessage.h"
+#include "../StringCompression.h"
+
+
+
+
+
+cHTTPFileCache::cHTTPFileCache(void):
+	m_CachedSize(0)
+{
+}
+
+
+
+
+
+cHTTPFileCache::sFilePtr cHTTPFileCache::GetFile(const AString & a_FileName, bool a_ShouldCompress)
+{
+	// A single stat() call both checks that the file exists and tells whether the cached copy is still valid:
+	struct stat st;
+	if ((stat(a_FileName.c_str(), &st) != 0) || ((st.st_mode & S_IFMT) != S_IFREG))
+	{
+		cCSLock Lock(m_CS);
+		auto itr = m_Files.find(a_FileName);
+		if (itr != m_Files.end())
+		{
+			m_CachedSize -= itr->second->m_Contents.size() + itr->second->m_GzipContents.size();
+			m_Files.erase(itr);
+		}
+		return nullptr;
+	}
+	auto ModificationTime = st.st_mtime;
+	auto Size = static_cast<Int64>(st.st_size);
+	{
+		cCSLock Lock(m_CS);
+		auto itr = m_Files.find(a_FileName);
+		if (
+			(itr != m_Files.end()) &&
+			(itr->second->m_ModificationTime == ModificationTime) &&
+			(itr->second->m_Size == Size)
+		)
+		{
+			return itr->second;
+		}
+	}
+
+	// Not cached, or changed since. Read the file without holding the lock, so that other requests aren't blocked:
+	auto File = ReadFile(a_FileName, ModificationTime, Size, a_ShouldCompress);
+	if (File == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Replace the old copy, if any, and store the new one if it fits:
+	cCSLock Lock(m_CS);
+	auto itr = m_Files.find(a_FileName);
+	if (itr != m_Files.end())
+	{
+		m_CachedSize -= itr->second->m_Contents.size() + itr->second->m_GzipContents.size();
+		m_Files.erase(itr);
+	}
+	size_t Cost = File->m_Contents.size() + File->m_GzipContents.size();
+	if ((File->m_Contents.size() <= MAX_FILE_SIZE) && (m_CachedSize + Cost <= MAX_CACHE_SIZE))
+	{
+		m_Files[a_FileName] = File;
+		m_CachedSize += Cost;
+	}
+	return File;
+}
+
+
+
+
+
+AString cHTTPFileCache::FormatHTTPDate(time_t a_Time)
+{
+	static const char * DayNames[] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
+	static const char * MonthNames[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+	struct tm stm;
+	#ifdef _MSC_VER
+		gmtime_s(&stm, &a_Time);
+	#else
+		gmtime_r(&a_Time, &stm);
+	#endif
+
+	// Don't use strftime(), the day and month names must not depend on the locale:
+	return Printf("%s, %02d %s %04d %02d:%02d:%02d GMT",
+		DayNames[stm.tm_wday], stm.tm_mday, MonthNames[stm.tm_mon], stm.tm_year + 1900,
+		stm.tm_hour, stm.tm_min, stm.tm_sec
+	);
+}
+
+
+
+
+
+bool cHTTPFileCache::DoesAcceptGzip(const cHTTPIncomingRequest & a_Request)
+{
+	auto Encodings = StringSplitAndTrim(a_Request.GetHeader("Accept-Encoding"), ",");
+	for (const auto & Encoding : Encodings)
+	{
+		// Strip the parameters, but honor the explicit refusal ("gzip;q=0"):
+		auto Params = StringSplitAndTrim(Encoding, ";");
+		if (Params.empty() || (NoCaseCompare(Params[0], "gzip") != 0))
+		{
+			continue;
+		}
+		if ((Params.size() >= 2) && (Params[1].compare(0, 2, "q=") == 0))
+		{
+			return (atof(Params[1].c_str() + 2) > 0);
+		}
+		return true;
+	}
+	return false;
+}
+
+
+
+
+
+bool cHTTPFileCache::IsNotModified(const cHTTPIncomingRequest & a_Request, const AString & a_ETag, const AString & a_LastModified)
+{
+	// If-None-Match takes precedence over If-Modified-Since (RFC 7232, section 6):
+	auto IfNoneMatch = a_Request.GetHeader("If-None-Match");
+	if (!IfNoneMatch.empty())
+	{
+		auto Tags = StringSplitAndTrim(IfNoneMatch, ",");
+		for (const auto & Tag : Tags)
+		{
+			// Weak comparison is used for If-None-Match:
+			if ((Tag == "*") || (Tag == a_ETag) || ((Tag.compare(0, 2, "W/") == 0) && (Tag.compare(2, AString::npos, a_ETag) == 0)))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// The browsers send back the exact Last-Modified value they received, no need to parse the dates:
+	auto IfModifiedSince = a_Request.GetHeader("If-Modified-Since");
+	return (!IfModifiedSince.empty() && (IfModifiedSince == a_LastModified));
+}
+
+
+
+
+
+cHTTPFileCache::sFilePtr cHTTPFileCache::ReadFile(const AString & a_FileName, time_t a_ModificationTime, Int64 a_Size, bool a_ShouldCompress)
+{
+	cFile f(a_FileName, cFile::fmRead);
+	if (!f.IsOpen())
+	{
+		return nullptr;
+	}
+	auto File = std::make_shared<sFile>();
+	if (f.ReadRestOfFile(File->m_Contents) == -1)
+	{
+		return nullptr;
+	}
+	File->m_ModificationTime = a_ModificationTime;
+	File->m_Size = a_Size;
+	File->m_ETag = Printf("\"%llx-%llx\"", static_cast<unsigned long long>(a_ModificationTime), static_cast<unsigned long long>(a_Size));
+	File->m_LastModified = FormatHTTPDate(a_ModificationTime);
+
+	// Only keep the compressed copy if it actually saves something:
+	if (a_ShouldCompress && !File->m_Contents.empty())
+	{
+		AString Compressed;
+		if (
+			(CompressStringGZIP(File->m_Contents.data(), File->m_Contents.size(), Compressed) == Z_OK) &&
+			(Compressed.size() < File->m_Contents.size())
+		)
+		{
+			std::swap(File->m_GzipContents, Compressed);
+			File->m_GzipETag = Printf("\"%llx-%llx-gz\"", static_cast<unsigned long long>(a_ModificationTime), static_cast<unsigned long long>(a_Size));
+		}
+	}
+	return File;
+}
+
+
+
+
@@ -0,0 +1,102 @@
+
+// HTTPFileCache.h
+
+// Declares the cHTTPFileCache class that keeps the static files served over HTTP in memory, together with their validators
+
+
+
+
+
+#pragma once
+
+
+
+
+
+// fwd:
+class cHTTPIncomingRequest;
+
+
+
+
+
+/** Keeps the contents of files served over HTTP in memory, so that repeated requests don't hit the disk.
+Each request still stats the file, and a file whose size or modification time has changed is re-read.
+Alongside the contents, the cache keeps the validators for the conditional requests (ETag, Last-Modified),
+and optionally a gzip-compressed copy of the contents, for the clients that accept it.
+Files larger than MAX_FILE_SIZE, or those that don't fit into the total budget, are read from disk on each request.
+Thread-safe; the returned files are immutable and shared, so they can be sent while the cache gets updated. */
+class cHTTPFileCache
+{
+public:
+
+	/** A single file, as served over HTTP. */
+	struct sFile
+	{
+		/** The contents of the file. */
+		AString m_Contents;
+
+		/** The contents compressed by gzip, or empty if compression wasn't requested or didn't make the file smaller. */
+		AString m_GzipContents;
+
+		/** The strong entity tag for m_Contents, including the quotes. */
+		AString m_ETag;
+
+		/** The entity tag for m_GzipContents; a different representation must have a different tag. */
+		AString m_GzipETag;
+
+		/** The file's modification time formatted as a HTTP date, for the Last-Modified header. */
+		AString m_LastModified;
+
+		/** The file's modification time and size when it was read, used to detect changes. */
+		time_t m_ModificationTime;
+		Int64 m_Size;
+	};
+
+	using sFilePtr = std::shared_ptr<const sFile>;
+
+
+	/** Maximum size of a single file to keep in the cache. */
+	static constexpr size_t MAX_FILE_SIZE = 1 MiB;
+
+	/** Maximum size of all the cached contents, including the compressed copies. */
+	static constexpr size_t MAX_CACHE_SIZE = 16 MiB;
+
+
+	cHTTPFileCache(void);
+
+	/** Returns the specified file, from the cache if it hasn't changed since it was cached, or read from disk.
+	If a_ShouldCompress is true, a gzipped copy of the contents is prepared as well; it should be set for the text files.
+	Returns nullptr if the file doesn't exist or cannot be read. */
+	sFilePtr GetFile(const AString & a_FileName, bool a_ShouldCompress);
+
+	/** Formats the specified time as a HTTP date (RFC 7231), such as "Sun, 06 Nov 1994 08:49:37 GMT". */
+	static AString FormatHTTPDate(time_t a_Time);
+
+	/** Returns true if the request's Accept-Encoding header allows a gzip-compressed response. */
+	static bool DoesAcceptGzip(const cHTTPIncomingRequest & a_Request);
+
+	/** Returns true if the request is conditional and its validators (If-None-Match, If-Modified-Since)
+	match the specified ones, so that the client's cached copy can be used. */
+	static bool IsNotModified(const cHTTPIncomingRequest & a_Request, const AString & a_ETag, const AString & a_LastModified);
+
+protected:
+
+	/** Protects m_Files and m_CachedSize against multithreaded access. */
+	cCriticalSection m_CS;
+
+	/** The cached files, mapped by their filename. */
+	std::map<AString, sFilePtr> m_Files;
+
+	/** The total size of the contents of all files in m_Files, both plain and compressed. */
+	size_t m_CachedSize;
+
+
+	/** Reads the file from disk and prepares its validators and compressed copy.
+	Returns nullptr if the file cannot be read. */
+	static sFilePtr ReadFile(const AString & a_FileName, time_t a_ModificationTime, Int64 a_Size, bool a_ShouldCompress);
+};
+
+
+
+
@@ -66,6 +66,20 @@ void cHTTPMessage::AddHeader(const AString & a_Key, const AString & a_Value)
 
 
 
+AString cHTTPMessage::GetHeader(const AString & a_Key) const
+{
+	auto itr = m_Headers.find(StrToLower(a_Key));
+	if (itr == m_Headers.end())
+	{
+		return AString();
+	}
+	return itr->second;
+}
+
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // cHTTPOutgoingResponse:
 
@@ -83,9 +97,19 @@ void cHTTPOutgoingResponse::AppendToData(AString & a_DataStream) const
 	a_DataStream.append("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\nContent-Type: ");
 	a_DataStream.append(m_ContentType);
 	a_DataStream.append("\r\n");
+	AppendHeadersToData(a_DataStream);
+}
+
+
+
+
+
+void cHTTPOutgoingResponse::AppendHeadersToData(AString & a_DataStream) const
+{
+	// The header keys are stored lowercased:
 	for (auto itr = m_Headers.cbegin(), end = m_Headers.cend(); itr != end; ++itr)
 	{
-		if ((itr->first == "Content-Type") || (itr->first == "Content-Length"))
+		if ((itr->first == "content-type") || (itr->first == "content-length"))
 		{
 			continue;
 		}
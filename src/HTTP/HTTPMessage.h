@@ -42,6 +42,9 @@ public:
 	const AString & GetContentType  (void) const { return m_ContentType; }
 	size_t          GetContentLength(void) const { return m_ContentLength; }
 
+	/** Returns the value of the specified header (case-insensitive), or an empty string if the header is not present. */
+	AString GetHeader(const AString & a_Key) const;
+
 protected:
 
 	using cNameValueMap = std::map<AString, AString>;
@@ -78,6 +81,10 @@ public:
 	/** Appends the response to the specified datastream - response line and headers.
 	The body will be sent later directly through cConnection::Send() */
 	void AppendToData(AString & a_DataStream) const;
+
+	/** Appends the headers other than Content-Type and Content-Length to the specified datastream,
+	including the empty line that terminates the headers. */
+	void AppendHeadersToData(AString & a_DataStream) const;
 } ;
 
 
@@ -58,6 +58,20 @@ void cHTTPServerConnection::SendNeedAuth(const AString & a_Realm)
 
 
 
+void cHTTPServerConnection::SendNotModified(const cHTTPOutgoingResponse & a_Response)
+{
+	ASSERT(m_CurrentRequest != nullptr);
+	AString toSend("HTTP/1.1 304 Not Modified\r\n");
+	a_Response.AppendHeadersToData(toSend);
+	SendData(toSend);
+	m_CurrentRequest.reset();
+	m_Parser.Reset();
+}
+
+
+
+
+
 void cHTTPServerConnection::Send(const cHTTPOutgoingResponse & a_Response)
 {
 	ASSERT(m_CurrentRequest != nullptr);
@@ -44,6 +44,10 @@ public:
 	Clears the current request (since it's finished by this call). */
 	void SendNeedAuth(const AString & a_Realm);
 
+	/** Sends the "304 Not Modified" reply together with the headers contained in a_Response (validators, caching), with no body.
+	Finishes the response, there's no need to call FinishResponse(). */
+	void SendNotModified(const cHTTPOutgoingResponse & a_Response);
+
 	/** Sends the headers contained in a_Response */
 	void Send(const cHTTPOutgoingResponse & a_Response);
 
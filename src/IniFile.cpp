@@ -238,15 +238,12 @@ bool cIniFile::WriteFile(const AString & a_FileName) const
 
 int cIniFile::FindKey(const AString & a_KeyName) const
 {
-	AString CaseKeyName = CheckCase(a_KeyName);
-	for (size_t keyID = 0; keyID < m_Names.size(); ++keyID)
+	auto itr = m_KeyIndex.find(CheckCase(a_KeyName));
+	if (itr == m_KeyIndex.end())
 	{
-		if (CheckCase(m_Names[keyID]) == CaseKeyName)
-		{
-			return static_cast<int>(keyID);
-		}
+		return noID;
 	}
-	return noID;
+	return itr->second;
 }
 
 
@@ -255,20 +252,18 @@ int cIniFile::FindKey(const AString & a_KeyName) const
 
 int cIniFile::FindValue(const int keyID, const AString & a_ValueName) const
 {
-	if (!m_Keys.size() || (keyID >= static_cast<int>(m_Keys.size())))
+	if ((keyID < 0) || (keyID >= static_cast<int>(m_Keys.size())))
 	{
 		return noID;
 	}
 
-	AString CaseValueName = CheckCase(a_ValueName);
-	for (size_t valueID = 0; valueID < m_Keys[static_cast<size_t>(keyID)].m_Names.size(); ++valueID)
+	const auto & Index = m_Keys[static_cast<size_t>(keyID)].m_NameIndex;
+	auto itr = Index.find(CheckCase(a_ValueName));
+	if (itr == Index.end())
 	{
-		if (CheckCase(m_Keys[static_cast<size_t>(keyID)].m_Names[valueID]) == CaseValueName)
-		{
-			return int(valueID);
-		}
+		return noID;
 	}
-	return noID;
+	return itr->second;
 }
 
 
@@ -279,7 +274,9 @@ int cIniFile::AddKeyName(const AString & keyname)
 {
 	m_Names.resize(m_Names.size() + 1, keyname);
 	m_Keys.resize(m_Keys.size() + 1);
-	return static_cast<int>(m_Names.size()) - 1;
+	int keyID = static_cast<int>(m_Names.size()) - 1;
+	m_KeyIndex.emplace(CheckCase(keyname), keyID);  // Doesn't replace an existing key of the same name
+	return keyID;
 }
 
 
@@ -364,8 +361,10 @@ void cIniFile::AddValue(const AString & a_KeyName, const AString & a_ValueName,
 		keyID = int(AddKeyName(a_KeyName));
 	}
 
-	m_Keys[static_cast<size_t>(keyID)].m_Names.push_back(a_ValueName);
-	m_Keys[static_cast<size_t>(keyID)].m_Values.push_back(a_Value);
+	auto & Key = m_Keys[static_cast<size_t>(keyID)];
+	Key.m_Names.push_back(a_ValueName);
+	Key.m_Values.push_back(a_Value);
+	Key.m_NameIndex.emplace(CheckCase(a_ValueName), static_cast<int>(Key.m_Names.size()) - 1);  // Doesn't replace an existing value of the same name
 }
 
 
@@ -423,8 +422,7 @@ bool cIniFile::SetValue(const AString & a_KeyName, const AString & a_ValueName,
 		{
 			return false;
 		}
-		m_Keys[static_cast<size_t>(keyID)].m_Names.push_back(a_ValueName);
-		m_Keys[static_cast<size_t>(keyID)].m_Values.push_back(a_Value);
+		AddValue(a_KeyName, a_ValueName, a_Value);
 	}
 	else
 	{
@@ -593,6 +591,7 @@ bool cIniFile::DeleteValueByID(const int keyID, const int valueID)
 		vector<AString>::iterator vpos = m_Keys[static_cast<size_t>(keyID)].m_Values.begin() + valueID;
 		m_Keys[static_cast<size_t>(keyID)].m_Names.erase(npos, npos + 1);
 		m_Keys[static_cast<size_t>(keyID)].m_Values.erase(vpos, vpos + 1);
+		RebuildValueIndex(m_Keys[static_cast<size_t>(keyID)]);
 		return true;
 	}
 	return false;
@@ -636,6 +635,9 @@ bool cIniFile::DeleteKey(const AString & keyname)
 	m_Names.erase(npos, npos + 1);
 	m_Keys.erase(kpos, kpos + 1);
 
+	// The following keys have shifted, reindex:
+	RebuildKeyIndex();
+
 	return true;
 }
 
@@ -648,6 +650,7 @@ void cIniFile::Clear(void)
 	m_Names.clear();
 	m_Keys.clear();
 	m_Comments.clear();
+	m_KeyIndex.clear();
 }
 
 
@@ -868,6 +871,45 @@ AString cIniFile::CheckCase(const AString & s) const
 
 
 
+void cIniFile::RebuildIndex(void)
+{
+	RebuildKeyIndex();
+	for (auto & Key : m_Keys)
+	{
+		RebuildValueIndex(Key);
+	}
+}
+
+
+
+
+
+void cIniFile::RebuildKeyIndex(void)
+{
+	m_KeyIndex.clear();
+	for (size_t i = 0; i < m_Names.size(); i++)
+	{
+		m_KeyIndex.emplace(CheckCase(m_Names[i]), static_cast<int>(i));
+	}
+}
+
+
+
+
+
+void cIniFile::RebuildValueIndex(key & a_Key)
+{
+	a_Key.m_NameIndex.clear();
+	for (size_t i = 0; i < a_Key.m_Names.size(); i++)
+	{
+		a_Key.m_NameIndex.emplace(CheckCase(a_Key.m_Names[i]), static_cast<int>(i));
+	}
+}
+
+
+
+
+
 void cIniFile::RemoveBom(AString & a_line) const
 {
 	// The BOM sequence for UTF-8 is 0xEF, 0xBB, 0xBF
@@ -20,6 +20,8 @@
 
 #include "SettingsRepositoryInterface.h"
 
+#include <unordered_map>
+
 #define MAX_KEYNAME    128
 #define MAX_VALUENAME  128
 #define MAX_VALUEDATA 2048
@@ -49,15 +51,34 @@ private:
 		std::vector<AString> m_Names;
 		std::vector<AString> m_Values;
 		std::vector<AString> m_Comments;
+
+		/** Maps each value name, as returned by CheckCase(), to its index in m_Names.
+		For duplicate names, the first one is indexed, same as a linear search would find. */
+		std::unordered_map<AString, int> m_NameIndex;
 	} ;
 
 	std::vector<key>     m_Keys;
 	std::vector<AString> m_Names;
 	std::vector<AString> m_Comments;
 
+	/** Maps each key name, as returned by CheckCase(), to its index in m_Names.
+	For duplicate names, the first one is indexed. Makes FindKey() and FindValue() constant-time, the settings are
+	looked up this way many times when loading the server and the worlds. */
+	std::unordered_map<AString, int> m_KeyIndex;
+
 	/** If the object is case-insensitive, returns s as lowercase; otherwise returns s as-is */
 	AString CheckCase(const AString & s) const;
 
+	/** Rebuilds m_KeyIndex and the value indices of all keys.
+	Needed when the names' positions shift due to a deletion, or when the case sensitivity changes. */
+	void RebuildIndex(void);
+
+	/** Rebuilds m_KeyIndex from m_Names. */
+	void RebuildKeyIndex(void);
+
+	/** Rebuilds the value index of the specified key. */
+	void RebuildValueIndex(key & a_Key);
+
 	/** Removes the UTF-8 BOMs (Byte order makers), if present. */
 	void RemoveBom(AString & a_line) const;
 
@@ -87,8 +108,8 @@ public:
 
 	// Sets whether or not keynames and valuenames should be case sensitive.
 	// The default is case insensitive.
-	void CaseSensitive  (void) { m_IsCaseInsensitive = false; }
-	void CaseInsensitive(void) { m_IsCaseInsensitive = true; }
+	void CaseSensitive  (void) { m_IsCaseInsensitive = false; RebuildIndex(); }
+	void CaseInsensitive(void) { m_IsCaseInsensitive = true;  RebuildIndex(); }
 
 	/** Reads the contents of the specified ini file
 	If the file doesn't exist and a_AllowExampleRedirect is true, tries to read <basename>.example.ini, and
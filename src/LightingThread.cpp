@@ -5,25 +5,31 @@
 
 #include "Globals.h"
 #include "LightingThread.h"
+#include "ChunkDataCallback.h"
 #include "ChunkMap.h"
 #include "World.h"
 #include "BlockInfo.h"
+#include "Metrics.h"
 
 
 
 
 
-/** Chunk data callback that takes the chunk data and puts them into cLightingThread's m_BlockTypes[] / m_HeightMap[]: */
+/** Chunk data callback that takes the chunk data and puts them into cLightingThread's m_BlockTypes[] / m_HeightMap[].
+The block types are only snapshotted while the chunkmap is locked, and then copied by CopyBlockTypes() once the lock is released. */
 class cReader :
-	public cChunkDataCallback
+	public cChunkDataCopyCollector
 {
-	virtual void ChunkData(const cChunkData & a_ChunkBuffer) override
+public:
+
+	/** Copies the block types snapshotted from the last chunk read into m_BlockTypes and releases the snapshot. */
+	void CopyBlockTypes(void)
 	{
 		BLOCKTYPE * OutputRows = m_BlockTypes;
 		int OutputIdx = m_ReadingChunkX + m_ReadingChunkZ * cChunkDef::Width * 3;
 		for (size_t i = 0; i != cChunkData::NumSections; ++i)
 		{
-			auto * Section = a_ChunkBuffer.GetSection(i);
+			auto * Section = m_Data.GetSection(i);
 			if (Section == nullptr)
 			{
 				// Skip to the next section
@@ -45,8 +51,10 @@ class cReader :
 				OutputIdx += cChunkDef::Width * 6;
 			}
 		}
-	}  // BlockTypes()
+		m_Data.Clear();
+	}
 
+protected:
 
 	virtual void HeightMap(const cChunkDef::HeightMap * a_Heightmap) override
 	{
@@ -102,6 +110,14 @@ public:
 cLightingThread::cLightingThread(cWorld & a_World):
 	Super("cLightingThread"),
 	m_World(a_World),
+	m_ChunksLitMetric(cMetrics::Get().GetCounter(
+		"cuberite_chunks_lit_total", "Number of chunks lit by the lighting thread.",
+		cMetrics::Label("world", a_World.GetName())
+	)),
+	m_LightingMicrosecondsMetric(cMetrics::Get().GetCounter(
+		"cuberite_chunk_lighting_microseconds_total", "Time the lighting thread spent lighting the chunks, in microseconds.",
+		cMetrics::Label("world", a_World.GetName())
+	)),
 	m_MaxHeight(0),
 	m_NumSeeds(0)
 {
@@ -187,6 +203,24 @@ size_t cLightingThread::GetQueueLength(void)
 
 
 
+UInt64 cLightingThread::GetNumChunksLit(void) const
+{
+	return m_ChunksLitMetric.GetValue();
+}
+
+
+
+
+
+UInt64 cLightingThread::GetLightingMicroseconds(void) const
+{
+	return m_LightingMicrosecondsMetric.GetValue();
+}
+
+
+
+
+
 void cLightingThread::Execute(void)
 {
 	for (;;)
@@ -243,6 +277,7 @@ void cLightingThread::LightChunk(cLightingChunkStay & a_Item)
 		return;
 	}
 
+	auto StartTime = std::chrono::steady_clock::now();
 	cChunkDef::BlockNibbles BlockLight, SkyLight;
 
 	ReadChunks(a_Item.m_ChunkX, a_Item.m_ChunkZ);
@@ -316,6 +351,8 @@ void cLightingThread::LightChunk(cLightingChunkStay & a_Item)
 	CompressLight(m_SkyLight, SkyLight);
 
 	m_World.ChunkLighted(a_Item.m_ChunkX, a_Item.m_ChunkZ, BlockLight, SkyLight);
+	m_ChunksLitMetric.Add();
+	m_LightingMicrosecondsMetric.Add(static_cast<UInt64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count()));
 
 	if (a_Item.m_CallbackAfter != nullptr)
 	{
@@ -338,6 +375,7 @@ void cLightingThread::ReadChunks(int a_ChunkX, int a_ChunkZ)
 		{
 			Reader.m_ReadingChunkX = x;
 			VERIFY(m_World.GetChunkData({a_ChunkX + x - 1, a_ChunkZ + z - 1}, Reader));
+			Reader.CopyBlockTypes();
 		}  // for z
 	}  // for x
 
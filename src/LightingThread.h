@@ -40,6 +40,7 @@ Chunks from m_PostponedQueue are moved back into m_Queue when their neighbors ge
 
 // fwd: "cWorld.h"
 class cWorld;
+class cMetricCounter;
 
 
 
@@ -66,6 +67,12 @@ public:
 
 	size_t GetQueueLength(void);
 
+	/** Returns the number of chunks lit by this thread so far. */
+	UInt64 GetNumChunksLit(void) const;
+
+	/** Returns the total time this thread has spent lighting chunks so far, in microseconds. */
+	UInt64 GetLightingMicroseconds(void) const;
+
 protected:
 
 	class cLightingChunkStay :
@@ -94,6 +101,12 @@ protected:
 
 	cWorld & m_World;
 
+	/** Counts the chunks lit by this thread, exported through cMetrics. */
+	cMetricCounter & m_ChunksLitMetric;
+
+	/** Counts the time spent lighting the chunks, in microseconds, exported through cMetrics. */
+	cMetricCounter & m_LightingMicrosecondsMetric;
+
 	/** The mutex to protect m_Queue and m_PendingQueue */
 	cCriticalSection m_CS;
 
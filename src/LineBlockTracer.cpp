@@ -14,6 +14,57 @@
 
 
 
+namespace
+{
+	/** Callbacks for FirstSolidHitTrace(): stop at the first solid block and calculate the exact hit coords. */
+	class cSolidHitCallbacks:
+		public cBlockTracer::cCallbacks
+	{
+	public:
+		cSolidHitCallbacks(const Vector3d & a_CBStart, const Vector3d & a_CBEnd, Vector3d & a_CBHitCoords, Vector3i & a_CBHitBlockCoords, eBlockFace & a_CBHitBlockFace):
+			m_Start(a_CBStart),
+			m_End(a_CBEnd),
+			m_HitCoords(a_CBHitCoords),
+			m_HitBlockCoords(a_CBHitBlockCoords),
+			m_HitBlockFace(a_CBHitBlockFace)
+		{
+		}
+
+		virtual bool OnNextBlock(Vector3i a_BlockPos, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta, eBlockFace a_EntryFace) override
+		{
+			if (!cBlockInfo::IsSolid(a_BlockType))
+			{
+				return false;
+			}
+
+			// We hit a solid block, calculate the exact hit coords and abort trace:
+			m_HitBlockCoords = a_BlockPos;
+			m_HitBlockFace = a_EntryFace;
+			cBoundingBox bb(a_BlockPos, a_BlockPos + Vector3i(1, 1, 1));  // Bounding box of the block hit
+			double LineCoeff = 0;  // Used to calculate where along the line an intersection with the bounding box occurs
+			eBlockFace Face;  // Face hit
+			if (!bb.CalcLineIntersection(m_Start, m_End, LineCoeff, Face))
+			{
+				// Math rounding errors have caused the calculation to miss the block completely, assume immediate hit
+				LineCoeff = 0;
+			}
+			m_HitCoords = m_Start + (m_End - m_Start) * LineCoeff;  // Point where projectile goes into the hit block
+			return true;
+		}
+
+	protected:
+		const Vector3d & m_Start;
+		const Vector3d & m_End;
+		Vector3d & m_HitCoords;
+		Vector3i & m_HitBlockCoords;
+		eBlockFace & m_HitBlockFace;
+	};
+}
+
+
+
+
+
 cLineBlockTracer::cLineBlockTracer(cWorld & a_World, cCallbacks & a_Callbacks) :
 	Super(a_World, a_Callbacks),
 	m_Start(),
@@ -85,49 +136,24 @@ bool cLineBlockTracer::FirstSolidHitTrace(
 	Vector3i & a_HitBlockCoords, eBlockFace & a_HitBlockFace
 )
 {
-	class cSolidHitCallbacks:
-		public cCallbacks
-	{
-	public:
-		cSolidHitCallbacks(const Vector3d & a_CBStart, const Vector3d & a_CBEnd, Vector3d & a_CBHitCoords, Vector3i & a_CBHitBlockCoords, eBlockFace & a_CBHitBlockFace):
-			m_Start(a_CBStart),
-			m_End(a_CBEnd),
-			m_HitCoords(a_CBHitCoords),
-			m_HitBlockCoords(a_CBHitBlockCoords),
-			m_HitBlockFace(a_CBHitBlockFace)
-		{
-		}
+	cSolidHitCallbacks Callbacks(a_Start, a_End, a_HitCoords, a_HitBlockCoords, a_HitBlockFace);
+	return !Trace(a_World, Callbacks, a_Start, a_End);
+}
 
-		virtual bool OnNextBlock(Vector3i a_BlockPos, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta, eBlockFace a_EntryFace) override
-		{
-			if (!cBlockInfo::IsSolid(a_BlockType))
-			{
-				return false;
-			}
 
-			// We hit a solid block, calculate the exact hit coords and abort trace:
-			m_HitBlockCoords = a_BlockPos;
-			m_HitBlockFace = a_EntryFace;
-			cBoundingBox bb(a_BlockPos, a_BlockPos + Vector3i(1, 1, 1));  // Bounding box of the block hit
-			double LineCoeff = 0;  // Used to calculate where along the line an intersection with the bounding box occurs
-			eBlockFace Face;  // Face hit
-			if (!bb.CalcLineIntersection(m_Start, m_End, LineCoeff, Face))
-			{
-				// Math rounding errors have caused the calculation to miss the block completely, assume immediate hit
-				LineCoeff = 0;
-			}
-			m_HitCoords = m_Start + (m_End - m_Start) * LineCoeff;  // Point where projectile goes into the hit block
-			return true;
-		}
 
-	protected:
-		const Vector3d & m_Start;
-		const Vector3d & m_End;
-		Vector3d & m_HitCoords;
-		Vector3i & m_HitBlockCoords;
-		eBlockFace & m_HitBlockFace;
-	} callbacks(a_Start, a_End, a_HitCoords, a_HitBlockCoords, a_HitBlockFace);
-	return !Trace(a_World, callbacks, a_Start, a_End);
+
+
+bool cLineBlockTracer::FirstSolidHitTrace(
+	cChunk & a_Chunk,
+	const Vector3d & a_Start, const Vector3d & a_End,
+	Vector3d & a_HitCoords,
+	Vector3i & a_HitBlockCoords, eBlockFace & a_HitBlockFace
+)
+{
+	cSolidHitCallbacks Callbacks(a_Start, a_End, a_HitCoords, a_HitBlockCoords, a_HitBlockFace);
+	cLineBlockTracer Tracer(*a_Chunk.GetWorld(), Callbacks);
+	return !Tracer.Trace(a_Chunk, a_Start, a_End);
 }
 
 
@@ -135,6 +161,40 @@ bool cLineBlockTracer::FirstSolidHitTrace(
 
 
 bool cLineBlockTracer::Trace(const Vector3d a_Start, const Vector3d a_End)
+{
+	if (!InitTrace(a_Start, a_End))
+	{
+		return true;
+	}
+
+	// The actual trace is handled with ChunkMapCS locked by calling our ChunkCallback for the specified chunk
+	int BlockX = FloorC(m_Start.x);
+	int BlockZ = FloorC(m_Start.z);
+	int ChunkX, ChunkZ;
+	cChunkDef::BlockToChunk(BlockX, BlockZ, ChunkX, ChunkZ);
+	return m_World->DoWithChunk(ChunkX, ChunkZ, [this](cChunk & a_Chunk) { return ChunkCallback(&a_Chunk); });
+}
+
+
+
+
+
+bool cLineBlockTracer::Trace(cChunk & a_Chunk, const Vector3d a_Start, const Vector3d a_End)
+{
+	if (!InitTrace(a_Start, a_End))
+	{
+		return true;
+	}
+
+	// ChunkCallback() walks the chunk neighbors on its own, any chunk near the start is a good starting point:
+	return ChunkCallback(&a_Chunk);
+}
+
+
+
+
+
+bool cLineBlockTracer::InitTrace(const Vector3d a_Start, const Vector3d a_End)
 {
 	// Initialize the member veriables:
 	m_Start = a_Start;
@@ -151,7 +211,7 @@ bool cLineBlockTracer::Trace(const Vector3d a_Start, const Vector3d a_End)
 		{
 			// Nothing to trace
 			m_Callbacks->OnNoMoreHits();
-			return true;
+			return false;
 		}
 		FixStartBelowWorld();
 		m_Callbacks->OnIntoWorld(m_Start);
@@ -161,7 +221,7 @@ bool cLineBlockTracer::Trace(const Vector3d a_Start, const Vector3d a_End)
 		if (m_End.y >= cChunkDef::Height)
 		{
 			m_Callbacks->OnNoMoreHits();
-			return true;
+			return false;
 		}
 		FixStartAboveWorld();
 		m_Callbacks->OnIntoWorld(m_Start);
@@ -170,13 +230,7 @@ bool cLineBlockTracer::Trace(const Vector3d a_Start, const Vector3d a_End)
 	m_Current = m_Start.Floor();
 
 	m_Diff = m_End -  m_Start;
-
-	// The actual trace is handled with ChunkMapCS locked by calling our ChunkCallback for the specified chunk
-	int BlockX = FloorC(m_Start.x);
-	int BlockZ = FloorC(m_Start.z);
-	int ChunkX, ChunkZ;
-	cChunkDef::BlockToChunk(BlockX, BlockZ, ChunkX, ChunkZ);
-	return m_World->DoWithChunk(ChunkX, ChunkZ, [this](cChunk & a_Chunk) { return ChunkCallback(&a_Chunk); });
+	return true;
 }
 
 
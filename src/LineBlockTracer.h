@@ -47,6 +47,11 @@ public:
 	/** Traces one line between Start and End; returns true if the entire line was traced (until OnNoMoreHits()) */
 	bool Trace(Vector3d a_Start, Vector3d a_End);
 
+	/** Traces one line between Start and End, starting the chunk lookups at a_Chunk instead of looking up the start chunk in the chunkmap.
+	a_Chunk needn't contain a_Start, but should be near it. The caller must hold the chunkmap's CS (e.g. is in a chunk tick).
+	Returns true if the entire line was traced (until OnNoMoreHits()) */
+	bool Trace(cChunk & a_Chunk, Vector3d a_Start, Vector3d a_End);
+
 
 	// Utility functions for simple one-line usage:
 
@@ -71,6 +76,16 @@ public:
 		eBlockFace & a_HitBlockFace
 	);
 
+	/** Same as the cWorld-based FirstSolidHitTrace(), but starts the chunk lookups at a_Chunk.
+	Cheaper for callers that already hold a chunk near a_Start and the chunkmap's CS, such as entity physics. */
+	static bool FirstSolidHitTrace(
+		cChunk & a_Chunk,
+		const Vector3d & a_Start, const Vector3d & a_End,
+		Vector3d & a_HitCoords,
+		Vector3i & a_HitBlockCoords,
+		eBlockFace & a_HitBlockFace
+	);
+
 protected:
 	/** The start point of the trace */
 	Vector3d m_Start;
@@ -91,6 +106,10 @@ protected:
 	eBlockFace m_CurrentFace;
 
 
+	/** Initializes the member variables for tracing from a_Start to a_End and adjusts the start into the world.
+	Returns false if there's nothing to trace; the callbacks have already been notified in such a case. */
+	bool InitTrace(Vector3d a_Start, Vector3d a_End);
+
 	/** Adjusts the start point above the world to just at the world's top */
 	void FixStartAboveWorld(void);
 
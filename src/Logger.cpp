@@ -40,6 +40,234 @@ static void WriteLogOpener(fmt::memory_buffer & Buffer)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+// cLogger::cAsyncWriter:
+
+/** Bounded lock-free multi-producer single-consumer queue of the log lines, drained by its own thread.
+Each slot carries a sequence number telling whether it is free for the producer or filled for the consumer at the current lap,
+so that producers only contend on a single atomic increment and never wait for the listeners.
+The producers only wake the thread up when it is idle, so a burst of lines costs a single event signal. */
+class cLogger::cAsyncWriter:
+	public cIsThread
+{
+	using Super = cIsThread;
+
+public:
+
+	/** Number of lines that can be queued; must be a power of two. */
+	static const size_t QUEUE_SIZE = 4096;
+
+
+	cAsyncWriter(cLogger & a_Logger):
+		Super("cLogger::cAsyncWriter"),
+		m_Logger(a_Logger),
+		m_Slots(new sSlot[QUEUE_SIZE]),
+		m_EnqueuePos(0),
+		m_DequeuePos(0),
+		m_NumDropped(0),
+		m_IsSleeping(false)
+	{
+		for (size_t i = 0; i < QUEUE_SIZE; i++)
+		{
+			m_Slots[i].m_Sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	virtual ~cAsyncWriter() override
+	{
+		Stop();
+	}
+
+	/** Wakes the thread up and waits for it to drain the queue and finish. */
+	void Stop(void)
+	{
+		m_ShouldTerminate = true;
+		m_evtQueued.Set();
+		Super::Stop();
+	}
+
+	/** Queues the line for writing. Returns false if the queue is full. */
+	bool TryPush(std::string_view a_Line, eLogLevel a_LogLevel)
+	{
+		auto Pos = m_EnqueuePos.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			auto & Slot = m_Slots[Pos & (QUEUE_SIZE - 1)];
+			auto Sequence = Slot.m_Sequence.load(std::memory_order_acquire);
+			auto Diff = static_cast<std::intptr_t>(Sequence) - static_cast<std::intptr_t>(Pos);
+			if (Diff == 0)
+			{
+				// The slot is free in this lap, try to claim it:
+				if (m_EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+				{
+					Slot.m_Line.assign(a_Line.data(), a_Line.size());
+					Slot.m_LogLevel = a_LogLevel;
+					Slot.m_Sequence.store(Pos + 1, std::memory_order_release);
+
+					// Wake the thread up only if it is idle; pairs with the fence in Execute():
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					if (m_IsSleeping.load(std::memory_order_relaxed))
+					{
+						m_evtQueued.Set();
+					}
+					return true;
+				}
+			}
+			else if (Diff < 0)
+			{
+				// The slot still holds a line from the previous lap, the queue is full
+				return false;
+			}
+			else
+			{
+				// Another producer has claimed the slot, retry with the current position
+				Pos = m_EnqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/** Counts a line that didn't fit into the queue; the count is reported by the next Drain(). */
+	void AddDropped(void)
+	{
+		m_NumDropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/** Hands all the queued lines over to the logger's listeners. Can be called from any thread.
+	The lines are popped and written under the logger's lock, so there is only ever a single consumer,
+	and the lines reach the listeners in the queue order. All the slots claimed before the call are drained,
+	waiting for the producers still writing into them, so that a line written synchronously after Drain() never overtakes them. */
+	void Drain(void)
+	{
+		cCSLock Lock(m_Logger.m_CriticalSection);
+		auto End = m_EnqueuePos.load(std::memory_order_relaxed);
+		AString Line;
+		eLogLevel LogLevel;
+		while (m_DequeuePos.load(std::memory_order_relaxed) != End)
+		{
+			if (TryPop(Line, LogLevel))
+			{
+				m_Logger.WriteToListeners(Line, LogLevel);
+			}
+			else
+			{
+				// The producer has claimed the slot but hasn't finished writing the line yet:
+				std::this_thread::yield();
+			}
+		}
+
+		auto NumDropped = m_NumDropped.exchange(0, std::memory_order_relaxed);
+		if (NumDropped > 0)
+		{
+			fmt::memory_buffer Buffer;
+			WriteLogOpener(Buffer);
+			fmt::format_to(Buffer, "Logger: {0} messages were dropped, the log queue was full\n", NumDropped);
+			m_Logger.WriteToListeners(std::string_view(Buffer.data(), Buffer.size()), eLogLevel::Warning);
+		}
+	}
+
+protected:
+
+	struct sSlot
+	{
+		std::atomic<size_t> m_Sequence;
+		AString m_Line;
+		eLogLevel m_LogLevel;
+	};
+
+	cLogger & m_Logger;
+
+	std::unique_ptr<sSlot[]> m_Slots;
+
+	/** Position of the next slot to be written by the producers. */
+	alignas(64) std::atomic<size_t> m_EnqueuePos;
+
+	/** Position of the next slot to be read by the consumer. Only modified by TryPop(). */
+	alignas(64) std::atomic<size_t> m_DequeuePos;
+
+	/** Number of lines dropped since the last Drain(). */
+	std::atomic<size_t> m_NumDropped;
+
+	/** Set while the thread waits for m_evtQueued, so that the producers know they need to wake it up. */
+	std::atomic<bool> m_IsSleeping;
+
+	/** Set by a producer that queues a line while the thread is idle, to wake the thread up. */
+	cEvent m_evtQueued;
+
+
+	/** Removes the oldest line from the queue. Returns false if the queue is empty.
+	Only called from Drain(), under the logger's lock. */
+	bool TryPop(AString & a_Line, eLogLevel & a_LogLevel)
+	{
+		auto Pos = m_DequeuePos.load(std::memory_order_relaxed);
+		auto & Slot = m_Slots[Pos & (QUEUE_SIZE - 1)];
+		if (Slot.m_Sequence.load(std::memory_order_acquire) != Pos + 1)
+		{
+			// Nothing queued, or the producer hasn't finished writing the line yet
+			return false;
+		}
+
+		// Swap the strings, so that the slot reuses the previous line's buffer:
+		std::swap(a_Line, Slot.m_Line);
+		a_LogLevel = Slot.m_LogLevel;
+		Slot.m_Sequence.store(Pos + QUEUE_SIZE, std::memory_order_release);
+		m_DequeuePos.store(Pos + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/** Returns true if there's no line waiting in the queue.
+	Only a hint when called outside of Drain(), another thread may be draining meanwhile. */
+	bool IsEmpty(void) const
+	{
+		auto Pos = m_DequeuePos.load(std::memory_order_relaxed);
+		return (m_Slots[Pos & (QUEUE_SIZE - 1)].m_Sequence.load(std::memory_order_acquire) != Pos + 1);
+	}
+
+	virtual void Execute(void) override
+	{
+		while (!m_ShouldTerminate)
+		{
+			Drain();
+
+			// Announce the sleep before checking the queue once more, so that a producer either sees the flag and wakes the thread up,
+			// or its line is seen here; the timeout covers the lines that another thread's Drain() was in the middle of:
+			m_IsSleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (IsEmpty())
+			{
+				m_evtQueued.Wait(100);
+			}
+			m_IsSleeping.store(false, std::memory_order_relaxed);
+		}
+		Drain();
+	}
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// cLogger:
+
+cLogger::cLogger(void):
+	m_IsAsync(false),
+	m_NumPushing(0)
+{
+}
+
+
+
+
+
+cLogger::~cLogger()
+{
+	StopAsync();
+}
+
+
+
+
+
 cLogger & cLogger::GetInstance(void)
 {
 	static cLogger Instance;
@@ -72,6 +300,47 @@ void cLogger::LogSimple(std::string_view a_Message, eLogLevel a_LogLevel)
 
 
 void cLogger::LogLine(std::string_view a_Line, eLogLevel a_LogLevel)
+{
+	if (m_IsAsync.load(std::memory_order_acquire))
+	{
+		// Announce the push before checking the mode again (both sequentially consistent),
+		// so that either StopAsync() sees the counter and waits for the push, or this thread sees the mode switched off:
+		m_NumPushing.fetch_add(1);
+		bool IsHandled = false;
+		if (m_IsAsync.load())
+		{
+			if (m_AsyncWriter->TryPush(a_Line, a_LogLevel))
+			{
+				IsHandled = true;
+			}
+			else if ((a_LogLevel == eLogLevel::Regular) || (a_LogLevel == eLogLevel::Info))
+			{
+				// The queue is full. Drop the less important messages, write the rest right away so that they're never lost:
+				m_AsyncWriter->AddDropped();
+				IsHandled = true;
+			}
+		}
+		m_NumPushing.fetch_sub(1, std::memory_order_release);
+		if (IsHandled)
+		{
+			return;
+		}
+	}
+
+	// Write the line right away. Drain the queue first, under the same lock, so that the line doesn't overtake the lines queued before it:
+	cCSLock Lock(m_CriticalSection);
+	if (m_AsyncWriter != nullptr)
+	{
+		m_AsyncWriter->Drain();
+	}
+	WriteToListeners(a_Line, a_LogLevel);
+}
+
+
+
+
+
+void cLogger::WriteToListeners(std::string_view a_Line, eLogLevel a_LogLevel)
 {
 	cCSLock Lock(m_CriticalSection);
 	for (size_t i = 0; i < m_LogListeners.size(); i++)
@@ -130,6 +399,61 @@ cLogger::cAttachment cLogger::AttachListener(std::unique_ptr<cListener> a_Listen
 
 
 
+void cLogger::StartAsync(void)
+{
+	cCSLock Lock(m_CriticalSection);
+	if (m_IsAsync)
+	{
+		return;
+	}
+	if (m_AsyncWriter == nullptr)
+	{
+		m_AsyncWriter = cpp14::make_unique<cAsyncWriter>(*this);
+	}
+	if (m_AsyncWriter->Start())
+	{
+		m_IsAsync.store(true, std::memory_order_release);
+	}
+}
+
+
+
+
+
+void cLogger::StopAsync(void)
+{
+	if (!m_IsAsync.exchange(false))
+	{
+		return;
+	}
+
+	// Wait for the threads that saw the async mode still on to finish their pushes; new ones write synchronously now:
+	while (m_NumPushing.load(std::memory_order_acquire) != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	// The thread drains the queue before finishing; drain once more in case it was already past its final drain:
+	m_AsyncWriter->Stop();
+	m_AsyncWriter->Drain();
+}
+
+
+
+
+
+void cLogger::Flush(void)
+{
+	if (m_IsAsync.load(std::memory_order_acquire))
+	{
+		m_AsyncWriter->Drain();
+	}
+}
+
+
+
+
+
 void cLogger::DetachListener(cListener * a_Listener)
 {
 	cCSLock Lock(m_CriticalSection);
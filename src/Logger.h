@@ -64,17 +64,53 @@ public:
 
 	cAttachment AttachListener(std::unique_ptr<cListener> a_Listener);
 
+	/** Switches to asynchronous logging: the logging threads only queue the formatted messages into a ring buffer
+	and a dedicated thread hands them over to the listeners, so that logging doesn't block on console or disk I/O.
+	When the ring buffer is full, regular and info messages are dropped (the number of dropped messages is logged later),
+	while warnings and errors are written synchronously instead, after the lines queued before them.
+	Does nothing if already asynchronous. */
+	void StartAsync(void);
+
+	/** Writes out all the queued messages and switches back to synchronous logging. */
+	void StopAsync(void);
+
+	/** Hands all the currently queued messages over to the listeners, from the calling thread.
+	Used before terminating on a crash, so that the messages explaining the crash aren't lost. */
+	void Flush(void);
+
 	static cLogger & GetInstance(void);
 	// Must be called before calling GetInstance in a multithreaded context
 	static void InitiateMultithreading();
 private:
 
+	class cAsyncWriter;
+
+	/** Protects m_LogListeners and m_AsyncWriter. Also held while draining the async queue and while writing a line synchronously,
+	so that the lines reach the listeners in order. */
 	cCriticalSection m_CriticalSection;
+
 	std::vector<std::unique_ptr<cListener>> m_LogListeners;
 
+	/** The queue and thread used for asynchronous logging. Created on the first StartAsync() call, kept until destruction. */
+	std::unique_ptr<cAsyncWriter> m_AsyncWriter;
+
+	/** Set while the messages are to be queued into m_AsyncWriter instead of being written right away. */
+	std::atomic<bool> m_IsAsync;
+
+	/** Number of threads currently between checking m_IsAsync and finishing their push into m_AsyncWriter.
+	StopAsync() waits for this to drop to zero before the final drain, so that no line is left behind in the queue. */
+	std::atomic<int> m_NumPushing;
+
+
+	cLogger(void);
+	~cLogger();
+
 	void DetachListener(cListener * a_Listener);
 	void LogLine(std::string_view a_Line, eLogLevel a_LogLevel);
 
+	/** Hands the line over to all the listeners. */
+	void WriteToListeners(std::string_view a_Line, eLogLevel a_LogLevel);
+
 };
 
 
@@ -23,9 +23,11 @@ cMap::cMap(unsigned int a_ID, cWorld * a_World):
 	m_Scale(3),
 	m_CenterX(0),
 	m_CenterZ(0),
+	m_UpdatePhase(0),
 	m_World(a_World)
 {
 	m_Data.assign(m_Width * m_Height, E_BASE_COLOR_TRANSPARENT);
+	MarkAllDirty();
 
 	Printf(m_Name, "map_%i", m_ID);
 }
@@ -41,9 +43,11 @@ cMap::cMap(unsigned int a_ID, int a_CenterX, int a_CenterZ, cWorld * a_World, un
 	, m_Scale(a_Scale)
 	, m_CenterX(a_CenterX)
 	, m_CenterZ(a_CenterZ)
+	, m_UpdatePhase(0)
 	, m_World(a_World)
 {
 	m_Data.assign(m_Width * m_Height, E_BASE_COLOR_TRANSPARENT);
+	MarkAllDirty();
 
 	Printf(m_Name, "map_%i", m_ID);
 }
@@ -54,10 +58,46 @@ cMap::cMap(unsigned int a_ID, int a_CenterX, int a_CenterZ, cWorld * a_World, un
 
 void cMap::Tick()
 {
+	bool HasChanges = (m_DirtyMinX <= m_DirtyMaxX);
+	if (HasChanges)
+	{
+		// Only the clients that receive these changes now will be up to date:
+		std::set<int> UpToDateClients;
+		for (const auto & Client : m_ClientsInCurrentTick)
+		{
+			if (m_UpToDateClients.count(Client->GetUniqueID()) > 0)
+			{
+				UpToDateClients.insert(Client->GetUniqueID());
+			}
+		}
+		std::swap(m_UpToDateClients, UpToDateClients);
+	}
+
 	for (const auto & Client : m_ClientsInCurrentTick)
 	{
-		Client->SendMapData(*this, 0, 0);
+		if (m_UpToDateClients.insert(Client->GetUniqueID()).second)
+		{
+			// The client has missed some changes, send everything:
+			Client->SendMapData(*this, 0, 0, m_Width, m_Height);
+		}
+		else if (HasChanges)
+		{
+			Client->SendMapData(*this, m_DirtyMinX, m_DirtyMinZ, m_DirtyMaxX - m_DirtyMinX + 1, m_DirtyMaxZ - m_DirtyMinZ + 1);
+		}
+		else
+		{
+			// Only the decorators:
+			Client->SendMapData(*this, 0, 0, 0, 0);
+		}
 	}
+
+	// Reset the dirty rectangle to empty:
+	m_DirtyMinX = m_Width;
+	m_DirtyMinZ = m_Height;
+	m_DirtyMaxX = 0;
+	m_DirtyMaxZ = 0;
+
+	m_UpdatePhase = (m_UpdatePhase + 1) % UPDATE_INTERLEAVE;
 	m_ClientsInCurrentTick.clear();
 	m_Decorators.clear();
 }
@@ -68,6 +108,13 @@ void cMap::Tick()
 
 void cMap::UpdateRadius(int a_PixelX, int a_PixelZ, unsigned int a_Radius)
 {
+	ASSERT(m_World != nullptr);
+	if (GetDimension() == dimNether)
+	{
+		// TODO 2014-02-22 xdot: Nether maps
+		return;
+	}
+
 	int PixelRadius = static_cast<int>(a_Radius / GetPixelWidth());
 
 	unsigned int StartX = static_cast<unsigned int>(Clamp(a_PixelX - PixelRadius, 0, static_cast<int>(m_Width)));
@@ -76,19 +123,73 @@ void cMap::UpdateRadius(int a_PixelX, int a_PixelZ, unsigned int a_Radius)
 	unsigned int EndX   = static_cast<unsigned int>(Clamp(a_PixelX + PixelRadius, 0, static_cast<int>(m_Width)));
 	unsigned int EndZ   = static_cast<unsigned int>(Clamp(a_PixelZ + PixelRadius, 0, static_cast<int>(m_Height)));
 
-	for (unsigned int X = StartX; X < EndX; ++X)
+	// Walk the area chunk by chunk, so that each chunk is looked up and locked only once.
+	// The block coords grow with the pixel coords, so the pixels belonging to a single chunk form a rectangle:
+	unsigned int MinZ = StartZ;
+	while (MinZ < EndZ)
 	{
-		for (unsigned int Z = StartZ; Z < EndZ; ++Z)
+		int ChunkZ = FAST_FLOOR_DIV(PixelToBlock(MinZ, m_CenterZ, m_Height), cChunkDef::Width);
+		unsigned int MaxZ = MinZ + 1;
+		bool HasRowToUpdate = ((MinZ % UPDATE_INTERLEAVE) == m_UpdatePhase);
+		while ((MaxZ < EndZ) && (FAST_FLOOR_DIV(PixelToBlock(MaxZ, m_CenterZ, m_Height), cChunkDef::Width) == ChunkZ))
 		{
-			int dX = static_cast<int>(X) - a_PixelX;
-			int dZ = static_cast<int>(Z) - a_PixelZ;
+			HasRowToUpdate = HasRowToUpdate || ((MaxZ % UPDATE_INTERLEAVE) == m_UpdatePhase);
+			MaxZ++;
+		}
+		if (!HasRowToUpdate)
+		{
+			MinZ = MaxZ;
+			continue;
+		}
 
-			if ((dX * dX) + (dZ * dZ) < (PixelRadius * PixelRadius))
+		unsigned int MinX = StartX;
+		while (MinX < EndX)
+		{
+			int ChunkX = FAST_FLOOR_DIV(PixelToBlock(MinX, m_CenterX, m_Width), cChunkDef::Width);
+			unsigned int MaxX = MinX + 1;
+			while ((MaxX < EndX) && (FAST_FLOOR_DIV(PixelToBlock(MaxX, m_CenterX, m_Width), cChunkDef::Width) == ChunkX))
 			{
-				UpdatePixel(X, Z);
+				MaxX++;
 			}
-		}
-	}
+
+			m_World->DoWithChunk(ChunkX, ChunkZ, [&](cChunk & a_Chunk)
+				{
+					if (!a_Chunk.IsValid())
+					{
+						return false;
+					}
+					for (unsigned int Z = MinZ; Z < MaxZ; ++Z)
+					{
+						if ((Z % UPDATE_INTERLEAVE) != m_UpdatePhase)
+						{
+							continue;
+						}
+						int dZ = static_cast<int>(Z) - a_PixelZ;
+						int RelZ = PixelToBlock(Z, m_CenterZ, m_Height) - ChunkZ * cChunkDef::Width;
+						for (unsigned int X = MinX; X < MaxX; ++X)
+						{
+							int dX = static_cast<int>(X) - a_PixelX;
+							if ((dX * dX) + (dZ * dZ) >= (PixelRadius * PixelRadius))
+							{
+								continue;
+							}
+							int RelX = PixelToBlock(X, m_CenterX, m_Width) - ChunkX * cChunkDef::Width;
+							ColorID Color = CalcPixelColor(a_Chunk, RelX, RelZ);
+							auto & Pixel = m_Data[Z * m_Width + X];
+							if (Pixel != Color)
+							{
+								Pixel = Color;
+								MarkDirty(X, Z);
+							}
+						}  // for X
+					}  // for Z
+					return false;
+				}
+			);
+			MinX = MaxX;
+		}  // while (MinX < EndX)
+		MinZ = MaxZ;
+	}  // while (MinZ < EndZ)
 }
 
 
@@ -109,69 +210,36 @@ void cMap::UpdateRadius(cPlayer & a_Player, unsigned int a_Radius)
 
 
 
-bool cMap::UpdatePixel(unsigned int a_X, unsigned int a_Z)
+cMap::ColorID cMap::CalcPixelColor(cChunk & a_Chunk, int a_RelX, int a_RelZ)
 {
-	int BlockX = m_CenterX + static_cast<int>((a_X - m_Width  / 2) * GetPixelWidth());
-	int BlockZ = m_CenterZ + static_cast<int>((a_Z - m_Height / 2) * GetPixelWidth());
-
-	int ChunkX, ChunkZ;
-	cChunkDef::BlockToChunk(BlockX, BlockZ, ChunkX, ChunkZ);
+	static const std::array<unsigned char, 4> BrightnessID = { { 3, 0, 1, 2 } };  // Darkest to lightest
+	BLOCKTYPE TargetBlock;
+	NIBBLETYPE TargetMeta;
 
-	int RelX = BlockX - (ChunkX * cChunkDef::Width);
-	int RelZ = BlockZ - (ChunkZ * cChunkDef::Width);
-
-	ASSERT(m_World != nullptr);
+	auto Height = a_Chunk.GetHeight(a_RelX, a_RelZ);
+	auto ChunkHeight = cChunkDef::Height;
+	a_Chunk.GetBlockTypeMeta(a_RelX, Height, a_RelZ, TargetBlock, TargetMeta);
+	auto ColourID = BlockHandler(TargetBlock)->GetMapBaseColourID(TargetMeta);
 
-	ColorID PixelData;
-	m_World->DoWithChunk(ChunkX, ChunkZ, [&](cChunk & a_Chunk)
+	if (IsBlockWater(TargetBlock))
+	{
+		ChunkHeight /= 4;
+		while (((--Height) != -1) && IsBlockWater(a_Chunk.GetBlock(a_RelX, Height, a_RelZ)))
 		{
-			if (!a_Chunk.IsValid())
-			{
-				return false;
-			}
-
-			if (GetDimension() == dimNether)
-			{
-				// TODO 2014-02-22 xdot: Nether maps
-
-				return false;
-			}
-
-			static const std::array<unsigned char, 4> BrightnessID = { { 3, 0, 1, 2 } };  // Darkest to lightest
-			BLOCKTYPE TargetBlock;
-			NIBBLETYPE TargetMeta;
-
-			auto Height = a_Chunk.GetHeight(RelX, RelZ);
-			auto ChunkHeight = cChunkDef::Height;
-			a_Chunk.GetBlockTypeMeta(RelX, Height, RelZ, TargetBlock, TargetMeta);
-			auto ColourID = BlockHandler(TargetBlock)->GetMapBaseColourID(TargetMeta);
-
-			if (IsBlockWater(TargetBlock))
-			{
-				ChunkHeight /= 4;
-				while (((--Height) != -1) && IsBlockWater(a_Chunk.GetBlock(RelX, Height, RelZ)))
-				{
-					continue;
-				}
-			}
-			else if (ColourID == 0)
-			{
-				while (((--Height) != -1) && ((ColourID = BlockHandler(a_Chunk.GetBlock(RelX, Height, RelZ))->GetMapBaseColourID(a_Chunk.GetMeta(RelX, Height, RelZ))) == 0))
-				{
-					continue;
-				}
-			}
-
-			// Multiply base color ID by 4 and add brightness ID
-			const int BrightnessIDSize = static_cast<int>(BrightnessID.size());
-			PixelData = ColourID * 4 + BrightnessID[static_cast<size_t>(Clamp<int>((BrightnessIDSize * Height) / ChunkHeight, 0, BrightnessIDSize - 1))];
-			return false;
+			continue;
 		}
-	);
-
-	SetPixel(a_X, a_Z, PixelData);
+	}
+	else if (ColourID == 0)
+	{
+		while (((--Height) != -1) && ((ColourID = BlockHandler(a_Chunk.GetBlock(a_RelX, Height, a_RelZ))->GetMapBaseColourID(a_Chunk.GetMeta(a_RelX, Height, a_RelZ))) == 0))
+		{
+			continue;
+		}
+	}
 
-	return true;
+	// Multiply base color ID by 4 and add brightness ID
+	const int BrightnessIDSize = static_cast<int>(BrightnessID.size());
+	return static_cast<ColorID>(ColourID * 4 + BrightnessID[static_cast<size_t>(Clamp<int>((BrightnessIDSize * Height) / ChunkHeight, 0, BrightnessIDSize - 1))]);
 }
 
 
@@ -210,6 +278,7 @@ void cMap::Resize(unsigned int a_Width, unsigned int a_Height)
 	m_Height = a_Height;
 
 	m_Data.assign(m_Width * m_Height, 0);
+	MarkAllDirty();
 }
 
 
@@ -230,7 +299,12 @@ bool cMap::SetPixel(unsigned int a_X, unsigned int a_Z, cMap::ColorID a_Data)
 {
 	if ((a_X < m_Width) && (a_Z < m_Height))
 	{
-		m_Data[a_Z * m_Width + a_X] = a_Data;
+		auto & Pixel = m_Data[a_Z * m_Width + a_X];
+		if (Pixel != a_Data)
+		{
+			Pixel = a_Data;
+			MarkDirty(a_X, a_Z);
+		}
 
 		return true;
 	}
@@ -260,6 +334,30 @@ cMap::ColorID cMap::GetPixel(unsigned int a_X, unsigned int a_Z)
 
 
 
+void cMap::MarkDirty(unsigned int a_X, unsigned int a_Z)
+{
+	m_DirtyMinX = std::min(m_DirtyMinX, a_X);
+	m_DirtyMinZ = std::min(m_DirtyMinZ, a_Z);
+	m_DirtyMaxX = std::max(m_DirtyMaxX, a_X);
+	m_DirtyMaxZ = std::max(m_DirtyMaxZ, a_Z);
+}
+
+
+
+
+
+void cMap::MarkAllDirty(void)
+{
+	m_DirtyMinX = 0;
+	m_DirtyMinZ = 0;
+	m_DirtyMaxX = m_Width - 1;
+	m_DirtyMaxZ = m_Height - 1;
+}
+
+
+
+
+
 unsigned int cMap::GetNumPixels(void) const
 {
 	return m_Width * m_Height;
@@ -330,7 +428,7 @@ const cMapDecorator cMap::CreateDecorator(const cEntity * a_TrackedEntity)
 
 unsigned int cMap::GetPixelWidth(void) const
 {
-	return static_cast<unsigned int>(pow(2.0, static_cast<double>(m_Scale)));
+	return 1u << m_Scale;
 }
 
 
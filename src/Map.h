@@ -15,6 +15,7 @@
 
 
 
+class cChunk;
 class cClientHandle;
 class cWorld;
 class cPlayer;
@@ -117,10 +118,13 @@ public:
 	cMap(unsigned int a_ID, int a_CenterX, int a_CenterZ, cWorld * a_World, unsigned int a_Scale = 3);
 
 	/** Sends a map update to all registered clients
+	Clients that have seen all the previous changes only receive the rectangle of pixels changed since the last tick,
+	the others receive the entire map.
 	Clears the list holding registered clients and decorators */
 	void Tick();
 
-	/** Update a circular region with the specified radius and center (in pixels). */
+	/** Update a circular region with the specified radius (in blocks) and center (in pixels).
+	Only every UPDATE_INTERLEAVE-th pixel row is updated in each tick, the rows take turns. */
 	void UpdateRadius(int a_PixelX, int a_PixelZ, unsigned int a_Radius);
 
 	/** Update a circular region around the specified player. */
@@ -182,8 +186,23 @@ public:
 
 private:
 
-	/** Update the specified pixel. */
-	bool UpdatePixel(unsigned int a_X, unsigned int a_Z);
+	/** Number of ticks over which UpdateRadius() spreads the update of the whole circle. */
+	static const unsigned int UPDATE_INTERLEAVE = 4;
+
+	/** Returns the color of the map pixel whose top-down view is the specified column of the chunk. */
+	static ColorID CalcPixelColor(cChunk & a_Chunk, int a_RelX, int a_RelZ);
+
+	/** Returns the block coord corresponding to the specified pixel coord, along an axis with the specified center and size. */
+	int PixelToBlock(unsigned int a_Pixel, int a_Center, unsigned int a_Size) const
+	{
+		return a_Center + (static_cast<int>(a_Pixel) - static_cast<int>(a_Size / 2)) * static_cast<int>(GetPixelWidth());
+	}
+
+	/** Adds the specified pixel to the rectangle of pixels changed since the last Tick(). */
+	void MarkDirty(unsigned int a_X, unsigned int a_Z);
+
+	/** Marks the entire map as changed. */
+	void MarkAllDirty(void);
 
 	unsigned int m_ID;
 
@@ -196,9 +215,22 @@ private:
 	int m_CenterX;
 	int m_CenterZ;
 
-	/** Column-major array of colours */
+	/** Row-major array of colours */
 	cColorList m_Data;
 
+	/** The rectangle of pixels changed since the last Tick(), inclusive. Empty if m_DirtyMinX > m_DirtyMaxX. */
+	unsigned int m_DirtyMinX;
+	unsigned int m_DirtyMinZ;
+	unsigned int m_DirtyMaxX;
+	unsigned int m_DirtyMaxZ;
+
+	/** Unique IDs of the clients that have received all the changes made to the map so far.
+	A client that wasn't holding the map while it changed gets the entire map the next time. */
+	std::set<int> m_UpToDateClients;
+
+	/** The pixel rows updated by UpdateRadius() in the current tick are those whose index modulo UPDATE_INTERLEAVE equals this. */
+	unsigned int m_UpdatePhase;
+
 	cWorld * m_World;
 
 	cMapClientList m_ClientsInCurrentTick;
@@ -0,0 +1,240 @@
+
+// Metrics.cpp
+
+// Implements the cMetrics registry and the individual metric classes
+
+#include "Globals.h"
+#include "Metrics.h"
+
+
+
+
+
+/** Returns the series name with its labels, in the Prometheus syntax: "name{labels}", or just "name" if there are no labels. */
+static AString SeriesName(const AString & a_Name, const AString & a_Labels)
+{
+	if (a_Labels.empty())
+	{
+		return a_Name;
+	}
+	return Printf("%s{%s}", a_Name.c_str(), a_Labels.c_str());
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// cMetricCounter:
+
+void cMetricCounter::Format(AString & a_Out, const AString & a_Name, const AString & a_Labels) const
+{
+	AppendPrintf(a_Out, "%s %llu\n", SeriesName(a_Name, a_Labels).c_str(), static_cast<unsigned long long>(GetValue()));
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// cMetricGauge:
+
+void cMetricGauge::Format(AString & a_Out, const AString & a_Name, const AString & a_Labels) const
+{
+	AppendPrintf(a_Out, "%s %lld\n", SeriesName(a_Name, a_Labels).c_str(), static_cast<long long>(GetValue()));
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// cMetricHistogram:
+
+cMetricHistogram::cMetricHistogram(std::vector<double> a_Bounds):
+	m_Bounds(std::move(a_Bounds)),
+	m_Buckets(new std::atomic<UInt64>[m_Bounds.size() + 1]),
+	m_Sum(0)
+{
+	ASSERT(std::is_sorted(m_Bounds.begin(), m_Bounds.end()));
+	for (size_t i = 0; i <= m_Bounds.size(); i++)
+	{
+		m_Buckets[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+
+
+
+
+void cMetricHistogram::Observe(double a_Value)
+{
+	// The bounds are few, a linear search is faster than a binary one:
+	size_t Idx = 0;
+	size_t NumBounds = m_Bounds.size();
+	while ((Idx < NumBounds) && (a_Value > m_Bounds[Idx]))
+	{
+		Idx++;
+	}
+	m_Buckets[Idx].fetch_add(1, std::memory_order_relaxed);
+
+	// There's no atomic add for doubles before C++20:
+	double Sum = m_Sum.load(std::memory_order_relaxed);
+	while (!m_Sum.compare_exchange_weak(Sum, Sum + a_Value, std::memory_order_relaxed))
+	{
+	}
+}
+
+
+
+
+
+void cMetricHistogram::Format(AString & a_Out, const AString & a_Name, const AString & a_Labels) const
+{
+	// The buckets are exported cumulative, with the "le" label added to the series' own labels:
+	AString BucketName = a_Name + "_bucket";
+	AString LabelPrefix = a_Labels.empty() ? AString() : (a_Labels + ",");
+	UInt64 Cumulative = 0;
+	for (size_t i = 0; i < m_Bounds.size(); i++)
+	{
+		Cumulative += m_Buckets[i].load(std::memory_order_relaxed);
+		AppendPrintf(a_Out, "%s{%sle=\"%g\"} %llu\n",
+			BucketName.c_str(), LabelPrefix.c_str(), m_Bounds[i], static_cast<unsigned long long>(Cumulative)
+		);
+	}
+	Cumulative += m_Buckets[m_Bounds.size()].load(std::memory_order_relaxed);
+	AppendPrintf(a_Out, "%s{%sle=\"+Inf\"} %llu\n", BucketName.c_str(), LabelPrefix.c_str(), static_cast<unsigned long long>(Cumulative));
+	AppendPrintf(a_Out, "%s %g\n", SeriesName(a_Name + "_sum", a_Labels).c_str(), m_Sum.load(std::memory_order_relaxed));
+
+	// Report the count as the sum of the buckets, so that the export is consistent even if observations happen meanwhile:
+	AppendPrintf(a_Out, "%s %llu\n", SeriesName(a_Name + "_count", a_Labels).c_str(), static_cast<unsigned long long>(Cumulative));
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// cMetrics:
+
+cMetrics & cMetrics::Get(void)
+{
+	static cMetrics Instance;
+	return Instance;
+}
+
+
+
+
+
+cMetricCounter & cMetrics::GetCounter(const AString & a_Name, const AString & a_Help, const AString & a_Labels)
+{
+	cCSLock Lock(m_CS);
+	auto & Series = GetFamily(a_Name, mtCounter, a_Help).m_Series[a_Labels];
+	if (Series == nullptr)
+	{
+		Series = cpp14::make_unique<cMetricCounter>();
+	}
+	return static_cast<cMetricCounter &>(*Series);
+}
+
+
+
+
+
+cMetricGauge & cMetrics::GetGauge(const AString & a_Name, const AString & a_Help, const AString & a_Labels)
+{
+	cCSLock Lock(m_CS);
+	auto & Series = GetFamily(a_Name, mtGauge, a_Help).m_Series[a_Labels];
+	if (Series == nullptr)
+	{
+		Series = cpp14::make_unique<cMetricGauge>();
+	}
+	return static_cast<cMetricGauge &>(*Series);
+}
+
+
+
+
+
+cMetricHistogram & cMetrics::GetHistogram(const AString & a_Name, const AString & a_Help, const std::vector<double> & a_Bounds, const AString & a_Labels)
+{
+	cCSLock Lock(m_CS);
+	auto & Series = GetFamily(a_Name, mtHistogram, a_Help).m_Series[a_Labels];
+	if (Series == nullptr)
+	{
+		Series = cpp14::make_unique<cMetricHistogram>(a_Bounds);
+	}
+	return static_cast<cMetricHistogram &>(*Series);
+}
+
+
+
+
+
+AString cMetrics::GetPrometheusText(void) const
+{
+	static const char * TypeNames[] =
+	{
+		"counter",
+		"gauge",
+		"histogram",
+	};
+
+	AString Res;
+	cCSLock Lock(m_CS);
+	for (const auto & Family : m_Families)
+	{
+		AppendPrintf(Res, "# HELP %s %s\n", Family.first.c_str(), Family.second.m_Help.c_str());
+		AppendPrintf(Res, "# TYPE %s %s\n", Family.first.c_str(), TypeNames[Family.second.m_Type]);
+		for (const auto & Series : Family.second.m_Series)
+		{
+			Series.second->Format(Res, Family.first, Series.first);
+		}
+	}
+	return Res;
+}
+
+
+
+
+
+AString cMetrics::Label(const AString & a_Name, const AString & a_Value)
+{
+	AString Res = a_Name + "=\"";
+	for (auto ch : a_Value)
+	{
+		switch (ch)
+		{
+			case '\\': Res.append("\\\\"); break;
+			case '"':  Res.append("\\\""); break;
+			case '\n': Res.append("\\n");  break;
+			default:   Res.push_back(ch);  break;
+		}
+	}
+	Res.push_back('"');
+	return Res;
+}
+
+
+
+
+
+cMetrics::sFamily & cMetrics::GetFamily(const AString & a_Name, eType a_Type, const AString & a_Help)
+{
+	auto itr = m_Families.find(a_Name);
+	if (itr != m_Families.end())
+	{
+		// The same name must always be used for the same kind of metric, otherwise the static_cast in the callers is invalid:
+		ASSERT(itr->second.m_Type == a_Type);
+		return itr->second;
+	}
+	auto & Family = m_Families[a_Name];
+	Family.m_Type = a_Type;
+	Family.m_Help = a_Help;
+	return Family;
+}
+
+
+
+
@@ -0,0 +1,177 @@
+
+// Metrics.h
+
+// Declares the cMetrics registry and the individual metric classes (counter, gauge, histogram), exported in the Prometheus text format
+
+
+
+
+
+#pragma once
+
+
+
+
+
+/** A single time series of a metric. */
+class cMetric
+{
+public:
+
+	virtual ~cMetric() {}
+
+	/** Appends the value(s) of the series to a_Out in the Prometheus text format.
+	a_Labels is the preformatted label list, without the braces; may be empty. */
+	virtual void Format(AString & a_Out, const AString & a_Name, const AString & a_Labels) const = 0;
+};
+
+
+
+
+
+/** A value that only ever increases, such as the number of bytes sent. */
+class cMetricCounter:
+	public cMetric
+{
+public:
+
+	cMetricCounter(void): m_Value(0) {}
+
+	void Add(UInt64 a_Amount = 1) { m_Value.fetch_add(a_Amount, std::memory_order_relaxed); }
+
+	UInt64 GetValue(void) const { return m_Value.load(std::memory_order_relaxed); }
+
+	// cMetric overrides:
+	virtual void Format(AString & a_Out, const AString & a_Name, const AString & a_Labels) const override;
+
+protected:
+
+	std::atomic<UInt64> m_Value;
+};
+
+
+
+
+
+/** A value that can go up and down, such as a queue length. */
+class cMetricGauge:
+	public cMetric
+{
+public:
+
+	cMetricGauge(void): m_Value(0) {}
+
+	void Set(Int64 a_Value) { m_Value.store(a_Value, std::memory_order_relaxed); }
+
+	void Add(Int64 a_Amount) { m_Value.fetch_add(a_Amount, std::memory_order_relaxed); }
+
+	Int64 GetValue(void) const { return m_Value.load(std::memory_order_relaxed); }
+
+	// cMetric overrides:
+	virtual void Format(AString & a_Out, const AString & a_Name, const AString & a_Labels) const override;
+
+protected:
+
+	std::atomic<Int64> m_Value;
+};
+
+
+
+
+
+/** Counts the observed values in buckets with fixed upper bounds, such as the tick durations. */
+class cMetricHistogram:
+	public cMetric
+{
+public:
+
+	/** Creates a histogram with the specified bucket upper bounds, which must be sorted ascending.
+	An implicit "+Inf" bucket is added after the last one. */
+	cMetricHistogram(std::vector<double> a_Bounds);
+
+	void Observe(double a_Value);
+
+	// cMetric overrides:
+	virtual void Format(AString & a_Out, const AString & a_Name, const AString & a_Labels) const override;
+
+protected:
+
+	/** The upper bounds of the buckets, ascending. */
+	const std::vector<double> m_Bounds;
+
+	/** The number of observations that fell into each bucket (not cumulative).
+	Has one more item than m_Bounds, for the values above the last bound. */
+	std::unique_ptr<std::atomic<UInt64>[]> m_Buckets;
+
+	/** The sum of all the observed values. */
+	std::atomic<double> m_Sum;
+};
+
+
+
+
+
+/** The registry of all the metrics in the server.
+Metrics are created on the first Get*() call for their name and labels and live until the server exits, so the returned
+references may be kept by the callers and updated without any lookup. Updating a metric is a single relaxed atomic
+operation, so it is cheap enough to be done in the network and tick code paths.
+The whole registry can be exported in the Prometheus text exposition format, which the webadmin serves at "/metrics". */
+class cMetrics
+{
+public:
+
+	/** Returns the single instance of the registry. */
+	static cMetrics & Get(void);
+
+	/** Returns the counter of the specified name and labels, creating it if needed.
+	a_Labels is a comma-separated list of label pairs, such as produced by Label(). */
+	cMetricCounter & GetCounter(const AString & a_Name, const AString & a_Help, const AString & a_Labels = AString());
+
+	/** Returns the gauge of the specified name and labels, creating it if needed. */
+	cMetricGauge & GetGauge(const AString & a_Name, const AString & a_Help, const AString & a_Labels = AString());
+
+	/** Returns the histogram of the specified name and labels, creating it with the specified bucket bounds if needed. */
+	cMetricHistogram & GetHistogram(const AString & a_Name, const AString & a_Help, const std::vector<double> & a_Bounds, const AString & a_Labels = AString());
+
+	/** Returns all the metrics in the Prometheus text exposition format. */
+	AString GetPrometheusText(void) const;
+
+	/** Returns a single label pair formatted for the a_Labels parameters, with the value escaped as needed. */
+	static AString Label(const AString & a_Name, const AString & a_Value);
+
+protected:
+
+	enum eType
+	{
+		mtCounter,
+		mtGauge,
+		mtHistogram,
+	};
+
+	/** All the series of a single metric name. */
+	struct sFamily
+	{
+		eType m_Type;
+		AString m_Help;
+
+		/** The series, mapped by their labels. */
+		std::map<AString, std::unique_ptr<cMetric>> m_Series;
+	};
+
+
+	/** Protects m_Families against multithreaded access. The metric values themselves are atomic and need no locking. */
+	mutable cCriticalSection m_CS;
+
+	/** All the metrics, mapped by their name. Sorted, so that the export is stable. */
+	std::map<AString, sFamily> m_Families;
+
+
+	cMetrics(void) {}
+
+	/** Returns the family of the specified name, creating it if needed. */
+	sFamily & GetFamily(const AString & a_Name, eType a_Type, const AString & a_Help);
+};
+
+
+
+
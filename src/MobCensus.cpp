@@ -7,87 +7,106 @@
 
 
 
-void cMobCensus::CollectMob(cMonster & a_Monster, cChunk & a_Chunk, double a_Distance)
+cMobCensus::cMobCensus(void) :
+	m_NumChunks(0)
 {
-	m_ProximityCounter.CollectMob(a_Monster, a_Chunk, a_Distance);
-	m_MobFamilyCollecter.CollectMob(a_Monster);
+	m_NumMobs.fill(0);
 }
 
 
 
 
 
-bool cMobCensus::IsCapped(cMonster::eFamily a_MobFamily)
+void cMobCensus::AddSpawnableChunk(void)
 {
-	const int ratio = 319;  // This should be 256 as we are only supposed to take account from chunks that are in 17 x 17 from a player
-	// but for now, we use all chunks loaded by players. that means 19 x 19 chunks. That's why we use 256 * (19 * 19) / (17 * 17) = 319
-	// MG TODO : code the correct count
-	const auto MobCap = ((GetCapMultiplier(a_MobFamily) * GetNumChunks()) / ratio);
-	return (MobCap < m_MobFamilyCollecter.GetNumberOfCollectedMobs(a_MobFamily));
+	m_NumChunks += 1;
 }
 
 
 
 
 
-int cMobCensus::GetCapMultiplier(cMonster::eFamily a_MobFamily)
+void cMobCensus::RemoveSpawnableChunk(void)
 {
-	switch (a_MobFamily)
-	{
-		case cMonster::mfHostile: return 79;
-		case cMonster::mfPassive: return 11;
-		case cMonster::mfAmbient: return 16;
-		case cMonster::mfWater:   return 5;
-		case cMonster::mfNoSpawn:
-		case cMonster::mfUnhandled:
-		{
-			ASSERT(!"Unhandled mob family");
-			return -1;
-		}
-	}
-	UNREACHABLE("Unsupported mob family");
+	ASSERT(m_NumChunks > 0);
+	m_NumChunks -= 1;
 }
 
 
 
 
 
-void cMobCensus::CollectSpawnableChunk(cChunk & a_Chunk)
+void cMobCensus::AddMob(cMonster::eFamily a_MobFamily)
 {
-	m_EligibleForSpawnChunks.insert(&a_Chunk);
+	m_NumMobs[static_cast<size_t>(a_MobFamily)] += 1;
 }
 
 
 
 
 
-int cMobCensus::GetNumChunks(void)
+void cMobCensus::RemoveMob(cMonster::eFamily a_MobFamily)
 {
-	return static_cast<int>(m_EligibleForSpawnChunks.size());
+	ASSERT(m_NumMobs[static_cast<size_t>(a_MobFamily)] > 0);
+	m_NumMobs[static_cast<size_t>(a_MobFamily)] -= 1;
 }
 
 
 
 
 
-cMobProximityCounter & cMobCensus::GetProximityCounter(void)
+int cMobCensus::GetNumMobs(cMonster::eFamily a_MobFamily) const
 {
-	return m_ProximityCounter;
+	return m_NumMobs[static_cast<size_t>(a_MobFamily)];
 }
 
 
 
 
 
-void cMobCensus::Logd()
+bool cMobCensus::IsCapped(cMonster::eFamily a_MobFamily) const
 {
-	LOGD("Hostile mobs : %d %s", m_MobFamilyCollecter.GetNumberOfCollectedMobs(cMonster::mfHostile), IsCapped(cMonster::mfHostile) ? "(capped)" : "");
-	LOGD("Ambient mobs : %d %s", m_MobFamilyCollecter.GetNumberOfCollectedMobs(cMonster::mfAmbient), IsCapped(cMonster::mfAmbient) ? "(capped)" : "");
-	LOGD("Water mobs   : %d %s", m_MobFamilyCollecter.GetNumberOfCollectedMobs(cMonster::mfWater),   IsCapped(cMonster::mfWater)   ? "(capped)" : "");
-	LOGD("Passive mobs : %d %s", m_MobFamilyCollecter.GetNumberOfCollectedMobs(cMonster::mfPassive), IsCapped(cMonster::mfPassive) ? "(capped)" : "");
+	const int ratio = 319;  // This should be 256 as we are only supposed to take account from chunks that are in 17 x 17 from a player
+	// but for now, we use all chunks loaded by players. that means 19 x 19 chunks. That's why we use 256 * (19 * 19) / (17 * 17) = 319
+	// MG TODO : code the correct count
+	const auto MobCap = ((GetCapMultiplier(a_MobFamily) * m_NumChunks) / ratio);
+	return (MobCap < GetNumMobs(a_MobFamily));
 }
 
 
 
 
 
+int cMobCensus::GetCapMultiplier(cMonster::eFamily a_MobFamily)
+{
+	switch (a_MobFamily)
+	{
+		case cMonster::mfHostile: return 79;
+		case cMonster::mfPassive: return 11;
+		case cMonster::mfAmbient: return 16;
+		case cMonster::mfWater:   return 5;
+		case cMonster::mfNoSpawn:
+		case cMonster::mfUnhandled:
+		{
+			ASSERT(!"Unhandled mob family");
+			return -1;
+		}
+	}
+	UNREACHABLE("Unsupported mob family");
+}
+
+
+
+
+
+void cMobCensus::Logd(void) const
+{
+	LOGD("Hostile mobs : %d %s", GetNumMobs(cMonster::mfHostile), IsCapped(cMonster::mfHostile) ? "(capped)" : "");
+	LOGD("Ambient mobs : %d %s", GetNumMobs(cMonster::mfAmbient), IsCapped(cMonster::mfAmbient) ? "(capped)" : "");
+	LOGD("Water mobs   : %d %s", GetNumMobs(cMonster::mfWater),   IsCapped(cMonster::mfWater)   ? "(capped)" : "");
+	LOGD("Passive mobs : %d %s", GetNumMobs(cMonster::mfPassive), IsCapped(cMonster::mfPassive) ? "(capped)" : "");
+}
+
+
+
+
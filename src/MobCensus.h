@@ -1,54 +1,55 @@
 
 #pragma once
 
-#include "MobProximityCounter.h"
-#include "MobFamilyCollecter.h"
+#include "Mobs/Monster.h"  // This is a side-effect of keeping Mobfamily inside Monster class. I'd prefer to keep both (Mobfamily and Monster) inside a "Monster" namespace MG TODO : do it
 
 
 
 
-// fwd:
-class cChunk;
-class cMonster;
 
+/** This class keeps a running count of the mobs, per family, that live in chunks eligible for spawning,
+and the number of such chunks. It is used to decide whether a mob family has reached its cap.
 
+A chunk is eligible for spawning if it is valid and loaded by at least one client. Rather than
+recounting every tick, each cChunk reports to the census when it becomes eligible / ineligible
+and when mobs enter or leave it while eligible, so that the census is always up to date.
+All access is protected by the chunkmap's CS. */
+class cMobCensus
+{
+public:
 
+	cMobCensus(void);
 
+	/** Called by a chunk when it becomes eligible for spawning. */
+	void AddSpawnableChunk(void);
 
-/** This class is used to collect information, for each Mob, what is the distance of the closest player
-it was first being designed in order to make mobs spawn / despawn / act
-as the behaviour and even life of mobs depends on the distance to closest player
+	/** Called by a chunk when it stops being eligible for spawning. */
+	void RemoveSpawnableChunk(void);
 
-as side effect : it also collect the chunks that are elligible for spawning
-as side effect 2 : it also know the caps for mobs number and can compare census to this numbers
-*/
-class cMobCensus
-{
-public:
-	/** Returns the nested proximity counter */
-	cMobProximityCounter & GetProximityCounter(void);
+	/** Called when a mob is added to a chunk eligible for spawning
+	(or when a chunk containing the mob becomes eligible). */
+	void AddMob(cMonster::eFamily a_MobFamily);
 
-	// collect an elligible Chunk for Mob Spawning
-	// MG TODO : code the correct rule (not loaded chunk but short distant from players)
-	void CollectSpawnableChunk(cChunk & a_Chunk);
+	/** Called when a mob is removed from a chunk eligible for spawning
+	(or when a chunk containing the mob stops being eligible). */
+	void RemoveMob(cMonster::eFamily a_MobFamily);
 
-	/** Collect a mob - its distance to player, its family ... */
-	void CollectMob(cMonster & a_Monster, cChunk & a_Chunk, double a_Distance);
+	/** Returns the number of mobs of the specified family in the chunks eligible for spawning. */
+	int GetNumMobs(cMonster::eFamily a_MobFamily) const;
 
 	/** Returns true if the family is capped (i.e. there are more mobs of this family than max) */
-	bool IsCapped(cMonster::eFamily a_MobFamily);
+	bool IsCapped(cMonster::eFamily a_MobFamily) const;
 
 	/** log the results of census to server console */
-	void Logd(void);
+	void Logd(void) const;
 
 protected :
-	cMobProximityCounter m_ProximityCounter;
-	cMobFamilyCollecter m_MobFamilyCollecter;
 
-	std::set<cChunk *> m_EligibleForSpawnChunks;
+	/** The number of mobs in the eligible chunks, for each family. */
+	std::array<int, cMonster::mfUnhandled + 1> m_NumMobs;
 
-	/** Returns the number of chunks that are elligible for spawning (for now, the loaded, valid chunks) */
-	int GetNumChunks();
+	/** The number of chunks that are elligible for spawning (for now, the loaded, valid chunks) */
+	int m_NumChunks;
 
 	/** Returns the cap multiplier value of the given monster family */
 	static int GetCapMultiplier(cMonster::eFamily a_MobFamily);
@@ -4,6 +4,7 @@
 #include "Path.h"
 #include "../BlockInfo.h"
 #include "../Chunk.h"
+#include "../ChunkDataCallback.h"
 
 #define JUMP_G_COST 20
 #define NORMAL_G_COST 10
@@ -14,6 +15,19 @@
 #define CALCULATIONS_PER_STEP 10  // Higher means more CPU load but faster path calculations.
 // The only version which guarantees the shortest path is 0, 0.
 
+/** Number of cells in each of the blocks that a cPathWorkspace allocates its cells in. */
+static const size_t PATH_CELL_BLOCK_SIZE = 256;
+
+/** Initial number of hash slots in a cPathWorkspace. Must be a power of 2. */
+static const size_t PATH_INITIAL_NUM_SLOTS = 1024;
+
+/** Maximum number of spare cPathWorkspace storages kept around for reuse. */
+static const size_t PATH_MAX_POOLED_STORAGES = 64;
+
+/** Maximum number of hash slots a cPathWorkspace storage may keep when returned to the pool. Must be a power of 2.
+Storages grown beyond this by an unusually long search are trimmed back to the initial size, so that a few such searches
+don't keep their memory pinned in the pool forever. */
+static const size_t PATH_MAX_POOLED_NUM_SLOTS = 4096;
 
 
 
@@ -27,16 +41,421 @@ bool compareHeuristics::operator()(cPathCell * & a_Cell1, cPathCell * & a_Cell2)
 
 
 
+/* cPathWorkspace implementation */
+
+struct cPathWorkspace::sStorage
+{
+	/** A single slot of the hash table. The slot is empty unless its m_Generation equals the storage's m_Generation. */
+	struct sSlot
+	{
+		UInt32 m_Generation;
+		cPathCell * m_Cell;
+	};
+
+	/** The hash table, open-addressed with linear probing. The size is always a power of 2 and kept at least twice the number of cells. */
+	std::vector<sSlot> m_Slots;
+
+	/** The memory for the cells. Never shrunk, so that the cells' addresses are stable and the blocks get reused. */
+	std::vector<std::unique_ptr<cPathCell[]>> m_CellBlocks;
+
+	/** Number of cells currently stored; they occupy the first m_NumCells entries of m_CellBlocks. */
+	size_t m_NumCells;
+
+	/** The current generation. Slots with a different generation are considered empty. */
+	UInt32 m_Generation;
+
+	/** The A* open list, kept as a binary heap ordered by compareHeuristics. */
+	std::vector<cPathCell *> m_OpenList;
+
+	/** Set while a workspace uses the storage, clear while the storage is in the pool. Protected by the pool's CS. */
+	bool m_IsInUse;
+
+
+	sStorage(void) :
+		m_Slots(PATH_INITIAL_NUM_SLOTS, sSlot{0, nullptr}),
+		m_NumCells(0),
+		m_Generation(1),
+		m_IsInUse(true)
+	{
+	}
+
+
+	/** Empties the storage without releasing any memory. */
+	void Clear(void)
+	{
+		m_NumCells = 0;
+		m_OpenList.clear();
+		m_Generation += 1;
+		if (m_Generation == 0)
+		{
+			// The generation counter wrapped around, old slots could be mistaken for valid ones; reset them:
+			for (auto & Slot : m_Slots)
+			{
+				Slot.m_Generation = 0;
+			}
+			m_Generation = 1;
+		}
+	}
+
+
+	/** Releases the memory above the pooled limits; the storage must be empty.
+	Keeps the first cell blocks and the open list's capacity up to what PATH_MAX_POOLED_NUM_SLOTS can index. */
+	void Trim(void)
+	{
+		ASSERT(m_NumCells == 0);
+		if (m_Slots.size() <= PATH_MAX_POOLED_NUM_SLOTS)
+		{
+			return;
+		}
+		std::vector<sSlot>(PATH_INITIAL_NUM_SLOTS, sSlot{0, nullptr}).swap(m_Slots);
+		auto MaxNumBlocks = PATH_MAX_POOLED_NUM_SLOTS / 2 / PATH_CELL_BLOCK_SIZE;
+		if (m_CellBlocks.size() > MaxNumBlocks)
+		{
+			m_CellBlocks.resize(MaxNumBlocks);
+		}
+		if (m_OpenList.capacity() > PATH_MAX_POOLED_NUM_SLOTS / 2)
+		{
+			std::vector<cPathCell *>().swap(m_OpenList);
+		}
+	}
+
+
+	/** Puts the cell into the first empty slot for its location. There must be no slot for the location yet. */
+	void InsertSlot(cPathCell * a_Cell)
+	{
+		auto Mask = m_Slots.size() - 1;
+		for (auto Idx = GetHomeSlot(a_Cell->m_Location, m_Slots.size());; Idx = (Idx + 1) & Mask)
+		{
+			auto & Slot = m_Slots[Idx];
+			if (Slot.m_Generation != m_Generation)
+			{
+				Slot.m_Generation = m_Generation;
+				Slot.m_Cell = a_Cell;
+				return;
+			}
+			ASSERT(Slot.m_Cell->m_Location != a_Cell->m_Location);
+		}
+	}
+};
+
+
+
+
+
+struct cPathWorkspace::sPool
+{
+	cCriticalSection m_CS;
+	std::vector<std::unique_ptr<sStorage>> m_Spares;
+};
+
+
+
+
+
+cPathWorkspace::cPathWorkspace(void) = default;
+
+
+
+
+
+cPathWorkspace::~cPathWorkspace()
+{
+	Release();
+}
+
+
+
+
+
+cPathCell * cPathWorkspace::FindCell(const Vector3i & a_Location)
+{
+	auto & Storage = GetStorage();
+	auto Mask = Storage.m_Slots.size() - 1;
+	for (auto Idx = GetHomeSlot(a_Location, Storage.m_Slots.size());; Idx = (Idx + 1) & Mask)
+	{
+		const auto & Slot = Storage.m_Slots[Idx];
+		if (Slot.m_Generation != Storage.m_Generation)
+		{
+			// Hit an empty slot, the location is not stored
+			return nullptr;
+		}
+		if (Slot.m_Cell->m_Location == a_Location)
+		{
+			return Slot.m_Cell;
+		}
+	}
+}
+
+
+
+
+
+cPathCell * cPathWorkspace::AddCell(const Vector3i & a_Location)
+{
+	auto & Storage = GetStorage();
+	if ((Storage.m_NumCells + 1) * 2 > Storage.m_Slots.size())
+	{
+		Grow(Storage);
+	}
+
+	auto BlockIdx = Storage.m_NumCells / PATH_CELL_BLOCK_SIZE;
+	if (BlockIdx >= Storage.m_CellBlocks.size())
+	{
+		Storage.m_CellBlocks.emplace_back(new cPathCell[PATH_CELL_BLOCK_SIZE]);
+	}
+	auto Cell = &Storage.m_CellBlocks[BlockIdx][Storage.m_NumCells % PATH_CELL_BLOCK_SIZE];
+	Storage.m_NumCells += 1;
+
+	*Cell = cPathCell();
+	Cell->m_Location = a_Location;
+	Storage.InsertSlot(Cell);
+	return Cell;
+}
+
+
+
+
+
+void cPathWorkspace::OpenListPush(cPathCell * a_Cell)
+{
+	auto & OpenList = GetStorage().m_OpenList;
+	OpenList.push_back(a_Cell);
+	std::push_heap(OpenList.begin(), OpenList.end(), compareHeuristics());
+}
+
+
+
+
+
+cPathCell * cPathWorkspace::OpenListPop(void)
+{
+	auto & OpenList = GetStorage().m_OpenList;
+	if (OpenList.empty())
+	{
+		return nullptr;
+	}
+	std::pop_heap(OpenList.begin(), OpenList.end(), compareHeuristics());
+	auto Ret = OpenList.back();
+	OpenList.pop_back();
+	return Ret;
+}
+
+
+
+
+
+void cPathWorkspace::Release(void)
+{
+	if (m_Storage == nullptr)
+	{
+		return;
+	}
+
+	// Empty and trim the storage under the pool's lock, so that it is never seen by the pool in a half-reset state:
+	auto & Pool = GetPool();
+	cCSLock Lock(Pool.m_CS);
+	ASSERT(m_Storage->m_IsInUse);
+	m_Storage->Clear();
+	m_Storage->Trim();
+	m_Storage->m_IsInUse = false;
+	if (Pool.m_Spares.size() < PATH_MAX_POOLED_STORAGES)
+	{
+		Pool.m_Spares.push_back(std::move(m_Storage));
+	}
+	m_Storage.reset();
+}
+
+
+
+
+
+cPathWorkspace::sStorage & cPathWorkspace::GetStorage(void)
+{
+	if (m_Storage != nullptr)
+	{
+		return *m_Storage;
+	}
+
+	{
+		auto & Pool = GetPool();
+		cCSLock Lock(Pool.m_CS);
+		if (!Pool.m_Spares.empty())
+		{
+			m_Storage = std::move(Pool.m_Spares.back());
+			Pool.m_Spares.pop_back();
+			ASSERT(!m_Storage->m_IsInUse);
+			m_Storage->m_IsInUse = true;
+			return *m_Storage;
+		}
+	}
+	m_Storage = cpp14::make_unique<sStorage>();
+	return *m_Storage;
+}
+
+
+
+
+
+cPathWorkspace::sPool & cPathWorkspace::GetPool(void)
+{
+	static sPool Pool;
+	return Pool;
+}
+
+
+
+
+
+void cPathWorkspace::Grow(sStorage & a_Storage)
+{
+	a_Storage.m_Slots.assign(a_Storage.m_Slots.size() * 2, sStorage::sSlot{0, nullptr});
+	for (size_t i = 0; i < a_Storage.m_NumCells; ++i)
+	{
+		a_Storage.InsertSlot(&a_Storage.m_CellBlocks[i / PATH_CELL_BLOCK_SIZE][i % PATH_CELL_BLOCK_SIZE]);
+	}
+}
+
+
+
+
+
+size_t cPathWorkspace::GetHomeSlot(const Vector3i & a_Location, size_t a_NumSlots)
+{
+	// Neighboring cells differ only in the lowest bits of their coords; mix the coords so that they spread over the whole table:
+	UInt32 Hash = (static_cast<UInt32>(a_Location.x) * 73856093u) ^ (static_cast<UInt32>(a_Location.y) * 19349663u) ^ (static_cast<UInt32>(a_Location.z) * 83492791u);
+	Hash ^= Hash >> 16;
+	Hash *= 0x45d9f3bu;
+	Hash ^= Hash >> 16;
+	return static_cast<size_t>(Hash) & (a_NumSlots - 1);
+}
+
+
+
+
+
+/* cPath::sSnapshot implementation */
+
+/** The blocks around a path's starting point and destination, taken when the path is created, so that the path can be
+calculated on another thread. The chunks share their sections with the live chunks (see cChunkData::Assign()),
+so taking the snapshot while the chunkmap is locked is cheap. */
+struct cPath::sSnapshot
+{
+	/** Takes the chunk's data into the specified cChunkData. */
+	class cCollector:
+		public cChunkDataCallback
+	{
+	public:
+		cCollector(cChunkData & a_Dest):
+			m_Dest(a_Dest)
+		{
+		}
+
+	protected:
+		cChunkData & m_Dest;
+
+		virtual void ChunkData(const cChunkData & a_ChunkData) override
+		{
+			m_Dest.Assign(a_ChunkData);
+		}
+	};
+
+
+	/** The coords of the snapshotted chunk with the lowest coords, and the number of chunks along each axis. */
+	int m_MinChunkX;
+	int m_MinChunkZ;
+	int m_SizeX;
+	int m_SizeZ;
+
+	/** The pool for the snapshot's chunk data. The data only ever gets freed into it, once the live chunk stops sharing a section. */
+	cListAllocationPool<cChunkData::sChunkSection> m_Pool;
+
+	/** The snapshotted chunks, X-major; nullptr for the chunks that were not valid. */
+	std::vector<std::unique_ptr<cChunkData>> m_Chunks;
+
+
+	/** Snapshots all the chunks in the specified rectangle (inclusive), taking their data from a_ChunkDataSource. */
+	sSnapshot(cChunkDataSource a_ChunkDataSource, int a_MinChunkX, int a_MinChunkZ, int a_MaxChunkX, int a_MaxChunkZ):
+		m_MinChunkX(a_MinChunkX),
+		m_MinChunkZ(a_MinChunkZ),
+		m_SizeX(a_MaxChunkX - a_MinChunkX + 1),
+		m_SizeZ(a_MaxChunkZ - a_MinChunkZ + 1),
+		m_Pool(cpp14::make_unique<cChunkDataCopyCollector::MemCallbacks>(), 0, 0)
+	{
+		m_Chunks.reserve(static_cast<size_t>(m_SizeX * m_SizeZ));
+		for (int x = 0; x < m_SizeX; ++x)
+		{
+			for (int z = 0; z < m_SizeZ; ++z)
+			{
+				auto ChunkData = cpp14::make_unique<cChunkData>(m_Pool);
+				if (!a_ChunkDataSource(m_MinChunkX + x, m_MinChunkZ + z, *ChunkData))
+				{
+					ChunkData.reset();
+				}
+				m_Chunks.push_back(std::move(ChunkData));
+			}
+		}
+	}
+
+
+	/** Returns true if the specified chunk is inside the snapshotted rectangle. */
+	bool IsInside(int a_ChunkX, int a_ChunkZ) const
+	{
+		return (
+			(a_ChunkX >= m_MinChunkX) && (a_ChunkX < m_MinChunkX + m_SizeX) &&
+			(a_ChunkZ >= m_MinChunkZ) && (a_ChunkZ < m_MinChunkZ + m_SizeZ)
+		);
+	}
+
+
+	/** Returns the data of the specified chunk, or nullptr if the chunk was not valid. The chunk must be inside the snapshot. */
+	const cChunkData * GetChunk(int a_ChunkX, int a_ChunkZ) const
+	{
+		ASSERT(IsInside(a_ChunkX, a_ChunkZ));
+		return m_Chunks[static_cast<size_t>((a_ChunkX - m_MinChunkX) * m_SizeZ + (a_ChunkZ - m_MinChunkZ))].get();
+	}
+};
+
+
+
+
+
 /* cPath implementation */
 cPath::cPath(
 	cChunk & a_Chunk,
 	const Vector3d & a_StartingPoint, const Vector3d & a_EndingPoint, int a_MaxSteps,
 	double a_BoundingBoxWidth, double a_BoundingBoxHeight
+) :
+	cPath(
+		[&a_Chunk](int a_ChunkX, int a_ChunkZ, cChunkData & a_Dest)
+		{
+			auto Chunk = a_Chunk.GetNeighborChunk(a_ChunkX * cChunkDef::Width, a_ChunkZ * cChunkDef::Width);
+			if ((Chunk == nullptr) || !Chunk->IsValid())
+			{
+				return false;
+			}
+			sSnapshot::cCollector Collector(a_Dest);
+			Chunk->GetAllData(Collector);
+			return true;
+		},
+		a_StartingPoint, a_EndingPoint, a_MaxSteps, a_BoundingBoxWidth, a_BoundingBoxHeight
+	)
+{
+}
+
+
+
+
+
+cPath::cPath(
+	cChunkDataSource a_ChunkDataSource,
+	const Vector3d & a_StartingPoint, const Vector3d & a_EndingPoint, int a_MaxSteps,
+	double a_BoundingBoxWidth, double a_BoundingBoxHeight
 ) :
 	m_StepsLeft(a_MaxSteps),
 	m_IsValid(true),
+	m_IsCalculated(false),
+	m_IsAbandoned(false),
 	m_CurrentPoint(0),  // GetNextPoint increments this to 1, but that's fine, since the first cell is always a_StartingPoint
-	m_Chunk(&a_Chunk),
 	m_BadChunkFound(false)
 {
 
@@ -55,23 +474,33 @@ cPath::cPath(
 	m_Destination.y = FloorC(a_EndingPoint.y);
 	m_Destination.z = FloorC(a_EndingPoint.z - HalfWidthInt);
 
-	if (!IsWalkable(m_Source, m_Source))
-	{
-		m_Status = ePathFinderStatus::PATH_NOT_FOUND;
-		return;
-	}
-
-	m_NearestPointToTarget = GetCell(m_Source);
 	m_Status = ePathFinderStatus::CALCULATING;
 
-	ProcessCell(GetCell(m_Source), nullptr, 0);
+	// Snapshot the chunks spanning the source and the destination, plus a margin of a chunk for detours.
+	// The search pops at most a_MaxSteps * CALCULATIONS_PER_STEP cells, each reached from an earlier one by a single block,
+	// so it never looks farther from the source than that; a farther destination only needs the chunks up to that distance:
+	int Reach = a_MaxSteps * CALCULATIONS_PER_STEP + 1;
+	int SourceChunkX, SourceChunkZ, DestChunkX, DestChunkZ, ReachMinChunkX, ReachMinChunkZ, ReachMaxChunkX, ReachMaxChunkZ;
+	cChunkDef::BlockToChunk(m_Source.x, m_Source.z, SourceChunkX, SourceChunkZ);
+	cChunkDef::BlockToChunk(m_Destination.x, m_Destination.z, DestChunkX, DestChunkZ);
+	cChunkDef::BlockToChunk(m_Source.x - Reach, m_Source.z - Reach, ReachMinChunkX, ReachMinChunkZ);
+	cChunkDef::BlockToChunk(m_Source.x + Reach, m_Source.z + Reach, ReachMaxChunkX, ReachMaxChunkZ);
+	m_Snapshot = cpp14::make_unique<sSnapshot>(a_ChunkDataSource,
+		std::max(std::min(SourceChunkX, DestChunkX) - 1, ReachMinChunkX),
+		std::max(std::min(SourceChunkZ, DestChunkZ) - 1, ReachMinChunkZ),
+		std::min(std::max(SourceChunkX, DestChunkX) + 1, ReachMaxChunkX),
+		std::min(std::max(SourceChunkZ, DestChunkZ) + 1, ReachMaxChunkZ)
+	);
 }
 
 
 
 
 
-cPath::cPath() : m_IsValid(false)
+cPath::cPath() :
+	m_IsValid(false),
+	m_IsCalculated(false),
+	m_IsAbandoned(false)
 {
 
 }
@@ -80,39 +509,53 @@ cPath::cPath() : m_IsValid(false)
 
 
 
-ePathFinderStatus cPath::CalculationStep(cChunk & a_Chunk)
+cPath::~cPath() = default;
+
+
+
+
+
+void cPath::Calculate(void)
 {
-	m_Chunk = &a_Chunk;
-	if (m_Status != ePathFinderStatus::CALCULATING)
-	{
-		return m_Status;
-	}
+	ASSERT(m_IsValid);
+	ASSERT(!IsCalculated());
 
-	if (m_BadChunkFound)
+	if (!IsWalkable(m_Source, m_Source))
 	{
 		FinishCalculation(ePathFinderStatus::PATH_NOT_FOUND);
-		return m_Status;
 	}
-
-	if (m_StepsLeft == 0)
+	else
 	{
-		AttemptToFindAlternative();
+		m_NearestPointToTarget = GetCell(m_Source);
+		ProcessCell(GetCell(m_Source), nullptr, 0);
 	}
-	else
+
+	while (m_Status == ePathFinderStatus::CALCULATING)
 	{
+		if (m_BadChunkFound || IsAbandoned())
+		{
+			FinishCalculation(ePathFinderStatus::PATH_NOT_FOUND);
+			break;
+		}
+
+		if (m_StepsLeft == 0)
+		{
+			AttemptToFindAlternative();
+			break;
+		}
+
 		--m_StepsLeft;
-		int i;
-		for (i = 0; i < CALCULATIONS_PER_STEP; ++i)
+		for (int i = 0; i < CALCULATIONS_PER_STEP; ++i)
 		{
 			if (StepOnce())  // StepOnce returns true when no more calculation is needed.
 			{
 				break;  // if we're here, m_Status must have changed either to PATH_FOUND or PATH_NOT_FOUND.
 			}
 		}
-
-		m_Chunk = nullptr;
 	}
-	return m_Status;
+
+	m_Snapshot.reset();
+	m_IsCalculated.store(true, std::memory_order_release);
 }
 
 
@@ -348,8 +791,7 @@ void cPath::BuildPath()
 
 void cPath::FinishCalculation()
 {
-	m_Map.clear();
-	m_OpenList = std::priority_queue<cPathCell *, std::vector<cPathCell *>, compareHeuristics>{};
+	m_Workspace.Release();
 }
 
 
@@ -373,7 +815,7 @@ void cPath::FinishCalculation(ePathFinderStatus a_NewStatus)
 void cPath::OpenListAdd(cPathCell * a_Cell)
 {
 	a_Cell->m_Status = eCellStatus::OPENLIST;
-	m_OpenList.push(a_Cell);
+	m_Workspace.OpenListPush(a_Cell);
 	#ifdef COMPILING_PATHFIND_DEBUGGER
 	si::setBlock(a_Cell->m_Location.x, a_Cell->m_Location.y, a_Cell->m_Location.z, debug_open, SetMini(a_Cell));
 	#endif
@@ -385,13 +827,12 @@ void cPath::OpenListAdd(cPathCell * a_Cell)
 
 cPathCell * cPath::OpenListPop()  // Popping from the open list also means adding to the closed list.
 {
-	if (m_OpenList.size() == 0)
+	cPathCell * Ret = m_Workspace.OpenListPop();
+	if (Ret == nullptr)
 	{
 		return nullptr;  // We've exhausted the search space and nothing was found, this will trigger a PATH_NOT_FOUND or NEARBY_FOUND status.
 	}
 
-	cPathCell * Ret = m_OpenList.top();
-	m_OpenList.pop();
 	Ret->m_Status = eCellStatus::CLOSEDLIST;
 	#ifdef COMPILING_PATHFIND_DEBUGGER
 	si::setBlock((Ret)->m_Location.x, (Ret)->m_Location.y, (Ret)->m_Location.z, debug_closed, SetMini(Ret));
@@ -477,7 +918,7 @@ void cPath::FillCellAttributes(cPathCell & a_Cell)
 {
 	const Vector3i & Location = a_Cell.m_Location;
 
-	ASSERT(m_Chunk != nullptr);
+	ASSERT(m_Snapshot != nullptr);
 
 	if (!cChunkDef::IsValidHeight(Location.y))
 	{
@@ -487,8 +928,18 @@ void cPath::FillCellAttributes(cPathCell & a_Cell)
 		a_Cell.m_BlockType = E_BLOCK_AIR;
 		return;
 	}
-	auto Chunk = m_Chunk->GetNeighborChunk(Location.x, Location.z);
-	if ((Chunk == nullptr) || !Chunk->IsValid())
+	int ChunkX, ChunkZ;
+	cChunkDef::BlockToChunk(Location.x, Location.z, ChunkX, ChunkZ);
+	if (!m_Snapshot->IsInside(ChunkX, ChunkZ))
+	{
+		// Outside of the snapshot, act as a wall so that the search settles for a nearby destination
+		a_Cell.m_IsSolid = true;
+		a_Cell.m_IsSpecial = false;
+		a_Cell.m_BlockType = E_BLOCK_AIR;
+		return;
+	}
+	auto ChunkData = m_Snapshot->GetChunk(ChunkX, ChunkZ);
+	if (ChunkData == nullptr)
 	{
 		m_BadChunkFound = true;
 		a_Cell.m_IsSolid = true;
@@ -496,14 +947,10 @@ void cPath::FillCellAttributes(cPathCell & a_Cell)
 		a_Cell.m_BlockType = E_BLOCK_AIR;  // m_BlockType is never used when m_IsSpecial is false, but it may be used if we implement dijkstra
 		return;
 	}
-	m_Chunk = Chunk;
-
-	BLOCKTYPE BlockType;
-	NIBBLETYPE BlockMeta;
-	int RelX = Location.x - m_Chunk->GetPosX() * cChunkDef::Width;
-	int RelZ = Location.z - m_Chunk->GetPosZ() * cChunkDef::Width;
 
-	m_Chunk->GetBlockTypeMeta(RelX, Location.y, RelZ, BlockType, BlockMeta);
+	Vector3i RelPos(Location.x - ChunkX * cChunkDef::Width, Location.y, Location.z - ChunkZ * cChunkDef::Width);
+	BLOCKTYPE BlockType = ChunkData->GetBlock(RelPos);
+	NIBBLETYPE BlockMeta = ChunkData->GetMeta(RelPos);
 	a_Cell.m_BlockType = BlockType;
 	a_Cell.m_BlockMeta = BlockMeta;
 
@@ -534,23 +981,20 @@ void cPath::FillCellAttributes(cPathCell & a_Cell)
 
 cPathCell * cPath::GetCell(const Vector3i & a_Location)
 {
-	// Create the cell in the hash table if it's not already there.
-	if (m_Map.count(a_Location) == 0)  // Case 1: Cell is not on any list. We've never checked this cell before.
+	// Create the cell in the workspace if it's not already there.
+	cPathCell * Cell = m_Workspace.FindCell(a_Location);
+	if (Cell == nullptr)  // Case 1: Cell is not on any list. We've never checked this cell before.
 	{
-		m_Map[a_Location].m_Location = a_Location;
-		FillCellAttributes(m_Map[a_Location]);
-		m_Map[a_Location].m_Status = eCellStatus::NOLIST;
+		Cell = m_Workspace.AddCell(a_Location);
+		FillCellAttributes(*Cell);
+		Cell->m_Status = eCellStatus::NOLIST;
 		#ifdef COMPILING_PATHFIND_DEBUGGER
 			#ifdef COMPILING_PATHFIND_DEBUGGER_MARK_UNCHECKED
 				si::setBlock(a_Location.x, a_Location.y, a_Location.z, debug_unchecked, Cell->m_IsSolid ? NORMAL : MINI);
 			#endif
 		#endif
-		return &m_Map[a_Location];
-	}
-	else
-	{
-		return &m_Map[a_Location];
 	}
+	return Cell;
 }
 
 
@@ -9,17 +9,19 @@ class cPath;
 
 
 #include "../FastRandom.h"
+#include "../FunctionRef.h"
 #ifdef COMPILING_PATHFIND_DEBUGGER
 	/* Note: the COMPILING_PATHFIND_DEBUGGER flag is used by Native / WiseOldMan95 to debug
 	this class outside of Cuberite. This preprocessor flag is never set when compiling Cuberite. */
 	#include "PathFinderIrrlicht_Head.h"
 #endif
 
-#include <unordered_map>
-
 //fwd: ../Chunk.h
 class cChunk;
 
+//fwd: ../ChunkData.h
+class cChunkData;
+
 
 /* Various little structs and classes */
 enum class ePathFinderStatus {CALCULATING,  PATH_FOUND,  PATH_NOT_FOUND, NEARBY_FOUND};
@@ -64,13 +66,78 @@ public:
 
 
 
+/** Scratch memory used by a single cPath calculation: the cells visited so far, and the open list.
+The cells are kept in a flat open-addressed hash table, backed by fixed-size blocks so that pointers to cells stay valid.
+The table is emptied by bumping a generation counter instead of touching every slot, and the whole storage is recycled
+through a process-wide pool once the calculation finishes, so that, once warmed up, path calculations don't allocate. */
+class cPathWorkspace
+{
+public:
+
+	cPathWorkspace(void);
+	~cPathWorkspace();
+
+	cPathWorkspace(const cPathWorkspace &) = delete;
+	cPathWorkspace & operator = (const cPathWorkspace &) = delete;
+
+	/** Returns the cell stored for the specified location, or nullptr if there's none. */
+	cPathCell * FindCell(const Vector3i & a_Location);
+
+	/** Stores a new cell for the specified location and returns it.
+	The returned cell has all members zeroed except for m_Location. The location must not have been stored yet. */
+	cPathCell * AddCell(const Vector3i & a_Location);
+
+	/** Adds the cell to the open list. */
+	void OpenListPush(cPathCell * a_Cell);
+
+	/** Removes the cell with the lowest F from the open list and returns it. Returns nullptr if the open list is empty. */
+	cPathCell * OpenListPop(void);
+
+	/** Forgets all cells and the open list, and returns the storage to the pool.
+	The workspace may still be used afterwards, it will acquire new storage on demand. */
+	void Release(void);
+
+private:
+
+	struct sStorage;
+	struct sPool;
+
+	/** The storage currently used by this workspace; nullptr if none acquired yet. */
+	std::unique_ptr<sStorage> m_Storage;
+
+	/** Returns the storage used by this workspace, acquiring one from the pool if needed. */
+	sStorage & GetStorage(void);
+
+	/** Returns the process-wide pool of spare storages. */
+	static sPool & GetPool(void);
+
+	/** Doubles the number of hash slots and re-inserts all the stored cells. */
+	static void Grow(sStorage & a_Storage);
+
+	/** Returns the slot index at which the specified location is to be searched first. */
+	static size_t GetHomeSlot(const Vector3i & a_Location, size_t a_NumSlots);
+};
+
+
+
+
+
 class cPath
 {
 public:
+
+	/** Provides the blocks of a single chunk for the snapshot: copies the data of the specified chunk into a_Dest.
+	Returns false if the chunk is not available. */
+	using cChunkDataSource = cFunctionRef<bool(int a_ChunkX, int a_ChunkZ, cChunkData & a_Dest)>;
+
+
 	/** Creates a pathfinder instance.
-	After calling this, you are expected to call CalculationStep() once per tick or once per several ticks
-	until it returns something other than CALCULATING.
+	Takes a snapshot of the blocks around the starting point and the destination, so that the path can then be calculated
+	on another thread; the chunkmap must be locked by the caller (it is while a_Chunk is being ticked).
+	After creating the path, call Calculate(), usually through cPathCalculatorThread, and query the result once
+	IsCalculated() returns true.
 
+	@param a_Chunk Any chunk near the starting point, used to look up the chunks to snapshot.
 	@param a_StartingPoint The function expects this position to be the lowest block the mob is in, a rule of thumb: "The block where the Zombie's knees are at".
 	@param a_EndingPoint "The block where the Zombie's knees want to be".
 	@param a_MaxSteps The maximum steps before giving up.
@@ -82,9 +149,19 @@ public:
 		double a_BoundingBoxWidth, double a_BoundingBoxHeight
 	);
 
+	/** Creates a pathfinder instance that takes its snapshot from a_ChunkDataSource rather than from the live chunks.
+	The parameters are the same as above. */
+	cPath(
+		cChunkDataSource a_ChunkDataSource,
+		const Vector3d & a_StartingPoint, const Vector3d & a_EndingPoint, int a_MaxSteps,
+		double a_BoundingBoxWidth, double a_BoundingBoxHeight
+	);
+
 	/** Creates an invalid path which is not usable. You shouldn't call any method other than isValid on such a path. */
 	cPath();
 
+	~cPath();
+
 	/** delete default constructors */
 	cPath(const cPath & a_other) = delete;
 	cPath(cPath && a_other) = delete;
@@ -92,15 +169,43 @@ public:
 	cPath & operator=(const cPath & a_other) = delete;
 	cPath & operator=(cPath && a_other) = delete;
 
-	/** Performs part of the path calculation and returns the appropriate status.
+	/** Calculates the whole path from the snapshot taken in the constructor, then releases the snapshot.
+	Reads no live chunks, so it may be called from any thread, but only once.
+	If the path gets abandoned meanwhile, the calculation stops early with PATH_NOT_FOUND. */
+	void Calculate(void);
+
+	/** Marks the path as no longer wanted by its owner, who won't query its result.
+	A queued path is then skipped by cPathCalculatorThread, and a path being calculated stops early. May be called from any thread. */
+	void Abandon(void)
+	{
+		m_IsAbandoned.store(true, std::memory_order_relaxed);
+	}
+
+	/** Returns true if the path's owner has called Abandon(). */
+	bool IsAbandoned(void) const
+	{
+		return m_IsAbandoned.load(std::memory_order_relaxed);
+	}
+
+	/** Returns true once Calculate() has finished. The thread that owns the path may then query the results. */
+	inline bool IsCalculated() const
+	{
+		return m_IsCalculated.load(std::memory_order_acquire);
+	}
+
+	/** Returns the result of the calculation. Only valid once IsCalculated() returns true.
 	If PATH_FOUND is returned, the path was found, and you can call query the instance for waypoints via GetNextWayPoint, etc.
 	If NEARBY_FOUND is returned, it means that the destination is not reachable, but a nearby destination
 	is reachable. If the user likes the alternative destination, they can call AcceptNearbyPath to treat the path as found,
-	and to make consequent calls to step return PATH_FOUND
+	and to make consequent calls to GetStatus return PATH_FOUND
 	If PATH_NOT_FOUND is returned, then no path was found. */
-	ePathFinderStatus CalculationStep(cChunk & a_Chunk);
+	inline ePathFinderStatus GetStatus() const
+	{
+		ASSERT(IsCalculated());
+		return m_Status;
+	}
 
-	/** Called after the PathFinder's step returns NEARBY_FOUND.
+	/** Called after GetStatus() returns NEARBY_FOUND.
 	Changes the PathFinder status from NEARBY_FOUND to PATH_FOUND, returns the nearby destination that
 	the PathFinder found a path to. */
 	Vector3i AcceptNearbyPath();
@@ -152,8 +257,10 @@ public:
 
 private:
 
+	struct sSnapshot;
+
 	/* General */
-	bool StepOnce();  // The public version just calls this version * CALCULATIONS_PER_CALL times.
+	bool StepOnce();  // Calculate() calls this until the calculation is finished.
 	void FinishCalculation();  // Clears the memory used for calculating the path.
 	void FinishCalculation(ePathFinderStatus a_NewStatus);  // Clears the memory used for calculating the path and changes the status.
 	void AttemptToFindAlternative();
@@ -169,8 +276,7 @@ private:
 	cPathCell * GetCell(const Vector3i & a_location);
 
 	/* Pathfinding fields */
-	std::priority_queue<cPathCell *,  std::vector<cPathCell *>,  compareHeuristics> m_OpenList;
-	std::unordered_map<Vector3i, cPathCell, VectorHasher<int>> m_Map;
+	cPathWorkspace m_Workspace;  // Holds the open list and all the cells visited so far
 	Vector3i m_Destination;
 	Vector3i m_Source;
 	int m_BoundingBoxWidth;
@@ -182,14 +288,16 @@ private:
 	/* Control fields */
 	ePathFinderStatus m_Status;
 	bool m_IsValid;
+	std::atomic<bool> m_IsCalculated;  // Set by Calculate() once it's done; the other fields may then be read by the path's owner
+	std::atomic<bool> m_IsAbandoned;  // Set by Abandon() once the owner no longer wants the result
 
 	/* Final path fields */
 	size_t m_CurrentPoint;
 	std::vector<Vector3i> m_PathPoints;
 
 	/* Interfacing with the world */
-	void FillCellAttributes(cPathCell & a_Cell);  // Query our hosting world and fill the cell with info
-	cChunk * m_Chunk;  // Only valid inside Step()!
+	void FillCellAttributes(cPathCell & a_Cell);  // Query the snapshot and fill the cell with info
+	std::unique_ptr<sSnapshot> m_Snapshot;  // The blocks the path is calculated from; released once the calculation finishes
 	bool m_BadChunkFound;
 
 	/* High level world queries */
@@ -0,0 +1,110 @@
+// PathCalculatorThread.cpp
+
+// Implements the cPathCalculatorThread class representing the thread that calculates the mobs' paths off the tick thread
+
+#include "Globals.h"
+#include "PathCalculatorThread.h"
+#include "Path.h"
+
+
+
+
+
+cPathCalculatorThread::cPathCalculatorThread(void) :
+	Super("cPathCalculatorThread")
+{
+}
+
+
+
+
+
+cPathCalculatorThread::~cPathCalculatorThread()
+{
+	Stop();
+}
+
+
+
+
+
+void cPathCalculatorThread::Stop(void)
+{
+	{
+		cCSLock Lock(m_CS);
+		m_Queue.clear();
+	}
+	m_ShouldTerminate = true;
+	m_evtItemAdded.Set();
+
+	Super::Stop();
+}
+
+
+
+
+
+void cPathCalculatorThread::QueuePath(std::shared_ptr<cPath> a_Path)
+{
+	{
+		cCSLock Lock(m_CS);
+		m_Queue.push_back(std::move(a_Path));
+	}
+	m_evtItemAdded.Set();
+}
+
+
+
+
+
+size_t cPathCalculatorThread::GetQueueLength(void)
+{
+	cCSLock Lock(m_CS);
+	return m_Queue.size();
+}
+
+
+
+
+
+void cPathCalculatorThread::Execute(void)
+{
+	for (;;)
+	{
+		{
+			cCSLock Lock(m_CS);
+			if (m_Queue.empty())
+			{
+				cCSUnlock Unlock(Lock);
+				m_evtItemAdded.Wait();
+			}
+		}
+
+		if (m_ShouldTerminate)
+		{
+			return;
+		}
+
+		// Process one path from the queue:
+		std::shared_ptr<cPath> Path;
+		{
+			cCSLock Lock(m_CS);
+			if (m_Queue.empty())
+			{
+				continue;
+			}
+			Path = std::move(m_Queue.front());
+			m_Queue.pop_front();
+		}
+
+		// If the path finder has already replaced the path with a newer one, or was destroyed, nobody is waiting for the result:
+		if (!Path->IsAbandoned())
+		{
+			Path->Calculate();
+		}
+	}
+}
+
+
+
+
@@ -0,0 +1,63 @@
+// PathCalculatorThread.h
+
+// Interfaces to the cPathCalculatorThread class representing the thread that calculates the mobs' paths off the tick thread
+
+
+
+
+
+#pragma once
+
+#include "../OSSupport/IsThread.h"
+
+
+
+
+
+class cPath;
+
+
+
+
+
+/** Calculates the mobs' paths, so that the A* search doesn't run on the world's tick thread.
+Each cPath snapshots the blocks around its starting point when it is created, so the calculation reads no live chunks
+and needs no locks on the world. The mob's cPathFinder queues its path here and polls cPath::IsCalculated() on its next ticks. */
+class cPathCalculatorThread:
+	public cIsThread
+{
+	using Super = cIsThread;
+
+public:
+
+	cPathCalculatorThread(void);
+	virtual ~cPathCalculatorThread() override;
+
+	void Stop(void);
+
+	/** Queues the path for calculation.
+	The path is shared with the caller, who mustn't touch it until its IsCalculated() returns true.
+	Paths that the caller has abandoned (cPath::Abandon()) are skipped. */
+	void QueuePath(std::shared_ptr<cPath> a_Path);
+
+	size_t GetQueueLength(void);
+
+protected:
+
+	/** The mutex protecting m_Queue. */
+	cCriticalSection m_CS;
+
+	/** The paths waiting to be calculated. */
+	std::deque<std::shared_ptr<cPath>> m_Queue;
+
+	/** Set when a path is queued, or to stop the thread. */
+	cEvent m_evtItemAdded;
+
+
+	// cIsThread override:
+	virtual void Execute(void) override;
+};
+
+
+
+
@@ -2,6 +2,7 @@
 #include "PathFinder.h"
 #include "../BlockInfo.h"
 #include "../Chunk.h"
+#include "../World.h"
 
 
 
@@ -20,6 +21,18 @@ cPathFinder::cPathFinder(double a_MobWidth, double a_MobHeight) :
 
 
 
+cPathFinder::~cPathFinder()
+{
+	if (m_Path != nullptr)
+	{
+		m_Path->Abandon();
+	}
+}
+
+
+
+
+
 ePathFinderStatus cPathFinder::GetNextWayPoint(cChunk & a_Chunk, const Vector3d & a_Source, Vector3d * a_Destination, Vector3d * a_OutputWaypoint, bool a_DontCare)
 {
 	m_FinalDestination = *a_Destination;
@@ -60,7 +73,13 @@ ePathFinderStatus cPathFinder::GetNextWayPoint(cChunk & a_Chunk, const Vector3d
 		ResetPathFinding(a_Chunk);
 	}
 
-	switch (m_Path->CalculationStep(a_Chunk))
+	// Wait for the path calculator thread to finish the path:
+	if (!m_Path->IsCalculated())
+	{
+		return ePathFinderStatus::CALCULATING;
+	}
+
+	switch (m_Path->GetStatus())
 	{
 		case ePathFinderStatus::NEARBY_FOUND:
 		{
@@ -167,7 +186,13 @@ void cPathFinder::ResetPathFinding(cChunk &a_Chunk)
 	m_NoPathToTarget = false;
 	m_PathDestination = m_FinalDestination;
 	m_DeviationOrigin = m_PathDestination;
-	m_Path.reset(new cPath(a_Chunk, m_Source, m_PathDestination, 20, m_Width, m_Height));
+	if (m_Path != nullptr)
+	{
+		// Let the calculator thread skip the old path, if it's still queued:
+		m_Path->Abandon();
+	}
+	m_Path = std::make_shared<cPath>(a_Chunk, m_Source, m_PathDestination, 20, m_Width, m_Height);
+	a_Chunk.GetWorld()->GetPathCalculator().QueuePath(m_Path);
 }
 
 
@@ -18,6 +18,9 @@ public:
 	*/
 	cPathFinder(double a_MobWidth, double a_MobHeight);
 
+	/** Abandons the path still being calculated, if any. */
+	~cPathFinder();
+
 	/** Updates the PathFinder's internal state and returns a waypoint.
 	A waypoint is a coordinate which the mob can safely move to from its current position in a straight line.
 	The mob is expected to call this function tick as long as it is following a path.
@@ -30,7 +33,7 @@ public:
 	In the future, idle mobs shouldn't use A* at all.
 
 	Returns an ePathFinderStatus.
-	ePathFinderStatus:CALCULATING - The PathFinder is still processing a path. Nothing was written to a_OutputWaypoint. The mob should probably not move.
+	ePathFinderStatus:CALCULATING - The PathFinder is still processing a path (on the world's cPathCalculatorThread). Nothing was written to a_OutputWaypoint. The mob should probably not move.
 	ePathFinderStatus:PATH_FOUND - The PathFinder has found a path to the target. The next waypoint was written a_OutputWaypoint. The mob should probably move to a_OutputWaypoint.
 	ePathFinderStatus:NEARBY_FOUND - The PathFinder did not find a destination to the target but did find a nearby spot. The next waypoint was written a_OutputWaypoint. The mob should probably move to a_OutputWaypoint.
 	ePathFinderStatus:PATH_NOT_FOUND - The PathFinder did not find a destination to the target. Nothing was written to a_OutputWaypoint. The mob should probably not move.
@@ -46,8 +49,9 @@ private:
 	/** The height of the Mob which owns this PathFinder. */
 	double m_Height;
 
-	/** The current cPath instance we have. This is discarded and recreated when a path recalculation is needed. */
-	std::unique_ptr<cPath> m_Path;
+	/** The current cPath instance we have. This is discarded and recreated when a path recalculation is needed.
+	Shared with the world's cPathCalculatorThread until the path is calculated; abandoned when discarded. */
+	std::shared_ptr<cPath> m_Path;
 
 	/** If 0, will give up reaching the next m_WayPoint and will recalculate path. */
 	int m_GiveUpCounter;
@@ -81,7 +85,8 @@ private:
 	2. If a_Vector is the position of air, a_Vector's Y will be modified to point to the first airblock below it which has solid or water beneath. */
 	bool EnsureProperPoint(Vector3d & a_Vector, cChunk & a_Chunk);
 
-	/** Resets a pathfinding task, typically because m_FinalDestination has deviated too much from m_DeviationOrigin. */
+	/** Resets a pathfinding task, typically because m_FinalDestination has deviated too much from m_DeviationOrigin.
+	Queues the new path for calculation on the world's cPathCalculatorThread. */
 	void ResetPathFinding(cChunk &a_Chunk);
 
 	/** Return true the the blocktype is either water or solid */
@@ -28,7 +28,10 @@ struct cMonsterConfig::sAttributesStruct
 struct cMonsterConfig::sMonsterConfigState
 {
 	AString MonsterTypes;
-	std::list< sAttributesStruct > AttributesList;
+
+	/** The attributes of each monster type, mapped by the monster's name.
+	Looked up each time a monster is created, so a hashed map is used. */
+	std::unordered_map<AString, sAttributesStruct> Attributes;
 };
 
 
@@ -65,7 +68,9 @@ void cMonsterConfig::Initialize()
 		return;
 	}
 
-	for (int i = static_cast<int>(MonstersIniFile.GetNumKeys()); i >= 0; i--)
+	int NumKeys = MonstersIniFile.GetNumKeys();
+	m_pState->Attributes.reserve(static_cast<size_t>(NumKeys));
+	for (int i = 0; i < NumKeys; i++)
 	{
 		sAttributesStruct Attributes;
 		AString Name = MonstersIniFile.GetKeyName(i);
@@ -77,8 +82,8 @@ void cMonsterConfig::Initialize()
 		Attributes.m_MaxHealth       = MonstersIniFile.GetValueF(Name, "MaxHealth",       1);
 		Attributes.m_IsFireproof     = MonstersIniFile.GetValueB(Name, "IsFireproof",     false);
 		Attributes.m_BurnsInDaylight = MonstersIniFile.GetValueB(Name, "BurnsInDaylight", false);
-		m_pState->AttributesList.push_front(Attributes);
-	}  // for i - SplitList[]
+		m_pState->Attributes.emplace(Name, Attributes);  // If the monster is listed multiple times, the first one is used
+	}  // for i - MonstersIniFile keys
 }
 
 
@@ -87,21 +92,19 @@ void cMonsterConfig::Initialize()
 
 void cMonsterConfig::AssignAttributes(cMonster * a_Monster, const AString & a_Name)
 {
-	std::list<sAttributesStruct>::const_iterator itr;
-	for (itr = m_pState->AttributesList.begin(); itr != m_pState->AttributesList.end(); ++itr)
+	auto itr = m_pState->Attributes.find(a_Name);
+	if (itr == m_pState->Attributes.end())
 	{
-		if (itr->m_Name.compare(a_Name) == 0)
-		{
-			a_Monster->SetAttackDamage   (itr->m_AttackDamage);
-			a_Monster->SetAttackRange    (itr->m_AttackRange);
-			a_Monster->SetSightDistance  (itr->m_SightDistance);
-			a_Monster->SetAttackRate     (static_cast<float>(itr->m_AttackRate));
-			a_Monster->SetMaxHealth      (static_cast<float>(itr->m_MaxHealth));
-			a_Monster->SetIsFireproof    (itr->m_IsFireproof);
-			a_Monster->SetBurnsInDaylight(itr->m_BurnsInDaylight);
-			return;
-		}
-	}  // for itr - m_pState->AttributesList[]
+		return;
+	}
+	const auto & Attributes = itr->second;
+	a_Monster->SetAttackDamage   (Attributes.m_AttackDamage);
+	a_Monster->SetAttackRange    (Attributes.m_AttackRange);
+	a_Monster->SetSightDistance  (Attributes.m_SightDistance);
+	a_Monster->SetAttackRate     (static_cast<float>(Attributes.m_AttackRate));
+	a_Monster->SetMaxHealth      (static_cast<float>(Attributes.m_MaxHealth));
+	a_Monster->SetIsFireproof    (Attributes.m_IsFireproof);
+	a_Monster->SetBurnsInDaylight(Attributes.m_BurnsInDaylight);
 }
 
 
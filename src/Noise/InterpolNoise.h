@@ -20,7 +20,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 // cInterpolCell2D:
 
-template <typename T>
+/** Interpolates between the noise values at integral coords en masse, see cInterpolCell3D.
+The fractional values are expected to have the interpolation curve already applied, so that it is calculated only once per coord. */
 class cInterpolCell2D
 {
 public:
@@ -28,8 +29,8 @@ public:
 		const cNoise & a_Noise,    ///< Noise to use for generating the random values
 		NOISE_DATATYPE * a_Array,  ///< Array to generate into [x + a_SizeX * y]
 		int a_SizeX, int a_SizeY,  ///< Count of the array, in each direction
-		const NOISE_DATATYPE * a_FracX,  ///< Pointer to the array that stores the X fractional values
-		const NOISE_DATATYPE * a_FracY   ///< Pointer to the attay that stores the Y fractional values
+		const NOISE_DATATYPE * a_FracX,  ///< Pointer to the array that stores the X interpolation coefficients
+		const NOISE_DATATYPE * a_FracY   ///< Pointer to the attay that stores the Y interpolation coefficients
 	):
 		m_Noise(a_Noise),
 		m_WorkRnds(&m_Workspace1),
@@ -53,13 +54,13 @@ public:
 		for (int y = a_FromY; y < a_ToY; y++)
 		{
 			NOISE_DATATYPE Interp[2];
-			NOISE_DATATYPE FracY = T::coeff(m_FracY[y]);
+			NOISE_DATATYPE FracY = m_FracY[y];
 			Interp[0] = Lerp((*m_WorkRnds)[0][0], (*m_WorkRnds)[0][1], FracY);
 			Interp[1] = Lerp((*m_WorkRnds)[1][0], (*m_WorkRnds)[1][1], FracY);
 			int idx = y * m_SizeX + a_FromX;
 			for (int x = a_FromX; x < a_ToX; x++)
 			{
-				m_Array[idx++] = Lerp(Interp[0], Interp[1], T::coeff(m_FracX[x]));
+				m_Array[idx++] = Lerp(Interp[0], Interp[1], m_FracX[x]);
 			}  // for x
 		}  // for y
 	}
@@ -136,7 +137,7 @@ protected:
 	/** Dimensions of the output array. */
 	int m_SizeX, m_SizeY;
 
-	/** Arrays holding the fractional values of the coords in each direction. */
+	/** Arrays holding the interpolation coefficients of the coords in each direction. */
 	const NOISE_DATATYPE * m_FracX;
 	const NOISE_DATATYPE * m_FracY;
 } ;
@@ -151,8 +152,8 @@ protected:
 /** Holds a cache of the last calculated integral noise values and interpolates between them en masse.
 Provides a massive optimization for cInterpolNoise.
 Works by calculating multiple noise values (that have the same integral noise coords) at once. The underlying noise values
-needn't be recalculated for these values, only the interpolation is done within the unit cube. */
-template <typename T>
+needn't be recalculated for these values, only the interpolation is done within the unit cube.
+The fractional values are expected to have the interpolation curve already applied, so that it is calculated only once per coord. */
 class cInterpolCell3D
 {
 public:
@@ -160,9 +161,9 @@ public:
 		const cNoise & a_Noise,                 ///< Noise to use for generating the random values
 		NOISE_DATATYPE * a_Array,               ///< Array to generate into [x + a_SizeX * y]
 		int a_SizeX, int a_SizeY, int a_SizeZ,  ///< Count of the array, in each direction
-		const NOISE_DATATYPE * a_FracX,         ///< Pointer to the array that stores the X fractional values
-		const NOISE_DATATYPE * a_FracY,         ///< Pointer to the attay that stores the Y fractional values
-		const NOISE_DATATYPE * a_FracZ          ///< Pointer to the array that stores the Z fractional values
+		const NOISE_DATATYPE * a_FracX,         ///< Pointer to the array that stores the X interpolation coefficients
+		const NOISE_DATATYPE * a_FracY,         ///< Pointer to the attay that stores the Y interpolation coefficients
+		const NOISE_DATATYPE * a_FracZ          ///< Pointer to the array that stores the Z interpolation coefficients
 	):
 		m_Noise(a_Noise),
 		m_WorkRnds(&m_Workspace1),
@@ -191,7 +192,7 @@ public:
 		{
 			int idxZ = z * m_SizeX * m_SizeY;
 			NOISE_DATATYPE Interp2[2][2];
-			NOISE_DATATYPE FracZ = T::coeff(m_FracZ[z]);
+			NOISE_DATATYPE FracZ = m_FracZ[z];
 			for (int x = 0; x < 2; x++)
 			{
 				for (int y = 0; y < 2; y++)
@@ -202,13 +203,13 @@ public:
 			for (int y = a_FromY; y < a_ToY; y++)
 			{
 				NOISE_DATATYPE Interp[2];
-				NOISE_DATATYPE FracY = T::coeff(m_FracY[y]);
+				NOISE_DATATYPE FracY = m_FracY[y];
 				Interp[0] = Lerp(Interp2[0][0], Interp2[0][1], FracY);
 				Interp[1] = Lerp(Interp2[1][0], Interp2[1][1], FracY);
 				int idx = idxZ + y * m_SizeX + a_FromX;
 				for (int x = a_FromX; x < a_ToX; x++)
 				{
-					m_Array[idx++] = Lerp(Interp[0], Interp[1], T::coeff(m_FracX[x]));
+					m_Array[idx++] = Lerp(Interp[0], Interp[1], m_FracX[x]);
 				}  // for x
 			}  // for y
 		}  // for z
@@ -299,7 +300,7 @@ protected:
 	/** Dimensions of the output array. */
 	int m_SizeX, m_SizeY, m_SizeZ;
 
-	/** Arrays holding the fractional values of the coords in each direction. */
+	/** Arrays holding the interpolation coefficients of the coords in each direction. */
 	const NOISE_DATATYPE * m_FracX;
 	const NOISE_DATATYPE * m_FracY;
 	const NOISE_DATATYPE * m_FracZ;
@@ -358,7 +359,7 @@ public:
 		CalcFloorFrac(a_SizeX, a_StartX, a_EndX, FloorX, FracX, SameX, NumSameX);
 		CalcFloorFrac(a_SizeY, a_StartY, a_EndY, FloorY, FracY, SameY, NumSameY);
 
-		cInterpolCell2D<T> Cell(m_Noise, a_Array, a_SizeX, a_SizeY, FracX, FracY);
+		cInterpolCell2D Cell(m_Noise, a_Array, a_SizeX, a_SizeY, FracX, FracY);
 
 		Cell.InitWorkRnds(FloorX[0], FloorY[0]);
 
@@ -417,7 +418,7 @@ public:
 		CalcFloorFrac(a_SizeY, a_StartY, a_EndY, FloorY, FracY, SameY, NumSameY);
 		CalcFloorFrac(a_SizeZ, a_StartZ, a_EndZ, FloorZ, FracZ, SameZ, NumSameZ);
 
-		cInterpolCell3D<T> Cell(
+		cInterpolCell3D Cell(
 			m_Noise, a_Array,
 			a_SizeX, a_SizeY, a_SizeZ,
 			FracX, FracY, FracZ
@@ -460,7 +461,7 @@ protected:
 
 	/** Calculates the integral and fractional parts along one axis.
 	a_Floor will receive the integral parts (array of a_Size ints).
-	a_Frac will receive the fractional parts (array of a_Size floats).
+	a_Frac will receive the fractional parts, with the interpolation curve T already applied (array of a_Size floats).
 	a_Same will receive the counts of items that have the same integral parts (array of up to a_Size ints).
 	a_NumSame will receive the count of a_Same elements (total count of different integral parts). */
 	void CalcFloorFrac(
@@ -478,7 +479,7 @@ protected:
 		for (int i = 0; i < a_Size; i++)
 		{
 			a_Floor[i] = FAST_FLOOR(val);
-			a_Frac[i] = val - a_Floor[i];
+			a_Frac[i] = T::coeff(val - a_Floor[i]);
 			val += dif;
 		}
 
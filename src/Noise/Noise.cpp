@@ -217,6 +217,8 @@ public:
 	void Move(int a_NewFloorX, int a_NewFloorY);
 
 protected:
+	/** The random values at the 4 * 4 integral coords around the cell, indexed as [y][x].
+	X is the innermost index so that the values interpolated along Y are contiguous for all four X columns. */
 	typedef NOISE_DATATYPE Workspace[4][4];
 
 	const cNoise & m_Noise;
@@ -265,14 +267,16 @@ void cCubicCell2D::Generate(
 	int a_FromY, int a_ToY
 )
 {
+	const Workspace & WorkRnds = *m_WorkRnds;
 	for (int y = a_FromY; y < a_ToY; y++)
 	{
+		// Interpolate all four X columns along Y at once; the loop is written so that the compiler can vectorize it:
 		NOISE_DATATYPE Interp[4];
 		NOISE_DATATYPE FracY = m_FracY[y];
-		Interp[0] = cNoise::CubicInterpolate((*m_WorkRnds)[0][0], (*m_WorkRnds)[0][1], (*m_WorkRnds)[0][2], (*m_WorkRnds)[0][3], FracY);
-		Interp[1] = cNoise::CubicInterpolate((*m_WorkRnds)[1][0], (*m_WorkRnds)[1][1], (*m_WorkRnds)[1][2], (*m_WorkRnds)[1][3], FracY);
-		Interp[2] = cNoise::CubicInterpolate((*m_WorkRnds)[2][0], (*m_WorkRnds)[2][1], (*m_WorkRnds)[2][2], (*m_WorkRnds)[2][3], FracY);
-		Interp[3] = cNoise::CubicInterpolate((*m_WorkRnds)[3][0], (*m_WorkRnds)[3][1], (*m_WorkRnds)[3][2], (*m_WorkRnds)[3][3], FracY);
+		for (int x = 0; x < 4; x++)
+		{
+			Interp[x] = cNoise::CubicInterpolate(WorkRnds[0][x], WorkRnds[1][x], WorkRnds[2][x], WorkRnds[3][x], FracY);
+		}
 		int idx = y * m_SizeX + a_FromX;
 		for (int x = a_FromX; x < a_ToX; x++)
 		{
@@ -289,13 +293,13 @@ void cCubicCell2D::InitWorkRnds(int a_FloorX, int a_FloorY)
 {
 	m_CurFloorX = a_FloorX;
 	m_CurFloorY = a_FloorY;
-	for (int x = 0; x < 4; x++)
+	for (int y = 0; y < 4; y++)
 	{
-		int cx = a_FloorX + x - 1;
-		for (int y = 0; y < 4; y++)
+		int cy = a_FloorY + y - 1;
+		for (int x = 0; x < 4; x++)
 		{
-			int cy = a_FloorY + y - 1;
-			(*m_WorkRnds)[x][y] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise2D(cx, cy));
+			int cx = a_FloorX + x - 1;
+			(*m_WorkRnds)[y][x] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise2D(cx, cy));
 		}
 	}
 }
@@ -315,21 +319,21 @@ void cCubicCell2D::Move(int a_NewFloorX, int a_NewFloorY)
 	// Reuse as much of the old workspace as possible:
 	int DiffX = OldFloorX - a_NewFloorX;
 	int DiffY = OldFloorY - a_NewFloorY;
-	for (int x = 0; x < 4; x++)
+	for (int y = 0; y < 4; y++)
 	{
-		int cx = a_NewFloorX + x - 1;
-		int OldX = x - DiffX;  // Where would this X be in the old grid?
-		for (int y = 0; y < 4; y++)
+		int cy = a_NewFloorY + y - 1;
+		int OldY = y - DiffY;  // Where would this Y be in the old grid?
+		for (int x = 0; x < 4; x++)
 		{
-			int cy = a_NewFloorY + y - 1;
-			int OldY = y - DiffY;  // Where would this Y be in the old grid?
+			int cx = a_NewFloorX + x - 1;
+			int OldX = x - DiffX;  // Where would this X be in the old grid?
 			if ((OldX >= 0) && (OldX < 4) && (OldY >= 0) && (OldY < 4))
 			{
-				(*m_WorkRnds)[x][y] = (*OldWorkRnds)[OldX][OldY];
+				(*m_WorkRnds)[y][x] = (*OldWorkRnds)[OldY][OldX];
 			}
 			else
 			{
-				(*m_WorkRnds)[x][y] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise2D(cx, cy));
+				(*m_WorkRnds)[y][x] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise2D(cx, cy));
 			}
 		}
 	}
@@ -370,6 +374,8 @@ public:
 	void Move(int a_NewFloorX, int a_NewFloorY, int a_NewFloorZ);
 
 protected:
+	/** The random values at the 4 * 4 * 4 integral coords around the cell, indexed as [z][y][x].
+	X is the innermost index so that the values interpolated along Z (and then Y) are contiguous. */
 	typedef NOISE_DATATYPE Workspace[4][4][4];
 
 	const cNoise & m_Noise;
@@ -425,26 +431,30 @@ void cCubicCell3D::Generate(
 	int a_FromZ, int a_ToZ
 )
 {
+	const Workspace & WorkRnds = *m_WorkRnds;
 	for (int z = a_FromZ; z < a_ToZ; z++)
 	{
 		int idxZ = z * m_SizeX * m_SizeY;
+
+		// Interpolate all 16 XY columns along Z at once, indexed as [y][x];
+		// the loops are written so that the compiler can vectorize them:
 		NOISE_DATATYPE Interp2[4][4];
 		NOISE_DATATYPE FracZ = m_FracZ[z];
-		for (int x = 0; x < 4; x++)
+		for (int y = 0; y < 4; y++)
 		{
-			for (int y = 0; y < 4; y++)
+			for (int x = 0; x < 4; x++)
 			{
-				Interp2[x][y] = cNoise::CubicInterpolate((*m_WorkRnds)[x][y][0], (*m_WorkRnds)[x][y][1], (*m_WorkRnds)[x][y][2], (*m_WorkRnds)[x][y][3], FracZ);
+				Interp2[y][x] = cNoise::CubicInterpolate(WorkRnds[0][y][x], WorkRnds[1][y][x], WorkRnds[2][y][x], WorkRnds[3][y][x], FracZ);
 			}
 		}
 		for (int y = a_FromY; y < a_ToY; y++)
 		{
 			NOISE_DATATYPE Interp[4];
 			NOISE_DATATYPE FracY = m_FracY[y];
-			Interp[0] = cNoise::CubicInterpolate(Interp2[0][0], Interp2[0][1], Interp2[0][2], Interp2[0][3], FracY);
-			Interp[1] = cNoise::CubicInterpolate(Interp2[1][0], Interp2[1][1], Interp2[1][2], Interp2[1][3], FracY);
-			Interp[2] = cNoise::CubicInterpolate(Interp2[2][0], Interp2[2][1], Interp2[2][2], Interp2[2][3], FracY);
-			Interp[3] = cNoise::CubicInterpolate(Interp2[3][0], Interp2[3][1], Interp2[3][2], Interp2[3][3], FracY);
+			for (int x = 0; x < 4; x++)
+			{
+				Interp[x] = cNoise::CubicInterpolate(Interp2[0][x], Interp2[1][x], Interp2[2][x], Interp2[3][x], FracY);
+			}
 			int idx = idxZ + y * m_SizeX + a_FromX;
 			for (int x = a_FromX; x < a_ToX; x++)
 			{
@@ -463,16 +473,16 @@ void cCubicCell3D::InitWorkRnds(int a_FloorX, int a_FloorY, int a_FloorZ)
 	m_CurFloorX = a_FloorX;
 	m_CurFloorY = a_FloorY;
 	m_CurFloorZ = a_FloorZ;
-	for (int x = 0; x < 4; x++)
+	for (int z = 0; z < 4; z++)
 	{
-		int cx = a_FloorX + x - 1;
+		int cz = a_FloorZ + z - 1;
 		for (int y = 0; y < 4; y++)
 		{
 			int cy = a_FloorY + y - 1;
-			for (int z = 0; z < 4; z++)
+			for (int x = 0; x < 4; x++)
 			{
-				int cz = a_FloorZ + z - 1;
-				(*m_WorkRnds)[x][y][z] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise3D(cx, cy, cz));
+				int cx = a_FloorX + x - 1;
+				(*m_WorkRnds)[z][y][x] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise3D(cx, cy, cz));
 			}
 		}
 	}
@@ -495,29 +505,29 @@ void cCubicCell3D::Move(int a_NewFloorX, int a_NewFloorY, int a_NewFloorZ)
 	int DiffX = OldFloorX - a_NewFloorX;
 	int DiffY = OldFloorY - a_NewFloorY;
 	int DiffZ = OldFloorZ - a_NewFloorZ;
-	for (int x = 0; x < 4; x++)
+	for (int z = 0; z < 4; z++)
 	{
-		int cx = a_NewFloorX + x - 1;
-		int OldX = x - DiffX;  // Where would this X be in the old grid?
+		int cz = a_NewFloorZ + z - 1;
+		int OldZ = z - DiffZ;  // Where would this Z be in the old grid?
 		for (int y = 0; y < 4; y++)
 		{
 			int cy = a_NewFloorY + y - 1;
 			int OldY = y - DiffY;  // Where would this Y be in the old grid?
-			for (int z = 0; z < 4; z++)
+			for (int x = 0; x < 4; x++)
 			{
-				int cz = a_NewFloorZ + z - 1;
-				int OldZ = z - DiffZ;
+				int cx = a_NewFloorX + x - 1;
+				int OldX = x - DiffX;
 				if ((OldX >= 0) && (OldX < 4) && (OldY >= 0) && (OldY < 4) && (OldZ >= 0) && (OldZ < 4))
 				{
-					(*m_WorkRnds)[x][y][z] = (*OldWorkRnds)[OldX][OldY][OldZ];
+					(*m_WorkRnds)[z][y][x] = (*OldWorkRnds)[OldZ][OldY][OldX];
 				}
 				else
 				{
-					(*m_WorkRnds)[x][y][z] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise3D(cx, cy, cz));
+					(*m_WorkRnds)[z][y][x] = static_cast<NOISE_DATATYPE>(m_Noise.IntNoise3D(cx, cy, cz));
 				}
-			}  // for z
+			}  // for x
 		}  // for y
-	}  // for x
+	}  // for z
 	m_CurFloorX = a_NewFloorX;
 	m_CurFloorY = a_NewFloorY;
 	m_CurFloorZ = a_NewFloorZ;
@@ -904,23 +914,29 @@ void cImprovedNoise::Generate2D(
 	NOISE_DATATYPE a_StartY, NOISE_DATATYPE a_EndY
 ) const
 {
+	ASSERT(a_SizeX > 0);
+	ASSERT(a_SizeY > 0);
+	ASSERT(a_SizeX <= MAX_SIZE);
+	ASSERT(a_SizeY <= MAX_SIZE);
+
+	// Calculate the per-coord values along each axis only once:
+	int CoordX[MAX_SIZE], CoordY[MAX_SIZE];
+	NOISE_DATATYPE FracX[MAX_SIZE], FracY[MAX_SIZE];
+	NOISE_DATATYPE FadeX[MAX_SIZE], FadeY[MAX_SIZE];
+	CalcAxis(a_SizeX, a_StartX, a_EndX, CoordX, FracX, FadeX);
+	CalcAxis(a_SizeY, a_StartY, a_EndY, CoordY, FracY, FadeY);
+
 	size_t idx = 0;
 	for (int y = 0; y < a_SizeY; y++)
 	{
-		NOISE_DATATYPE ratioY = static_cast<NOISE_DATATYPE>(y) / (a_SizeY - 1);
-		NOISE_DATATYPE noiseY = Lerp(a_StartY, a_EndY, ratioY);
-		int noiseYInt = FAST_FLOOR(noiseY);
-		int yCoord = noiseYInt & 255;
-		NOISE_DATATYPE noiseYFrac = noiseY - noiseYInt;
-		NOISE_DATATYPE fadeY = Fade(noiseYFrac);
+		int yCoord = CoordY[y];
+		NOISE_DATATYPE noiseYFrac = FracY[y];
+		NOISE_DATATYPE fadeY = FadeY[y];
 		for (int x = 0; x < a_SizeX; x++)
 		{
-			NOISE_DATATYPE ratioX = static_cast<NOISE_DATATYPE>(x) / (a_SizeX - 1);
-			NOISE_DATATYPE noiseX = Lerp(a_StartX, a_EndX, ratioX);
-			int noiseXInt = FAST_FLOOR(noiseX);
-			int xCoord = noiseXInt & 255;
-			NOISE_DATATYPE noiseXFrac = noiseX - noiseXInt;
-			NOISE_DATATYPE fadeX = Fade(noiseXFrac);
+			int xCoord = CoordX[x];
+			NOISE_DATATYPE noiseXFrac = FracX[x];
+			NOISE_DATATYPE fadeX = FadeX[x];
 
 			// Hash the coordinates:
 			int A  = m_Perm[xCoord] + yCoord;
@@ -952,31 +968,37 @@ void cImprovedNoise::Generate3D(
 	NOISE_DATATYPE a_StartZ, NOISE_DATATYPE a_EndZ
 ) const
 {
+	ASSERT(a_SizeX > 0);
+	ASSERT(a_SizeY > 0);
+	ASSERT(a_SizeZ > 0);
+	ASSERT(a_SizeX <= MAX_SIZE);
+	ASSERT(a_SizeY <= MAX_SIZE);
+	ASSERT(a_SizeZ <= MAX_SIZE);
+
+	// Calculate the per-coord values along each axis only once:
+	int CoordX[MAX_SIZE], CoordY[MAX_SIZE], CoordZ[MAX_SIZE];
+	NOISE_DATATYPE FracX[MAX_SIZE], FracY[MAX_SIZE], FracZ[MAX_SIZE];
+	NOISE_DATATYPE FadeX[MAX_SIZE], FadeY[MAX_SIZE], FadeZ[MAX_SIZE];
+	CalcAxis(a_SizeX, a_StartX, a_EndX, CoordX, FracX, FadeX);
+	CalcAxis(a_SizeY, a_StartY, a_EndY, CoordY, FracY, FadeY);
+	CalcAxis(a_SizeZ, a_StartZ, a_EndZ, CoordZ, FracZ, FadeZ);
+
 	size_t idx = 0;
 	for (int z = 0; z < a_SizeZ; z++)
 	{
-		NOISE_DATATYPE ratioZ = static_cast<NOISE_DATATYPE>(z) / (a_SizeZ - 1);
-		NOISE_DATATYPE noiseZ = Lerp(a_StartZ, a_EndZ, ratioZ);
-		int noiseZInt = FAST_FLOOR(noiseZ);
-		int zCoord = noiseZInt & 255;
-		NOISE_DATATYPE noiseZFrac = noiseZ - noiseZInt;
-		NOISE_DATATYPE fadeZ = Fade(noiseZFrac);
+		int zCoord = CoordZ[z];
+		NOISE_DATATYPE noiseZFrac = FracZ[z];
+		NOISE_DATATYPE fadeZ = FadeZ[z];
 		for (int y = 0; y < a_SizeY; y++)
 		{
-			NOISE_DATATYPE ratioY = static_cast<NOISE_DATATYPE>(y) / (a_SizeY - 1);
-			NOISE_DATATYPE noiseY = Lerp(a_StartY, a_EndY, ratioY);
-			int noiseYInt = FAST_FLOOR(noiseY);
-			int yCoord = noiseYInt & 255;
-			NOISE_DATATYPE noiseYFrac = noiseY - noiseYInt;
-			NOISE_DATATYPE fadeY = Fade(noiseYFrac);
+			int yCoord = CoordY[y];
+			NOISE_DATATYPE noiseYFrac = FracY[y];
+			NOISE_DATATYPE fadeY = FadeY[y];
 			for (int x = 0; x < a_SizeX; x++)
 			{
-				NOISE_DATATYPE ratioX = static_cast<NOISE_DATATYPE>(x) / (a_SizeX - 1);
-				NOISE_DATATYPE noiseX = Lerp(a_StartX, a_EndX, ratioX);
-				int noiseXInt = FAST_FLOOR(noiseX);
-				int xCoord = noiseXInt & 255;
-				NOISE_DATATYPE noiseXFrac = noiseX - noiseXInt;
-				NOISE_DATATYPE fadeX = Fade(noiseXFrac);
+				int xCoord = CoordX[x];
+				NOISE_DATATYPE noiseXFrac = FracX[x];
+				NOISE_DATATYPE fadeX = FadeX[x];
 
 				// Hash the coordinates:
 				int A  = m_Perm[xCoord] + yCoord;
@@ -1026,3 +1048,24 @@ NOISE_DATATYPE cImprovedNoise::GetValueAt(int a_X, int a_Y, int a_Z)
 
 
 
+void cImprovedNoise::CalcAxis(
+	int a_Size,
+	NOISE_DATATYPE a_Start, NOISE_DATATYPE a_End,
+	int * a_Coord, NOISE_DATATYPE * a_Frac, NOISE_DATATYPE * a_Fade
+)
+{
+	for (int i = 0; i < a_Size; i++)
+	{
+		NOISE_DATATYPE ratio = static_cast<NOISE_DATATYPE>(i) / (a_Size - 1);
+		NOISE_DATATYPE noise = Lerp(a_Start, a_End, ratio);
+		int noiseInt = FAST_FLOOR(noise);
+		a_Coord[i] = noiseInt & 255;
+		a_Frac[i] = noise - noiseInt;
+		a_Fade[i] = Fade(a_Frac[i]);
+	}
+}
+
+
+
+
+
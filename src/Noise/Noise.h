@@ -121,6 +121,10 @@ Implementation adapted from Perlin's Java implementation: https://mrl.nyu.edu/~p
 class cImprovedNoise
 {
 public:
+	/** Maximum size of each dimension of the query arrays. */
+	static const int MAX_SIZE = 512;
+
+
 	/** Constructs a new instance of the noise obbject.
 	Note that this operation is quite expensive (the permutation array being constructed). */
 	cImprovedNoise(int a_Seed);
@@ -159,6 +163,16 @@ protected:
 		return a_T * a_T * a_T * (a_T * (a_T * 6 - 15) + 10);
 	}
 
+	/** Calculates the values along one axis of the queried array, shared by all the rows of the array:
+	a_Coord receives the integral coords masked into the permutation table,
+	a_Frac receives the fractional parts of the coords and a_Fade receives their fade curve values.
+	All the output arrays must hold a_Size items. */
+	static void CalcAxis(
+		int a_Size,
+		NOISE_DATATYPE a_Start, NOISE_DATATYPE a_End,
+		int * a_Coord, NOISE_DATATYPE * a_Frac, NOISE_DATATYPE * a_Fade
+	);
+
 	/** Returns the gradient value based on the hash. */
 	inline static NOISE_DATATYPE Grad(int a_Hash, NOISE_DATATYPE a_X, NOISE_DATATYPE a_Y, NOISE_DATATYPE a_Z)
 	{
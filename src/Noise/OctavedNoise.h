@@ -70,14 +70,14 @@ public:
 		{
 			const cOctave & FirstOctave = m_Octaves.front();
 			FirstOctave.m_Noise.Generate2D(
-				a_Workspace, a_SizeX, a_SizeY,
+				a_Array, a_SizeX, a_SizeY,
 				a_StartX * FirstOctave.m_Frequency, a_EndX * FirstOctave.m_Frequency,
 				a_StartY * FirstOctave.m_Frequency, a_EndY * FirstOctave.m_Frequency
 			);
 			NOISE_DATATYPE Amplitude = FirstOctave.m_Amplitude;
 			for (int i = 0; i < ArrayCount; i++)
 			{
-				a_Array[i] = a_Workspace[i] * Amplitude;
+				a_Array[i] *= Amplitude;
 			}
 		}
 
@@ -130,7 +130,7 @@ public:
 		{
 			const cOctave & FirstOctave = m_Octaves.front();
 			FirstOctave.m_Noise.Generate3D(
-				a_Workspace, a_SizeX, a_SizeY, a_SizeZ,
+				a_Array, a_SizeX, a_SizeY, a_SizeZ,
 				a_StartX * FirstOctave.m_Frequency, a_EndX * FirstOctave.m_Frequency,
 				a_StartY * FirstOctave.m_Frequency, a_EndY * FirstOctave.m_Frequency,
 				a_StartZ * FirstOctave.m_Frequency, a_EndZ * FirstOctave.m_Frequency
@@ -138,7 +138,7 @@ public:
 			NOISE_DATATYPE Amplitude = FirstOctave.m_Amplitude;
 			for (int i = 0; i < ArrayCount; i++)
 			{
-				a_Array[i] = a_Workspace[i] * Amplitude;
+				a_Array[i] *= Amplitude;
 			}
 		}
 
@@ -0,0 +1,142 @@
+
+// PermissionTrie.cpp
+
+// Implements the cPermissionTrie class that stores a set of permission templates for fast matching
+// Implements the cPermissionChecker class that decides a player's permissions using the tries and a decision cache
+
+#include "Globals.h"
+#include "PermissionTrie.h"
+
+
+
+
+
+cPermissionTrie::cPermissionTrie(void)
+{
+}
+
+
+
+
+
+void cPermissionTrie::Clear(void)
+{
+	m_Root.m_Children.clear();
+	m_Root.m_IsEnd = false;
+	m_Root.m_HasWildcard = false;
+}
+
+
+
+
+
+void cPermissionTrie::Add(const AString & a_Template)
+{
+	auto Node = &m_Root;
+	for (const auto & Part: StringSplit(a_Template, "."))
+	{
+		if (Part == "*")
+		{
+			// The wildcard matches everything below, the rest of the template doesn't matter:
+			Node->m_HasWildcard = true;
+			return;
+		}
+		auto & Child = Node->m_Children[Part];
+		if (Child == nullptr)
+		{
+			Child = cpp14::make_unique<sNode>();
+		}
+		Node = Child.get();
+	}
+	Node->m_IsEnd = true;
+}
+
+
+
+
+
+bool cPermissionTrie::Matches(const AString & a_Permission) const
+{
+	// Walk the permission's parts the same way StringSplit() would split them, but without copying them:
+	auto Node = &m_Root;
+	size_t Start = 0;
+	size_t Length = a_Permission.size();
+	while (Start < Length)
+	{
+		if (Node->m_HasWildcard)
+		{
+			// There's at least one more part and a template has a wildcard here
+			return true;
+		}
+		auto End = a_Permission.find('.', Start);
+		if (End == AString::npos)
+		{
+			End = Length;
+		}
+		auto itr = Node->m_Children.find(std::string_view(a_Permission.data() + Start, End - Start));
+		if (itr == Node->m_Children.end())
+		{
+			return false;
+		}
+		Node = itr->second.get();
+		Start = End + 1;
+	}
+	return Node->m_IsEnd;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// cPermissionChecker:
+
+void cPermissionChecker::SetPermissions(const AStringVector & a_Permissions, const AStringVector & a_Restrictions)
+{
+	cCSLock Lock(m_CS);
+	m_Permissions.Clear();
+	for (const auto & Permission: a_Permissions)
+	{
+		m_Permissions.Add(Permission);
+	}
+	m_Restrictions.Clear();
+	for (const auto & Restriction: a_Restrictions)
+	{
+		m_Restrictions.Add(Restriction);
+	}
+	m_Cache.clear();
+}
+
+
+
+
+
+bool cPermissionChecker::HasPermission(const AString & a_Permission)
+{
+	if (a_Permission.empty())
+	{
+		// Empty permission request is always granted
+		return true;
+	}
+
+	cCSLock Lock(m_CS);
+	auto itr = m_Cache.find(a_Permission);
+	if (itr != m_Cache.end())
+	{
+		return itr->second;
+	}
+
+	// The permission is granted if it doesn't match any restriction and matches any granted permission:
+	bool Res = (!m_Restrictions.Matches(a_Permission) && m_Permissions.Matches(a_Permission));
+
+	if (m_Cache.size() >= MAX_CACHE_SIZE)
+	{
+		m_Cache.clear();
+	}
+	m_Cache.emplace(a_Permission, Res);
+	return Res;
+}
+
+
+
+
@@ -0,0 +1,98 @@
+
+// PermissionTrie.h
+
+// Declares the cPermissionTrie class that stores a set of permission templates for fast matching
+// Declares the cPermissionChecker class that decides a player's permissions using the tries and a decision cache
+
+
+
+
+
+#pragma once
+
+#include <unordered_map>
+
+
+
+
+
+/** Stores a set of dot-separated permission templates, such as "core.build" or "worldedit.*", in a trie keyed by
+the individual dot-separated parts. Checking whether a permission matches any of the templates is then a single walk
+through the permission's parts, instead of splitting the permission and comparing it to each template in turn.
+The matching rules are the same as in cPlayer::PermissionMatches(): a "*" part in a template matches the rest of
+the permission, as long as the permission has at least one more part; otherwise all the parts must be equal. */
+class cPermissionTrie
+{
+public:
+
+	cPermissionTrie(void);
+
+	/** Removes all the templates. */
+	void Clear(void);
+
+	/** Adds the specified template. */
+	void Add(const AString & a_Template);
+
+	/** Returns true if the permission matches any of the stored templates. */
+	bool Matches(const AString & a_Permission) const;
+
+protected:
+
+	/** A single node of the trie, representing the template parts on the path from the root. */
+	struct sNode
+	{
+		/** Subsequent template parts. The comparator allows lookup by a string_view, without creating an AString. */
+		std::map<AString, std::unique_ptr<sNode>, std::less<>> m_Children;
+
+		/** True if a template ends at this node. */
+		bool m_IsEnd = false;
+
+		/** True if a template continues with a "*" part after this node. */
+		bool m_HasWildcard = false;
+	};
+
+
+	sNode m_Root;
+};
+
+
+
+
+
+/** Decides whether a set of permissions and restrictions, such as a player's, grants the requested permissions.
+A permission is granted if it matches any of the permissions and none of the restrictions.
+The templates are compiled into tries, and the decisions are cached per requested permission until the permissions change.
+All the functions are thread-safe. */
+class cPermissionChecker
+{
+public:
+
+	/** Replaces the permissions and restrictions, forgetting all the cached decisions. */
+	void SetPermissions(const AStringVector & a_Permissions, const AStringVector & a_Restrictions);
+
+	/** Returns true if the permission is granted. An empty permission is always granted. */
+	bool HasPermission(const AString & a_Permission);
+
+protected:
+
+	/** Maximum number of decisions kept in m_Cache.
+	Plugins may ask for an unbounded number of distinct permissions, the cache starts over when it grows this large. */
+	static const size_t MAX_CACHE_SIZE = 1000;
+
+
+	/** Protects all the members against concurrent access. */
+	cCriticalSection m_CS;
+
+	/** The granted permission templates. */
+	cPermissionTrie m_Permissions;
+
+	/** The restriction templates, overriding the granted permissions. */
+	cPermissionTrie m_Restrictions;
+
+	/** The decisions made since the permissions were last set, keyed by the requested permission. */
+	std::unordered_map<AString, bool> m_Cache;
+};
+
+
+
+
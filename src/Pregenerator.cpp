@@ -0,0 +1,308 @@
+
+// Pregenerator.cpp
+
+// Implements the cPregenerator class that generates, lights and saves a rectangle of chunks ahead of time
+
+#include "Globals.h"
+
+#include "Pregenerator.h"
+#include "ChunkMap.h"
+#include "World.h"
+
+
+
+
+
+/** Notifies the pregenerator about a prepared chunk. Keeps the pregenerator alive until called. */
+class cPregeneratorCallback :
+	public cChunkCoordCallback
+{
+public:
+	cPregeneratorCallback(std::shared_ptr<cPregenerator> a_Pregenerator) :
+		m_Pregenerator(std::move(a_Pregenerator))
+	{
+		ASSERT(m_Pregenerator != nullptr);
+	}
+
+protected:
+
+	std::shared_ptr<cPregenerator> m_Pregenerator;
+
+	virtual void Call(cChunkCoords a_Coords, bool a_IsSuccess) override
+	{
+		m_Pregenerator->PreparedChunkCallback(a_Coords);
+	}
+};
+
+
+
+
+
+/** Notifies the pregenerator about a saved chunk. A single instance is shared by all the chunks being saved. */
+class cPregeneratorSaveCallback :
+	public cChunkCoordCallback
+{
+public:
+	cPregeneratorSaveCallback(cPregenerator & a_Pregenerator) :
+		m_Pregenerator(a_Pregenerator)
+	{
+	}
+
+protected:
+
+	cPregenerator & m_Pregenerator;
+
+	virtual void Call(cChunkCoords a_Coords, bool a_IsSuccess) override
+	{
+		m_Pregenerator.SavedChunkCallback(a_Coords);
+	}
+};
+
+
+
+
+
+cPregenerator::cPregenerator(cWorld & a_World, int a_MinChunkX, int a_MinChunkZ, int a_MaxChunkX, int a_MaxChunkZ, sMakeSharedTag):
+	m_World(a_World),
+	m_MinRegionX(FAST_FLOOR_DIV(a_MinChunkX, REGION_SIZE)),
+	m_MinRegionZ(FAST_FLOOR_DIV(a_MinChunkZ, REGION_SIZE)),
+	m_NumRegionsX(FAST_FLOOR_DIV(a_MaxChunkX, REGION_SIZE) - m_MinRegionX + 1),
+	m_NumPrepared(0),
+	m_StartTime(std::chrono::steady_clock::now()),
+	m_SaveCallback(cpp14::make_unique<cPregeneratorSaveCallback>(*this))
+{
+	ASSERT(a_MinChunkX <= a_MaxChunkX);
+	ASSERT(a_MinChunkZ <= a_MaxChunkZ);
+
+	// List the chunks region by region, in the same order in which GetRegionIndex() numbers the regions:
+	int MaxRegionZ = FAST_FLOOR_DIV(a_MaxChunkZ, REGION_SIZE);
+	int MaxRegionX = m_MinRegionX + m_NumRegionsX - 1;
+	m_Chunks.reserve(static_cast<size_t>(a_MaxChunkX - a_MinChunkX + 1) * static_cast<size_t>(a_MaxChunkZ - a_MinChunkZ + 1));
+	for (int RegionZ = m_MinRegionZ; RegionZ <= MaxRegionZ; RegionZ++)
+	{
+		int MinZ = std::max(a_MinChunkZ, RegionZ * REGION_SIZE);
+		int MaxZ = std::min(a_MaxChunkZ, RegionZ * REGION_SIZE + REGION_SIZE - 1);
+		for (int RegionX = m_MinRegionX; RegionX <= MaxRegionX; RegionX++)
+		{
+			int MinX = std::max(a_MinChunkX, RegionX * REGION_SIZE);
+			int MaxX = std::min(a_MaxChunkX, RegionX * REGION_SIZE + REGION_SIZE - 1);
+			m_RegionStart.push_back(m_Chunks.size());
+			for (int z = MinZ; z <= MaxZ; z++)
+			{
+				for (int x = MinX; x <= MaxX; x++)
+				{
+					m_Chunks.emplace_back(x, z);
+				}
+			}
+			m_RegionUnprepared.push_back((MaxX - MinX + 1) * (MaxZ - MinZ + 1));
+		}  // for RegionX
+	}  // for RegionZ
+	m_RegionStart.push_back(m_Chunks.size());
+	m_RegionUnsaved.resize(m_RegionUnprepared.size(), 0);
+}
+
+
+
+
+
+void cPregenerator::Pregenerate(cWorld & a_World, int a_MinChunkX, int a_MinChunkZ, int a_MaxChunkX, int a_MaxChunkZ, unsigned a_NumGeneratorThreads)
+{
+	auto Pregen = std::make_shared<cPregenerator>(a_World, a_MinChunkX, a_MinChunkZ, a_MaxChunkX, a_MaxChunkZ, sMakeSharedTag{});
+	size_t NumChunks = Pregen->m_Chunks.size();
+	LOG("Pregenerating (%s): %zu chunks in %zu regions, from chunk [%d, %d] to chunk [%d, %d], on %u generator threads",
+		a_World.GetName().c_str(), NumChunks, Pregen->m_RegionUnprepared.size(),
+		a_MinChunkX, a_MinChunkZ, a_MaxChunkX, a_MaxChunkZ, a_NumGeneratorThreads
+	);
+
+	a_World.GetGenerator().StartHelpers((a_NumGeneratorThreads > 1) ? (a_NumGeneratorThreads - 1) : 0);
+	Pregen->Run();
+	a_World.GetGenerator().StopHelpers();
+
+	auto Elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - Pregen->m_StartTime).count();
+	LOG("Pregenerated (%s): %zu chunks in %.02f seconds (%.02f chunks / sec)",
+		a_World.GetName().c_str(), NumChunks, Elapsed, (Elapsed > 0) ? (static_cast<double>(NumChunks) / Elapsed) : 0.0
+	);
+}
+
+
+
+
+
+void cPregenerator::Run(void)
+{
+	// All the queueing, saving and unloading is done here, on the pregenerating thread.
+	// The callbacks only update the counters and wake this thread up, so that PrepareChunk() never recurses
+	// through a callback that it calls synchronously for a chunk that is already lit.
+	size_t NumRegions = m_RegionUnprepared.size();
+	size_t NextChunk = 0;
+	size_t NextRegionToSave = 0;
+	size_t NumRegionsUnloaded = 0;
+	auto LastReportTime = m_StartTime;
+	while (NumRegionsUnloaded < NumRegions)
+	{
+		// Collect the progress made by the callbacks:
+		size_t NumPrepared;
+		size_t NumRegionsPrepared;
+		std::vector<size_t> RegionsToUnload;
+		{
+			cCSLock Lock(m_CS);
+			NumPrepared = m_NumPrepared;
+			NumRegionsPrepared = NextRegionToSave;
+			while ((NumRegionsPrepared < NumRegions) && (m_RegionUnprepared[NumRegionsPrepared] == 0))
+			{
+				NumRegionsPrepared += 1;
+			}
+			std::swap(RegionsToUnload, m_RegionsToUnload);
+		}
+
+		// Keep up to MAX_QUEUED_CHUNKS chunks in flight:
+		while ((NextChunk < m_Chunks.size()) && (NextChunk - NumPrepared < MAX_QUEUED_CHUNKS))
+		{
+			const auto & Coords = m_Chunks[NextChunk];
+			NextChunk += 1;
+			m_World.PrepareChunk(Coords.m_ChunkX, Coords.m_ChunkZ, cpp14::make_unique<cPregeneratorCallback>(shared_from_this()));
+		}
+
+		// Save the regions that got prepared, in order. A region with nothing to save can be unloaded right away:
+		for (; NextRegionToSave < NumRegionsPrepared; NextRegionToSave++)
+		{
+			if (!SaveRegion(NextRegionToSave))
+			{
+				RegionsToUnload.push_back(NextRegionToSave);
+			}
+		}
+
+		// Unload the regions whose chunks have all been saved:
+		for (auto RegionIdx: RegionsToUnload)
+		{
+			UnloadRegion(RegionIdx);
+			NumRegionsUnloaded += 1;
+		}
+
+		// Report progress every 5 seconds:
+		auto Now = std::chrono::steady_clock::now();
+		if (Now - LastReportTime > std::chrono::seconds(5))
+		{
+			LastReportTime = Now;
+			ReportProgress(NumPrepared, NumRegionsUnloaded);
+		}
+
+		// Wait for a callback to make progress, with a timeout so that the progress is reported even when the chunks are slow:
+		if (NumRegionsUnloaded < NumRegions)
+		{
+			m_EvtProgress.Wait(1000);
+		}
+	}
+}
+
+
+
+
+
+size_t cPregenerator::GetRegionIndex(cChunkCoords a_Coords) const
+{
+	int RegionX = FAST_FLOOR_DIV(a_Coords.m_ChunkX, REGION_SIZE) - m_MinRegionX;
+	int RegionZ = FAST_FLOOR_DIV(a_Coords.m_ChunkZ, REGION_SIZE) - m_MinRegionZ;
+	ASSERT((RegionX >= 0) && (RegionX < m_NumRegionsX));
+	ASSERT(RegionZ >= 0);
+	return static_cast<size_t>(RegionZ * m_NumRegionsX + RegionX);
+}
+
+
+
+
+
+bool cPregenerator::SaveRegion(size_t a_RegionIdx)
+{
+	// Only the chunks still loaded can be saved; the world may have already saved and unloaded some on its own:
+	cChunkCoordsVector ToSave;
+	for (size_t i = m_RegionStart[a_RegionIdx]; i < m_RegionStart[a_RegionIdx + 1]; i++)
+	{
+		if (m_World.IsChunkValid(m_Chunks[i].m_ChunkX, m_Chunks[i].m_ChunkZ))
+		{
+			ToSave.push_back(m_Chunks[i]);
+		}
+	}
+	if (ToSave.empty())
+	{
+		return false;
+	}
+
+	// Set the counter before queueing, the storage thread may report the first chunks right away,
+	// and the storage reports the chunks unloaded in the meantime synchronously, from within QueueSaveChunk():
+	{
+		cCSLock Lock(m_CS);
+		m_RegionUnsaved[a_RegionIdx] = static_cast<int>(ToSave.size());
+	}
+	for (const auto & Coords: ToSave)
+	{
+		m_World.GetStorage().QueueSaveChunk(Coords.m_ChunkX, Coords.m_ChunkZ, m_SaveCallback.get());
+	}
+	return true;
+}
+
+
+
+
+
+void cPregenerator::UnloadRegion(size_t a_RegionIdx)
+{
+	cChunkCoordsVector Chunks(m_Chunks.begin() + static_cast<ptrdiff_t>(m_RegionStart[a_RegionIdx]), m_Chunks.begin() + static_cast<ptrdiff_t>(m_RegionStart[a_RegionIdx + 1]));
+	m_World.QueueTask([Chunks](cWorld & a_World)
+		{
+			a_World.GetChunkMap()->UnloadUnusedChunks(Chunks);
+		}
+	);
+}
+
+
+
+
+
+void cPregenerator::PreparedChunkCallback(cChunkCoords a_Coords)
+{
+	{
+		cCSLock Lock(m_CS);
+		m_NumPrepared += 1;
+		m_RegionUnprepared[GetRegionIndex(a_Coords)] -= 1;
+	}
+	m_EvtProgress.Set();
+}
+
+
+
+
+
+void cPregenerator::SavedChunkCallback(cChunkCoords a_Coords)
+{
+	// Keep this object alive until the callback returns, the pregenerating thread may finish as soon as the counter drops:
+	auto Self = shared_from_this();
+
+	{
+		cCSLock Lock(m_CS);
+		auto RegionIdx = GetRegionIndex(a_Coords);
+		m_RegionUnsaved[RegionIdx] -= 1;
+		if (m_RegionUnsaved[RegionIdx] == 0)
+		{
+			m_RegionsToUnload.push_back(RegionIdx);
+		}
+	}
+	m_EvtProgress.Set();
+}
+
+
+
+
+
+void cPregenerator::ReportProgress(size_t a_NumPrepared, size_t a_NumRegionsUnloaded)
+{
+	auto Elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - m_StartTime).count();
+	double ChunkSpeed = static_cast<double>(a_NumPrepared) / Elapsed;
+	double PercentDone = static_cast<double>(a_NumPrepared * 100) / static_cast<double>(m_Chunks.size());
+	auto SecondsLeft = static_cast<int>(static_cast<double>(m_Chunks.size() - a_NumPrepared) / std::max(ChunkSpeed, 0.001));
+	LOG("Pregenerating (%s): %.02f%% (%zu/%zu chunks prepared, %zu/%zu regions saved and unloaded; %.02f chunks / sec; ETA %d:%02d:%02d)",
+		m_World.GetName().c_str(), PercentDone,
+		a_NumPrepared, m_Chunks.size(), a_NumRegionsUnloaded, m_RegionUnprepared.size(),
+		ChunkSpeed, SecondsLeft / 3600, (SecondsLeft / 60) % 60, SecondsLeft % 60
+	);
+}
@@ -0,0 +1,122 @@
+
+// Pregenerator.h
+
+// Declares the cPregenerator class that generates, lights and saves a rectangle of chunks ahead of time
+
+
+
+
+
+#pragma once
+
+class cWorld;
+
+
+
+
+
+/** Generates, lights and saves all the chunks in a rectangle, so that the players don't have to wait for them later.
+The chunks are queued through cWorld::PrepareChunk() in the region file order, at most MAX_QUEUED_CHUNKS at a time.
+Once all the chunks in a region are prepared, that region's chunks are saved, and once saved, unloaded.
+The chunks held in memory are therefore the regions in progress (at most two, because the chunks in flight are
+fewer than a region's worth), the regions waiting for their save to finish, plus the neighbours that lighting
+the chunks on a region's edge needs. Those neighbours include up to a full row of chunks across the rectangle
+in the next row of regions, which stay loaded until their own region is done; the neighbours reloaded
+from the already finished regions are left to the world's regular unloading of unused chunks.
+Uses the world's own generator, lighting and storage threads, which work in parallel on different chunks.
+Generating, usually the slowest stage, is spread over the requested number of threads by starting the generator's helper
+threads for the duration of the pregeneration; lighting and saving stay on the world's single threads. */
+class cPregenerator:
+	public std::enable_shared_from_this<cPregenerator>
+{
+	/** Private tag allows public constructors that can only be used with private access. */
+	struct sMakeSharedTag {};
+
+public:
+
+	cPregenerator(cWorld & a_World, int a_MinChunkX, int a_MinChunkZ, int a_MaxChunkX, int a_MaxChunkZ, sMakeSharedTag);
+
+	/** Prepares all the chunks in the specified rectangle (inclusive), saves and unloads them region by region.
+	The chunks are generated on a_NumGeneratorThreads threads, the world's generator thread and its helpers.
+	Blocks until all the chunks are prepared and saved. Progress is logged periodically. */
+	static void Pregenerate(cWorld & a_World, int a_MinChunkX, int a_MinChunkZ, int a_MaxChunkX, int a_MaxChunkZ, unsigned a_NumGeneratorThreads);
+
+protected:
+
+	/** Maximum number of chunks being prepared at the same time.
+	Keeps the generator and lighting queues busy, but well below the length at which the generator starts skipping
+	chunks that have no clients (which is all of them when pregenerating). */
+	static constexpr size_t MAX_QUEUED_CHUNKS = 128;
+
+	/** Number of chunks along each axis of a region file. */
+	static constexpr int REGION_SIZE = 32;
+
+
+	cWorld & m_World;
+
+	/** The lowest coords of the regions that intersect the chunk rectangle, and the number of such regions along the X axis. */
+	int m_MinRegionX;
+	int m_MinRegionZ;
+	int m_NumRegionsX;
+
+	/** All the chunks to prepare, in the order in which they are queued: region by region, row by row inside each region. */
+	cChunkCoordsVector m_Chunks;
+
+	/** Index into m_Chunks of the first chunk of each region, indexed by GetRegionIndex(), plus the end of the last region. */
+	std::vector<size_t> m_RegionStart;
+
+	/** Protects the members below against concurrent access from the lighting and storage thread callbacks. */
+	cCriticalSection m_CS;
+
+	/** Number of chunks already prepared. */
+	size_t m_NumPrepared;
+
+	/** Number of chunks not yet prepared, for each region, indexed by GetRegionIndex(). */
+	std::vector<int> m_RegionUnprepared;
+
+	/** Number of chunks queued for saving whose save hasn't finished yet, for each region, indexed by GetRegionIndex(). */
+	std::vector<int> m_RegionUnsaved;
+
+	/** Regions that have been completely saved and are waiting to be unloaded by the pregenerating thread. */
+	std::vector<size_t> m_RegionsToUnload;
+
+	/** Event set by the callbacks whenever a chunk gets prepared or saved, waking up the pregenerating thread. */
+	cEvent m_EvtProgress;
+
+	/** The time when the pregeneration started, used for the overall speed and the ETA. */
+	std::chrono::steady_clock::time_point m_StartTime;
+
+	/** The callback given to the storage for each chunk saved by SaveRegion(). */
+	std::unique_ptr<cChunkCoordCallback> m_SaveCallback;
+
+
+	/** Runs the pregeneration on the calling thread: queues the chunks, saves and unloads the finished regions. */
+	void Run(void);
+
+	/** Returns the index into the per-region arrays of the region containing the specified chunk. */
+	size_t GetRegionIndex(cChunkCoords a_Coords) const;
+
+	/** Queues all the loaded chunks of the specified region for saving.
+	Returns true if any chunk was queued, false if there was nothing to save (so the region can be unloaded right away). */
+	bool SaveRegion(size_t a_RegionIdx);
+
+	/** Queues the unloading of the specified region's chunks onto the world's tick thread.
+	Only the chunks that are not used by anything else get unloaded. */
+	void UnloadRegion(size_t a_RegionIdx);
+
+	/** Called by the lighting thread when a chunk is prepared. */
+	void PreparedChunkCallback(cChunkCoords a_Coords);
+
+	/** Called by the storage thread when a chunk queued by SaveRegion() is saved. */
+	void SavedChunkCallback(cChunkCoords a_Coords);
+
+	/** Logs the current progress, the speed and the estimated time remaining. */
+	void ReportProgress(size_t a_NumPrepared, size_t a_NumRegionsUnloaded);
+
+	friend class cPregeneratorCallback;
+	friend class cPregeneratorSaveCallback;
+};
+
+
+
+
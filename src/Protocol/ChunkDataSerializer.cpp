@@ -4,6 +4,7 @@
 #include "Protocol_1_8.h"
 #include "Protocol_1_9.h"
 #include "../ByteBuffer.h"
+#include "../Endianness.h"
 
 
 
@@ -27,6 +28,36 @@ void ForEachSection(const cChunkData & a_Data, Func a_Func)
 
 
 
+/** Packs the 4096 entries of a section, each a_BitsPerEntry bits wide, into the 1.13 array of longs; an entry may span two longs.
+a_GetEntry(Index) returns the value to be stored for the block at the specified index.
+The longs are left in network byte order, so that they can be written to the packet at once. */
+template <class Func>
+void PackSectionEntries393(size_t a_BitsPerEntry, UInt64 * a_Longs, Func a_GetEntry)
+{
+	size_t NumLongs = (cChunkData::SectionBlockCount * a_BitsPerEntry) / 64;
+	std::fill(a_Longs, a_Longs + NumLongs, 0);
+	for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
+	{
+		UInt64 Value = a_GetEntry(Index);
+		size_t BitPosition = Index * a_BitsPerEntry;
+		size_t LongIndex = BitPosition / 64;
+		size_t BitOffset = BitPosition % 64;
+		a_Longs[LongIndex] |= (Value << BitOffset);
+		if (BitOffset + a_BitsPerEntry > 64)
+		{
+			a_Longs[LongIndex + 1] |= (Value >> (64 - BitOffset));
+		}
+	}
+	for (size_t i = 0; i < NumLongs; i++)
+	{
+		a_Longs[i] = HostToNetwork8(&a_Longs[i]);
+	}
+}
+
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // cChunkDataSerializer:
 
@@ -45,7 +76,7 @@ cChunkDataSerializer::cChunkDataSerializer(
 
 
 
-const AString & cChunkDataSerializer::Serialize(int a_Version, int a_ChunkX, int a_ChunkZ, const std::map<UInt32, UInt32> & a_BlockTypeMap)
+const AString & cChunkDataSerializer::Serialize(int a_Version, int a_ChunkX, int a_ChunkZ, const std::vector<UInt32> & a_BlockTypeMap)
 {
 	Serializations::const_iterator itr = m_Serializations.find(a_Version);
 	if (itr != m_Serializations.end())
@@ -434,11 +465,11 @@ void cChunkDataSerializer::Serialize110(AString & a_Data, int a_ChunkX, int a_Ch
 
 
 
-void cChunkDataSerializer::Serialize393(AString & a_Data, int a_ChunkX, int a_ChunkZ, const std::map<UInt32, UInt32> & a_BlockTypeMap)
+void cChunkDataSerializer::Serialize393(AString & a_Data, int a_ChunkX, int a_ChunkZ, const std::vector<UInt32> & a_BlockTypeMap)
 {
 	// This function returns the fully compressed packet (including packet size), not the raw packet!
 
-	ASSERT(!a_BlockTypeMap.empty());  // We need a protocol-specific translation map
+	ASSERT(a_BlockTypeMap.size() == 256 * 16);  // We need a protocol-specific translation map covering every BLOCKTYPE#META
 
 	// Create the packet:
 	cByteBuffer Packet(512 KiB);
@@ -448,85 +479,118 @@ void cChunkDataSerializer::Serialize393(AString & a_Data, int a_ChunkX, int a_Ch
 	Packet.WriteBool(true);  // "Ground-up continuous", or rather, "biome data present" flag
 	Packet.WriteVarInt32(m_Data.GetSectionBitmask());
 
-	// Write the chunk size in bytes:
-	const size_t BitsPerEntry = 14;
-	const size_t Mask = (1 << BitsPerEntry) - 1;
-	const size_t ChunkSectionDataArraySize = (cChunkData::SectionBlockCount * BitsPerEntry) / 8 / 8;
-	size_t ChunkSectionSize = (
+	// Sections with few distinct blocks are sent with a section-local palette and fewer bits per entry,
+	// otherwise the NetBlockIDs are sent directly, using the global palette:
+	const size_t GlobalBitsPerEntry = 14;
+	const size_t GlobalMask = (1 << GlobalBitsPerEntry) - 1;
+	const size_t MinPaletteBitsPerEntry = 4;
+	const size_t MaxPaletteBitsPerEntry = 8;
+	const size_t MaxPaletteSize = 1 << MaxPaletteBitsPerEntry;
+	const size_t GlobalDataArraySize = (cChunkData::SectionBlockCount * GlobalBitsPerEntry) / 8 / 8;
+	size_t MaxChunkSectionSize = (
 		1 +  // Bits per entry, BEUInt8, 1 byte
-		Packet.GetVarIntSize(static_cast<UInt32>(ChunkSectionDataArraySize)) +  // Field containing "size of whole section", VarInt32, variable size
-		ChunkSectionDataArraySize * 8 +  // Actual section data, lots of bytes (multiplier 1 long = 8 bytes)
-		cChunkData::SectionBlockCount / 2  // Size of blocklight which is always sent
-	);
-
-	if (m_Dimension == dimOverworld)
-	{
-		// Sky light is only sent in the overworld.
-		ChunkSectionSize += cChunkData::SectionBlockCount / 2;
-	}
-
-	const size_t BiomeDataSize = cChunkDef::Width * cChunkDef::Width;
-	size_t ChunkSize = (
-		ChunkSectionSize * m_Data.NumPresentSections() +
-		BiomeDataSize * 4  // Biome data now BE ints
+		Packet.GetVarIntSize(static_cast<UInt32>(GlobalDataArraySize)) +  // Field containing "size of whole section", VarInt32, variable size
+		GlobalDataArraySize * 8 +  // Actual section data, lots of bytes (multiplier 1 long = 8 bytes)
+		cChunkData::SectionBlockCount  // Size of blocklight and skylight
 	);
-	Packet.WriteVarInt32(static_cast<UInt32>(ChunkSize));
 
-	// Write each chunk section...
+	// Serialize the sections into a separate buffer first, their size is only known once their palettes are built:
+	cByteBuffer Sections(MaxChunkSectionSize * m_Data.NumPresentSections());
 	ForEachSection(m_Data, [&](const cChunkData::sChunkSection & a_Section)
 		{
-			Packet.WriteBEUInt8(static_cast<UInt8>(BitsPerEntry));
-			Packet.WriteVarInt32(static_cast<UInt32>(ChunkSectionDataArraySize));
-
-			UInt64 TempLong = 0;  // Temporary value that will be stored into
-			UInt64 CurrentlyWrittenIndex = 0;  // "Index" of the long that would be written to
-
+			const auto GetKey = [&a_Section](size_t a_Index)
+				{
+					UInt32 BlockType = a_Section.m_BlockTypes[a_Index];
+					UInt32 BlockMeta = (a_Section.m_BlockMetas[a_Index / 2] >> ((a_Index % 2) * 4)) & 0x0f;
+					return BlockType * 16 | BlockMeta;
+				};
+
+			// Collect the distinct NetBlockIDs in the section, until there's too many of them for a section palette:
+			static const UInt16 NoPaletteIndex = 0xffff;
+			std::array<UInt16, 256 * 16> PaletteIndexByKey;
+			PaletteIndexByKey.fill(NoPaletteIndex);
+			std::vector<UInt32> Palette;
 			for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
 			{
-				UInt32 blockType = a_Section.m_BlockTypes[Index];
-				UInt32 blockMeta = (a_Section.m_BlockMetas[Index / 2] >> ((Index % 2) * 4)) & 0x0f;
-				auto itr = a_BlockTypeMap.find(blockType * 16 | blockMeta);
-				UInt64 Value = (itr == a_BlockTypeMap.end()) ? 0 :itr->second;
-				Value &= Mask;  // It shouldn't go out of bounds, but it's still worth being careful
-
-				// Painful part where we write data into the long array.  Based off of the normal code.
-				size_t BitPosition = Index * BitsPerEntry;
-				size_t FirstIndex = BitPosition / 64;
-				size_t SecondIndex = ((Index + 1) * BitsPerEntry - 1) / 64;
-				size_t BitOffset = BitPosition % 64;
-
-				if (FirstIndex != CurrentlyWrittenIndex)
+				auto Key = GetKey(Index);
+				if (PaletteIndexByKey[Key] != NoPaletteIndex)
 				{
-					// Write the current data before modifiying it.
-					Packet.WriteBEUInt64(TempLong);
-					TempLong = 0;
-					CurrentlyWrittenIndex = FirstIndex;
+					continue;
 				}
+				UInt32 NetBlockID = a_BlockTypeMap[Key] & GlobalMask;  // It shouldn't go out of bounds, but it's still worth being careful
+				auto itr = std::find(Palette.begin(), Palette.end(), NetBlockID);
+				if (itr == Palette.end())
+				{
+					if (Palette.size() >= MaxPaletteSize)
+					{
+						Palette.clear();
+						break;
+					}
+					itr = Palette.insert(Palette.end(), NetBlockID);
+				}
+				PaletteIndexByKey[Key] = static_cast<UInt16>(itr - Palette.begin());
+			}
 
-				TempLong |= (Value << BitOffset);
-
-				if (FirstIndex != SecondIndex)
+			// Pack the entries, either as palette indices or directly as NetBlockIDs:
+			UInt64 Longs[GlobalDataArraySize];
+			size_t BitsPerEntry;
+			if (Palette.empty())
+			{
+				BitsPerEntry = GlobalBitsPerEntry;
+				PackSectionEntries393(BitsPerEntry, Longs, [&](size_t a_Index)
+					{
+						return a_BlockTypeMap[GetKey(a_Index)] & GlobalMask;
+					}
+				);
+			}
+			else
+			{
+				BitsPerEntry = MinPaletteBitsPerEntry;
+				while ((static_cast<size_t>(1) << BitsPerEntry) < Palette.size())
 				{
-					// Part of the data is now in the second long; write the first one first
-					Packet.WriteBEUInt64(TempLong);
-					CurrentlyWrittenIndex = SecondIndex;
+					BitsPerEntry++;
+				}
+				PackSectionEntries393(BitsPerEntry, Longs, [&](size_t a_Index)
+					{
+						return PaletteIndexByKey[GetKey(a_Index)];
+					}
+				);
+			}
+			size_t NumLongs = (cChunkData::SectionBlockCount * BitsPerEntry) / 64;
 
-					TempLong = (Value >> (64 - BitOffset));
+			Sections.WriteBEUInt8(static_cast<UInt8>(BitsPerEntry));
+			if (!Palette.empty())
+			{
+				Sections.WriteVarInt32(static_cast<UInt32>(Palette.size()));
+				for (auto NetBlockID: Palette)
+				{
+					Sections.WriteVarInt32(NetBlockID);
 				}
 			}
-			// The last long will generally not be written
-			Packet.WriteBEUInt64(TempLong);
+			Sections.WriteVarInt32(static_cast<UInt32>(NumLongs));
+			Sections.WriteBuf(Longs, NumLongs * sizeof(UInt64));
 
 			// Write lighting:
-			Packet.WriteBuf(a_Section.m_BlockLight, sizeof(a_Section.m_BlockLight));
+			Sections.WriteBuf(a_Section.m_BlockLight, sizeof(a_Section.m_BlockLight));
 			if (m_Dimension == dimOverworld)
 			{
 				// Skylight is only sent in the overworld; the nether and end do not use it
-				Packet.WriteBuf(a_Section.m_BlockSkyLight, sizeof(a_Section.m_BlockSkyLight));
+				Sections.WriteBuf(a_Section.m_BlockSkyLight, sizeof(a_Section.m_BlockSkyLight));
 			}
 		}
 	);
 
+	// Write the chunk size in bytes, followed by the sections:
+	const size_t BiomeDataSize = cChunkDef::Width * cChunkDef::Width;
+	size_t ChunkSize = (
+		Sections.GetReadableSpace() +
+		BiomeDataSize * 4  // Biome data now BE ints
+	);
+	Packet.WriteVarInt32(static_cast<UInt32>(ChunkSize));
+	AString SectionData;
+	Sections.ReadAll(SectionData);
+	Packet.WriteBuf(SectionData.data(), SectionData.size());
+
 	// Write the biome data
 	for (size_t i = 0; i != BiomeDataSize; i++)
 	{
@@ -29,8 +29,9 @@ public:
 
 	/** Serializes the contained chunk data into the specified protocol version.
 	TEMPORARY: a_BlockTypeMap is used for the 1.13+ protocols to map from BLOCKTYPE#META to NetBlockID.
+	It is a dense table indexed by (BLOCKTYPE * 16 + META), so it needs to have 4096 entries.
 	a_BlockTypeMap is ignored for pre-1.13 protocols. */
-	const AString & Serialize(int a_Version, int a_ChunkX, int a_ChunkZ, const std::map<UInt32, UInt32> & a_BlockTypeMap);
+	const AString & Serialize(int a_Version, int a_ChunkX, int a_ChunkZ, const std::vector<UInt32> & a_BlockTypeMap);
 
 
 protected:
@@ -54,7 +55,7 @@ protected:
 	void Serialize47 (AString & a_Data, int a_ChunkX, int a_ChunkZ);  // Release 1.8
 	void Serialize107(AString & a_Data, int a_ChunkX, int a_ChunkZ);  // Release 1.9
 	void Serialize110(AString & a_Data, int a_ChunkX, int a_ChunkZ);  // Release 1.9.4
-	void Serialize393(AString & a_Data, int a_ChunkX, int a_ChunkZ, const std::map<UInt32, UInt32> & a_BlockTypeMap);  // Release 1.13
+	void Serialize393(AString & a_Data, int a_ChunkX, int a_ChunkZ, const std::vector<UInt32> & a_BlockTypeMap);  // Release 1.13
 } ;
 
 
@@ -12,9 +12,18 @@ void ProtocolPalettes::load(const AString & aProtocolFolder)
 	for (const auto & c: contents)
 	{
 		auto fullName = aProtocolFolder + cFile::PathSeparator() + c;
-		if (cFile::IsFolder(fullName))
+		if (!cFile::IsFolder(fullName))
 		{
-			loadSingleVersion(c, fullName);
+			continue;
+		}
+
+		// Only remember the folder, unless the version has already been requested (and thus loaded):
+		cCSLock lock(mCS);
+		auto & pal = mPalettes[c];
+		pal.mFolders.push_back(fullName);
+		if (pal.mIsLoaded)
+		{
+			loadSingleVersion(pal, fullName);
 		}
 	}
 }
@@ -31,7 +40,20 @@ std::shared_ptr<const BlockTypePalette> ProtocolPalettes::blockTypePalette(const
 	{
 		return nullptr;
 	}
-	return itr->second.mBlockTypePalette;
+	auto & pal = itr->second;
+	if (!pal.mIsLoaded)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (const auto & folder: pal.mFolders)
+		{
+			loadSingleVersion(pal, folder);
+		}
+		pal.mIsLoaded = true;
+		LOG("Loaded palettes for protocol version %s in %.1f ms",
+			aProtocolVersion, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+		);
+	}
+	return pal.mBlockTypePalette;
 }
 
 
@@ -54,15 +76,13 @@ std::vector<AString> ProtocolPalettes::protocolVersions() const
 
 
 
-void ProtocolPalettes::loadSingleVersion(const AString & aProtocolVersion, const AString & aFolder)
+void ProtocolPalettes::loadSingleVersion(Palettes & aPalettes, const AString & aFolder)
 {
 	// Get the file list, sort by name
 	auto contents = cFile::GetFolderContents(aFolder);
 	std::sort(contents.begin(), contents.end());
 
 	// Load files into the palettes:
-	cCSLock lock(mCS);
-	auto & pal = mPalettes[aProtocolVersion];
 	for (const auto & c: contents)
 	{
 		if (c.length() < 8)
@@ -80,7 +100,7 @@ void ProtocolPalettes::loadSingleVersion(const AString & aProtocolVersion, const
 		{
 			try
 			{
-				pal.mBlockTypePalette->loadFromString(cFile::ReadWholeFile(fnam));
+				aPalettes.mBlockTypePalette->loadFromString(cFile::ReadWholeFile(fnam));
 			}
 			catch (...)
 			{
@@ -102,6 +122,7 @@ void ProtocolPalettes::loadSingleVersion(const AString & aProtocolVersion, const
 // ProtocolPalettes::Palettes:
 
 ProtocolPalettes::Palettes::Palettes():
-	mBlockTypePalette(new BlockTypePalette)
+	mBlockTypePalette(new BlockTypePalette),
+	mIsLoaded(false)
 {
 }
@@ -13,29 +13,31 @@ class BlockTypePalette;
 
 
 
-/** Loads the protocol-specific palettes on startup and provides them to the individual protocol
+/** Finds the protocol-specific palettes on startup and provides them to the individual protocol
 instances when they are created.
 Uses the data in the $/Server/Protocol folder. Each protocol version has a subfolder there,
 containing possibly multiple palette files. All the files are loaded in sequence (alpha-sorted),
 into the palette corresponding to the file's extension (*.btp.txt -> BlockTypePalette).
+Parsing the palettes takes a while, so only the subfolders are enumerated on startup; each protocol version's
+palettes are loaded when they are first requested, i.e. when the first client of that version connects.
 Provides thread safety for the data properly. */
 class ProtocolPalettes
 {
 public:
 
-	/** Loads all the per-protocol palettes.
+	/** Registers all the per-protocol palettes for loading on first use.
 	aProtocolFolder is the folder that contains a subfolder for each protocol version;
 	each subfolder contains the protocol-specific palettes (as in $/Server/Protocol)
-	If a protocol version is already loaded, yet present in the folder, the newly loaded data is merged
+	If a protocol version is already known, yet present in the folder, the data from the folder is merged
 	into the current data.
 	Always succeeds (even when there are no palettes). */
 	void load(const AString & aProtocolFolder);
 
-	/** Returns the BlockTypePalette for the specified protocol.
-	Returns nullptr if no such palette has been loaded. */
+	/** Returns the BlockTypePalette for the specified protocol, loading it first if needed.
+	Returns nullptr if there are no palettes for such a protocol. */
 	std::shared_ptr<const BlockTypePalette> blockTypePalette(const AString & aProtocolVersion) const;
 
-	/** Returns the version names of all protocols that have been loaded. */
+	/** Returns the version names of all protocols that have palettes, whether already loaded or not. */
 	std::vector<AString> protocolVersions() const;
 
 
@@ -47,6 +49,12 @@ protected:
 		std::shared_ptr<BlockTypePalette> mBlockTypePalette;
 		// TODO: ItemTypePalette
 
+		/** The folders from which the palettes are to be loaded on first use, in the order they were registered. */
+		AStringVector mFolders;
+
+		/** Set once the palettes have been loaded from mFolders. */
+		bool mIsLoaded;
+
 		Palettes();
 	};
 
@@ -54,10 +62,12 @@ protected:
 	/** The CS protecting all members against multithreaded access. */
 	mutable cCriticalSection mCS;
 
-	/** The map of protocol version -> all its palettes. */
-	std::map<AString, Palettes> mPalettes;
+	/** The map of protocol version -> all its palettes.
+	Mutable, because the palettes are loaded lazily from within the const getters. */
+	mutable std::map<AString, Palettes> mPalettes;
 
 
-	/** Loads all the palettes from the specified folder into mPalettes under the aProtocolVersion key. */
-	void loadSingleVersion(const AString & aProtocolVersion, const AString & aFolder);
+	/** Loads all the palettes from the specified folder into aPalettes.
+	Assumes mCS is locked. */
+	static void loadSingleVersion(Palettes & aPalettes, const AString & aFolder);
 };
@@ -512,10 +512,10 @@ void cProtocolRecognizer::SendLoginSuccess(void)
 
 
 
-void cProtocolRecognizer::SendMapData(const cMap & a_Map, int a_DataStartX, int a_DataStartY)
+void cProtocolRecognizer::SendMapData(const cMap & a_Map, unsigned a_DataStartX, unsigned a_DataStartY, unsigned a_DataWidth, unsigned a_DataHeight)
 {
 	ASSERT(m_Protocol != nullptr);
-	m_Protocol->SendMapData(a_Map, a_DataStartX, a_DataStartY);
+	m_Protocol->SendMapData(a_Map, a_DataStartX, a_DataStartY, a_DataWidth, a_DataHeight);
 }
 
 
@@ -86,7 +86,15 @@ void cProtocol_1_13::Initialize(cClientHandle & a_Client)
 
 	// Process the palette into the temporary BLOCKTYPE -> NetBlockID map:
 	auto upg = cRoot::Get()->GetUpgradeBlockTypePalette();
-	m_BlockTypeMap = m_BlockTypePalette->createTransformMapWithFallback(upg, 0);
+	auto TransformMap = m_BlockTypePalette->createTransformMapWithFallback(upg, 0);
+	m_BlockTypeMap.assign(256 * 16, 0);
+	for (const auto & Entry: TransformMap)
+	{
+		if (Entry.first < m_BlockTypeMap.size())
+		{
+			m_BlockTypeMap[Entry.first] = Entry.second;
+		}
+	}
 }
 
 
@@ -333,7 +341,7 @@ void cProtocol_1_13::SendChunkData(int a_ChunkX, int a_ChunkZ, cChunkDataSeriali
 
 
 
-void cProtocol_1_13::SendMapData(const cMap & a_Map, int a_DataStartX, int a_DataStartY)
+void cProtocol_1_13::SendMapData(const cMap & a_Map, unsigned a_DataStartX, unsigned a_DataStartY, unsigned a_DataWidth, unsigned a_DataHeight)
 {
 	// TODO
 }
@@ -46,8 +46,9 @@ protected:
 	std::shared_ptr<const BlockTypePalette> m_BlockTypePalette;
 
 	/** Temporary hack for initial 1.13+ support while keeping BLOCKTYPE data:
-	Map of the BLOCKTYPE#META to the protocol-specific NetBlockID. */
-	std::map<UInt32, UInt32> m_BlockTypeMap;
+	Map of the BLOCKTYPE#META to the protocol-specific NetBlockID.
+	Dense table indexed by (BLOCKTYPE * 16 + META), so that chunk serialization needn't do a tree lookup per block. */
+	std::vector<UInt32> m_BlockTypeMap;
 
 
 	/** Returns the string identifying the palettes' version, such as "1.13" or "1.14.4".
@@ -66,7 +67,7 @@ protected:
 	virtual void SendBlockChange                (int a_BlockX, int a_BlockY, int a_BlockZ, BLOCKTYPE a_BlockType, NIBBLETYPE a_BlockMeta) override;
 	virtual void SendBlockChanges               (int a_ChunkX, int a_ChunkZ, const sSetBlockVector & a_Changes) override;
 	virtual void SendChunkData                  (int a_ChunkX, int a_ChunkZ, cChunkDataSerializer & a_Serializer) override;
-	virtual void SendMapData                    (const cMap & a_Map, int a_DataStartX, int a_DataStartY) override;
+	virtual void SendMapData                    (const cMap & a_Map, unsigned a_DataStartX, unsigned a_DataStartY, unsigned a_DataWidth, unsigned a_DataHeight) override;
 	virtual void SendPaintingSpawn              (const cPainting & a_Painting) override;
 	virtual void SendPluginMessage              (const AString & a_Channel, const AString & a_Message) override;
 	virtual void SendScoreboardObjective        (const AString & a_Name, const AString & a_DisplayName, Byte a_Mode) override;
@@ -25,6 +25,7 @@ Implements the 1.8 protocol classes:
 #include "../UUID.h"
 #include "../World.h"
 #include "../JsonUtils.h"
+#include "../Metrics.h"
 
 #include "../WorldStorage/FastNBT.h"
 #include "../WorldStorage/EnchantmentSerializer.h"
@@ -99,6 +100,28 @@ extern bool g_ShouldLogCommIn, g_ShouldLogCommOut;
 
 
 
+/** Returns the counter of the packets received from all the clients. */
+static cMetricCounter & GetPacketsReceivedMetric(void)
+{
+	static cMetricCounter & Metric = cMetrics::Get().GetCounter("cuberite_network_received_packets_total", "Number of packets received from the clients.");
+	return Metric;
+}
+
+
+
+
+
+/** Returns the counter of the packets sent to all the clients. */
+static cMetricCounter & GetPacketsSentMetric(void)
+{
+	static cMetricCounter & Metric = cMetrics::Get().GetCounter("cuberite_network_sent_packets_total", "Number of packets sent to the clients.");
+	return Metric;
+}
+
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // cProtocol_1_8_0:
 
@@ -840,7 +863,7 @@ void cProtocol_1_8_0::SendPaintingSpawn(const cPainting & a_Painting)
 
 
 
-void cProtocol_1_8_0::SendMapData(const cMap & a_Map, int a_DataStartX, int a_DataStartY)
+void cProtocol_1_8_0::SendMapData(const cMap & a_Map, unsigned a_DataStartX, unsigned a_DataStartY, unsigned a_DataWidth, unsigned a_DataHeight)
 {
 	ASSERT(m_State == 3);  // In game mode?
 
@@ -856,14 +879,20 @@ void cProtocol_1_8_0::SendMapData(const cMap & a_Map, int a_DataStartX, int a_Da
 		Pkt.WriteBEUInt8(static_cast<UInt8>(Decorator.GetPixelZ()));
 	}
 
-	Pkt.WriteBEUInt8(128);
-	Pkt.WriteBEUInt8(128);
+	// Zero columns means no pixel data, only the decorators are updated:
+	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataWidth));
+	if (a_DataWidth == 0)
+	{
+		return;
+	}
+	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataHeight));
 	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataStartX));
 	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataStartY));
-	Pkt.WriteVarInt32(static_cast<UInt32>(a_Map.GetData().size()));
-	for (auto itr = a_Map.GetData().cbegin(); itr != a_Map.GetData().cend(); ++itr)
+	Pkt.WriteVarInt32(static_cast<UInt32>(a_DataWidth * a_DataHeight));
+	const auto & Data = a_Map.GetData();
+	for (unsigned z = a_DataStartY; z < a_DataStartY + a_DataHeight; ++z)
 	{
-		Pkt.WriteBEUInt8(*itr);
+		Pkt.WriteBuf(reinterpret_cast<const char *>(Data.data() + z * a_Map.GetWidth() + a_DataStartX), a_DataWidth);
 	}
 }
 
@@ -1980,6 +2009,7 @@ void cProtocol_1_8_0::AddReceivedData(const char * a_Data, size_t a_Size)
 			);
 		}
 
+		GetPacketsReceivedMetric().Add();
 		if (!HandlePacket(bb, PacketType))
 		{
 			// Unknown packet, already been reported, but without the length. Log the length here:
@@ -3117,6 +3147,7 @@ eBlockFace cProtocol_1_8_0::FaceIntToBlockFace(Int8 a_BlockFace)
 
 void cProtocol_1_8_0::SendPacket(cPacketizer & a_Pkt)
 {
+	GetPacketsSentMetric().Add();
 	UInt32 PacketLen = static_cast<UInt32>(m_OutPacketBuffer.GetUsedSpace());
 	AString PacketData, CompressedPacket;
 	m_OutPacketBuffer.ReadAll(PacketData);
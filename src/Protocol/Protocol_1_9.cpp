@@ -311,7 +311,7 @@ void cProtocol_1_9_0::SendPaintingSpawn(const cPainting & a_Painting)
 
 
 
-void cProtocol_1_9_0::SendMapData(const cMap & a_Map, int a_DataStartX, int a_DataStartY)
+void cProtocol_1_9_0::SendMapData(const cMap & a_Map, unsigned a_DataStartX, unsigned a_DataStartY, unsigned a_DataWidth, unsigned a_DataHeight)
 {
 	ASSERT(m_State == 3);  // In game mode?
 
@@ -328,14 +328,20 @@ void cProtocol_1_9_0::SendMapData(const cMap & a_Map, int a_DataStartX, int a_Da
 		Pkt.WriteBEUInt8(static_cast<UInt8>(Decorator.GetPixelZ()));
 	}
 
-	Pkt.WriteBEUInt8(128);
-	Pkt.WriteBEUInt8(128);
+	// Zero columns means no pixel data, only the decorators are updated:
+	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataWidth));
+	if (a_DataWidth == 0)
+	{
+		return;
+	}
+	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataHeight));
 	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataStartX));
 	Pkt.WriteBEUInt8(static_cast<UInt8>(a_DataStartY));
-	Pkt.WriteVarInt32(static_cast<UInt32>(a_Map.GetData().size()));
-	for (auto itr = a_Map.GetData().cbegin(); itr != a_Map.GetData().cend(); ++itr)
+	Pkt.WriteVarInt32(static_cast<UInt32>(a_DataWidth * a_DataHeight));
+	const auto & Data = a_Map.GetData();
+	for (unsigned z = a_DataStartY; z < a_DataStartY + a_DataHeight; ++z)
 	{
-		Pkt.WriteBEUInt8(*itr);
+		Pkt.WriteBuf(reinterpret_cast<const char *>(Data.data() + z * a_Map.GetWidth() + a_DataStartX), a_DataWidth);
 	}
 }
 
@@ -41,6 +41,7 @@
 #include "ClientHandle.h"
 #include "BlockTypePalette.h"
 #include "Protocol/ProtocolPalettes.h"
+#include "Pregenerator.h"
 
 
 
@@ -189,6 +190,12 @@ void cRoot::Start(std::unique_ptr<cSettingsRepositoryInterface> a_OverridesRepo)
 
 	auto settingsRepo = cpp14::make_unique<cOverridesSettingsRepository>(std::move(IniFile), std::move(a_OverridesRepo));
 
+	if (settingsRepo->GetValueSetB("Server", "AsyncLogging", false))
+	{
+		// Let a separate thread do the console and file writes, so that the tick threads don't wait for them:
+		cLogger::GetInstance().StartAsync();
+	}
+
 	LOG("Starting server...");
 
 	// cClientHandle::FASTBREAK_PERCENTAGE = settingsRepo->GetValueSetI("AntiCheat", "FastBreakPercentage", 97) / 100.0f;
@@ -203,6 +210,7 @@ void cRoot::Start(std::unique_ptr<cSettingsRepositoryInterface> a_OverridesRepo)
 	{
 		settingsRepo->Flush();
 		LOGERROR("Failure starting server, aborting...");
+		cLogger::GetInstance().StopAsync();
 		return;
 	}
 
@@ -242,7 +250,22 @@ void cRoot::Start(std::unique_ptr<cSettingsRepositoryInterface> a_OverridesRepo)
 	settingsRepo->Flush();
 
 	LOGD("Finalising startup...");
-	if (m_Server->Start())
+	if (settingsRepo->HasValue("Server", "PregenerateRadius"))
+	{
+		// Offline pregeneration requested on the command line, don't accept any connections and exit once done:
+		int Radius = 0;
+		if (!StringToInteger(settingsRepo->GetValue("Server", "PregenerateRadius"), Radius) || (Radius < 0))
+		{
+			LOGERROR("Invalid pregeneration radius, must be a non-negative number of chunks");
+		}
+		else
+		{
+			PregenerateWorlds(Radius);
+			SaveAllChunks();
+		}
+		m_TerminateEventRaised = true;
+	}
+	else if (m_Server->Start())
 	{
 		m_WebAdmin->Start();
 
@@ -317,40 +340,44 @@ void cRoot::Start(std::unique_ptr<cSettingsRepositoryInterface> a_OverridesRepo)
 	LOG("Cleaning up...");
 	delete m_Server; m_Server = nullptr;
 
-	m_InputThreadRunFlag.clear();
-	#ifdef _WIN32
-		DWORD Length;
-		INPUT_RECORD Record
-		{
-			KEY_EVENT,
+	// The input thread isn't running if the server failed to start or only pregenerated the worlds:
+	if (m_InputThread.joinable())
+	{
+		m_InputThreadRunFlag.clear();
+		#ifdef _WIN32
+			DWORD Length;
+			INPUT_RECORD Record
 			{
+				KEY_EVENT,
 				{
-					TRUE,
-					1,
-					VK_RETURN,
-					static_cast<WORD>(MapVirtualKey(VK_RETURN, MAPVK_VK_TO_VSC)),
-					{ { VK_RETURN } },
-					0
+					{
+						TRUE,
+						1,
+						VK_RETURN,
+						static_cast<WORD>(MapVirtualKey(VK_RETURN, MAPVK_VK_TO_VSC)),
+						{ { VK_RETURN } },
+						0
+					}
 				}
-			}
-		};
+			};
 
-		// Can't kill the input thread since it breaks cin (getline doesn't block / receive input on restart)
-		// Apparently no way to unblock getline
-		// Only thing I can think of for now
-		if (WriteConsoleInput(GetStdHandle(STD_INPUT_HANDLE), &Record, 1, &Length) == 0)
-		{
-			LOGWARN("Couldn't notify the input thread; the server will hang before shutdown!");
-			m_TerminateEventRaised = true;
-			m_InputThread.detach();
-		}
-		else
-		{
+			// Can't kill the input thread since it breaks cin (getline doesn't block / receive input on restart)
+			// Apparently no way to unblock getline
+			// Only thing I can think of for now
+			if (WriteConsoleInput(GetStdHandle(STD_INPUT_HANDLE), &Record, 1, &Length) == 0)
+			{
+				LOGWARN("Couldn't notify the input thread; the server will hang before shutdown!");
+				m_TerminateEventRaised = true;
+				m_InputThread.detach();
+			}
+			else
+			{
+				m_InputThread.join();
+			}
+		#else
 			m_InputThread.join();
-		}
-	#else
-		m_InputThread.join();
-	#endif
+		#endif
+	}
 
 	if (m_TerminateEventRaised)
 	{
@@ -361,6 +388,9 @@ void cRoot::Start(std::unique_ptr<cSettingsRepositoryInterface> a_OverridesRepo)
 		LOG("Shutdown successful - restarting...");
 	}
 	LOG("--- Stopped Log ---");
+
+	// Write out any queued messages before the listeners are detached:
+	cLogger::GetInstance().StopAsync();
 }
 
 
@@ -403,39 +433,29 @@ void cRoot::LoadGlobalSettings()
 
 void cRoot::LoadPalettes(const AString & aProtocolFolder)
 {
-	LOG("Loading UpgradeBlockTypePalette...");
-	try
-	{
-		auto paletteStr = cFile::ReadWholeFile(aProtocolFolder + cFile::PathSeparator() + "UpgradeBlockTypePalette.txt");
-		if (paletteStr.empty())
-		{
-			throw std::runtime_error("File is empty");
-		}
-		m_UpgradeBlockTypePalette.reset(new BlockTypePalette);
-		m_UpgradeBlockTypePalette->loadFromString(paletteStr);
-	}
-	catch (const std::exception & exc)
+	// The upgrade palette is only checked for here, it is loaded when the first 1.13+ client connects:
+	m_UpgradeBlockTypePaletteFileName = aProtocolFolder + cFile::PathSeparator() + "UpgradeBlockTypePalette.txt";
+	if (cFile::GetSize(m_UpgradeBlockTypePaletteFileName) <= 0)
 	{
-		LOGERROR("Failed to load the Upgrade block type palette from %s/UpgradeBlockTypePalette.txt: %s\nAborting",
-			aProtocolFolder, exc.what()
+		LOGERROR("Failed to load the Upgrade block type palette from %s: File is missing or empty\nAborting",
+			m_UpgradeBlockTypePaletteFileName
 		);
-		throw;
+		throw std::runtime_error("The upgrade block type palette is missing");
 	}
 
-	// Note: This can take a lot of time in MSVC debug builds
-	// If impatient, edit the settings.ini: [Folders] ProtocolPalettes=DummyDir; copy only one palette to DummyDir
-	LOG("Loading per-protocol palettes...");
+	// The per-protocol palettes are only enumerated here, each is loaded when the first client of its version connects
+	// Note: Loading can take a lot of time in MSVC debug builds
 	m_ProtocolPalettes.reset(new ProtocolPalettes);
 	m_ProtocolPalettes->load(aProtocolFolder);
 	auto versions = m_ProtocolPalettes->protocolVersions();
 	if (versions.empty())
 	{
-		LOGWARNING("No per-protocol palettes were loaded");
+		LOGWARNING("No per-protocol palettes were found");
 	}
 	else
 	{
 		std::sort(versions.begin(), versions.end());
-		LOG("Loaded palettes for protocol versions: %s", StringJoin(versions, ", "));
+		LOG("Found palettes for protocol versions: %s", StringJoin(versions, ", "));
 	}
 }
 
@@ -443,6 +463,43 @@ void cRoot::LoadPalettes(const AString & aProtocolFolder)
 
 
 
+const BlockTypePalette & cRoot::GetUpgradeBlockTypePalette() const
+{
+	cCSLock Lock(m_CSUpgradeBlockTypePalette);
+	if (m_UpgradeBlockTypePalette != nullptr)
+	{
+		return *m_UpgradeBlockTypePalette;
+	}
+
+	auto Start = std::chrono::steady_clock::now();
+	try
+	{
+		auto paletteStr = cFile::ReadWholeFile(m_UpgradeBlockTypePaletteFileName);
+		if (paletteStr.empty())
+		{
+			throw std::runtime_error("File is empty");
+		}
+		auto Palette = cpp14::make_unique<BlockTypePalette>();
+		Palette->loadFromString(paletteStr);
+		m_UpgradeBlockTypePalette = std::move(Palette);
+	}
+	catch (const std::exception & exc)
+	{
+		LOGERROR("Failed to load the Upgrade block type palette from %s: %s",
+			m_UpgradeBlockTypePaletteFileName, exc.what()
+		);
+		throw;
+	}
+	LOG("Loaded the Upgrade block type palette in %.1f ms",
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count()
+	);
+	return *m_UpgradeBlockTypePalette;
+}
+
+
+
+
+
 void cRoot::LoadWorlds(cDeadlockDetect & a_dd, cSettingsRepositoryInterface & a_Settings, bool a_IsNewIniFile)
 {
 	if (a_IsNewIniFile)
@@ -591,11 +648,90 @@ void cRoot::LoadWorlds(cDeadlockDetect & a_dd, cSettingsRepositoryInterface & a_
 
 void cRoot::StartWorlds(cDeadlockDetect & a_DeadlockDetect)
 {
-	for (WorldMap::iterator itr = m_WorldsByName.begin(); itr != m_WorldsByName.end(); ++itr)
+	auto StartTime = std::chrono::steady_clock::now();
+
+	// Each world has its own generator, lighting and storage threads, so the spawn areas can be prepared concurrently.
+	// Start all the worlds, then prepare their spawns:
+	for (const auto & World: m_WorldsByName)
+	{
+		World.second->Start();
+	}
+	ForEachWorldInParallel([](cWorld & a_World)
+		{
+			a_World.InitializeSpawn();
+		}
+	);
+
+	// Notify the plugins from the main thread, once all the worlds are ready:
+	for (const auto & World: m_WorldsByName)
+	{
+		m_PluginManager->CallHookWorldStarted(*World.second);
+	}
+
+	auto Elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - StartTime);
+	LOG("Started %u worlds in %.02f seconds", static_cast<unsigned>(m_WorldsByName.size()), Elapsed.count());
+}
+
+
+
+
+
+void cRoot::PregenerateWorlds(int a_Radius)
+{
+	auto StartTime = std::chrono::steady_clock::now();
+
+	// Each world has its own generator, lighting and storage threads, so the worlds can be pregenerated concurrently.
+	// Split the cores among the worlds for generating, the most expensive part:
+	unsigned NumCores = std::max(std::thread::hardware_concurrency(), 1U);
+	auto NumWorldsAtOnce = static_cast<unsigned>(std::min<size_t>(NumCores, std::max<size_t>(m_WorldsByName.size(), 1)));
+	unsigned NumGeneratorThreads = std::max(NumCores / NumWorldsAtOnce, 1U);
+	ForEachWorldInParallel([a_Radius, NumGeneratorThreads](cWorld & a_World)
+		{
+			int SpawnChunkX, SpawnChunkZ;
+			cChunkDef::BlockToChunk(FloorC(a_World.GetSpawnX()), FloorC(a_World.GetSpawnZ()), SpawnChunkX, SpawnChunkZ);
+			cPregenerator::Pregenerate(
+				a_World, SpawnChunkX - a_Radius, SpawnChunkZ - a_Radius, SpawnChunkX + a_Radius, SpawnChunkZ + a_Radius, NumGeneratorThreads
+			);
+		}
+	);
+
+	auto Elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - StartTime);
+	LOG("Pregenerated %u worlds in %.02f seconds", static_cast<unsigned>(m_WorldsByName.size()), Elapsed.count());
+}
+
+
+
+
+
+void cRoot::ForEachWorldInParallel(const std::function<void(cWorld &)> & a_Action)
+{
+	// Collect the worlds, so that the workers can pick them by index:
+	std::vector<cWorld *> Worlds;
+	Worlds.reserve(m_WorldsByName.size());
+	for (const auto & World: m_WorldsByName)
+	{
+		Worlds.push_back(World.second);
+	}
+
+	// While a world is being processed, its generator, lighting and storage threads are busy;
+	// limit the number of worlds processed at once so that they don't oversubscribe the CPU:
+	size_t NumWorkers = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U), Worlds.size());
+	std::atomic<size_t> NextWorld(0);
+	std::vector<std::thread> Workers;
+	for (size_t i = 0; i < NumWorkers; ++i)
+	{
+		Workers.emplace_back([&Worlds, &NextWorld, &a_Action]()
+			{
+				for (size_t Idx = NextWorld++; Idx < Worlds.size(); Idx = NextWorld++)
+				{
+					a_Action(*Worlds[Idx]);
+				}
+			}
+		);
+	}
+	for (auto & Worker: Workers)
 	{
-		itr->second->Start();
-		itr->second->InitializeSpawn();
-		m_PluginManager->CallHookWorldStarted(*itr->second);
+		Worker.join();
 	}
 }
 
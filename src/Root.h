@@ -95,8 +95,10 @@ public:
 	/** Returns the (read-write) storage for registered block types. */
 	BlockTypeRegistry & GetBlockTypeRegistry() { return m_BlockTypeRegistry; }
 
-	/** Returns the block type palette used for upgrading blocks from pre-1.13 data. */
-	const BlockTypePalette & GetUpgradeBlockTypePalette() const { return *m_UpgradeBlockTypePalette; }
+	/** Returns the block type palette used for upgrading blocks from pre-1.13 data.
+	The palette is loaded on the first call, i.e. when the first 1.13+ client connects.
+	Throws a std::exception if the palette cannot be loaded. */
+	const BlockTypePalette & GetUpgradeBlockTypePalette() const;
 
 	/** Returns the per-protocol palettes manager. */
 	ProtocolPalettes & GetProtocolPalettes() const { return *m_ProtocolPalettes; }
@@ -243,8 +245,15 @@ private:
 	/** The storage for all registered block types. */
 	BlockTypeRegistry m_BlockTypeRegistry;
 
-	/** The upgrade palette for pre-1.13 blocks. */
-	std::unique_ptr<BlockTypePalette> m_UpgradeBlockTypePalette;
+	/** The file from which the upgrade palette is loaded on first use. */
+	AString m_UpgradeBlockTypePaletteFileName;
+
+	/** Protects m_UpgradeBlockTypePalette while it is being loaded. */
+	mutable cCriticalSection m_CSUpgradeBlockTypePalette;
+
+	/** The upgrade palette for pre-1.13 blocks.
+	Mutable, because it is loaded lazily from within the const getter. */
+	mutable std::unique_ptr<BlockTypePalette> m_UpgradeBlockTypePalette;
 
 	/** The per-protocol palettes manager. */
 	std::unique_ptr<ProtocolPalettes> m_ProtocolPalettes;
@@ -252,7 +261,7 @@ private:
 
 	void LoadGlobalSettings();
 
-	/** Loads the upgrade palette and the per-protocol palettes.
+	/** Checks that the upgrade palette exists and registers the per-protocol palettes; all of them are loaded on first use.
 	The aProtocolFolder is the path to the folder containing the per-protocol palettes. */
 	void LoadPalettes(const AString & aProtocolFolder);
 
@@ -262,6 +271,15 @@ private:
 	/** Starts each world's life */
 	void StartWorlds(cDeadlockDetect & a_DeadlockDetect);
 
+	/** Generates, lights and saves all chunks within the specified radius (in chunks) around each world's spawn.
+	The worlds are processed in parallel. Blocks until all the worlds are done. */
+	void PregenerateWorlds(int a_Radius);
+
+	/** Calls a_Action for each world, processing several worlds in parallel.
+	At most as many worlds as there are hardware threads are processed at the same time, each by a temporary worker thread.
+	Blocks until a_Action has returned for all the worlds. */
+	void ForEachWorldInParallel(const std::function<void(cWorld &)> & a_Action);
+
 	/** Stops each world's threads, so that it's safe to unload them */
 	void StopWorlds(cDeadlockDetect & a_DeadlockDetect);
 
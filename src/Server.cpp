@@ -538,6 +538,84 @@ void cServer::ExecuteConsoleCommand(const AString & a_Cmd, cCommandOutputCallbac
 		a_Output.Finished();
 		return;
 	}
+	else if (split[0].compare("hookstats") == 0)
+	{
+		auto PluginManager = cPluginManager::Get();
+		if (split.size() == 1)
+		{
+			a_Output.Out(PluginManager->GetHookProfilerStats());
+		}
+		else if (split[1] == "on")
+		{
+			PluginManager->SetHookProfilerEnabled(true);
+			a_Output.Out("Hook profiler enabled, statistics reset");
+		}
+		else if (split[1] == "off")
+		{
+			PluginManager->SetHookProfilerEnabled(false);
+			a_Output.Out("Hook profiler disabled");
+		}
+		else
+		{
+			a_Output.Out("Usage: hookstats [on | off]");
+		}
+		a_Output.Finished();
+		return;
+	}
+	else if (split[0].compare("tickstats") == 0)
+	{
+		if ((split.size() == 2) && ((split[1] == "on") || (split[1] == "off")))
+		{
+			bool ShouldEnable = (split[1] == "on");
+			cRoot::Get()->ForEachWorld([ShouldEnable](cWorld & a_World)
+				{
+					a_World.SetTickProfilerEnabled(ShouldEnable);
+					return false;
+				}
+			);
+			a_Output.Out(ShouldEnable ? "Tick profiler enabled in all worlds, statistics reset" : "Tick profiler disabled in all worlds");
+		}
+		else if (split.size() == 1)
+		{
+			cRoot::Get()->ForEachWorld([&a_Output](cWorld & a_World)
+				{
+					a_Output.Out(Printf("World \"%s\":\n%s", a_World.GetName(), a_World.GetTickProfilerStats()));
+					return false;
+				}
+			);
+		}
+		else
+		{
+			a_Output.Out("Usage: tickstats [on | off]");
+		}
+		a_Output.Finished();
+		return;
+	}
+	else if (split[0].compare("ticktrace") == 0)
+	{
+		if (split.size() != 3)
+		{
+			a_Output.Out("Usage: ticktrace <WorldName> <FileName>");
+		}
+		else
+		{
+			auto World = cRoot::Get()->GetWorld(split[1]);
+			if (World == nullptr)
+			{
+				a_Output.Out(Printf("There's no world named \"%s\"", split[1]));
+			}
+			else if (World->ExportTickTrace(split[2]))
+			{
+				a_Output.Out(Printf("Tick trace of world \"%s\" written to \"%s\"", split[1], split[2]));
+			}
+			else
+			{
+				a_Output.Out(Printf("Cannot write the tick trace into \"%s\"", split[2]));
+			}
+		}
+		a_Output.Finished();
+		return;
+	}
 	else if (cPluginManager::Get()->ExecuteConsoleCommand(split, a_Output, a_Cmd))
 	{
 		a_Output.Finished();
@@ -623,6 +701,9 @@ void cServer::BindBuiltInConsoleCommands(void)
 	PlgMgr->BindConsoleCommand("load",            nullptr, handler, "Adds and enables the specified plugin");
 	PlgMgr->BindConsoleCommand("unload",          nullptr, handler, "Disables the specified plugin");
 	PlgMgr->BindConsoleCommand("destroyentities", nullptr, handler, "Destroys all entities in all worlds");
+	PlgMgr->BindConsoleCommand("hookstats",       nullptr, handler, "Shows the plugin hook timing statistics; \"hookstats on\" / \"hookstats off\" starts / stops collecting them");
+	PlgMgr->BindConsoleCommand("tickstats",       nullptr, handler, "Shows the worlds' tick phase timings; \"tickstats on\" / \"tickstats off\" starts / stops recording them");
+	PlgMgr->BindConsoleCommand("ticktrace",       nullptr, handler, "Writes the recorded ticks of a world into a Chrome trace file: ticktrace <WorldName> <FileName>");
 }
 
 
@@ -2,6 +2,7 @@
 
 #include "FluidSimulator.h"
 #include "../World.h"
+#include "../Chunk.h"
 
 
 
@@ -137,7 +138,35 @@ Vector3f cFluidSimulator::GetFlowingDirection(int a_X, int a_Y, int a_Z)
 		return {};
 	}
 
-	if (!IsAllowedBlock(m_World.GetBlock(a_X, a_Y, a_Z)))  // No Fluid -> No Flowing direction :D
+	// Look up the chunk and let the chunk-based version do the work; no chunk -> no fluid -> no flowing direction:
+	Vector3f Direction;
+	m_World.DoWithChunkAt({a_X, a_Y, a_Z}, [&](cChunk & a_Chunk)
+		{
+			if (a_Chunk.IsValid())
+			{
+				Direction = GetFlowingDirection(a_Chunk, cChunkDef::AbsoluteToRelative({a_X, a_Y, a_Z}));
+			}
+			return true;
+		}
+	);
+	return Direction;
+}
+
+
+
+
+
+Vector3f cFluidSimulator::GetFlowingDirection(cChunk & a_Chunk, Vector3i a_RelPos)
+{
+	if (!cChunkDef::IsValidHeight(a_RelPos.y))
+	{
+		return {};
+	}
+
+	BLOCKTYPE BlockType;
+	NIBBLETYPE BlockMeta;
+	a_Chunk.GetBlockTypeMeta(a_RelPos, BlockType, BlockMeta);
+	if (!IsAllowedBlock(BlockType))  // No Fluid -> No Flowing direction
 	{
 		return {};
 	}
@@ -148,24 +177,25 @@ Vector3f cFluidSimulator::GetFlowingDirection(int a_X, int a_Y, int a_Z)
 			return ((a_BlockMeta & 0x08) != 0) ? 0 : a_BlockMeta;
 		};
 
-	auto BlockMeta = m_World.GetBlockMeta(a_X, a_Y, a_Z);
 	NIBBLETYPE CentralPoint = HeightFromMeta(BlockMeta);
 	NIBBLETYPE LevelPoint[4];
 
-	// blocks around the checking pos
+	// blocks around the checking pos, may lie in the neighboring chunks
 	Vector3i Points[]
 	{
-		{ a_X + 1, a_Y, a_Z },
-		{ a_X, a_Y, a_Z + 1 },
-		{ a_X - 1, a_Y, a_Z },
-		{ a_X, a_Y, a_Z - 1 }
+		a_RelPos.addedX(1),
+		a_RelPos.addedZ(1),
+		a_RelPos.addedX(-1),
+		a_RelPos.addedZ(-1)
 	};
 
 	for (size_t i = 0; i < ARRAYCOUNT(LevelPoint); i++)
 	{
-		if (IsAllowedBlock(m_World.GetBlock(Points[i])))
+		BLOCKTYPE NeighborType;
+		NIBBLETYPE NeighborMeta;
+		if (a_Chunk.UnboundedRelGetBlock(Points[i], NeighborType, NeighborMeta) && IsAllowedBlock(NeighborType))
 		{
-			LevelPoint[i] = HeightFromMeta(m_World.GetBlockMeta(Points[i]));
+			LevelPoint[i] = HeightFromMeta(NeighborMeta);
 		}
 		else
 		{
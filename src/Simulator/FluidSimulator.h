@@ -4,6 +4,7 @@
 #include "Simulator.h"
 
 
+class cChunk;
 class cWorld;
 
 
@@ -46,9 +47,14 @@ public:
 	// cSimulator overrides:
 	virtual bool IsAllowedBlock(BLOCKTYPE a_BlockType) override;
 
-	/** Returns a unit vector in the direction the fluid is flowing or a zero-vector if not flowing. */
+	/** Returns a unit vector in the direction the fluid is flowing or a zero-vector if not flowing.
+	Locks the chunkmap and delegates to the chunk-based overload. */
 	virtual Vector3f GetFlowingDirection(int a_X, int a_Y, int a_Z);
 
+	/** Returns a unit vector in the direction the fluid is flowing at a_RelPos in a_Chunk, or a zero-vector if not flowing.
+	Reads the blocks directly from the chunk and its neighbors, so the caller must hold the chunkmap's CS (e.g. is in a chunk tick). */
+	Vector3f GetFlowingDirection(cChunk & a_Chunk, Vector3i a_RelPos);
+
 	/** Creates a ChunkData object for the simulator to use. The simulator returns the correct object type. */
 	virtual cFluidSimulatorData * CreateChunkData(void) { return nullptr; }
 
@@ -0,0 +1,373 @@
+
+// TickProfiler.cpp
+
+// Implements the cTickProfiler class that records the durations of the individual phases of a world's ticks
+
+#include "Globals.h"
+#include "TickProfiler.h"
+#include "JsonUtils.h"
+#include "json/json.h"
+
+
+
+
+
+cTickProfiler::cTickProfiler(void):
+	m_IsEnabled(false),
+	m_IsRecordingTick(false),
+	m_CurrentTick(),
+	m_Epoch(std::chrono::steady_clock::now()),
+	m_NextTick(0)
+{
+}
+
+
+
+
+
+void cTickProfiler::SetEnabled(bool a_Enabled)
+{
+	cCSLock Lock(m_CS);
+	if (a_Enabled)
+	{
+		m_Ticks.clear();
+		m_Ticks.reserve(NUM_TICKS);
+		m_NextTick = 0;
+	}
+	m_IsEnabled.store(a_Enabled, std::memory_order_relaxed);
+}
+
+
+
+
+
+void cTickProfiler::BeginTick(void)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+	m_IsRecordingTick = true;
+	m_TickStart = std::chrono::steady_clock::now();
+	m_LastPhaseEnd = m_TickStart;
+	m_CurrentTick.m_Start = static_cast<UInt64>(std::chrono::duration_cast<std::chrono::microseconds>(m_TickStart - m_Epoch).count());
+	m_CurrentTick.m_PhaseDurations.fill(0);
+	m_CurrentTick.m_NumChunkOutliers = 0;
+}
+
+
+
+
+
+void cTickProfiler::EndPhase(ePhase a_Phase)
+{
+	if (!m_IsRecordingTick)
+	{
+		return;
+	}
+	ASSERT((a_Phase >= 0) && (a_Phase < phCount));
+	auto Now = std::chrono::steady_clock::now();
+	m_CurrentTick.m_PhaseDurations[static_cast<size_t>(a_Phase)] += ToUSec(Now - m_LastPhaseEnd);
+	m_LastPhaseEnd = Now;
+}
+
+
+
+
+
+void cTickProfiler::ChunkTicked(int a_ChunkX, int a_ChunkZ, TimePoint a_Start, TimePoint a_End)
+{
+	if (!m_IsRecordingTick)
+	{
+		return;
+	}
+	auto Duration = ToUSec(a_End - a_Start);
+	if (Duration < static_cast<UInt32>(CHUNK_OUTLIER_THRESHOLD_USEC))
+	{
+		return;
+	}
+
+	// Insert into the outliers, which are sorted by duration, dropping the fastest one if full:
+	auto & Outliers = m_CurrentTick.m_ChunkOutliers;
+	auto & NumOutliers = m_CurrentTick.m_NumChunkOutliers;
+	size_t Idx = NumOutliers;
+	while ((Idx > 0) && (Outliers[Idx - 1].m_Duration < Duration))
+	{
+		Idx -= 1;
+	}
+	if (Idx >= MAX_CHUNK_OUTLIERS)
+	{
+		// Faster than all the outliers recorded so far
+		return;
+	}
+	if (NumOutliers < MAX_CHUNK_OUTLIERS)
+	{
+		NumOutliers += 1;
+	}
+	for (size_t i = NumOutliers - 1; i > Idx; --i)
+	{
+		Outliers[i] = Outliers[i - 1];
+	}
+	Outliers[Idx] = {a_ChunkX, a_ChunkZ, ToUSec(a_Start - m_TickStart), Duration};
+}
+
+
+
+
+
+void cTickProfiler::EndTick(void)
+{
+	if (!m_IsRecordingTick)
+	{
+		return;
+	}
+	m_IsRecordingTick = false;
+	m_CurrentTick.m_Duration = ToUSec(std::chrono::steady_clock::now() - m_TickStart);
+
+	cCSLock Lock(m_CS);
+	if (m_Ticks.size() < NUM_TICKS)
+	{
+		m_Ticks.push_back(m_CurrentTick);
+	}
+	else
+	{
+		m_Ticks[m_NextTick] = m_CurrentTick;
+	}
+	m_NextTick = (m_NextTick + 1) % NUM_TICKS;
+}
+
+
+
+
+
+AString cTickProfiler::GetStats(void) const
+{
+	auto Ticks = GetTicks();
+	if (Ticks.empty())
+	{
+		return IsEnabled() ? "No ticks recorded yet.\n" : "The tick profiler is disabled, no ticks recorded.\n";
+	}
+
+	// Sum up the phases and the totals:
+	std::array<UInt64, phCount> PhaseTotal{};
+	std::array<UInt32, phCount> PhaseMax{};
+	UInt64 TickTotal = 0;
+	UInt32 TickMax = 0;
+	size_t NumSlowTicks = 0;
+	for (const auto & Tick: Ticks)
+	{
+		TickTotal += Tick.m_Duration;
+		TickMax = std::max(TickMax, Tick.m_Duration);
+		if (Tick.m_Duration > 50000)
+		{
+			NumSlowTicks += 1;
+		}
+		for (size_t i = 0; i < phCount; i++)
+		{
+			PhaseTotal[i] += Tick.m_PhaseDurations[i];
+			PhaseMax[i] = std::max(PhaseMax[i], Tick.m_PhaseDurations[i]);
+		}
+	}
+	auto NumTicks = static_cast<double>(Ticks.size());
+	auto LastStart = Ticks.back().m_Start;
+
+	AString Res;
+	AppendPrintf(Res, "Recorded ticks: %zu, covering the last %.1f sec\n",
+		Ticks.size(), static_cast<double>(LastStart - Ticks.front().m_Start) / 1000000
+	);
+	AppendPrintf(Res, "Tick duration: avg %.3f ms, max %.3f ms; %zu ticks took longer than 50 ms\n",
+		static_cast<double>(TickTotal) / NumTicks / 1000, static_cast<double>(TickMax) / 1000, NumSlowTicks
+	);
+	AppendPrintf(Res, "%-14s %10s %10s %8s\n", "Phase", "avg [ms]", "max [ms]", "share");
+	for (size_t i = 0; i < phCount; i++)
+	{
+		AppendPrintf(Res, "%-14s %10.3f %10.3f %6.1f %%\n",
+			GetPhaseName(static_cast<ePhase>(i)),
+			static_cast<double>(PhaseTotal[i]) / NumTicks / 1000,
+			static_cast<double>(PhaseMax[i]) / 1000,
+			(TickTotal > 0) ? (100.0 * static_cast<double>(PhaseTotal[i]) / static_cast<double>(TickTotal)) : 0.0
+		);
+	}
+
+	// List the slowest ticks, with their slowest phase:
+	static const size_t NUM_SLOWEST = 5;
+	std::vector<const sTick *> Slowest;
+	Slowest.reserve(Ticks.size());
+	for (const auto & Tick: Ticks)
+	{
+		Slowest.push_back(&Tick);
+	}
+	auto NumSlowest = std::min<size_t>(NUM_SLOWEST, Slowest.size());
+	std::partial_sort(Slowest.begin(), Slowest.begin() + static_cast<ptrdiff_t>(NumSlowest), Slowest.end(),
+		[](const sTick * a_Tick1, const sTick * a_Tick2)
+		{
+			return (a_Tick1->m_Duration > a_Tick2->m_Duration);
+		}
+	);
+	Res.append("Slowest ticks:\n");
+	for (size_t i = 0; i < NumSlowest; i++)
+	{
+		const auto & Tick = *Slowest[i];
+		auto SlowestPhase = std::max_element(Tick.m_PhaseDurations.begin(), Tick.m_PhaseDurations.end()) - Tick.m_PhaseDurations.begin();
+		AppendPrintf(Res, "  %.1f sec ago: %.3f ms, mostly %s (%.3f ms)\n",
+			static_cast<double>(LastStart - Tick.m_Start) / 1000000,
+			static_cast<double>(Tick.m_Duration) / 1000,
+			GetPhaseName(static_cast<ePhase>(SlowestPhase)),
+			static_cast<double>(Tick.m_PhaseDurations[static_cast<size_t>(SlowestPhase)]) / 1000
+		);
+	}
+
+	// List the slowest chunks:
+	std::vector<std::pair<const sTick *, const sChunkOutlier *>> Chunks;
+	for (const auto & Tick: Ticks)
+	{
+		for (size_t i = 0; i < Tick.m_NumChunkOutliers; i++)
+		{
+			Chunks.emplace_back(&Tick, &Tick.m_ChunkOutliers[i]);
+		}
+	}
+	if (Chunks.empty())
+	{
+		AppendPrintf(Res, "No chunk took longer than %d usec to tick.\n", CHUNK_OUTLIER_THRESHOLD_USEC);
+		return Res;
+	}
+	auto NumSlowestChunks = std::min<size_t>(NUM_SLOWEST, Chunks.size());
+	std::partial_sort(Chunks.begin(), Chunks.begin() + static_cast<ptrdiff_t>(NumSlowestChunks), Chunks.end(),
+		[](const std::pair<const sTick *, const sChunkOutlier *> & a_Chunk1, const std::pair<const sTick *, const sChunkOutlier *> & a_Chunk2)
+		{
+			return (a_Chunk1.second->m_Duration > a_Chunk2.second->m_Duration);
+		}
+	);
+	AppendPrintf(Res, "Slowest chunks (%zu chunk ticks took longer than %d usec):\n", Chunks.size(), CHUNK_OUTLIER_THRESHOLD_USEC);
+	for (size_t i = 0; i < NumSlowestChunks; i++)
+	{
+		const auto & Chunk = *Chunks[i].second;
+		AppendPrintf(Res, "  [%d, %d], %.1f sec ago: %.3f ms\n",
+			Chunk.m_ChunkX, Chunk.m_ChunkZ,
+			static_cast<double>(LastStart - Chunks[i].first->m_Start) / 1000000,
+			static_cast<double>(Chunk.m_Duration) / 1000
+		);
+	}
+	return Res;
+}
+
+
+
+
+
+AString cTickProfiler::GetChromeTrace(const AString & a_ThreadName) const
+{
+	auto Ticks = GetTicks();
+
+	// Creates a "complete" event spanning the specified time, in microseconds:
+	auto MakeEvent = [](const char * a_Name, const char * a_Category, UInt64 a_Start, UInt32 a_Duration)
+	{
+		Json::Value Event;
+		Event["name"] = a_Name;
+		Event["cat"] = a_Category;
+		Event["ph"] = "X";
+		Event["ts"] = static_cast<Json::UInt64>(a_Start);
+		Event["dur"] = a_Duration;
+		Event["pid"] = 1;
+		Event["tid"] = 1;
+		return Event;
+	};
+
+	Json::Value Events(Json::arrayValue);
+	Json::Value ThreadName;
+	ThreadName["name"] = "thread_name";
+	ThreadName["ph"] = "M";
+	ThreadName["pid"] = 1;
+	ThreadName["tid"] = 1;
+	ThreadName["args"]["name"] = a_ThreadName;
+	Events.append(ThreadName);
+	for (const auto & Tick: Ticks)
+	{
+		Events.append(MakeEvent("Tick", "tick", Tick.m_Start, Tick.m_Duration));
+
+		// The phases are executed one after another, so their starts can be reconstructed from the durations:
+		auto PhaseStart = Tick.m_Start;
+		for (size_t i = 0; i < phCount; i++)
+		{
+			if (Tick.m_PhaseDurations[i] > 0)
+			{
+				Events.append(MakeEvent(GetPhaseName(static_cast<ePhase>(i)), "phase", PhaseStart, Tick.m_PhaseDurations[i]));
+			}
+			PhaseStart += Tick.m_PhaseDurations[i];
+		}
+
+		for (size_t i = 0; i < Tick.m_NumChunkOutliers; i++)
+		{
+			const auto & Chunk = Tick.m_ChunkOutliers[i];
+			auto Event = MakeEvent("Chunk", "chunk", Tick.m_Start + Chunk.m_Start, Chunk.m_Duration);
+			Event["args"]["ChunkX"] = Chunk.m_ChunkX;
+			Event["args"]["ChunkZ"] = Chunk.m_ChunkZ;
+			Events.append(Event);
+		}
+	}
+
+	Json::Value Root;
+	Root["traceEvents"] = Events;
+	Root["displayTimeUnit"] = "ms";
+	return JsonUtils::WriteFastString(Root);
+}
+
+
+
+
+
+const char * cTickProfiler::GetPhaseName(ePhase a_Phase)
+{
+	switch (a_Phase)
+	{
+		case phPlugins:      return "Plugins";
+		case phSetChunkData: return "SetChunkData";
+		case phTimeOfDay:    return "TimeOfDay";
+		case phAddEntities:  return "AddEntities";
+		case phChunks:       return "Chunks";
+		case phMobs:         return "Mobs";
+		case phMaps:         return "Maps";
+		case phClients:      return "Clients";
+		case phQueuedBlocks: return "QueuedBlocks";
+		case phQueuedTasks:  return "QueuedTasks";
+		case phSimulators:   return "Simulators";
+		case phWeather:      return "Weather";
+		case phUnloadSave:   return "UnloadSave";
+		case phCount:        break;
+	}
+	ASSERT(!"Unknown tick phase");
+	return "Unknown";
+}
+
+
+
+
+
+UInt32 cTickProfiler::ToUSec(std::chrono::steady_clock::duration a_Duration)
+{
+	return static_cast<UInt32>(std::chrono::duration_cast<std::chrono::microseconds>(a_Duration).count());
+}
+
+
+
+
+
+std::vector<cTickProfiler::sTick> cTickProfiler::GetTicks(void) const
+{
+	cCSLock Lock(m_CS);
+	if (m_Ticks.size() < NUM_TICKS)
+	{
+		return m_Ticks;
+	}
+
+	// The buffer is full, the oldest tick is at m_NextTick:
+	std::vector<sTick> Res;
+	Res.reserve(m_Ticks.size());
+	Res.insert(Res.end(), m_Ticks.begin() + static_cast<ptrdiff_t>(m_NextTick), m_Ticks.end());
+	Res.insert(Res.end(), m_Ticks.begin(), m_Ticks.begin() + static_cast<ptrdiff_t>(m_NextTick));
+	return Res;
+}
+
+
+
+
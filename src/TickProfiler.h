@@ -0,0 +1,166 @@
+
+// TickProfiler.h
+
+// Declares the cTickProfiler class that records the durations of the individual phases of a world's ticks
+
+
+
+
+
+#pragma once
+
+
+
+
+
+/** Records how long each phase of cWorld::Tick() took, for the last NUM_TICKS ticks, together with the chunks
+whose ticking took unusually long. The data can be summarized as a human-readable table, or exported as a
+trace in the Chrome trace event format (chrome://tracing, Perfetto) to be inspected on a timeline.
+
+The recording functions (BeginTick(), EndPhase(), ChunkTicked(), EndTick()) may only be called from the world's
+tick thread. The remaining functions can be called from any thread.
+While disabled, the recording functions return immediately without reading the clock. */
+class cTickProfiler
+{
+public:
+
+	/** The phases of cWorld::Tick(), in the order in which they are executed. */
+	enum ePhase
+	{
+		phPlugins,
+		phSetChunkData,
+		phTimeOfDay,
+		phAddEntities,
+		phChunks,
+		phMobs,
+		phMaps,
+		phClients,
+		phQueuedBlocks,
+		phQueuedTasks,
+		phSimulators,
+		phWeather,
+		phUnloadSave,
+
+		phCount
+	};
+
+	/** Number of the most recent ticks that are kept; one minute at 20 TPS. */
+	static constexpr size_t NUM_TICKS = 1200;
+
+	/** Maximum number of slow chunks remembered per tick, the slowest ones are kept. */
+	static constexpr size_t MAX_CHUNK_OUTLIERS = 4;
+
+	/** A chunk whose ticking takes at least this long is considered an outlier. */
+	static constexpr int CHUNK_OUTLIER_THRESHOLD_USEC = 1000;
+
+
+	cTickProfiler(void);
+
+	/** Enables or disables the profiler. Enabling discards the ticks recorded so far. */
+	void SetEnabled(bool a_Enabled);
+
+	/** Returns true if the ticks are being recorded. */
+	bool IsEnabled(void) const { return m_IsEnabled.load(std::memory_order_relaxed); }
+
+	/** Returns true if the tick currently being executed is being recorded.
+	Tick thread only; used by the callers to skip measuring when there's nothing to record. */
+	bool IsRecordingTick(void) const { return m_IsRecordingTick; }
+
+	/** Starts recording a new tick, if the profiler is enabled. */
+	void BeginTick(void);
+
+	/** Marks the end of the specified phase. The phase's duration is the time elapsed since the previous
+	EndPhase() or BeginTick() call. */
+	void EndPhase(ePhase a_Phase);
+
+	/** Reports that ticking the specified chunk took the time between the two time points.
+	The chunk is remembered only if it is among the slowest in this tick and above the outlier threshold. */
+	void ChunkTicked(int a_ChunkX, int a_ChunkZ, std::chrono::steady_clock::time_point a_Start, std::chrono::steady_clock::time_point a_End);
+
+	/** Finishes recording the current tick and stores it in the ring buffer. */
+	void EndTick(void);
+
+	/** Returns a human-readable summary of the recorded ticks: per-phase average and maximum, the slowest ticks
+	and the slowest chunks. */
+	AString GetStats(void) const;
+
+	/** Returns the recorded ticks as a JSON document in the Chrome trace event format.
+	a_ThreadName is shown as the name of the timeline row, typically the world name. */
+	AString GetChromeTrace(const AString & a_ThreadName) const;
+
+	/** Returns the human-readable name of the phase. */
+	static const char * GetPhaseName(ePhase a_Phase);
+
+protected:
+
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	/** A chunk whose tick took long. */
+	struct sChunkOutlier
+	{
+		int m_ChunkX;
+		int m_ChunkZ;
+
+		/** Start of the chunk's tick, in microseconds relative to the start of the world tick. */
+		UInt32 m_Start;
+
+		/** Duration of the chunk's tick, in microseconds. */
+		UInt32 m_Duration;
+	};
+
+	/** A single recorded tick. All times are in microseconds. */
+	struct sTick
+	{
+		/** Start of the tick, relative to m_Epoch. */
+		UInt64 m_Start;
+
+		/** Total duration of the tick. */
+		UInt32 m_Duration;
+
+		/** Durations of the individual phases, indexed by ePhase. */
+		std::array<UInt32, phCount> m_PhaseDurations;
+
+		/** The slowest chunks in the tick, sorted by their duration, slowest first. */
+		std::array<sChunkOutlier, MAX_CHUNK_OUTLIERS> m_ChunkOutliers;
+		size_t m_NumChunkOutliers;
+	};
+
+
+	/** Set while the profiler is enabled. Atomic so that the tick thread can check it without locking. */
+	std::atomic<bool> m_IsEnabled;
+
+	/** Set between BeginTick() and EndTick() of a tick that is being recorded. Tick thread only. */
+	bool m_IsRecordingTick;
+
+	/** The tick currently being recorded. Tick thread only. */
+	sTick m_CurrentTick;
+
+	/** Time when the current tick started. Tick thread only. */
+	TimePoint m_TickStart;
+
+	/** Time when the last phase of the current tick ended. Tick thread only. */
+	TimePoint m_LastPhaseEnd;
+
+	/** Time point to which the tick starts are relative; the time of the profiler's creation. */
+	const TimePoint m_Epoch;
+
+	/** Protects m_Ticks and m_NextTick against multithreaded access. */
+	mutable cCriticalSection m_CS;
+
+	/** The ring buffer of the recorded ticks. Has up to NUM_TICKS items, m_NextTick points to the oldest one once full. */
+	std::vector<sTick> m_Ticks;
+
+	/** Index into m_Ticks where the next tick will be stored. */
+	size_t m_NextTick;
+
+
+	/** Converts the duration to microseconds. */
+	static UInt32 ToUSec(std::chrono::steady_clock::duration a_Duration);
+
+	/** Returns a copy of the recorded ticks, oldest first. */
+	std::vector<sTick> GetTicks(void) const;
+};
+
+
+
+
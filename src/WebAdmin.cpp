@@ -7,6 +7,7 @@
 #include "Entities/Player.h"
 #include "Server.h"
 #include "Root.h"
+#include "Metrics.h"
 
 #include "HTTP/HTTPServerConnection.h"
 #include "HTTP/HTTPFormParser.h"
@@ -61,7 +62,8 @@ public:
 cWebAdmin::cWebAdmin(void) :
 	m_TemplateScript("<webadmin_template>"),
 	m_IsInitialized(false),
-	m_IsRunning(false)
+	m_IsRunning(false),
+	m_MetricsRequireAuth(true)
 {
 }
 
@@ -94,6 +96,9 @@ bool cWebAdmin::Init(void)
 	// Note that historically the ports were stored in the "Port" and "PortsIPv6" values
 	m_Ports = ReadUpgradeIniPorts(m_IniFile, "WebAdmin", "Ports", "Port", "PortsIPv6", DEFAULT_WEBADMIN_PORTS);
 
+	// Allow the metrics to be scraped without a login, for monitoring systems that can't authenticate:
+	m_MetricsRequireAuth = m_IniFile.GetValueSetB("WebAdmin", "MetricsRequireAuth", true);
+
 	if (!m_HTTPServer.Initialize())
 	{
 		return false;
@@ -248,23 +253,33 @@ bool cWebAdmin::LoadIniFile(void)
 
 
 
-void cWebAdmin::HandleWebadminRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request)
+bool cWebAdmin::CheckAuth(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request)
 {
 	if (!a_Request.HasAuth())
 	{
 		a_Connection.SendNeedAuth("Cuberite WebAdmin");
-		return;
+		return false;
 	}
 
-	// Check auth:
+	cCSLock Lock(m_CS);
+	AString UserPassword = m_IniFile.GetValue("User:" + a_Request.GetAuthUsername(), "Password", "");
+	if ((UserPassword == "") || (a_Request.GetAuthPassword() != UserPassword))
 	{
-		cCSLock Lock(m_CS);
-		AString UserPassword = m_IniFile.GetValue("User:" + a_Request.GetAuthUsername(), "Password", "");
-		if ((UserPassword == "") || (a_Request.GetAuthPassword() != UserPassword))
-		{
-			a_Connection.SendNeedAuth("Cuberite WebAdmin - bad username or password");
-			return;
-		}
+		a_Connection.SendNeedAuth("Cuberite WebAdmin - bad username or password");
+		return false;
+	}
+	return true;
+}
+
+
+
+
+
+void cWebAdmin::HandleWebadminRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request)
+{
+	if (!CheckAuth(a_Connection, a_Request))
+	{
+		return;
 	}
 
 	// Check if the contents should be wrapped in the template:
@@ -360,6 +375,24 @@ void cWebAdmin::HandleRootRequest(cHTTPServerConnection & a_Connection, cHTTPInc
 
 
 
+void cWebAdmin::HandleMetricsRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request)
+{
+	if (m_MetricsRequireAuth && !CheckAuth(a_Connection, a_Request))
+	{
+		return;
+	}
+
+	cHTTPOutgoingResponse Resp;
+	Resp.SetContentType("text/plain; version=0.0.4");
+	a_Connection.Send(Resp);
+	a_Connection.Send(cMetrics::Get().GetPrometheusText());
+	a_Connection.FinishResponse();
+}
+
+
+
+
+
 void cWebAdmin::HandleFileRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request)
 {
 	AString FileURL = a_Request.GetURL();
@@ -375,36 +408,62 @@ void cWebAdmin::HandleFileRequest(cHTTPServerConnection & a_Connection, cHTTPInc
 		}
 	}
 
-	// Read the file contents and guess its mime-type, based on the extension:
-	AString Content = "<h2>404 Not Found</h2>";
-	AString ContentType = "text/html";
+	// Guess the mime-type, based on the extension:
 	AString Path = Printf("webadmin/files/%s", FileURL.c_str());
+	AString ContentType;
+	size_t LastPointPosition = Path.find_last_of('.');
+	if (LastPointPosition != AString::npos)
+	{
+		ContentType = GetContentTypeFromFileExt(Path.substr(LastPointPosition + 1));
+	}
 
+	// Get the file contents, from the cache if possible. Only the text files are worth compressing.
 	// Return 404 if the file is not found, or the URL contains '../' (for security reasons)
-	if ((FileURL.find("../") == AString::npos) && cFile::IsFile(Path))
+	cHTTPFileCache::sFilePtr File;
+	if (FileURL.find("../") == AString::npos)
 	{
-		cFile File(Path, cFile::fmRead);
-		AString FileContent;
-		if (File.IsOpen() && (File.ReadRestOfFile(FileContent) != -1))
-		{
-			std::swap(Content, FileContent);
-			size_t LastPointPosition = Path.find_last_of('.');
-			if (LastPointPosition != AString::npos)
-			{
-				ContentType = GetContentTypeFromFileExt(Path.substr(LastPointPosition + 1));
-			}
-		}
-		if (ContentType.empty())
-		{
-			ContentType = "application/unknown";
-		}
+		bool IsText = ((ContentType.compare(0, 5, "text/") == 0) || (ContentType == "application/xhtml+xml"));
+		File = m_FileCache.GetFile(Path, IsText);
+	}
+	if (File == nullptr)
+	{
+		cHTTPOutgoingResponse Resp;
+		Resp.SetContentType("text/html");
+		a_Connection.Send(Resp);
+		a_Connection.Send("<h2>404 Not Found</h2>");
+		a_Connection.FinishResponse();
+		return;
+	}
+	if (ContentType.empty())
+	{
+		ContentType = "application/unknown";
 	}
 
-	// Send the response:
+	// Each representation has its own validator; the browser revalidates on each use and gets a 304 if the file is unchanged:
+	bool ShouldSendGzip = (!File->m_GzipContents.empty() && cHTTPFileCache::DoesAcceptGzip(a_Request));
+	const AString & ETag = ShouldSendGzip ? File->m_GzipETag : File->m_ETag;
 	cHTTPOutgoingResponse Resp;
 	Resp.SetContentType(ContentType);
+	Resp.AddHeader("ETag", ETag);
+	Resp.AddHeader("Last-Modified", File->m_LastModified);
+	Resp.AddHeader("Cache-Control", "no-cache");
+	if (!File->m_GzipContents.empty())
+	{
+		Resp.AddHeader("Vary", "Accept-Encoding");
+	}
+	if (cHTTPFileCache::IsNotModified(a_Request, ETag, File->m_LastModified))
+	{
+		a_Connection.SendNotModified(Resp);
+		return;
+	}
+
+	// Send the response:
+	if (ShouldSendGzip)
+	{
+		Resp.AddHeader("Content-Encoding", "gzip");
+	}
 	a_Connection.Send(Resp);
-	a_Connection.Send(Content);
+	a_Connection.Send(ShouldSendGzip ? File->m_GzipContents : File->m_Contents);
 	a_Connection.FinishResponse();
 }
 
@@ -616,9 +675,9 @@ void cWebAdmin::OnRequestBegun(cHTTPServerConnection & a_Connection, cHTTPIncomi
 		a_Request.SetUserData(std::make_shared<cWebadminRequestData>(a_Request));
 		return;
 	}
-	if (URL == "/")
+	if ((URL == "/") || (URL == "/metrics"))
 	{
-		// The root needs no body handler and is fully handled in the OnRequestFinished() call
+		// The root and the metrics need no body handler and are fully handled in the OnRequestFinished() call
 		return;
 	}
 	// TODO: Handle other requests
@@ -645,23 +704,41 @@ void cWebAdmin::OnRequestBody(cHTTPServerConnection & a_Connection, cHTTPIncomin
 
 void cWebAdmin::OnRequestFinished(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request)
 {
+	auto StartTime = std::chrono::steady_clock::now();
+	const char * Handler;
 	const AString & URL = a_Request.GetURL();
 	if (
 		(strncmp(URL.c_str(), "/webadmin", 9) == 0) ||
 		(strncmp(URL.c_str(), "/~webadmin", 10) == 0)
 	)
 	{
+		Handler = "page";
 		HandleWebadminRequest(a_Connection, a_Request);
 	}
 	else if (URL == "/")
 	{
 		// The root needs no body handler and is fully handled in the OnRequestFinished() call
+		Handler = "root";
 		HandleRootRequest(a_Connection, a_Request);
 	}
+	else if (URL == "/metrics")
+	{
+		Handler = "metrics";
+		HandleMetricsRequest(a_Connection, a_Request);
+	}
 	else
 	{
+		Handler = "file";
 		HandleFileRequest(a_Connection, a_Request);
 	}
+
+	// Record how long it took to produce and send the response:
+	auto Duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - StartTime).count();
+	cMetrics::Get().GetHistogram(
+		"cuberite_webadmin_response_duration_seconds", "Time taken to produce and send the webadmin responses, in seconds.",
+		{0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5},
+		cMetrics::Label("handler", Handler)
+	).Observe(Duration);
 }
 
 
@@ -9,6 +9,7 @@
 #include "IniFile.h"
 #include "HTTP/HTTPServer.h"
 #include "HTTP/HTTPMessage.h"
+#include "HTTP/HTTPFileCache.h"
 
 
 
@@ -248,24 +249,38 @@ protected:
 	/** Set to true if Start() succeeds in starting the server, reset back to false in Stop(). */
 	bool m_IsRunning;
 
+	/** If true, the "/metrics" page requires the same login as the webadmin pages.
+	Read from webadmin.ini in Init(). */
+	bool m_MetricsRequireAuth;
+
 	/** The ports on which the webadmin is running. */
 	AStringVector m_Ports;
 
 	/** The HTTP server which provides the underlying HTTP parsing, serialization and events */
 	cHTTPServer m_HTTPServer;
 
+	/** The files from webadmin/files, kept in memory between the requests. */
+	cHTTPFileCache m_FileCache;
+
 
 	/** Loads webadmin.ini into m_IniFile.
 	Creates a default file if it doesn't exist.
 	Returns true if webadmin is enabled, false if disabled. */
 	bool LoadIniFile(void);
 
+	/** Checks the login sent with the request against the users in webadmin.ini.
+	Returns true if the login is valid; otherwise sends the authentication request to the client and returns false. */
+	bool CheckAuth(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request);
+
 	/** Handles requests coming to the "/webadmin" or "/~webadmin" URLs */
 	void HandleWebadminRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request);
 
 	/** Handles requests for the root page */
 	void HandleRootRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request);
 
+	/** Handles requests for the "/metrics" page, sends all of cMetrics in the Prometheus text format */
+	void HandleMetricsRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request);
+
 	/** Handles requests for a file */
 	void HandleFileRequest(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request);
 
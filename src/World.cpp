@@ -12,6 +12,7 @@
 #include "SetChunkData.h"
 #include "DeadlockDetect.h"
 #include "LineBlockTracer.h"
+#include "Metrics.h"
 #include "UUID.h"
 #include "BlockInServerPluginInterface.h"
 
@@ -42,7 +43,6 @@
 
 // Mobs:
 #include "Mobs/IncludeAllMonsters.h"
-#include "MobCensus.h"
 #include "MobSpawner.h"
 
 #include "Generating/Trees.h"
@@ -121,7 +121,9 @@ void cWorld::cTickThread::Execute(void)
 		auto NowTime = std::chrono::steady_clock::now();
 		auto WaitTime = std::chrono::duration_cast<std::chrono::milliseconds>(NowTime - LastTime);
 		m_World.Tick(WaitTime, TickTime);
-		TickTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - NowTime);
+		auto TickDuration = std::chrono::steady_clock::now() - NowTime;
+		TickTime = std::chrono::duration_cast<std::chrono::milliseconds>(TickDuration);
+		m_World.m_TickDurationMetric.Observe(std::chrono::duration_cast<std::chrono::duration<double>>(TickDuration).count());
 
 		if (TickTime < cTickTime(1))
 		{
@@ -216,6 +218,12 @@ cWorld::cWorld(
 	m_MaxViewDistance(12),
 	m_Scoreboard(this),
 	m_MapManager(this),
+	m_TickDurationMetric(cMetrics::Get().GetHistogram(
+		"cuberite_world_tick_duration_seconds", "Duration of the world ticks, in seconds.",
+		{0.005, 0.01, 0.025, 0.05, 0.075, 0.1, 0.25, 0.5, 1},
+		cMetrics::Label("world", a_WorldName)
+	)),
+	m_LastMetricsUpdate(0),
 	m_GeneratorCallbacks(*this),
 	m_ChunkSender(*this),
 	m_Lighting(*this),
@@ -431,7 +439,7 @@ cWorld::cWorld(
 	m_SimulatorManager->RegisterSimulator(m_FireSimulator.get(), 1);
 
 	m_Storage.Initialize(*this, m_StorageSchema, m_StorageCompressionFactor);
-	m_Generator.Initialize(m_GeneratorCallbacks, m_GeneratorCallbacks, IniFile);
+	m_Generator.Initialize(m_GeneratorCallbacks, m_GeneratorCallbacks, IniFile, m_WorldName);
 
 	m_MapManager.LoadMapData();
 
@@ -635,11 +643,13 @@ void cWorld::InitializeSpawn(void)
 		const int DefaultViewDist = 20;  // Always prepare an area 20 chunks across, no matter what the actual cClientHandle::VIEWDISTANCE is
 	#endif  // _DEBUG
 
+	auto StartTime = std::chrono::steady_clock::now();
 	if (!m_IsSpawnExplicitlySet)
 	{
 		// Spawn position wasn't already explicitly set, enumerate random solid-land coordinate and then write it to the world configuration:
 		GenerateRandomSpawn(DefaultViewDist);
 	}
+	auto SpawnFoundTime = std::chrono::steady_clock::now();
 
 	cIniFile IniFile;
 	IniFile.ReadFile(m_IniFileName);
@@ -648,7 +658,31 @@ void cWorld::InitializeSpawn(void)
 
 	int ChunkX = 0, ChunkZ = 0;
 	cChunkDef::BlockToChunk(FloorC(m_SpawnX), FloorC(m_SpawnZ), ChunkX, ChunkZ);
+	UInt64 NumLoaded = m_Storage.GetNumChunksLoaded(), LoadingUs = m_Storage.GetLoadingMicroseconds();
+	UInt64 NumGenerated = m_Generator.GetNumChunksGenerated(), GeneratingUs = m_Generator.GetGeneratingMicroseconds();
+	UInt64 NumLit = m_Lighting.GetNumChunksLit(), LightingUs = m_Lighting.GetLightingMicroseconds();
 	cSpawnPrepare::PrepareChunks(*this, ChunkX, ChunkZ, ViewDist);
+
+	// Report the startup timeline, worlds are prepared in parallel so the total alone doesn't tell which one is slow.
+	// The storage, generator and lighting threads work at the same time, so their busy times overlap within the preparation time:
+	using cSeconds = std::chrono::duration<double>;
+	auto Now = std::chrono::steady_clock::now();
+	LOG("Spawn prepared (%s) in %.02f seconds: finding the spawn point took %.02f seconds, preparing %d chunks took %.02f seconds",
+		m_WorldName.c_str(),
+		std::chrono::duration_cast<cSeconds>(Now - StartTime).count(),
+		std::chrono::duration_cast<cSeconds>(SpawnFoundTime - StartTime).count(),
+		ViewDist * ViewDist,
+		std::chrono::duration_cast<cSeconds>(Now - SpawnFoundTime).count()
+	);
+	LOG("Spawn preparation (%s): loaded %llu chunks in %.02f seconds, generated %llu chunks in %.02f seconds, lit %llu chunks in %.02f seconds",
+		m_WorldName.c_str(),
+		static_cast<unsigned long long>(m_Storage.GetNumChunksLoaded() - NumLoaded),
+		static_cast<double>(m_Storage.GetLoadingMicroseconds() - LoadingUs) / 1e6,
+		static_cast<unsigned long long>(m_Generator.GetNumChunksGenerated() - NumGenerated),
+		static_cast<double>(m_Generator.GetGeneratingMicroseconds() - GeneratingUs) / 1e6,
+		static_cast<unsigned long long>(m_Lighting.GetNumChunksLit() - NumLit),
+		static_cast<double>(m_Lighting.GetLightingMicroseconds() - LightingUs) / 1e6
+	);
 }
 
 
@@ -658,6 +692,7 @@ void cWorld::InitializeSpawn(void)
 void cWorld::Start()
 {
 	m_Lighting.Start();
+	m_PathCalculator.Start();
 	m_Storage.Start();
 	m_Generator.Start();
 	m_ChunkSender.Start();
@@ -961,6 +996,7 @@ void cWorld::Stop(cDeadlockDetect & a_DeadlockDetect)
 	IniFile.WriteFile(m_IniFileName);
 
 	m_TickThread.Stop();
+	m_PathCalculator.Stop();
 	m_Lighting.Stop();
 	m_Generator.Stop();
 	m_ChunkSender.Stop();
@@ -977,8 +1013,11 @@ void cWorld::Stop(cDeadlockDetect & a_DeadlockDetect)
 
 void cWorld::Tick(std::chrono::milliseconds a_Dt, std::chrono::milliseconds a_LastTickDurationMSec)
 {
+	m_TickProfiler.BeginTick();
+
 	// Call the plugins
 	cPluginManager::Get()->CallHookWorldTick(*this, a_Dt, a_LastTickDurationMSec);
+	m_TickProfiler.EndPhase(cTickProfiler::phPlugins);
 
 	// Set any chunk data that has been queued for setting:
 	cSetChunkDataPtrs SetChunkDataQueue;
@@ -990,6 +1029,7 @@ void cWorld::Tick(std::chrono::milliseconds a_Dt, std::chrono::milliseconds a_La
 	{
 		SetChunkData(**itr);
 	}  // for itr - SetChunkDataQueue[]
+	m_TickProfiler.EndPhase(cTickProfiler::phSetChunkData);
 
 	m_WorldAge += a_Dt;
 
@@ -1014,6 +1054,7 @@ void cWorld::Tick(std::chrono::milliseconds a_Dt, std::chrono::milliseconds a_La
 			m_LastTimeUpdate = std::chrono::duration_cast<cTickTimeLong>(m_WorldAge);
 		}
 	}
+	m_TickProfiler.EndPhase(cTickProfiler::phTimeOfDay);
 
 	// Add entities waiting in the queue to be added:
 	cEntityList EntitiesToAdd;
@@ -1036,18 +1077,27 @@ void cWorld::Tick(std::chrono::milliseconds a_Dt, std::chrono::milliseconds a_La
 
 	// Add players waiting in the queue to be added:
 	AddQueuedPlayers();
+	m_TickProfiler.EndPhase(cTickProfiler::phAddEntities);
 
 	m_ChunkMap->Tick(a_Dt);
+	m_TickProfiler.EndPhase(cTickProfiler::phChunks);
 	TickMobs(a_Dt);
+	m_TickProfiler.EndPhase(cTickProfiler::phMobs);
 	m_MapManager.TickMaps();
+	m_TickProfiler.EndPhase(cTickProfiler::phMaps);
 
 	TickClients(static_cast<float>(a_Dt.count()));
+	m_TickProfiler.EndPhase(cTickProfiler::phClients);
 	TickQueuedBlocks();
+	m_TickProfiler.EndPhase(cTickProfiler::phQueuedBlocks);
 	TickQueuedTasks();
+	m_TickProfiler.EndPhase(cTickProfiler::phQueuedTasks);
 
 	GetSimulatorManager()->Simulate(static_cast<float>(a_Dt.count()));
+	m_TickProfiler.EndPhase(cTickProfiler::phSimulators);
 
 	TickWeather(static_cast<float>(a_Dt.count()));
+	m_TickProfiler.EndPhase(cTickProfiler::phWeather);
 
 	if (m_WorldAge - m_LastChunkCheck > std::chrono::seconds(10))
 	{
@@ -1065,6 +1115,30 @@ void cWorld::Tick(std::chrono::milliseconds a_Dt, std::chrono::milliseconds a_La
 			SaveAllChunks();
 		}
 	}
+	m_TickProfiler.EndPhase(cTickProfiler::phUnloadSave);
+	m_TickProfiler.EndTick();
+
+	if (m_WorldAge - m_LastMetricsUpdate >= std::chrono::seconds(1))
+	{
+		UpdateMetrics();
+		m_LastMetricsUpdate = std::chrono::duration_cast<std::chrono::milliseconds>(m_WorldAge);
+	}
+}
+
+
+
+
+
+bool cWorld::ExportTickTrace(const AString & a_FileName) const
+{
+	cFile f;
+	if (!f.Open(a_FileName, cFile::fmWrite))
+	{
+		LOGWARNING("Cannot open file \"%s\" for writing the tick trace of world \"%s\".", a_FileName, m_WorldName);
+		return false;
+	}
+	auto Trace = m_TickProfiler.GetChromeTrace(m_WorldName);
+	return (f.Write(Trace) == static_cast<int>(Trace.size()));
 }
 
 
@@ -1110,9 +1184,7 @@ void cWorld::TickMobs(std::chrono::milliseconds a_Dt)
 	// _X 2013_10_22: This is a quick fix for #283 - the world needs to be locked while ticking mobs
 	cWorld::cLock Lock(*this);
 
-	// before every Mob action, we have to count them depending on the distance to players, on their family ...
-	cMobCensus MobCensus;
-	m_ChunkMap->CollectMobCensus(MobCensus);
+	// The mob census is kept up to date by the chunks as mobs and clients come and go, no need to recount here
 	if (m_bAnimals)
 	{
 		// Spawning is enabled, spawn now:
@@ -1129,7 +1201,7 @@ void cWorld::TickMobs(std::chrono::milliseconds a_Dt)
 			cTickTime SpawnDelay = cTickTime(cMonster::GetSpawnDelay(Family));
 			if (
 				(m_LastSpawnMonster[Family] > m_WorldAge - SpawnDelay) ||  // Not reached the needed ticks before the next round
-				MobCensus.IsCapped(Family)
+				m_MobCensus.IsCapped(Family)
 			)
 			{
 				continue;
@@ -3176,6 +3248,33 @@ void cWorld::GetChunkStats(int & a_NumValid, int & a_NumDirty, int & a_NumInLigh
 
 
 
+void cWorld::UpdateMetrics(void)
+{
+	int NumValid, NumDirty;
+	m_ChunkMap->GetChunkStats(NumValid, NumDirty);
+	size_t NumPlayers;
+	{
+		cLock Lock(*this);
+		NumPlayers = m_Players.size();
+	}
+
+	auto & Metrics = cMetrics::Get();
+	auto Labels = cMetrics::Label("world", m_WorldName);
+	Metrics.GetGauge("cuberite_world_chunks_loaded", "Number of valid chunks loaded in the world.", Labels).Set(NumValid);
+	Metrics.GetGauge("cuberite_world_chunks_dirty", "Number of loaded chunks that need saving.", Labels).Set(NumDirty);
+	Metrics.GetGauge("cuberite_world_players", "Number of players in the world.", Labels).Set(static_cast<Int64>(NumPlayers));
+	Metrics.GetGauge("cuberite_world_generator_queue_length", "Number of chunks waiting to be generated.", Labels).Set(m_Generator.GetQueueLength());
+	Metrics.GetGauge("cuberite_world_lighting_queue_length", "Number of chunks waiting to be lit.", Labels).Set(static_cast<Int64>(m_Lighting.GetQueueLength()));
+	Metrics.GetGauge("cuberite_world_storage_load_queue_length", "Number of chunks waiting to be loaded from disk.", Labels).Set(static_cast<Int64>(m_Storage.GetLoadQueueLength()));
+	Metrics.GetGauge("cuberite_world_storage_save_queue_length", "Number of chunks waiting to be saved to disk.", Labels).Set(static_cast<Int64>(m_Storage.GetSaveQueueLength()));
+	Metrics.GetGauge("cuberite_world_chunk_send_queue_length", "Number of chunks waiting to be sent to the clients.", Labels).Set(static_cast<Int64>(m_ChunkSender.GetQueueLength()));
+	Metrics.GetGauge("cuberite_world_path_queue_length", "Number of mob paths waiting to be calculated.", Labels).Set(static_cast<Int64>(m_PathCalculator.GetQueueLength()));
+}
+
+
+
+
+
 void cWorld::TickQueuedBlocks(void)
 {
 	if (m_BlockTickQueue.empty())
@@ -15,11 +15,14 @@
 #include "IniFile.h"
 #include "Item.h"
 #include "Mobs/Monster.h"
+#include "Mobs/PathCalculatorThread.h"
 #include "Entities/ProjectileEntity.h"
 #include "Entities/Boat.h"
 #include "ForEachChunkProvider.h"
 #include "Scoreboard.h"
 #include "MapManager.h"
+#include "MobCensus.h"
+#include "TickProfiler.h"
 #include "Blocks/WorldInterface.h"
 #include "Blocks/BroadcastInterface.h"
 #include "EffectID.h"
@@ -51,6 +54,7 @@ class cMobHeadEntity;
 class cCompositeChat;
 class cSetChunkData;
 class cDeadlockDetect;
+class cMetricHistogram;
 class cUUID;
 
 typedef std::list< cPlayer * > cPlayerList;
@@ -942,8 +946,28 @@ public:
 	virtual void SetMinNetherPortalHeight(int a_NewMinHeight) override { m_MinNetherPortalHeight = a_NewMinHeight; }
 	virtual void SetMaxNetherPortalHeight(int a_NewMaxHeight) override { m_MaxNetherPortalHeight = a_NewMaxHeight; }
 
+	/** Enables or disables recording the durations of the individual phases of this world's ticks.
+	Enabling discards the ticks recorded so far. */
+	void SetTickProfilerEnabled(bool a_Enabled) { m_TickProfiler.SetEnabled(a_Enabled); }
+
+	/** Returns true if the durations of this world's tick phases are being recorded. */
+	bool IsTickProfilerEnabled(void) const { return m_TickProfiler.IsEnabled(); }
+
+	/** Returns a human-readable summary of the recorded ticks: per-phase timings, the slowest ticks and the slowest chunks. */
+	AString GetTickProfilerStats(void) const { return m_TickProfiler.GetStats(); }
+
+	/** Writes the recorded ticks into the specified file, in the Chrome trace event format.
+	Returns true on success, false if the file cannot be written. */
+	bool ExportTickTrace(const AString & a_FileName) const;
+
 	// tolua_end
 
+	/** Returns the mob census, kept up to date by the chunks. Protected by the chunkmap CS. */
+	cMobCensus & GetMobCensus(void) { return m_MobCensus; }
+
+	/** Returns the profiler recording the durations of this world's tick phases. */
+	cTickProfiler & GetTickProfiler(void) { return m_TickProfiler; }
+
 	/** Saves all chunks immediately. Dangerous interface, may deadlock, use QueueSaveAllChunks() instead */
 	void SaveAllChunks(void);
 
@@ -973,6 +997,8 @@ public:
 
 	cLightingThread & GetLightingThread(void) { return m_Lighting; }
 
+	cPathCalculatorThread & GetPathCalculator(void) { return m_PathCalculator; }
+
 	void InitializeSpawn(void);
 
 	/** Starts threads that belong to this world. */
@@ -1226,6 +1252,10 @@ private:
 
 	unsigned int m_MaxPlayers;
 
+	/** The counts of mobs in chunks eligible for spawning, maintained by the chunks themselves.
+	Must be declared before m_ChunkMap so that it outlives all the chunks. */
+	cMobCensus m_MobCensus;
+
 	std::unique_ptr<cChunkMap> m_ChunkMap;
 
 	bool m_bAnimals;
@@ -1284,11 +1314,21 @@ private:
 	cScoreboard      m_Scoreboard;
 	cMapManager      m_MapManager;
 
+	/** Records the durations of the individual phases of the ticks, while enabled. */
+	cTickProfiler    m_TickProfiler;
+
+	/** The distribution of the tick durations, exported through cMetrics. Observed by the tick thread. */
+	cMetricHistogram & m_TickDurationMetric;
+
+	/** The world age at which the world's gauges in cMetrics were last updated. */
+	std::chrono::milliseconds m_LastMetricsUpdate;
+
 	/** The callbacks that the ChunkGenerator uses to store new chunks and interface to plugins */
 	cChunkGeneratorCallbacks m_GeneratorCallbacks;
 
 	cChunkSender     m_ChunkSender;
 	cLightingThread  m_Lighting;
+	cPathCalculatorThread m_PathCalculator;
 	cTickThread      m_TickThread;
 
 	/** Guards the m_Tasks */
@@ -1355,6 +1395,10 @@ private:
 	/** Unloads all chunks immediately. */
 	void UnloadUnusedChunks(void);
 
+	/** Updates the world's gauges in cMetrics: chunk counts and queue lengths.
+	Called from the tick thread once per second, because counting the dirty chunks walks the whole chunkmap. */
+	void UpdateMetrics(void);
+
 	void UpdateSkyDarkness(void);
 
 	/** Generates a random spawnpoint on solid land by walking chunks and finding their biomes */
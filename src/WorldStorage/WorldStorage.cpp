@@ -12,6 +12,7 @@
 #include "../Generating/ChunkGenerator.h"
 #include "../Entities/Entity.h"
 #include "../BlockEntities/BlockEntity.h"
+#include "../Metrics.h"
 
 
 
@@ -40,6 +41,8 @@ protected:
 cWorldStorage::cWorldStorage(void) :
 	Super("cWorldStorage"),
 	m_World(nullptr),
+	m_ChunksLoadedMetric(nullptr),
+	m_LoadingMicrosecondsMetric(nullptr),
 	m_SaveSchema(nullptr)
 {
 }
@@ -64,6 +67,14 @@ void cWorldStorage::Initialize(cWorld & a_World, const AString & a_StorageSchema
 {
 	m_World = &a_World;
 	m_StorageSchemaName = a_StorageSchemaName;
+	m_ChunksLoadedMetric = &cMetrics::Get().GetCounter(
+		"cuberite_chunks_loaded_total", "Number of chunks loaded from the disk.",
+		cMetrics::Label("world", a_World.GetName())
+	);
+	m_LoadingMicrosecondsMetric = &cMetrics::Get().GetCounter(
+		"cuberite_chunk_loading_microseconds_total", "Time the storage thread spent loading the chunks, including those not found on the disk, in microseconds.",
+		cMetrics::Label("world", a_World.GetName())
+	);
 	InitSchemas(a_StorageCompressionFactor);
 }
 
@@ -138,6 +149,24 @@ size_t cWorldStorage::GetSaveQueueLength(void)
 
 
 
+UInt64 cWorldStorage::GetNumChunksLoaded(void) const
+{
+	return (m_ChunksLoadedMetric == nullptr) ? 0 : m_ChunksLoadedMetric->GetValue();
+}
+
+
+
+
+
+UInt64 cWorldStorage::GetLoadingMicroseconds(void) const
+{
+	return (m_LoadingMicrosecondsMetric == nullptr) ? 0 : m_LoadingMicrosecondsMetric->GetValue();
+}
+
+
+
+
+
 void cWorldStorage::QueueLoadChunk(int a_ChunkX, int a_ChunkZ, cChunkCoordCallback * a_Callback)
 {
 	ASSERT((a_ChunkX > -0x08000000) && (a_ChunkX < 0x08000000));
@@ -154,7 +183,15 @@ void cWorldStorage::QueueLoadChunk(int a_ChunkX, int a_ChunkZ, cChunkCoordCallba
 
 void cWorldStorage::QueueSaveChunk(int a_ChunkX, int a_ChunkZ, cChunkCoordCallback * a_Callback)
 {
-	ASSERT(m_World->IsChunkValid(a_ChunkX, a_ChunkZ));
+	// The chunk may have been unloaded since the caller checked it, report it as not saved:
+	if (!m_World->IsChunkValid(a_ChunkX, a_ChunkZ))
+	{
+		if (a_Callback != nullptr)
+		{
+			a_Callback->Call({a_ChunkX, a_ChunkZ}, false);
+		}
+		return;
+	}
 
 	m_SaveQueue.EnqueueItem(cChunkCoordsWithCallback(a_ChunkX, a_ChunkZ, a_Callback));
 	m_Event.Set();
@@ -235,7 +272,13 @@ bool cWorldStorage::LoadOneChunk(void)
 	}
 
 	// Load the chunk:
+	auto StartTime = std::chrono::steady_clock::now();
 	bool res = LoadChunk(ToLoad.m_ChunkX, ToLoad.m_ChunkZ);
+	if (res)
+	{
+		m_ChunksLoadedMetric->Add();
+	}
+	m_LoadingMicrosecondsMetric->Add(static_cast<UInt64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count()));
 
 	// Call the callback, if specified:
 	if (ToLoad.m_Callback != nullptr)
@@ -21,6 +21,7 @@
 
 // fwd:
 class cWorld;
+class cMetricCounter;
 
 typedef cQueue<cChunkCoordsWithCallback> cChunkCoordsQueue;
 
@@ -66,7 +67,8 @@ public:
 	void QueueLoadChunk(int a_ChunkX, int a_ChunkZ, cChunkCoordCallback * a_Callback = nullptr);
 
 	/** Queues a chunk to be saved, asynchronously.
-	The callback, if specified, will be called with the result of the save operation. */
+	The callback, if specified, will be called with the result of the save operation.
+	If the chunk is not valid (anymore), nothing is queued and the callback is called right away, reporting a failure. */
 	void QueueSaveChunk(int a_ChunkX, int a_ChunkZ, cChunkCoordCallback * a_Callback = nullptr);
 
 	/** Initializes the storage schemas, ready to be started. */
@@ -79,11 +81,23 @@ public:
 	size_t GetLoadQueueLength(void);
 	size_t GetSaveQueueLength(void);
 
+	/** Returns the number of chunks successfully loaded from the disk so far. */
+	UInt64 GetNumChunksLoaded(void) const;
+
+	/** Returns the total time spent loading the chunks so far, including the chunks not found on the disk, in microseconds. */
+	UInt64 GetLoadingMicroseconds(void) const;
+
 protected:
 
 	cWorld * m_World;
 	AString  m_StorageSchemaName;
 
+	/** Counts the chunks successfully loaded from the disk, exported through cMetrics. Set in Initialize(). */
+	cMetricCounter * m_ChunksLoadedMetric;
+
+	/** Counts the time spent loading the chunks, in microseconds, exported through cMetrics. Set in Initialize(). */
+	cMetricCounter * m_LoadingMicrosecondsMetric;
+
 	cChunkCoordsQueue  m_LoadQueue;
 	cChunkCoordsQueue m_SaveQueue;
 
@@ -82,6 +82,7 @@ static void NonCtrlHandler(int a_Signal)
 			LOGERROR("Cuberite " BUILD_SERIES_NAME " build id: " BUILD_ID);
 			LOGERROR("from commit id: " BUILD_COMMIT_ID " built at: " BUILD_DATETIME);
 			#endif
+			cLogger::GetInstance().Flush();
 			PrintStackTrace();
 			abort();
 		}
@@ -97,6 +98,7 @@ static void NonCtrlHandler(int a_Signal)
 			LOGERROR("Cuberite " BUILD_SERIES_NAME " build id: " BUILD_ID);
 			LOGERROR("from commit id: " BUILD_COMMIT_ID " built at: " BUILD_DATETIME);
 			#endif
+			cLogger::GetInstance().Flush();
 			PrintStackTrace();
 			abort();
 		}
@@ -377,6 +379,7 @@ static std::unique_ptr<cMemorySettingsRepository> ParseArguments(int argc, char
 		TCLAP::SwitchArg noBufArg        ("",  "no-output-buffering", "Disable output buffering", cmd);
 		TCLAP::SwitchArg noFileLogArg    ("",  "no-log-file",         "Disable logging to file", cmd);
 		TCLAP::SwitchArg runAsServiceArg ("d", "service",             "Run as a service on Windows, or daemon on UNIX like systems", cmd);
+		TCLAP::ValueArg<int> pregenArg   ("",  "pregenerate",         "Generate, light and save all chunks within the specified radius (in chunks) around each world's spawn, then exit without accepting any connections", false, -1, "radius", cmd);
 		cmd.parse(argc, argv);
 
 		// Copy the parsed args' values into a settings repository:
@@ -398,6 +401,10 @@ static std::unique_ptr<cMemorySettingsRepository> ParseArguments(int argc, char
 				repo->AddValue("Server", "Ports", std::to_string(port));
 			}
 		}
+		if (pregenArg.isSet())
+		{
+			repo->AddValue("Server", "PregenerateRadius", static_cast<Int64>(pregenArg.getValue()));
+		}
 		if (noFileLogArg.getValue())
 		{
 			repo->AddValue("Server", "DisableLogFile", true);
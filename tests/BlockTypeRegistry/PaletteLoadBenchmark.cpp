@@ -0,0 +1,117 @@
+
+// PaletteLoadBenchmark.cpp
+
+// Measures the time spent loading the palettes shipped with the server, and how much of it a binary palette cache could save
+
+#include "Globals.h"
+#include "BlockTypePalette.h"
+
+
+
+
+
+/** Number of times each measurement is repeated; the fastest run is reported. */
+static const int NUM_REPEATS = 10;
+
+
+
+
+
+/** Runs a_Fn NUM_REPEATS times, returns the fastest run's duration, in milliseconds. */
+template <typename Fn>
+static double Measure(Fn a_Fn)
+{
+	double Best = std::numeric_limits<double>::max();
+	for (int i = 0; i < NUM_REPEATS; ++i)
+	{
+		auto Start = std::chrono::steady_clock::now();
+		a_Fn();
+		Best = std::min(Best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count());
+	}
+	return Best;
+}
+
+
+
+
+
+/** Loads the palette from the specified file. */
+static void LoadPalette(BlockTypePalette & a_Palette, const AString & a_FileName)
+{
+	a_Palette.loadFromString(cFile::ReadWholeFile(a_FileName));
+}
+
+
+
+
+
+/** Measures the loading of the palette file:
+the whole load, the file reading alone, and the building of the palette's maps from the already parsed entries.
+The last one is the part that a binary cache would still have to do. */
+static void MeasureFile(const AString & a_FileName)
+{
+	BlockTypePalette Parsed;
+	LoadPalette(Parsed, a_FileName);
+
+	// Collect the parsed entries; the indices may have gaps (the upgrade palette is indexed by the blocktype and meta):
+	std::vector<std::pair<AString, BlockState>> Entries;
+	for (UInt32 Index = 0; Entries.size() < Parsed.count(); ++Index)
+	{
+		try
+		{
+			Entries.push_back(Parsed.entry(Index));
+		}
+		catch (const BlockTypePalette::NoSuchIndexException &)
+		{
+			continue;
+		}
+	}
+
+	auto Load = Measure([&]()
+		{
+			BlockTypePalette Palette;
+			LoadPalette(Palette, a_FileName);
+		}
+	);
+	auto Read = Measure([&]()
+		{
+			auto Contents = cFile::ReadWholeFile(a_FileName);
+			return Contents.size();
+		}
+	);
+	auto BuildMaps = Measure([&]()
+		{
+			BlockTypePalette Palette;
+			for (const auto & Entry: Entries)
+			{
+				Palette.index(Entry.first, Entry.second);
+			}
+		}
+	);
+	LOG("%s: %u entries, load %.2f ms (file read %.2f ms, building the maps from parsed entries %.2f ms)",
+		a_FileName.c_str(), Parsed.count(), Load, Read, BuildMaps
+	);
+}
+
+
+
+
+
+int main()
+{
+	LOG("Palette load benchmark, fastest of %d runs:", NUM_REPEATS);
+	MeasureFile("UpgradeBlockTypePalette.txt");
+	MeasureFile("base.btp.txt");
+
+	// The transform map that cProtocol_1_13::Initialize() builds for each connecting client:
+	BlockTypePalette Upgrade, Protocol;
+	LoadPalette(Upgrade, "UpgradeBlockTypePalette.txt");
+	LoadPalette(Protocol, "base.btp.txt");
+	auto Transform = Measure([&]()
+		{
+			return Protocol.createTransformMapWithFallback(Upgrade, 0).size();
+		}
+	);
+	LOG("Transform map for a connecting client: %.2f ms", Transform);
+	return 0;
+}
@@ -2,6 +2,46 @@
 #include "Globals.h"
 #include "../TestHelpers.h"
 #include "ChunkData.h"
+#include <functional>
+#include <thread>
+
+
+
+
+
+/** Allocation pool that counts its allocations and frees.
+Only compares equal to itself, so cChunkData instances share sections only if they use the same pool instance. */
+class cCountingPool:
+	public cAllocationPool<cChunkData::sChunkSection>
+{
+public:
+
+	/** Number of sections currently allocated from this pool and not freed yet. */
+	int m_NumAllocated = 0;
+
+	/** Total number of sections ever allocated from this pool. */
+	int m_NumAllocations = 0;
+
+	virtual cChunkData::sChunkSection * Allocate() override
+	{
+		m_NumAllocated += 1;
+		m_NumAllocations += 1;
+		return new cChunkData::sChunkSection();
+	}
+
+	virtual void Free(cChunkData::sChunkSection * a_Ptr) override
+	{
+		m_NumAllocated -= 1;
+		delete a_Ptr;
+	}
+
+private:
+
+	virtual bool DoIsEqual(const cAllocationPool<cChunkData::sChunkSection> &) const noexcept override
+	{
+		return false;
+	}
+};
 
 
 
@@ -158,7 +198,228 @@ static void test()
 
 
 
+/** Checks that writing into either instance after a sharing Assign() doesn't show in the other one. */
+static void TestWritesAfterAssign()
+{
+	LOGD("Testing writes after Assign()...");
+	cCountingPool Pool;
+	{
+		cChunkData Original(Pool);
+		Original.SetBlock({ 3, 1, 4 }, 0xDE);
+		Original.SetMeta({ 3, 1, 4 }, 0xA);
+		Original.SetBlock({ 5, 200, 7 }, 0x11);
+		TEST_EQUAL(Pool.m_NumAllocated, 2);
+
+		// The copy shares both sections, no new allocation:
+		cChunkData Copy(Pool);
+		Copy.Assign(Original);
+		TEST_EQUAL(Pool.m_NumAllocated, 2);
+		TEST_EQUAL(Copy.GetBlock({ 3, 1, 4 }), 0xDE);
+		TEST_EQUAL(Copy.GetMeta({ 3, 1, 4 }), 0xA);
+		TEST_EQUAL(Copy.GetBlock({ 5, 200, 7 }), 0x11);
+
+		// Writing into the copy unshares only the written section:
+		Copy.SetBlock({ 3, 1, 4 }, 0x01);
+		Copy.SetMeta({ 3, 1, 4 }, 0x2);
+		TEST_EQUAL(Pool.m_NumAllocated, 3);
+		TEST_EQUAL(Copy.GetBlock({ 3, 1, 4 }), 0x01);
+		TEST_EQUAL(Copy.GetMeta({ 3, 1, 4 }), 0x2);
+		TEST_EQUAL(Original.GetBlock({ 3, 1, 4 }), 0xDE);
+		TEST_EQUAL(Original.GetMeta({ 3, 1, 4 }), 0xA);
+
+		// Writing into the original unshares the other section:
+		Original.SetBlock({ 5, 200, 7 }, 0x22);
+		TEST_EQUAL(Pool.m_NumAllocated, 4);
+		TEST_EQUAL(Original.GetBlock({ 5, 200, 7 }), 0x22);
+		TEST_EQUAL(Copy.GetBlock({ 5, 200, 7 }), 0x11);
+
+		// Once unshared, further writes happen in place:
+		Original.SetBlock({ 5, 200, 8 }, 0x33);
+		Copy.SetBlock({ 3, 1, 5 }, 0x44);
+		TEST_EQUAL(Pool.m_NumAllocated, 4);
+		TEST_EQUAL(Copy.GetBlock({ 5, 200, 8 }), 0);
+		TEST_EQUAL(Original.GetBlock({ 3, 1, 5 }), 0);
+
+		// Releasing the copy frees only its own sections:
+		Copy.Clear();
+		TEST_EQUAL(Pool.m_NumAllocated, 2);
+		TEST_EQUAL(Original.GetBlock({ 3, 1, 4 }), 0xDE);
+		TEST_EQUAL(Original.GetBlock({ 5, 200, 7 }), 0x22);
+	}
+	TEST_EQUAL(Pool.m_NumAllocated, 0);
+
+	// A section shared by several copies is freed only by the last one, regardless of the destruction order:
+	{
+		auto Original = cpp14::make_unique<cChunkData>(Pool);
+		Original->SetBlock({ 0, 0, 0 }, 0x01);
+		cChunkData Copy1(Pool), Copy2(Pool);
+		Copy1.Assign(*Original);
+		Copy2.Assign(Copy1);
+		TEST_EQUAL(Pool.m_NumAllocated, 1);
+		Original.reset();
+		TEST_EQUAL(Pool.m_NumAllocated, 1);
+		TEST_EQUAL(Copy2.GetBlock({ 0, 0, 0 }), 0x01);
+		Copy1.Clear();
+		TEST_EQUAL(Pool.m_NumAllocated, 1);
+		TEST_EQUAL(Copy2.GetBlock({ 0, 0, 0 }), 0x01);
+	}
+	TEST_EQUAL(Pool.m_NumAllocated, 0);
+}
+
+
+
+
+
+/** Checks that each of the whole-chunk Fill*() and Set*() functions unshares the sections before writing. */
+static void TestBulkWritesUnshare()
+{
+	LOGD("Testing Fill*() and Set*() unsharing...");
+	cCountingPool Pool;
+
+	BLOCKTYPE Blocks[cChunkDef::NumBlocks];
+	memset(Blocks, 0x05, sizeof(Blocks));
+	NIBBLETYPE Nibbles[cChunkDef::NumBlocks / 2];
+	memset(Nibbles, 0x77, sizeof(Nibbles));
+
+	const std::pair<const char *, std::function<void(cChunkData &)>> Writers[] =
+	{
+		{ "FillBlockTypes", [](cChunkData & a_Data) { a_Data.FillBlockTypes(0x09); } },
+		{ "FillMetas",      [](cChunkData & a_Data) { a_Data.FillMetas(0x9); } },
+		{ "FillBlockLight", [](cChunkData & a_Data) { a_Data.FillBlockLight(0x9); } },
+		{ "FillSkyLight",   [](cChunkData & a_Data) { a_Data.FillSkyLight(0x9); } },
+		{ "SetBlockTypes",  [&](cChunkData & a_Data) { a_Data.SetBlockTypes(Blocks); } },
+		{ "SetMetas",       [&](cChunkData & a_Data) { a_Data.SetMetas(Nibbles); } },
+		{ "SetBlockLight",  [&](cChunkData & a_Data) { a_Data.SetBlockLight(Nibbles); } },
+		{ "SetSkyLight",    [&](cChunkData & a_Data) { a_Data.SetSkyLight(Nibbles); } },
+	};
+	for (const auto & Writer: Writers)
+	{
+		LOGD("  %s", Writer.first);
+		cChunkData Original(Pool);
+		Original.SetBlock({ 1, 2, 3 }, 0x01);
+		Original.SetMeta({ 1, 2, 3 }, 0x1);
+		cChunkData Copy(Pool);
+		Copy.Assign(Original);
+
+		BLOCKTYPE OrigBlocks[cChunkDef::NumBlocks];
+		NIBBLETYPE OrigMetas[cChunkDef::NumBlocks / 2], OrigBlockLight[cChunkDef::NumBlocks / 2], OrigSkyLight[cChunkDef::NumBlocks / 2];
+		Original.CopyBlockTypes(OrigBlocks);
+		Original.CopyMetas(OrigMetas);
+		Original.CopyBlockLight(OrigBlockLight);
+		Original.CopySkyLight(OrigSkyLight);
+
+		Writer.second(Copy);
+
+		// The original must be untouched:
+		BLOCKTYPE NewBlocks[cChunkDef::NumBlocks];
+		NIBBLETYPE NewNibbles[cChunkDef::NumBlocks / 2];
+		Original.CopyBlockTypes(NewBlocks);
+		TEST_EQUAL(memcmp(OrigBlocks, NewBlocks, sizeof(NewBlocks)), 0);
+		Original.CopyMetas(NewNibbles);
+		TEST_EQUAL(memcmp(OrigMetas, NewNibbles, sizeof(NewNibbles)), 0);
+		Original.CopyBlockLight(NewNibbles);
+		TEST_EQUAL(memcmp(OrigBlockLight, NewNibbles, sizeof(NewNibbles)), 0);
+		Original.CopySkyLight(NewNibbles);
+		TEST_EQUAL(memcmp(OrigSkyLight, NewNibbles, sizeof(NewNibbles)), 0);
+
+		// The copy must have got its own section:
+		TEST_NOTEQUAL(Copy.GetSection(0), Original.GetSection(0));
+	}
+	TEST_EQUAL(Pool.m_NumAllocated, 0);
+}
+
+
+
+
+
+/** Checks that a copy using a different pool gets its own sections and each pool frees only its own. */
+static void TestDifferentPools()
+{
+	LOGD("Testing a copy with a different pool...");
+	cCountingPool Pool1, Pool2;
+	{
+		cChunkData Original(Pool1);
+		Original.SetBlock({ 1, 2, 3 }, 0x01);
+		Original.SetBlock({ 1, 100, 3 }, 0x02);
+		TEST_EQUAL(Pool1.m_NumAllocated, 2);
+
+		{
+			cChunkData Copy(Pool2);
+			Copy.Assign(Original);
+			TEST_EQUAL(Pool1.m_NumAllocated, 2);
+			TEST_EQUAL(Pool2.m_NumAllocated, 2);
+			TEST_NOTEQUAL(Copy.GetSection(0), Original.GetSection(0));
+			TEST_EQUAL(Copy.GetBlock({ 1, 2, 3 }), 0x01);
+			TEST_EQUAL(Copy.GetBlock({ 1, 100, 3 }), 0x02);
+
+			// A copy from the copy, using the first pool again, is a deep copy too:
+			cChunkData Copy2(Pool1);
+			Copy2.Assign(Copy);
+			TEST_EQUAL(Pool1.m_NumAllocated, 4);
+			TEST_EQUAL(Pool2.m_NumAllocated, 2);
+
+			// Writes don't need to unshare anything:
+			Copy.SetBlock({ 1, 2, 3 }, 0x03);
+			TEST_EQUAL(Pool2.m_NumAllocated, 2);
+			TEST_EQUAL(Pool2.m_NumAllocations, 2);
+			TEST_EQUAL(Original.GetBlock({ 1, 2, 3 }), 0x01);
+			TEST_EQUAL(Copy2.GetBlock({ 1, 2, 3 }), 0x01);
+		}
+		TEST_EQUAL(Pool1.m_NumAllocated, 2);
+		TEST_EQUAL(Pool2.m_NumAllocated, 0);
+	}
+	TEST_EQUAL(Pool1.m_NumAllocated, 0);
+}
+
+
+
+
+
+/** Reads a snapshot on another thread while the original is being written, like the chunk sender does.
+Besides checking the data read, this gives ThreadSanitizer builds a reproducible run of the sharing across threads. */
+static void TestSnapshotOnOtherThread()
+{
+	LOGD("Testing reading a snapshot on another thread...");
+	cCountingPool Pool;
+	cChunkData Original(Pool);
+	Original.FillBlockTypes(0x01);
+
+	for (int Round = 0; Round < 50; Round++)
+	{
+		cChunkData Snapshot(Pool);
+		Snapshot.Assign(Original);
+		auto Expected = static_cast<BLOCKTYPE>(Round + 1);
+		bool IsCorrect = true;
+		std::thread Reader([&Snapshot, &IsCorrect, Expected]()
+			{
+				for (int y = 0; y < cChunkDef::Height; y++)
+				{
+					IsCorrect = IsCorrect && (Snapshot.GetBlock({ 7, y, 7 }) == Expected);
+				}
+			}
+		);
+
+		// Meanwhile, overwrite the original:
+		for (int y = 0; y < cChunkDef::Height; y++)
+		{
+			Original.SetBlock({ 7, y, 7 }, static_cast<BLOCKTYPE>(Round + 2));
+		}
+		Original.FillBlockTypes(static_cast<BLOCKTYPE>(Round + 2));
+
+		Reader.join();
+		TEST_TRUE(IsCorrect);
+	}
+}
+
+
+
+
+
 
 IMPLEMENT_TEST_MAIN("ChunkData Copies",
-	test()
+	test();
+	TestWritesAfterAssign();
+	TestBulkWritesUnshare();
+	TestDifferentPools();
+	TestSnapshotOnOtherThread();
 )
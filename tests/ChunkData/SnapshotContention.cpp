@@ -0,0 +1,129 @@
+
+// SnapshotContention.cpp
+
+// Measures how long taking a chunk snapshot holds the lock that a ticking thread needs,
+// with the sections shared (same pool) versus copied (different pools, same as before the sections were shared)
+
+#include "Globals.h"
+#include "ChunkData.h"
+#include <thread>
+
+
+
+
+
+/** Number of snapshots taken by the reading thread in each measurement. */
+static const int NUM_SNAPSHOTS = 20000;
+
+
+
+
+
+/** Allocation pool that allocates each section on the heap. Only compares equal to itself. */
+class cHeapPool:
+	public cAllocationPool<cChunkData::sChunkSection>
+{
+public:
+
+	virtual cChunkData::sChunkSection * Allocate() override
+	{
+		return new cChunkData::sChunkSection();
+	}
+
+	virtual void Free(cChunkData::sChunkSection * a_Ptr) override
+	{
+		delete a_Ptr;
+	}
+
+private:
+
+	virtual bool DoIsEqual(const cAllocationPool<cChunkData::sChunkSection> &) const noexcept override
+	{
+		return false;
+	}
+};
+
+
+
+
+
+/** Runs a single measurement and logs the results.
+The ticking thread keeps locking the chunk and changing a few blocks, the same way the world tick does.
+The reading thread keeps locking the chunk, taking a snapshot, unlocking it and then reading the whole snapshot,
+the same way the chunk sender and the lighting thread do. */
+static void Measure(const char * a_Name, cAllocationPool<cChunkData::sChunkSection> & a_ChunkPool, cAllocationPool<cChunkData::sChunkSection> & a_SnapshotPool)
+{
+	cCriticalSection CS;
+	cChunkData Chunk(a_ChunkPool);
+	Chunk.FillBlockTypes(1);
+	Chunk.FillMetas(2);
+	std::atomic<bool> IsReading(true);
+
+	// The ticking thread:
+	std::chrono::nanoseconds TickLockWait(0);
+	int NumTicks = 0;
+	std::thread Ticker([&]()
+		{
+			while (IsReading.load())
+			{
+				auto Start = std::chrono::steady_clock::now();
+				cCSLock Lock(CS);
+				TickLockWait += std::chrono::steady_clock::now() - Start;
+				for (int i = 0; i < 4; i++)
+				{
+					int Idx = (NumTicks * 4 + i) * 997;
+					Chunk.SetBlock({ Idx % cChunkDef::Width, (Idx / 256) % cChunkDef::Height, (Idx / 16) % cChunkDef::Width }, static_cast<BLOCKTYPE>(NumTicks));
+				}
+				NumTicks += 1;
+			}
+		}
+	);
+
+	// The reading thread is this one:
+	std::chrono::nanoseconds ReadLockHeld(0);
+	auto Start = std::chrono::steady_clock::now();
+	size_t Checksum = 0;
+	{
+		BLOCKTYPE Blocks[cChunkDef::NumBlocks];
+		for (int i = 0; i < NUM_SNAPSHOTS; i++)
+		{
+			cChunkData Snapshot(a_SnapshotPool);
+			{
+				cCSLock Lock(CS);
+				auto LockStart = std::chrono::steady_clock::now();
+				Snapshot.Assign(Chunk);
+				ReadLockHeld += std::chrono::steady_clock::now() - LockStart;
+			}
+			Snapshot.CopyBlockTypes(Blocks);
+			Checksum += Blocks[static_cast<size_t>(i) % cChunkDef::NumBlocks];
+		}
+	}
+	auto WallTime = std::chrono::steady_clock::now() - Start;
+	IsReading = false;
+	Ticker.join();
+
+	LOG("%s: %d snapshots in %.1f ms; lock held %.2f us per snapshot; %d ticks, which waited for the lock %.1f ms in total (checksum %u)",
+		a_Name, NUM_SNAPSHOTS,
+		std::chrono::duration<double, std::milli>(WallTime).count(),
+		std::chrono::duration<double, std::micro>(ReadLockHeld).count() / NUM_SNAPSHOTS,
+		NumTicks,
+		std::chrono::duration<double, std::milli>(TickLockWait).count(),
+		static_cast<unsigned>(Checksum)
+	);
+}
+
+
+
+
+
+int main()
+{
+	LOG("SnapshotContention started.");
+
+	cHeapPool Pool1, Pool2;
+	Measure("Copied sections", Pool1, Pool2);
+	Measure("Shared sections", Pool1, Pool1);
+
+	LOG("SnapshotContention finished.");
+	return 0;
+}
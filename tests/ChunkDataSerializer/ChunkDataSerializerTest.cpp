@@ -0,0 +1,340 @@
+
+// ChunkDataSerializerTest.cpp
+
+// Tests the 1.13 chunk data serialization by parsing the packet back, the same way the client does
+
+#include "Globals.h"
+#include "../TestHelpers.h"
+#include "ByteBuffer.h"
+#include "ChunkData.h"
+#include "StringCompression.h"
+#include "Protocol/ChunkDataSerializer.h"
+
+
+
+
+
+/** The NetBlockID that all the metas of block type 2 map to, so that the palette must merge their keys. */
+static const UInt32 MERGED_NET_BLOCK_ID = 16000;
+
+
+
+
+
+/** Allocation pool that simply allocates each section on the heap. */
+class cTestPool:
+	public cAllocationPool<cChunkData::sChunkSection>
+{
+	virtual cChunkData::sChunkSection * Allocate() override
+	{
+		return new cChunkData::sChunkSection();
+	}
+
+	virtual void Free(cChunkData::sChunkSection * a_Ptr) override
+	{
+		delete a_Ptr;
+	}
+
+	virtual bool DoIsEqual(const cAllocationPool<cChunkData::sChunkSection> &) const noexcept override
+	{
+		return false;
+	}
+};
+
+
+
+
+
+/** The contents of a single section in the test chunk, and how it should be serialized. */
+struct sSectionSpec
+{
+	/** The index of the section in the chunk. */
+	size_t m_SectionIdx;
+
+	/** The BLOCKTYPE * 16 + META keys used in the section; the block at Index uses m_Keys[Index % m_Keys.size()]. */
+	std::vector<UInt16> m_Keys;
+
+	/** The number of bits per entry that the section should be sent with. */
+	UInt8 m_ExpectedBitsPerEntry;
+};
+
+
+
+
+
+/** Returns a_NumKeys distinct keys, none of them using block type 0 (air) or 2 (merged). */
+static std::vector<UInt16> MakeKeys(size_t a_NumKeys, size_t a_Seed)
+{
+	std::vector<UInt16> Keys;
+	for (size_t i = 0; i < a_NumKeys; i++)
+	{
+		Keys.push_back(static_cast<UInt16>(48 + (i * 37 + a_Seed) % (4096 - 48)));
+	}
+	return Keys;
+}
+
+
+
+
+
+/** Returns the keys of all 16 metas of block type 2 (which all map to MERGED_NET_BLOCK_ID), followed by a_Others. */
+static std::vector<UInt16> MakeMergedKeys(const std::vector<UInt16> & a_Others)
+{
+	std::vector<UInt16> Keys;
+	for (UInt16 Meta = 0; Meta < 16; Meta++)
+	{
+		Keys.push_back(static_cast<UInt16>(2 * 16 + Meta));
+	}
+	Keys.insert(Keys.end(), a_Others.begin(), a_Others.end());
+	return Keys;
+}
+
+
+
+
+
+/** Returns the sections of the test chunk, covering each palette size and the direct global IDs.
+The sections not listed are left empty. */
+static std::vector<sSectionSpec> MakeSectionSpecs()
+{
+	std::vector<UInt16> AllKeys;
+	for (UInt16 Key = 0; Key < 4096; Key++)
+	{
+		AllKeys.push_back(Key);
+	}
+
+	return
+	{
+		{ 0, {1 * 16}, 4},                       // Uniform section, a single palette entry
+		{ 1, MakeKeys(16, 1), 4},                // Largest 4-bit palette
+		{ 2, MakeKeys(17, 2), 5},                // Smallest 5-bit palette
+		{ 3, MakeKeys(40, 3), 6},                // 6-bit entries straddle the longs
+		{ 5, MakeKeys(100, 5), 7},               // 7-bit entries straddle the longs
+		{ 6, MakeKeys(256, 6), 8},               // Largest palette
+		{ 7, MakeKeys(257, 7), 14},              // Too many for a palette, direct global IDs
+		{ 8, AllKeys, 14},                       // Every single key
+		{10, MakeMergedKeys({1 * 16}), 4},       // 17 keys, but only 2 distinct NetBlockIDs
+		{11, MakeMergedKeys(MakeKeys(255, 11)), 8},  // 271 keys, but only 256 distinct NetBlockIDs, still fits a palette
+	};
+}
+
+
+
+
+
+/** Returns the BLOCKTYPE * 16 + META to NetBlockID map used for the test.
+All the keys map to distinct NetBlockIDs, except for block type 2, whose metas all map to MERGED_NET_BLOCK_ID. */
+static std::vector<UInt32> MakeBlockTypeMap()
+{
+	std::vector<UInt32> Map;
+	for (UInt32 Key = 0; Key < 4096; Key++)
+	{
+		Map.push_back((Key / 16 == 2) ? MERGED_NET_BLOCK_ID : (Key * 3 + 1));
+	}
+	return Map;
+}
+
+
+
+
+
+/** Reads a single 1.13 section from the packet and checks it against the expected contents. */
+static void VerifySection(
+	cByteBuffer & a_Packet,
+	const sSectionSpec & a_Spec,
+	const std::vector<UInt32> & a_Map,
+	const NIBBLETYPE * a_BlockLight,
+	const NIBBLETYPE * a_SkyLight,
+	bool a_HasSkyLight
+)
+{
+	auto Msg = Printf("Section %u", static_cast<unsigned>(a_Spec.m_SectionIdx));
+
+	// Bits per entry:
+	UInt8 BitsPerEntry;
+	TEST_TRUE(a_Packet.ReadBEUInt8(BitsPerEntry));
+	TEST_EQUAL_MSG(BitsPerEntry, a_Spec.m_ExpectedBitsPerEntry, Msg);
+
+	// The palette, with exactly the distinct NetBlockIDs of the section:
+	std::vector<UInt32> Palette;
+	if (BitsPerEntry <= 8)
+	{
+		std::set<UInt32> Expected;
+		for (auto Key: a_Spec.m_Keys)
+		{
+			Expected.insert(a_Map[Key]);
+		}
+		UInt32 PaletteSize;
+		TEST_TRUE(a_Packet.ReadVarInt32(PaletteSize));
+		TEST_EQUAL_MSG(PaletteSize, Expected.size(), Msg);
+		for (UInt32 i = 0; i < PaletteSize; i++)
+		{
+			UInt32 NetBlockID;
+			TEST_TRUE(a_Packet.ReadVarInt32(NetBlockID));
+			TEST_EQUAL_MSG(Expected.erase(NetBlockID), 1, Msg);
+			Palette.push_back(NetBlockID);
+		}
+	}
+
+	// The packed entries:
+	UInt32 NumLongs;
+	TEST_TRUE(a_Packet.ReadVarInt32(NumLongs));
+	TEST_EQUAL_MSG(NumLongs, cChunkData::SectionBlockCount * BitsPerEntry / 64, Msg);
+	std::vector<UInt64> Longs(NumLongs);
+	for (auto & Long: Longs)
+	{
+		TEST_TRUE(a_Packet.ReadBEUInt64(Long));
+	}
+	UInt64 Mask = (static_cast<UInt64>(1) << BitsPerEntry) - 1;
+	for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
+	{
+		size_t BitPosition = Index * BitsPerEntry;
+		size_t LongIndex = BitPosition / 64;
+		size_t BitOffset = BitPosition % 64;
+		UInt64 Value = Longs[LongIndex] >> BitOffset;
+		if (BitOffset + BitsPerEntry > 64)
+		{
+			Value |= Longs[LongIndex + 1] << (64 - BitOffset);
+		}
+		Value &= Mask;
+		if (!Palette.empty())
+		{
+			TEST_LESS_THAN_OR_EQUAL(Value + 1, Palette.size());
+			Value = Palette[Value];
+		}
+		UInt32 Expected = a_Map[a_Spec.m_Keys[Index % a_Spec.m_Keys.size()]];
+		TEST_EQUAL_MSG(Value, Expected, Printf("Section %u, block %u", static_cast<unsigned>(a_Spec.m_SectionIdx), static_cast<unsigned>(Index)));
+	}
+
+	// Lighting, skylight only in the overworld:
+	const size_t LightSize = cChunkData::SectionBlockCount / 2;
+	const size_t LightStart = a_Spec.m_SectionIdx * LightSize;
+	AString Light;
+	TEST_TRUE(a_Packet.ReadString(Light, LightSize));
+	TEST_EQUAL(memcmp(Light.data(), a_BlockLight + LightStart, LightSize), 0);
+	if (a_HasSkyLight)
+	{
+		TEST_TRUE(a_Packet.ReadString(Light, LightSize));
+		TEST_EQUAL(memcmp(Light.data(), a_SkyLight + LightStart, LightSize), 0);
+	}
+}
+
+
+
+
+
+/** Serializes the test chunk in the specified dimension for 1.13, then parses the packet back and checks everything in it. */
+static void TestSerialize393(eDimension a_Dimension)
+{
+	LOG("Testing the 1.13 serialization in dimension %d", static_cast<int>(a_Dimension));
+	auto Specs = MakeSectionSpecs();
+	auto Map = MakeBlockTypeMap();
+
+	// Fill the chunk; the sections not listed in Specs stay empty:
+	std::unique_ptr<BLOCKTYPE[]>  BlockTypes(new BLOCKTYPE[cChunkDef::NumBlocks]);
+	std::unique_ptr<NIBBLETYPE[]> Metas     (new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::unique_ptr<NIBBLETYPE[]> BlockLight(new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::unique_ptr<NIBBLETYPE[]> SkyLight  (new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::fill_n(BlockTypes.get(), cChunkDef::NumBlocks, 0);
+	std::fill_n(Metas.get(),      cChunkDef::NumBlocks / 2, 0);
+	std::fill_n(BlockLight.get(), cChunkDef::NumBlocks / 2, 0);
+	std::fill_n(SkyLight.get(),   cChunkDef::NumBlocks / 2, 0xff);
+	UInt32 ExpectedBitmask = 0;
+	for (const auto & Spec: Specs)
+	{
+		ExpectedBitmask |= 1U << Spec.m_SectionIdx;
+		size_t Start = Spec.m_SectionIdx * cChunkData::SectionBlockCount;
+		for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
+		{
+			auto Key = Spec.m_Keys[Index % Spec.m_Keys.size()];
+			BlockTypes[Start + Index] = static_cast<BLOCKTYPE>(Key / 16);
+			Metas[(Start + Index) / 2] |= static_cast<NIBBLETYPE>((Key % 16) << (((Start + Index) % 2) * 4));
+		}
+		for (size_t Index = 0; Index < cChunkData::SectionBlockCount / 2; Index++)
+		{
+			BlockLight[Start / 2 + Index] = static_cast<NIBBLETYPE>(Index + Spec.m_SectionIdx);
+			SkyLight  [Start / 2 + Index] = static_cast<NIBBLETYPE>(Index * 3 + Spec.m_SectionIdx);
+		}
+	}
+	cTestPool Pool;
+	cChunkData Data(Pool);
+	Data.SetBlockTypes(BlockTypes.get());
+	Data.SetMetas(Metas.get());
+	Data.SetBlockLight(BlockLight.get());
+	Data.SetSkyLight(SkyLight.get());
+	unsigned char Biomes[cChunkDef::Width * cChunkDef::Width];
+	for (size_t i = 0; i < ARRAYCOUNT(Biomes); i++)
+	{
+		Biomes[i] = static_cast<unsigned char>(i * 7);
+	}
+
+	// Serialize:
+	cChunkDataSerializer Serializer(Data, Biomes, a_Dimension);
+	const auto & Serialized = Serializer.Serialize(cChunkDataSerializer::RELEASE_1_13, 12, -34, Map);
+
+	// Unwrap the packet length and the compression:
+	cByteBuffer Wrapped(Serialized.size());
+	TEST_TRUE(Wrapped.Write(Serialized.data(), Serialized.size()));
+	UInt32 PacketLength, DataLength;
+	TEST_TRUE(Wrapped.ReadVarInt32(PacketLength));
+	TEST_EQUAL(PacketLength, Wrapped.GetReadableSpace());
+	TEST_TRUE(Wrapped.ReadVarInt32(DataLength));
+	AString PacketData;
+	TEST_TRUE(Wrapped.ReadString(PacketData, Wrapped.GetReadableSpace()));
+	if (DataLength != 0)
+	{
+		AString Uncompressed;
+		TEST_EQUAL(UncompressString(PacketData.data(), PacketData.size(), Uncompressed, DataLength), Z_OK);
+		TEST_EQUAL(Uncompressed.size(), DataLength);
+		std::swap(PacketData, Uncompressed);
+	}
+	cByteBuffer Packet(PacketData.size());
+	TEST_TRUE(Packet.Write(PacketData.data(), PacketData.size()));
+
+	// Header:
+	UInt32 PacketID, Bitmask, ChunkSize;
+	Int32 ChunkX, ChunkZ;
+	bool IsFullChunk;
+	TEST_TRUE(Packet.ReadVarInt32(PacketID));
+	TEST_EQUAL(PacketID, 0x22);
+	TEST_TRUE(Packet.ReadBEInt32(ChunkX));
+	TEST_EQUAL(ChunkX, 12);
+	TEST_TRUE(Packet.ReadBEInt32(ChunkZ));
+	TEST_EQUAL(ChunkZ, -34);
+	TEST_TRUE(Packet.ReadBool(IsFullChunk));
+	TEST_TRUE(IsFullChunk);
+	TEST_TRUE(Packet.ReadVarInt32(Bitmask));
+	TEST_EQUAL(Bitmask, ExpectedBitmask);
+	TEST_TRUE(Packet.ReadVarInt32(ChunkSize));
+	size_t ChunkStart = Packet.GetReadableSpace();
+
+	// Sections, in the bitmask order:
+	for (const auto & Spec: Specs)
+	{
+		VerifySection(Packet, Spec, Map, BlockLight.get(), SkyLight.get(), (a_Dimension == dimOverworld));
+	}
+
+	// Biomes:
+	for (size_t i = 0; i < ARRAYCOUNT(Biomes); i++)
+	{
+		Int32 Biome;
+		TEST_TRUE(Packet.ReadBEInt32(Biome));
+		TEST_EQUAL(Biome, Biomes[i]);
+	}
+	TEST_EQUAL(ChunkStart - Packet.GetReadableSpace(), ChunkSize);
+
+	// No block entities:
+	UInt32 NumBlockEntities;
+	TEST_TRUE(Packet.ReadVarInt32(NumBlockEntities));
+	TEST_EQUAL(NumBlockEntities, 0);
+	TEST_EQUAL(Packet.GetReadableSpace(), 0);
+}
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("ChunkDataSerializer",
+	TestSerialize393(dimOverworld);
+	TestSerialize393(dimNether);
+)
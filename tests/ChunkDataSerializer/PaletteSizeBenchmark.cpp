@@ -0,0 +1,200 @@
+
+// PaletteSizeBenchmark.cpp
+
+// Reports the size of the 1.13 chunk data packets sent with the section-local palettes, for each palette width,
+// against the same chunks sent with the global palette (14 bits per block), as they were sent before the section palettes
+
+#include "Globals.h"
+#include "ByteBuffer.h"
+#include "ChunkData.h"
+#include "Endianness.h"
+#include "FastRandom.h"
+#include "Protocol/ChunkDataSerializer.h"
+#include "Protocol/Protocol_1_8.h"
+
+
+
+
+
+/** The bits per entry used by the 1.13 global palette. */
+static const size_t GLOBAL_BITS_PER_ENTRY = 14;
+
+/** The number of longs in a 1.13 section sent using the global palette. */
+static const size_t GLOBAL_NUM_LONGS = cChunkData::SectionBlockCount * GLOBAL_BITS_PER_ENTRY / 64;
+
+/** The number of sections filled in each measured chunk, the rest of the chunk is air. */
+static const size_t NUM_FILLED_SECTIONS = 8;
+
+
+
+
+
+/** Allocation pool that simply allocates each section on the heap. */
+class cTestPool:
+	public cAllocationPool<cChunkData::sChunkSection>
+{
+	virtual cChunkData::sChunkSection * Allocate() override
+	{
+		return new cChunkData::sChunkSection();
+	}
+
+	virtual void Free(cChunkData::sChunkSection * a_Ptr) override
+	{
+		delete a_Ptr;
+	}
+
+	virtual bool DoIsEqual(const cAllocationPool<cChunkData::sChunkSection> &) const noexcept override
+	{
+		return false;
+	}
+};
+
+
+
+
+
+/** Fills the bottom NUM_FILLED_SECTIONS sections of a_Data with a_NumKeys distinct BLOCKTYPE * 16 + META keys (none of them air).
+If a_IsLayered is true, each key fills a run of consecutive blocks, as strata and flat builds do; otherwise the keys are random. */
+static void FillChunk(cChunkData & a_Data, size_t a_NumKeys, bool a_IsLayered)
+{
+	cFastRandom Random;
+	std::unique_ptr<BLOCKTYPE[]>  BlockTypes(new BLOCKTYPE[cChunkDef::NumBlocks]);
+	std::unique_ptr<NIBBLETYPE[]> Metas     (new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::unique_ptr<NIBBLETYPE[]> BlockLight(new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::unique_ptr<NIBBLETYPE[]> SkyLight  (new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::fill_n(BlockTypes.get(), cChunkDef::NumBlocks, 0);
+	std::fill_n(Metas.get(),      cChunkDef::NumBlocks / 2, 0);
+	std::fill_n(BlockLight.get(), cChunkDef::NumBlocks / 2, 0);
+	std::fill_n(SkyLight.get(),   cChunkDef::NumBlocks / 2, 0xff);
+	const size_t NumFilledBlocks = NUM_FILLED_SECTIONS * cChunkData::SectionBlockCount;
+	for (size_t Index = 0; Index < NumFilledBlocks; Index++)
+	{
+		size_t KeyIdx = a_IsLayered ? (Index * a_NumKeys / NumFilledBlocks) : Random.RandInt<size_t>(a_NumKeys - 1);
+		auto Key = static_cast<UInt16>(16 + KeyIdx);
+		BlockTypes[Index] = static_cast<BLOCKTYPE>(Key / 16);
+		Metas[Index / 2] |= static_cast<NIBBLETYPE>((Key % 16) << ((Index % 2) * 4));
+	}
+	a_Data.SetBlockTypes(BlockTypes.get());
+	a_Data.SetMetas(Metas.get());
+	a_Data.SetBlockLight(BlockLight.get());
+	a_Data.SetSkyLight(SkyLight.get());
+}
+
+
+
+
+
+/** Returns the chunk data packet with all the sections sent using the global palette, the way Serialize393 sent them before
+the section palettes, compressed the same way. Only the overworld is supported. */
+static AString SerializeGlobal(const cChunkData & a_Data, const unsigned char * a_Biomes, const std::vector<UInt32> & a_BlockTypeMap)
+{
+	cByteBuffer Sections(cChunkData::NumSections * (3 + GLOBAL_NUM_LONGS * 8 + cChunkData::SectionBlockCount));
+	for (size_t SectionIdx = 0; SectionIdx < cChunkData::NumSections; SectionIdx++)
+	{
+		auto Section = a_Data.GetSection(SectionIdx);
+		if (Section == nullptr)
+		{
+			continue;
+		}
+		UInt64 Longs[GLOBAL_NUM_LONGS] = {};
+		for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
+		{
+			UInt32 Key = static_cast<UInt32>(Section->m_BlockTypes[Index]) * 16 | ((Section->m_BlockMetas[Index / 2] >> ((Index % 2) * 4)) & 0x0f);
+			UInt64 Value = a_BlockTypeMap[Key];
+			size_t BitPosition = Index * GLOBAL_BITS_PER_ENTRY;
+			size_t BitOffset = BitPosition % 64;
+			Longs[BitPosition / 64] |= (Value << BitOffset);
+			if (BitOffset + GLOBAL_BITS_PER_ENTRY > 64)
+			{
+				Longs[BitPosition / 64 + 1] |= (Value >> (64 - BitOffset));
+			}
+		}
+		for (auto & Long: Longs)
+		{
+			Long = HostToNetwork8(&Long);
+		}
+		Sections.WriteBEUInt8(static_cast<UInt8>(GLOBAL_BITS_PER_ENTRY));
+		Sections.WriteVarInt32(static_cast<UInt32>(GLOBAL_NUM_LONGS));
+		Sections.WriteBuf(Longs, sizeof(Longs));
+		Sections.WriteBuf(Section->m_BlockLight, sizeof(Section->m_BlockLight));
+		Sections.WriteBuf(Section->m_BlockSkyLight, sizeof(Section->m_BlockSkyLight));
+	}
+
+	const size_t BiomeDataSize = cChunkDef::Width * cChunkDef::Width;
+	cByteBuffer Packet(512 KiB);
+	Packet.WriteVarInt32(0x22);
+	Packet.WriteBEInt32(0);
+	Packet.WriteBEInt32(0);
+	Packet.WriteBool(true);
+	Packet.WriteVarInt32(a_Data.GetSectionBitmask());
+	Packet.WriteVarInt32(static_cast<UInt32>(Sections.GetReadableSpace() + BiomeDataSize * 4));
+	AString SectionData;
+	Sections.ReadAll(SectionData);
+	Packet.WriteBuf(SectionData.data(), SectionData.size());
+	for (size_t i = 0; i < BiomeDataSize; i++)
+	{
+		Packet.WriteBEUInt32(a_Biomes[i]);
+	}
+	Packet.WriteVarInt32(0);
+
+	AString PacketData, Res;
+	Packet.ReadAll(PacketData);
+	cProtocol_1_8_0::CompressPacket(PacketData, Res);
+	return Res;
+}
+
+
+
+
+
+/** Returns the size of the uncompressed data in the compressed packet, as stated in its header. */
+static UInt32 GetUncompressedSize(const AString & a_Packet)
+{
+	cByteBuffer Buffer(a_Packet.size());
+	Buffer.Write(a_Packet.data(), a_Packet.size());
+	UInt32 PacketLength = 0, DataLength = 0;
+	Buffer.ReadVarInt32(PacketLength);
+	Buffer.ReadVarInt32(DataLength);
+	return DataLength;
+}
+
+
+
+
+
+int main()
+{
+	// All the keys map to distinct NetBlockIDs, so the number of keys in a section is the size of its palette:
+	std::vector<UInt32> BlockTypeMap;
+	for (UInt32 Key = 0; Key < 4096; Key++)
+	{
+		BlockTypeMap.push_back(Key * 3 + 1);
+	}
+	unsigned char Biomes[cChunkDef::Width * cChunkDef::Width] = {};
+
+	LOG("1.13 chunk data packet sizes, %zu sections filled, bytes uncompressed / compressed:", NUM_FILLED_SECTIONS);
+	for (bool IsLayered: {true, false})
+	{
+		LOG("%s", IsLayered ?
+			"Layered blocks, each section has about 1/8 of the chunk's block types:" :
+			"Random blocks, each section has all of the chunk's block types:"
+		);
+		for (size_t NumKeys: {1, 2, 4, 16, 17, 32, 64, 128, 256, 257, 1024})
+		{
+			cTestPool Pool;
+			cChunkData Data(Pool);
+			FillChunk(Data, NumKeys, IsLayered);
+			cChunkDataSerializer Serializer(Data, Biomes, dimOverworld);
+			const auto & Palette = Serializer.Serialize(cChunkDataSerializer::RELEASE_1_13, 0, 0, BlockTypeMap);
+			auto Global = SerializeGlobal(Data, Biomes, BlockTypeMap);
+			LOG("  %4zu block types per chunk: section palettes %7u / %6zu, global palette %7u / %6zu, saved %5.1f %% / %5.1f %%",
+				NumKeys,
+				GetUncompressedSize(Palette), Palette.size(),
+				GetUncompressedSize(Global), Global.size(),
+				100.0 - 100.0 * GetUncompressedSize(Palette) / GetUncompressedSize(Global),
+				100.0 - 100.0 * Palette.size() / Global.size()
+			);
+		}
+	}
+	return 0;
+}
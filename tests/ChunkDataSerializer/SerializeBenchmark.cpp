@@ -0,0 +1,319 @@
+
+// SerializeBenchmark.cpp
+
+// Measures the chunk data serialization for each protocol version,
+// and the translation and packing of the 1.13 section data, the way it was done with the std::map against the dense table
+
+#include "Globals.h"
+#include "ByteBuffer.h"
+#include "ChunkData.h"
+#include "Endianness.h"
+#include "FastRandom.h"
+#include "Protocol/ChunkDataSerializer.h"
+
+
+
+
+
+/** Number of times each measurement is repeated. */
+static const int NUM_REPEATS = 200;
+
+/** The bits per entry used by the 1.13 global palette. */
+static const size_t GLOBAL_BITS_PER_ENTRY = 14;
+
+/** The number of longs in a 1.13 section sent using the global palette. */
+static const size_t GLOBAL_NUM_LONGS = cChunkData::SectionBlockCount * GLOBAL_BITS_PER_ENTRY / 64;
+
+
+
+
+
+/** Allocation pool that simply allocates each section on the heap. */
+class cTestPool:
+	public cAllocationPool<cChunkData::sChunkSection>
+{
+	virtual cChunkData::sChunkSection * Allocate() override
+	{
+		return new cChunkData::sChunkSection();
+	}
+
+	virtual void Free(cChunkData::sChunkSection * a_Ptr) override
+	{
+		delete a_Ptr;
+	}
+
+	virtual bool DoIsEqual(const cAllocationPool<cChunkData::sChunkSection> &) const noexcept override
+	{
+		return false;
+	}
+};
+
+
+
+
+
+/** A chunk to be serialized: the BLOCKTYPE * 16 + META keys for each block, the sections not listed are left empty. */
+struct sChunkSpec
+{
+	AString m_Name;
+	std::vector<std::vector<UInt16>> m_Sections;
+};
+
+
+
+
+
+/** Returns a section filled with random keys picked from a_Keys. */
+static std::vector<UInt16> RandomSection(cFastRandom & a_Random, const std::vector<UInt16> & a_Keys)
+{
+	std::vector<UInt16> Res(cChunkData::SectionBlockCount);
+	for (auto & Key: Res)
+	{
+		Key = a_Keys[a_Random.RandInt<size_t>(a_Keys.size() - 1)];
+	}
+	return Res;
+}
+
+
+
+
+
+/** Returns the chunks used for the measurements: plain terrain, a uniform chunk and a chunk with random blocks. */
+static std::vector<sChunkSpec> MakeChunkSpecs()
+{
+	cFastRandom Random;
+	std::vector<UInt16> Underground = {1 * 16, 1 * 16, 1 * 16, 1 * 16, 3 * 16, 13 * 16, 14 * 16, 15 * 16, 16 * 16, 56 * 16};  // Mostly stone, some ores
+	std::vector<UInt16> Surface = {0, 0, 0, 2 * 16, 3 * 16, 31 * 16 + 1, 17 * 16, 18 * 16};  // Air, grass, dirt, tall grass, a tree
+	std::vector<UInt16> AllKeys;
+	for (UInt16 Key = 0; Key < 4096; Key++)
+	{
+		AllKeys.push_back(Key);
+	}
+
+	std::vector<sChunkSpec> Res;
+	Res.push_back({"Terrain, 5 sections", {}});
+	for (int i = 0; i < 4; i++)
+	{
+		Res.back().m_Sections.push_back(RandomSection(Random, Underground));
+	}
+	Res.back().m_Sections.push_back(RandomSection(Random, Surface));
+	Res.push_back({"Uniform stone, 16 sections", std::vector<std::vector<UInt16>>(16, std::vector<UInt16>(cChunkData::SectionBlockCount, 1 * 16))});
+	Res.push_back({"Random blocks, 16 sections", {}});
+	for (int i = 0; i < 16; i++)
+	{
+		Res.back().m_Sections.push_back(RandomSection(Random, AllKeys));
+	}
+	return Res;
+}
+
+
+
+
+
+/** Fills a_Data with the blocks of the chunk spec, no block light and full skylight, so that only the listed sections are present. */
+static void FillChunk(cChunkData & a_Data, const sChunkSpec & a_Spec)
+{
+	std::unique_ptr<BLOCKTYPE[]>  BlockTypes(new BLOCKTYPE[cChunkDef::NumBlocks]);
+	std::unique_ptr<NIBBLETYPE[]> Metas     (new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::unique_ptr<NIBBLETYPE[]> BlockLight(new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::unique_ptr<NIBBLETYPE[]> SkyLight  (new NIBBLETYPE[cChunkDef::NumBlocks / 2]);
+	std::fill_n(BlockTypes.get(), cChunkDef::NumBlocks, 0);
+	std::fill_n(Metas.get(),      cChunkDef::NumBlocks / 2, 0);
+	std::fill_n(BlockLight.get(), cChunkDef::NumBlocks / 2, 0);
+	std::fill_n(SkyLight.get(),   cChunkDef::NumBlocks / 2, 0xff);
+	for (size_t SectionIdx = 0; SectionIdx < a_Spec.m_Sections.size(); SectionIdx++)
+	{
+		size_t Start = SectionIdx * cChunkData::SectionBlockCount;
+		for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
+		{
+			auto Key = a_Spec.m_Sections[SectionIdx][Index];
+			BlockTypes[Start + Index] = static_cast<BLOCKTYPE>(Key / 16);
+			Metas[(Start + Index) / 2] |= static_cast<NIBBLETYPE>((Key % 16) << (((Start + Index) % 2) * 4));
+		}
+	}
+	a_Data.SetBlockTypes(BlockTypes.get());
+	a_Data.SetMetas(Metas.get());
+	a_Data.SetBlockLight(BlockLight.get());
+	a_Data.SetSkyLight(SkyLight.get());
+}
+
+
+
+
+
+/** Returns the microseconds per call of a_Fn, averaged over NUM_REPEATS calls. */
+template <typename Fn>
+static double Measure(Fn a_Fn)
+{
+	auto Start = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_REPEATS; i++)
+	{
+		a_Fn();
+	}
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Start).count() / NUM_REPEATS;
+}
+
+
+
+
+
+/** Translates and packs a single section using the global palette the way Serialize393 used to:
+a std::map lookup for each block, each long written to the buffer separately. */
+static void PackSectionWithMap(const cChunkData::sChunkSection & a_Section, const std::map<UInt32, UInt32> & a_Map, cByteBuffer & a_Buffer)
+{
+	const UInt64 Mask = (static_cast<UInt64>(1) << GLOBAL_BITS_PER_ENTRY) - 1;
+	UInt64 TempLong = 0;
+	size_t CurrentlyWrittenIndex = 0;
+	for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
+	{
+		UInt32 BlockType = a_Section.m_BlockTypes[Index];
+		UInt32 BlockMeta = (a_Section.m_BlockMetas[Index / 2] >> ((Index % 2) * 4)) & 0x0f;
+		auto itr = a_Map.find(BlockType * 16 | BlockMeta);
+		UInt64 Value = ((itr == a_Map.end()) ? 0 : itr->second) & Mask;
+
+		size_t BitPosition = Index * GLOBAL_BITS_PER_ENTRY;
+		size_t FirstIndex = BitPosition / 64;
+		size_t SecondIndex = ((Index + 1) * GLOBAL_BITS_PER_ENTRY - 1) / 64;
+		size_t BitOffset = BitPosition % 64;
+		if (FirstIndex != CurrentlyWrittenIndex)
+		{
+			a_Buffer.WriteBEUInt64(TempLong);
+			TempLong = 0;
+			CurrentlyWrittenIndex = FirstIndex;
+		}
+		TempLong |= (Value << BitOffset);
+		if (FirstIndex != SecondIndex)
+		{
+			a_Buffer.WriteBEUInt64(TempLong);
+			CurrentlyWrittenIndex = SecondIndex;
+			TempLong = (Value >> (64 - BitOffset));
+		}
+	}
+	a_Buffer.WriteBEUInt64(TempLong);
+}
+
+
+
+
+
+/** Translates and packs a single section using the global palette the way Serialize393 does now:
+a dense table lookup for each block, the longs packed into an array and written to the buffer at once. */
+static void PackSectionWithTable(const cChunkData::sChunkSection & a_Section, const std::vector<UInt32> & a_Table, cByteBuffer & a_Buffer)
+{
+	const UInt64 Mask = (static_cast<UInt64>(1) << GLOBAL_BITS_PER_ENTRY) - 1;
+	UInt64 Longs[GLOBAL_NUM_LONGS] = {};
+	for (size_t Index = 0; Index < cChunkData::SectionBlockCount; Index++)
+	{
+		UInt32 BlockType = a_Section.m_BlockTypes[Index];
+		UInt32 BlockMeta = (a_Section.m_BlockMetas[Index / 2] >> ((Index % 2) * 4)) & 0x0f;
+		UInt64 Value = a_Table[BlockType * 16 | BlockMeta] & Mask;
+
+		size_t BitPosition = Index * GLOBAL_BITS_PER_ENTRY;
+		size_t LongIndex = BitPosition / 64;
+		size_t BitOffset = BitPosition % 64;
+		Longs[LongIndex] |= (Value << BitOffset);
+		if (BitOffset + GLOBAL_BITS_PER_ENTRY > 64)
+		{
+			Longs[LongIndex + 1] |= (Value >> (64 - BitOffset));
+		}
+	}
+	for (auto & Long: Longs)
+	{
+		Long = HostToNetwork8(&Long);
+	}
+	a_Buffer.WriteBuf(Longs, sizeof(Longs));
+}
+
+
+
+
+
+int main()
+{
+	// The BLOCKTYPE * 16 + META to NetBlockID mapping, both as the old std::map and the dense table:
+	std::vector<UInt32> Table;
+	std::map<UInt32, UInt32> Map;
+	for (UInt32 Key = 0; Key < 4096; Key++)
+	{
+		Table.push_back(Key * 3 + 1);
+		Map[Key] = Key * 3 + 1;
+	}
+
+	LOG("Chunk data serialization benchmark, %d repeats:", NUM_REPEATS);
+	unsigned char Biomes[cChunkDef::Width * cChunkDef::Width] = {};
+	for (const auto & Spec: MakeChunkSpecs())
+	{
+		cTestPool Pool;
+		cChunkData Data(Pool);
+		FillChunk(Data, Spec);
+
+		// The whole packet, including the compression; a new serializer each time, so that the cached serialization isn't used:
+		AString Versions;
+		for (int Version: {cChunkDataSerializer::RELEASE_1_8_0, cChunkDataSerializer::RELEASE_1_9_4, cChunkDataSerializer::RELEASE_1_13})
+		{
+			size_t Size = 0;
+			auto Time = Measure([&]()
+				{
+					cChunkDataSerializer Serializer(Data, Biomes, dimOverworld);
+					Size = Serializer.Serialize(Version, 0, 0, Table).size();
+				}
+			);
+			Versions.append(Printf(" %d: %7.1f us (%6zu bytes);", Version, Time, Size));
+		}
+		LOG("%s, whole packet per protocol:%s", Spec.m_Name.c_str(), Versions.c_str());
+
+		// The translation and packing of the sections alone, with the global palette; first check that both ways write the same data:
+		cByteBuffer Buffer(cChunkData::NumSections * GLOBAL_NUM_LONGS * 8 + 1);
+		for (size_t SectionIdx = 0; SectionIdx < cChunkData::NumSections; SectionIdx++)
+		{
+			auto Section = Data.GetSection(SectionIdx);
+			if (Section == nullptr)
+			{
+				continue;
+			}
+			AString Old, New;
+			PackSectionWithMap(*Section, Map, Buffer);
+			Buffer.ReadAll(Old);
+			Buffer.CommitRead();
+			PackSectionWithTable(*Section, Table, Buffer);
+			Buffer.ReadAll(New);
+			Buffer.CommitRead();
+			if (Old != New)
+			{
+				LOGERROR("%s: The packed data of section %zu differs", Spec.m_Name.c_str(), SectionIdx);
+				return 1;
+			}
+		}
+		auto PackAll = [&](auto a_PackSection)
+		{
+			return Measure([&]()
+				{
+					for (size_t SectionIdx = 0; SectionIdx < cChunkData::NumSections; SectionIdx++)
+					{
+						auto Section = Data.GetSection(SectionIdx);
+						if (Section != nullptr)
+						{
+							a_PackSection(*Section);
+						}
+					}
+					Buffer.SkipRead(Buffer.GetReadableSpace());
+					Buffer.CommitRead();
+				}
+			);
+		};
+		auto WithMap = PackAll([&](const cChunkData::sChunkSection & a_Section)
+			{
+				PackSectionWithMap(a_Section, Map, Buffer);
+			}
+		);
+		auto WithTable = PackAll([&](const cChunkData::sChunkSection & a_Section)
+			{
+				PackSectionWithTable(a_Section, Table, Buffer);
+			}
+		);
+		LOG("%s, 1.13 section data packing: std::map and separate longs %7.1f us, dense table and a single write %7.1f us",
+			Spec.m_Name.c_str(), WithMap, WithTable
+		);
+	}
+	return 0;
+}
@@ -0,0 +1,51 @@
+
+// Stubs.cpp
+
+// Implements stubs of various Cuberite methods that are needed for linking but not for runtime
+// This is required so that we don't bring in the entire Cuberite via dependencies
+
+#include "Globals.h"
+#include "zlib/zlib.h"
+#include "Protocol/Protocol_1_8.h"
+#include "UUID.h"
+
+
+
+
+
+void cUUID::FromRaw(const std::array<Byte, 16> &){}
+
+
+
+
+
+/** The serializer compresses its packets through the protocol; this mirrors the real implementation,
+so that the test can decompress the packet the same way the client would. */
+bool cProtocol_1_8_0::CompressPacket(const AString & a_Packet, AString & a_CompressedData)
+{
+	uLongf CompressedSize = compressBound(static_cast<uLongf>(a_Packet.size()));
+	AString CompressedData(CompressedSize, '\0');
+	int Status = compress2(
+		reinterpret_cast<Bytef *>(&CompressedData[0]), &CompressedSize,
+		reinterpret_cast<const Bytef *>(a_Packet.data()), static_cast<uLongf>(a_Packet.size()), Z_DEFAULT_COMPRESSION
+	);
+	if (Status != Z_OK)
+	{
+		return false;
+	}
+	CompressedData.resize(CompressedSize);
+
+	AString LengthData;
+	cByteBuffer Buffer(20);
+	Buffer.WriteVarInt32(static_cast<UInt32>(a_Packet.size()));
+	Buffer.ReadAll(LengthData);
+	Buffer.CommitRead();
+
+	Buffer.WriteVarInt32(static_cast<UInt32>(CompressedSize + LengthData.size()));
+	Buffer.WriteVarInt32(static_cast<UInt32>(a_Packet.size()));
+	Buffer.ReadAll(LengthData);
+	Buffer.CommitRead();
+
+	a_CompressedData = LengthData + CompressedData;
+	return true;
+}
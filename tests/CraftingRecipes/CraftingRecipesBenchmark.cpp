@@ -0,0 +1,232 @@
+
+// CraftingRecipesBenchmark.cpp
+
+// Measures the crafting recipe lookup using the signature index, against trying all the recipes one by one, as it used to be done
+
+#include "Globals.h"
+#include "CraftingRecipes.h"
+#include "FastRandom.h"
+
+
+
+
+
+/** Number of times the whole set of grids is looked up in a single measurement. */
+static const int NUM_PASSES = 20;
+
+
+
+
+
+/** Exposes the recipe lookups of cCraftingRecipes to the benchmark. */
+class cTestCraftingRecipes:
+	public cCraftingRecipes
+{
+public:
+
+	/** A crafting grid to be looked up, MAX_GRID_WIDTH * MAX_GRID_HEIGHT items. */
+	using cGrid = std::vector<cItem>;
+
+
+	/** Returns a grid for each of the loaded recipes, filled with the recipe's ingredients. */
+	std::vector<cGrid> CreateMatchingGrids(void) const
+	{
+		std::vector<cGrid> Res;
+		for (const auto Recipe: m_Recipes)
+		{
+			cGrid Grid(MAX_GRID_WIDTH * MAX_GRID_HEIGHT);
+			for (const auto & Slot: Recipe->m_Ingredients)
+			{
+				if ((Slot.x >= 0) && (Slot.y >= 0))
+				{
+					SetGridItem(Grid[static_cast<size_t>(Slot.x + MAX_GRID_WIDTH * Slot.y)], Slot.m_Item);
+				}
+			}
+			for (const auto & Slot: Recipe->m_Ingredients)
+			{
+				if ((Slot.x >= 0) && (Slot.y >= 0))
+				{
+					continue;
+				}
+				// An "anywhere" ingredient, put it into the first free cell:
+				for (auto & Item: Grid)
+				{
+					if (Item.IsEmpty())
+					{
+						SetGridItem(Item, Slot.m_Item);
+						break;
+					}
+				}
+			}
+			Res.push_back(std::move(Grid));
+		}
+		return Res;
+	}
+
+
+	/** Returns a_NumGrids grids with up to 4 random ingredients scattered around.
+	These are the grids that a player goes through while filling the crafting grid; most of them match no recipe. */
+	std::vector<cGrid> CreateRandomGrids(size_t a_NumGrids) const
+	{
+		// Collect all the ingredients used by the recipes:
+		std::vector<cItem> Ingredients;
+		for (const auto Recipe: m_Recipes)
+		{
+			for (const auto & Slot: Recipe->m_Ingredients)
+			{
+				Ingredients.push_back(Slot.m_Item);
+			}
+		}
+
+		cFastRandom Random;
+		std::vector<cGrid> Res;
+		for (size_t i = 0; i < a_NumGrids; ++i)
+		{
+			cGrid Grid(MAX_GRID_WIDTH * MAX_GRID_HEIGHT);
+			for (int NumItems = Random.RandInt(1, 4); NumItems > 0; --NumItems)
+			{
+				auto & Item = Grid[Random.RandInt<size_t>(Grid.size() - 1)];
+				SetGridItem(Item, Ingredients[Random.RandInt<size_t>(Ingredients.size() - 1)]);
+			}
+			Res.push_back(std::move(Grid));
+		}
+		return Res;
+	}
+
+
+	/** Looks the grid up using the signature index. Returns the resulting item, empty if no recipe matches. */
+	cItem FindIndexed(const cGrid & a_Grid)
+	{
+		std::unique_ptr<cRecipe> Recipe(FindRecipe(a_Grid.data(), MAX_GRID_WIDTH, MAX_GRID_HEIGHT));
+		return (Recipe == nullptr) ? cItem() : Recipe->m_Result;
+	}
+
+
+	/** Looks the grid up by trying all the recipes in their crafting.txt order, as FindRecipeCropped() did before the index.
+	Returns the resulting item, empty if no recipe matches. */
+	cItem FindLinear(const cGrid & a_Grid)
+	{
+		// Crop the grid the same way FindRecipe() does:
+		int GridLeft = MAX_GRID_WIDTH, GridTop = MAX_GRID_HEIGHT;
+		int GridRight = 0,  GridBottom = 0;
+		for (int y = 0; y < MAX_GRID_HEIGHT; y++) for (int x = 0; x < MAX_GRID_WIDTH; x++)
+		{
+			if (!a_Grid[static_cast<size_t>(x + y * MAX_GRID_WIDTH)].IsEmpty())
+			{
+				GridRight  = std::max(x, GridRight);
+				GridBottom = std::max(y, GridBottom);
+				GridLeft   = std::min(x, GridLeft);
+				GridTop    = std::min(y, GridTop);
+			}
+		}
+		int GridWidth = GridRight - GridLeft + 1;
+		int GridHeight = GridBottom - GridTop + 1;
+		const cItem * Grid = a_Grid.data() + GridLeft + (MAX_GRID_WIDTH * GridTop);
+
+		for (const auto Recipe: m_Recipes)
+		{
+			int MaxOfsX = GridWidth  - Recipe->m_Width;
+			int MaxOfsY = GridHeight - Recipe->m_Height;
+			for (int x = 0; x <= MaxOfsX; x++) for (int y = 0; y <= MaxOfsY; y++)
+			{
+				std::unique_ptr<cRecipe> Match(MatchRecipe(Grid, GridWidth, GridHeight, MAX_GRID_WIDTH, Recipe, x, y));
+				if (Match != nullptr)
+				{
+					return Match->m_Result;
+				}
+			}  // for y, for x
+		}  // for Recipe - m_Recipes[]
+		return cItem();
+	}
+
+
+	/** Returns the number of the loaded recipes. */
+	size_t GetNumRecipes(void) const
+	{
+		return m_Recipes.size();
+	}
+
+
+	/** Returns the number of the signature groups in the index. */
+	size_t GetNumSignatures(void) const
+	{
+		return m_RecipeIndex.size();
+	}
+
+protected:
+
+	/** Sets a single grid item to the ingredient, resolving a wildcard damage. */
+	static void SetGridItem(cItem & a_GridItem, const cItem & a_Ingredient)
+	{
+		a_GridItem = a_Ingredient;
+		a_GridItem.m_ItemCount = 1;
+		if (a_GridItem.m_ItemDamage < 0)
+		{
+			a_GridItem.m_ItemDamage = 0;
+		}
+	}
+};
+
+
+
+
+
+/** Looks up all the grids NUM_PASSES times with each of the ways, logs the times per lookup.
+Returns false if the two ways disagree on any grid's result. */
+static bool Measure(cTestCraftingRecipes & a_Recipes, const char * a_Name, const std::vector<cTestCraftingRecipes::cGrid> & a_Grids)
+{
+	// Check that both ways find the same recipes:
+	size_t NumMatched = 0;
+	for (const auto & Grid: a_Grids)
+	{
+		auto Indexed = a_Recipes.FindIndexed(Grid);
+		auto Linear = a_Recipes.FindLinear(Grid);
+		if (!Indexed.IsEqual(Linear) || (Indexed.m_ItemCount != Linear.m_ItemCount))
+		{
+			LOGERROR("%s: The index found item %d:%d, the linear search %d:%d",
+				a_Name, Indexed.m_ItemType, Indexed.m_ItemDamage, Linear.m_ItemType, Linear.m_ItemDamage
+			);
+			return false;
+		}
+		NumMatched += Indexed.IsEmpty() ? 0 : 1;
+	}
+
+	auto Time = [&](cItem (cTestCraftingRecipes::*a_Find)(const cTestCraftingRecipes::cGrid &))
+	{
+		auto Start = std::chrono::steady_clock::now();
+		for (int Pass = 0; Pass < NUM_PASSES; ++Pass)
+		{
+			for (const auto & Grid: a_Grids)
+			{
+				(a_Recipes.*a_Find)(Grid);
+			}
+		}
+		auto Duration = std::chrono::steady_clock::now() - Start;
+		return std::chrono::duration<double, std::micro>(Duration).count() / (NUM_PASSES * a_Grids.size());
+	};
+	auto Indexed = Time(&cTestCraftingRecipes::FindIndexed);
+	auto Linear = Time(&cTestCraftingRecipes::FindLinear);
+	LOG("%s (%zu grids, %zu matching a recipe): index %.2f us per lookup, linear search %.2f us per lookup",
+		a_Name, a_Grids.size(), NumMatched, Indexed, Linear
+	);
+	return true;
+}
+
+
+
+
+
+int main()
+{
+	cTestCraftingRecipes Recipes;
+	LOG("Crafting recipes benchmark: %zu recipes in %zu signature groups", Recipes.GetNumRecipes(), Recipes.GetNumSignatures());
+	if (Recipes.GetNumRecipes() == 0)
+	{
+		LOGERROR("No recipes loaded, crafting.txt and items.ini need to be in the current folder");
+		return 1;
+	}
+	bool IsOk =
+		Measure(Recipes, "A grid for each recipe", Recipes.CreateMatchingGrids()) &&
+		Measure(Recipes, "Random grids", Recipes.CreateRandomGrids(1000));
+	return IsOk ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+
+// EntityGridBenchmark.cpp
+
+// Measures the proximity queries in a crowded chunk, using the cEntityGrid spatial index and using a linear scan of all the chunk's entities
+
+#include "Globals.h"
+#include "BoundingBox.h"
+#include "EntityGrid.h"
+#include "FastRandom.h"
+#include "Entities/Entity.h"
+
+
+
+
+
+/** Minimum time that each measurement runs for. */
+static const std::chrono::milliseconds MIN_DURATION(500);
+
+
+
+
+
+/** A bare entity that can be created without a world. */
+class cTestEntity:
+	public cEntity
+{
+	using Super = cEntity;
+
+public:
+
+	cTestEntity(Vector3d a_Pos, double a_Width, double a_Height):
+		Super(etEntity, a_Pos, a_Width, a_Height)
+	{
+	}
+
+	virtual void SpawnOn(cClientHandle & a_Client) override
+	{
+	}
+};
+
+using cTestEntities = std::vector<std::unique_ptr<cTestEntity>>;
+
+
+
+
+
+/** A single scenario: the entities in the chunk and the boxes queried on each "tick". */
+struct sScenario
+{
+	AString m_Name;
+	cTestEntities m_Entities;
+	std::vector<cBoundingBox> m_Queries;
+};
+
+
+
+
+
+/** Runs the queries over and over again for at least MIN_DURATION, then logs the number of queries per second.
+a_Query is called for each box and returns the number of entities found, which is summed up so that the work can't be optimized away. */
+template <typename QueryFn>
+static void Measure(const AString & a_Name, const std::vector<cBoundingBox> & a_Queries, QueryFn a_Query)
+{
+	size_t NumFound = 0;
+	Int64 NumQueries = 0;
+	auto Start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::duration Elapsed;
+	do
+	{
+		for (const auto & Box: a_Queries)
+		{
+			NumFound += a_Query(Box);
+		}
+		NumQueries += static_cast<Int64>(a_Queries.size());
+		Elapsed = std::chrono::steady_clock::now() - Start;
+	} while (Elapsed < MIN_DURATION);
+
+	auto Seconds = std::chrono::duration<double>(Elapsed).count();
+	LOG("%-40s %10.0f queries/sec (%.1f entities per query)",
+		a_Name.c_str(), static_cast<double>(NumQueries) / Seconds, static_cast<double>(NumFound) / static_cast<double>(NumQueries)
+	);
+}
+
+
+
+
+
+/** Measures the scenario's queries using the grid and using a linear scan, the way cChunk answered them before the grid. */
+static void Benchmark(const sScenario & a_Scenario)
+{
+	LOG("%s: %zu entities, %zu queries per tick", a_Scenario.m_Name.c_str(), a_Scenario.m_Entities.size(), a_Scenario.m_Queries.size());
+
+	cEntityGrid Grid(0, 0);
+	for (const auto & Entity: a_Scenario.m_Entities)
+	{
+		Grid.Add(*Entity);
+	}
+	Measure("  grid", a_Scenario.m_Queries, [&Grid](const cBoundingBox & a_Box)
+		{
+			size_t NumFound = 0;
+			Grid.ForEachEntityInBox(a_Box, [&NumFound](cEntity & a_Entity)
+				{
+					NumFound += 1;
+					return false;
+				}
+			);
+			return NumFound;
+		}
+	);
+
+	const auto & Entities = a_Scenario.m_Entities;
+	Measure("  linear scan", a_Scenario.m_Queries, [&Entities](const cBoundingBox & a_Box)
+		{
+			size_t NumFound = 0;
+			for (const auto & Entity: Entities)
+			{
+				if (Entity->GetBoundingBox().DoesIntersect(a_Box))
+				{
+					NumFound += 1;
+				}
+			}
+			return NumFound;
+		}
+	);
+}
+
+
+
+
+
+/** A mob farm: mobs packed into a small spawning pit, plus the mobs wandering in the rest of the chunk.
+Each mob queries its surroundings, as for the collision push. */
+static sScenario MobFarm(int a_NumPacked, int a_NumWandering)
+{
+	cFastRandom Random;
+	sScenario Res;
+	Res.m_Name = Printf("Mob farm (%d packed, %d wandering)", a_NumPacked, a_NumWandering);
+	for (int i = 0; i < a_NumPacked; ++i)
+	{
+		Vector3d Pos(Random.RandReal(6.0, 10.0), Random.RandReal(64.0, 66.0), Random.RandReal(6.0, 10.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(Pos, 0.6, 1.95));
+	}
+	for (int i = 0; i < a_NumWandering; ++i)
+	{
+		Vector3d Pos(Random.RandReal(0.0, 16.0), Random.RandReal(40.0, 80.0), Random.RandReal(0.0, 16.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(Pos, 0.6, 1.95));
+	}
+	for (const auto & Entity: Res.m_Entities)
+	{
+		Res.m_Queries.emplace_back(Entity->GetPosition(), 0.3, 1.95);
+	}
+	return Res;
+}
+
+
+
+
+
+/** An item drop flood: pickups piled up around a single spot, each looking for the pickups to combine with,
+and a few players nearby collecting them. */
+static sScenario ItemFlood(int a_NumPickups, int a_NumPlayers)
+{
+	cFastRandom Random;
+	sScenario Res;
+	Res.m_Name = Printf("Item drop flood (%d pickups, %d players)", a_NumPickups, a_NumPlayers);
+	for (int i = 0; i < a_NumPickups; ++i)
+	{
+		Vector3d Pos(Random.RandReal(5.0, 11.0), 64.0, Random.RandReal(5.0, 11.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(Pos, 0.25, 0.25));
+		Res.m_Queries.emplace_back(Pos, 1.0, 0.25, 0.0);
+	}
+	for (int i = 0; i < a_NumPlayers; ++i)
+	{
+		Vector3d Pos(Random.RandReal(0.0, 16.0), 64.0, Random.RandReal(0.0, 16.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(Pos, 0.6, 1.8));
+		Res.m_Queries.emplace_back(Pos, 1.0, 1.8, 0.0);
+	}
+	return Res;
+}
+
+
+
+
+
+int main()
+{
+	LOG("EntityGrid benchmark");
+	Benchmark(MobFarm(50, 50));
+	Benchmark(MobFarm(400, 100));
+	Benchmark(ItemFlood(500, 4));
+	Benchmark(ItemFlood(3000, 4));
+	return 0;
+}
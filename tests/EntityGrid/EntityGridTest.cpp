@@ -0,0 +1,205 @@
+
+// EntityGridTest.cpp
+
+// Tests the cEntityGrid spatial index against a linear scan of all the entities
+
+#include "Globals.h"
+#include "../TestHelpers.h"
+#include "BoundingBox.h"
+#include "EntityGrid.h"
+#include "FastRandom.h"
+#include "Entities/Entity.h"
+
+
+
+
+
+/** A bare entity that can be created without a world. */
+class cTestEntity:
+	public cEntity
+{
+	using Super = cEntity;
+
+public:
+
+	cTestEntity(Vector3d a_Pos, double a_Width, double a_Height):
+		Super(etEntity, a_Pos, a_Width, a_Height)
+	{
+	}
+
+	virtual void SpawnOn(cClientHandle & a_Client) override
+	{
+	}
+};
+
+using cTestEntities = std::vector<std::unique_ptr<cTestEntity>>;
+
+
+
+
+
+/** Returns a random position in chunk [0, 0], or up to 4 blocks outside of it, as entities that haven't been moved to the neighbor chunk yet. */
+static Vector3d RandomPosition(cFastRandom & a_Random)
+{
+	return
+	{
+		a_Random.RandReal(-4.0, cChunkDef::Width + 4.0),
+		a_Random.RandReal(0.0, static_cast<double>(cChunkDef::Height)),
+		a_Random.RandReal(-4.0, cChunkDef::Width + 4.0)
+	};
+}
+
+
+
+
+
+/** Returns the entities whose bounding box intersects a_Box, by testing each one. */
+static std::set<cEntity *> LinearScan(const cTestEntities & a_Entities, const cBoundingBox & a_Box)
+{
+	std::set<cEntity *> Res;
+	for (const auto & Entity: a_Entities)
+	{
+		if (Entity->GetBoundingBox().DoesIntersect(a_Box))
+		{
+			Res.insert(Entity.get());
+		}
+	}
+	return Res;
+}
+
+
+
+
+
+/** Returns the entities that the grid reports for a_Box, checking that none is reported twice. */
+static std::set<cEntity *> GridQuery(const cEntityGrid & a_Grid, const cBoundingBox & a_Box)
+{
+	std::set<cEntity *> Res;
+	a_Grid.ForEachEntityInBox(a_Box, [&Res](cEntity & a_Entity)
+		{
+			TEST_TRUE(Res.insert(&a_Entity).second);
+			return false;
+		}
+	);
+	return Res;
+}
+
+
+
+
+
+/** Checks that the grid answers random box queries the same as the linear scan. */
+static void CheckQueries(const cEntityGrid & a_Grid, const cTestEntities & a_Entities, cFastRandom & a_Random)
+{
+	for (int i = 0; i < 200; ++i)
+	{
+		cBoundingBox Box(RandomPosition(a_Random), a_Random.RandReal(0.1, 10.0), a_Random.RandReal(0.1, 20.0));
+		TEST_EQUAL(GridQuery(a_Grid, Box), LinearScan(a_Entities, Box));
+	}
+}
+
+
+
+
+
+/** Checks the queries with entities of different sizes, after the entities move around and after some are removed. */
+static void TestQueries(void)
+{
+	cFastRandom Random;
+	cEntityGrid Grid(0, 0);
+	cTestEntities Entities;
+	for (int i = 0; i < 500; ++i)
+	{
+		Entities.push_back(cpp14::make_unique<cTestEntity>(RandomPosition(Random), Random.RandReal(0.25, 1.5), Random.RandReal(0.25, 3.0)));
+		Grid.Add(*Entities.back());
+	}
+	CheckQueries(Grid, Entities, Random);
+
+	// Move the entities around:
+	for (auto & Entity: Entities)
+	{
+		auto OldPosition = Entity->GetPosition();
+		Entity->SetPosition(RandomPosition(Random));
+		Grid.Move(*Entity, OldPosition);
+	}
+	CheckQueries(Grid, Entities, Random);
+
+	// Remove half of them:
+	for (size_t i = 0; i < Entities.size(); ++i)
+	{
+		Grid.Remove(*Entities[i]);
+		Entities.erase(Entities.begin() + static_cast<ptrdiff_t>(i));
+	}
+	CheckQueries(Grid, Entities, Random);
+}
+
+
+
+
+
+/** Checks that a callback may move the entities between the cells, including into the cells not yet enumerated. */
+static void TestMoveInCallback(void)
+{
+	cFastRandom Random;
+	cEntityGrid Grid(0, 0);
+	cTestEntities Entities;
+	for (int i = 0; i < 500; ++i)
+	{
+		Entities.push_back(cpp14::make_unique<cTestEntity>(RandomPosition(Random), 0.5, 1.0));
+		Grid.Add(*Entities.back());
+	}
+
+	cBoundingBox WholeChunk({-8.0, 0.0, -8.0}, {cChunkDef::Width + 8.0, cChunkDef::Height, cChunkDef::Width + 8.0});
+	auto Expected = LinearScan(Entities, WholeChunk);
+	std::set<cEntity *> Visited;
+	Grid.ForEachEntityInBox(WholeChunk, [&](cEntity & a_Entity)
+		{
+			TEST_TRUE(Visited.insert(&a_Entity).second);
+			auto OldPosition = a_Entity.GetPosition();
+			a_Entity.SetPosition(RandomPosition(Random));
+			Grid.Move(a_Entity, OldPosition);
+			return false;
+		}
+	);
+	TEST_EQUAL(Visited, Expected);
+	CheckQueries(Grid, Entities, Random);
+}
+
+
+
+
+
+/** Checks that moving or removing an entity that isn't in the grid doesn't add it to the grid. */
+static void TestUnknownEntity(void)
+{
+	cEntityGrid Grid(0, 0);
+	cTestEntity Known({1, 1, 1}, 0.5, 1.0);
+	cTestEntity Unknown({2, 2, 2}, 0.5, 1.0);
+	Grid.Add(Known);
+
+	Unknown.SetPosition({14, 100, 14});
+	#ifdef _DEBUG
+		TEST_ASSERTS(Grid.Move(Unknown, {2, 2, 2}));
+		TEST_ASSERTS(Grid.Remove(Unknown));
+	#else
+		Grid.Move(Unknown, {2, 2, 2});
+		Grid.Remove(Unknown);
+	#endif
+
+	cBoundingBox WholeChunk({-8.0, 0.0, -8.0}, {cChunkDef::Width + 8.0, cChunkDef::Height, cChunkDef::Width + 8.0});
+	TEST_EQUAL(GridQuery(Grid, WholeChunk), std::set<cEntity *>({&Known}));
+
+	// The known entity is still counted, removing it works:
+	Grid.Remove(Known);
+	TEST_EQUAL(GridQuery(Grid, WholeChunk), std::set<cEntity *>());
+}
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("EntityGrid",
+	TestQueries();
+	TestMoveInCallback();
+	TestUnknownEntity();
+)
@@ -0,0 +1,275 @@
+
+// PickupScanBenchmark.cpp
+
+// Measures the per-tick pickup scans of a chunk full of items: the players collecting the pickups (cChunk::CollectPickupsByPlayer())
+// and the pickups on the ground looking for pickups to combine with (cPickup::Tick()), using the entity grid and using a linear scan
+
+#include "Globals.h"
+#include "BoundingBox.h"
+#include "EntityGrid.h"
+#include "FastRandom.h"
+#include "Entities/Entity.h"
+
+
+
+
+
+/** Number of ticks measured in each scenario. */
+static const int NUM_TICKS = 100;
+
+
+
+
+
+/** A bare entity of the specified type that can be created without a world. */
+class cTestEntity:
+	public cEntity
+{
+	using Super = cEntity;
+
+public:
+
+	cTestEntity(eEntityType a_EntityType, Vector3d a_Pos, double a_Width, double a_Height):
+		Super(a_EntityType, a_Pos, a_Width, a_Height)
+	{
+	}
+
+	virtual void SpawnOn(cClientHandle & a_Client) override
+	{
+	}
+};
+
+using cTestEntities = std::vector<std::unique_ptr<cTestEntity>>;
+
+
+
+
+
+/** A chunk full of items: the pickups, some mobs and the players standing among them. */
+struct sScenario
+{
+	AString m_Name;
+	cTestEntities m_Entities;
+	std::vector<cEntity *> m_Pickups;
+	std::vector<cEntity *> m_Players;
+};
+
+
+
+
+
+/** Returns the box in which a player collects the pickups, same as cChunk::CollectPickupsByPlayer(). */
+static cBoundingBox CollectionBox(const cEntity & a_Player)
+{
+	auto Box = a_Player.GetBoundingBox();
+	Box.Expand(1, 0.5, 1);
+	return Box;
+}
+
+
+
+
+
+/** Returns true if the entity would be collected from within a_Box, same as in cChunk::CollectPickupsByPlayer(). */
+static bool IsCollectable(cEntity & a_Entity, cBoundingBox & a_Box)
+{
+	return (a_Entity.IsPickup() || a_Entity.IsProjectile()) && a_Box.IsInside(a_Entity.GetPosition());
+}
+
+
+
+
+
+/** Returns true if a_Other is a pickup close enough to a_Pickup to combine with, same as cPickupCombiningCallback does. */
+static bool IsCombinable(cEntity & a_Other, const cEntity & a_Pickup)
+{
+	return a_Other.IsPickup() && (&a_Other != &a_Pickup) && ((a_Other.GetPosition() - a_Pickup.GetPosition()).Length() < 1.2);
+}
+
+
+
+
+
+/** Calls a_Callback for each of the entities, the way cChunk::ForEachEntity() did before the grid. */
+static bool ForEachEntityLinear(const cTestEntities & a_Entities, cEntityCallback a_Callback)
+{
+	for (const auto & Entity: a_Entities)
+	{
+		if (a_Callback(*Entity))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+
+
+/** Runs NUM_TICKS ticks of both scans, using the grid the way cChunk and cPickup do now, and using the linear scan over all the chunk's entities.
+Logs the per-tick times, checks that both ways find the same entities. */
+static bool Measure(const sScenario & a_Scenario)
+{
+	cEntityGrid Grid(0, 0);
+	for (const auto & Entity: a_Scenario.m_Entities)
+	{
+		Grid.Add(*Entity);
+	}
+
+	std::chrono::steady_clock::duration GridCollect{}, LinearCollect{}, GridCombine{}, LinearCombine{};
+	size_t GridFound = 0, LinearFound = 0;
+	std::vector<cEntity *> Collectables;
+	for (int Tick = 0; Tick < NUM_TICKS; ++Tick)
+	{
+		// The players collecting, via the grid:
+		auto Start = std::chrono::steady_clock::now();
+		for (auto Player: a_Scenario.m_Players)
+		{
+			auto Box = CollectionBox(*Player);
+			Collectables.clear();
+			Grid.ForEachEntityInBox(Box, [&](cEntity & a_Entity)
+				{
+					if (IsCollectable(a_Entity, Box))
+					{
+						Collectables.push_back(&a_Entity);
+					}
+					return false;
+				}
+			);
+			GridFound += Collectables.size();
+		}
+		GridCollect += std::chrono::steady_clock::now() - Start;
+
+		// The players collecting, via the linear scan:
+		Start = std::chrono::steady_clock::now();
+		for (auto Player: a_Scenario.m_Players)
+		{
+			auto Box = CollectionBox(*Player);
+			ForEachEntityLinear(a_Scenario.m_Entities, [&](cEntity & a_Entity)
+				{
+					LinearFound += IsCollectable(a_Entity, Box) ? 1 : 0;
+					return false;
+				}
+			);
+		}
+		LinearCollect += std::chrono::steady_clock::now() - Start;
+
+		// The pickups looking for a pickup to combine with, via the grid, in the cube that cPickup::Tick() queries:
+		Start = std::chrono::steady_clock::now();
+		for (auto Pickup: a_Scenario.m_Pickups)
+		{
+			Grid.ForEachEntityInBox(cBoundingBox(Pickup->GetPosition(), 2 * 1.2), [&](cEntity & a_Entity)
+				{
+					GridFound += IsCombinable(a_Entity, *Pickup) ? 1 : 0;
+					return false;
+				}
+			);
+		}
+		GridCombine += std::chrono::steady_clock::now() - Start;
+
+		// The pickups looking for a pickup to combine with, via the linear scan:
+		Start = std::chrono::steady_clock::now();
+		for (auto Pickup: a_Scenario.m_Pickups)
+		{
+			ForEachEntityLinear(a_Scenario.m_Entities, [&](cEntity & a_Entity)
+				{
+					LinearFound += IsCombinable(a_Entity, *Pickup) ? 1 : 0;
+					return false;
+				}
+			);
+		}
+		LinearCombine += std::chrono::steady_clock::now() - Start;
+	}
+
+	auto PerTick = [](std::chrono::steady_clock::duration a_Duration)
+	{
+		return std::chrono::duration<double, std::micro>(a_Duration).count() / NUM_TICKS;
+	};
+	LOG("%s:", a_Scenario.m_Name.c_str());
+	LOG("  collecting: grid %9.1f us/tick, linear scan %9.1f us/tick", PerTick(GridCollect), PerTick(LinearCollect));
+	LOG("  combining:  grid %9.1f us/tick, linear scan %9.1f us/tick", PerTick(GridCombine), PerTick(LinearCombine));
+	if (GridFound != LinearFound)
+	{
+		LOG("  The grid found %zu entities, the linear scan %zu", GridFound, LinearFound);
+		return false;
+	}
+	return true;
+}
+
+
+
+
+
+/** An item farm's collection floor: the pickups dropped over a few blocks, a few mobs waiting to be killed, and the players standing around. */
+static sScenario ItemFarm(int a_NumPickups, int a_NumMobs, int a_NumPlayers)
+{
+	cFastRandom Random;
+	sScenario Res;
+	Res.m_Name = Printf("Item farm (%d pickups, %d mobs, %d players)", a_NumPickups, a_NumMobs, a_NumPlayers);
+	for (int i = 0; i < a_NumPickups; ++i)
+	{
+		Vector3d Pos(Random.RandReal(4.0, 12.0), 64.0, Random.RandReal(4.0, 12.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(cEntity::etPickup, Pos, 0.25, 0.25));
+		Res.m_Pickups.push_back(Res.m_Entities.back().get());
+	}
+	for (int i = 0; i < a_NumMobs; ++i)
+	{
+		Vector3d Pos(Random.RandReal(0.0, 16.0), Random.RandReal(64.0, 70.0), Random.RandReal(0.0, 16.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(cEntity::etMonster, Pos, 0.6, 1.95));
+	}
+	for (int i = 0; i < a_NumPlayers; ++i)
+	{
+		Vector3d Pos(Random.RandReal(0.0, 16.0), 64.0, Random.RandReal(0.0, 16.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(cEntity::etPlayer, Pos, 0.6, 1.8));
+		Res.m_Players.push_back(Res.m_Entities.back().get());
+	}
+	return Res;
+}
+
+
+
+
+
+/** Drops scattered over the whole chunk, as left by a mob grinder or an explosion: the pickups lie on several levels,
+far apart compared to the merge distance. */
+static sScenario ScatteredDrops(int a_NumPickups, int a_NumMobs, int a_NumPlayers)
+{
+	cFastRandom Random;
+	sScenario Res;
+	Res.m_Name = Printf("Scattered drops (%d pickups, %d mobs, %d players)", a_NumPickups, a_NumMobs, a_NumPlayers);
+	for (int i = 0; i < a_NumPickups; ++i)
+	{
+		Vector3d Pos(Random.RandReal(0.0, 16.0), 40.0 + 8 * Random.RandInt(0, 7), Random.RandReal(0.0, 16.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(cEntity::etPickup, Pos, 0.25, 0.25));
+		Res.m_Pickups.push_back(Res.m_Entities.back().get());
+	}
+	for (int i = 0; i < a_NumMobs; ++i)
+	{
+		Vector3d Pos(Random.RandReal(0.0, 16.0), 40.0 + 8 * Random.RandInt(0, 7), Random.RandReal(0.0, 16.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(cEntity::etMonster, Pos, 0.6, 1.95));
+	}
+	for (int i = 0; i < a_NumPlayers; ++i)
+	{
+		Vector3d Pos(Random.RandReal(0.0, 16.0), 40.0 + 8 * Random.RandInt(0, 7), Random.RandReal(0.0, 16.0));
+		Res.m_Entities.push_back(cpp14::make_unique<cTestEntity>(cEntity::etPlayer, Pos, 0.6, 1.8));
+		Res.m_Players.push_back(Res.m_Entities.back().get());
+	}
+	return Res;
+}
+
+
+
+
+
+int main()
+{
+	LOG("Pickup scan benchmark, %d ticks per scenario:", NUM_TICKS);
+	bool IsOk =
+		Measure(ItemFarm(50, 10, 2)) &&
+		Measure(ItemFarm(500, 50, 4)) &&
+		Measure(ItemFarm(3000, 50, 8)) &&
+		Measure(ScatteredDrops(500, 50, 4)) &&
+		Measure(ScatteredDrops(3000, 50, 8));
+	return IsOk ? 0 : 1;
+}
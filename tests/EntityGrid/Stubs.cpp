@@ -0,0 +1,572 @@
+
+// Stubs.cpp
+
+// Implements stubs of various Cuberite methods that are needed for linking but not for runtime
+// This is required so that we don't bring in the entire Cuberite via dependencies
+
+#include "Globals.h"
+#include "BlockInfo.h"
+#include "Chunk.h"
+#include "ChunkMap.h"
+#include "ClientHandle.h"
+#include "Enchantments.h"
+#include "Inventory.h"
+#include "Item.h"
+#include "LineBlockTracer.h"
+#include "NetherPortalScanner.h"
+#include "Root.h"
+#include "Statistics.h"
+#include "World.h"
+#include "Bindings/PluginManager.h"
+#include "Entities/Pawn.h"
+#include "Entities/Player.h"
+#include "Mobs/Monster.h"
+#include "Simulator/FluidSimulator.h"
+
+
+
+
+
+cRoot * cRoot::s_Root = nullptr;
+
+
+
+
+
+bool IsBlockWater(BLOCKTYPE a_BlockType)
+{
+	return false;
+}
+
+
+
+
+
+bool IsBlockLava(BLOCKTYPE a_BlockType)
+{
+	return false;
+}
+
+
+
+
+
+void PrintStackTrace(void)
+{
+}
+
+
+
+
+
+AString DimensionToString(eDimension a_Dimension)
+{
+	return "";
+}
+
+
+
+
+
+cBlockInfo::cBlockInfoArray::cBlockInfoArray()
+{
+}
+
+
+
+
+
+cBlockInfo::cBlockInfo()
+{
+}
+
+
+
+
+
+void cBlockInfo::sHandlerDeleter::operator () (cBlockHandler * a_Handler)
+{
+}
+
+
+
+
+
+StatValue cStatManager::AddValue(const eStatistic a_Stat, const StatValue a_Delta)
+{
+	return 0;
+}
+
+
+
+
+
+void cClientHandle::SendRespawn(eDimension a_Dimension, bool a_ShouldIgnoreDimensionChecks)
+{
+}
+
+
+
+
+
+cPluginManager * cPluginManager::Get(void)
+{
+	return nullptr;
+}
+
+
+
+
+
+bool cPluginManager::CallHookEntityTeleport(cEntity & a_Entity, const Vector3d & a_OldPosition, const Vector3d & a_NewPosition)
+{
+	return false;
+}
+
+
+
+
+
+bool cPluginManager::CallHookEntityChangingWorld(cEntity & a_Entity, cWorld & a_World)
+{
+	return false;
+}
+
+
+
+
+
+bool cPluginManager::CallHookEntityChangedWorld(cEntity & a_Entity, cWorld & a_World)
+{
+	return false;
+}
+
+
+
+
+
+bool cPluginManager::CallHookKilling(cEntity & a_Victim, cEntity * a_Killer, TakeDamageInfo & a_TDI)
+{
+	return false;
+}
+
+
+
+
+
+bool cPluginManager::CallHookSpawningEntity(cWorld & a_World, cEntity & a_Entity)
+{
+	return false;
+}
+
+
+
+
+
+bool cPluginManager::CallHookTakeDamage(cEntity & a_Receiver, TakeDamageInfo & a_TDI)
+{
+	return false;
+}
+
+
+
+
+
+Vector3f cFluidSimulator::GetFlowingDirection(cChunk & a_Chunk, Vector3i a_RelPos)
+{
+	return {};
+}
+
+
+
+
+
+bool cLineBlockTracer::FirstSolidHitTrace(
+	cChunk & a_Chunk,
+	const Vector3d & a_Start, const Vector3d & a_End,
+	Vector3d & a_HitCoords,
+	Vector3i & a_HitBlockCoords,
+	eBlockFace & a_HitBlockFace
+)
+{
+	return false;
+}
+
+
+
+
+
+cNetherPortalScanner::cNetherPortalScanner(cEntity & a_MovingEntity, cWorld & a_DestinationWorld, Vector3d a_DestPosition, int a_MaxY) :
+	m_SourceWorld(a_DestinationWorld),
+	m_World(a_DestinationWorld)
+{
+}
+
+
+
+
+
+void cNetherPortalScanner::OnChunkAvailable(int a_ChunkX, int a_ChunkY)
+{
+}
+
+
+
+
+
+bool cNetherPortalScanner::OnAllChunksAvailable(void)
+{
+	return false;
+}
+
+
+
+
+
+void cNetherPortalScanner::OnDisabled(void)
+{
+}
+
+
+
+
+
+cItem::cItem(void)
+{
+}
+
+
+
+
+
+cItemHandler * cItem::GetHandler(void) const
+{
+	return nullptr;
+}
+
+
+
+
+
+unsigned int cEnchantments::GetLevel(int a_EnchantmentID) const
+{
+	return 0;
+}
+
+
+
+
+
+const cItem & cInventory::GetEquippedItem(void) const
+{
+	static cItem Item;
+	return Item;
+}
+
+
+
+
+
+void cPawn::AddEntityEffect(cEntityEffect::eType a_EffectType, int a_EffectDurationTicks, short a_IntensityLevel, double a_DistanceModifier)
+{
+}
+
+
+
+
+
+cWorld * cPlayer::GetBedWorld()
+{
+	return nullptr;
+}
+
+
+
+
+
+unsigned int cPlayer::AwardAchievement(const eStatistic a_Ach)
+{
+	return 0;
+}
+
+
+
+
+
+bool cPlayer::IsGameModeCreative(void) const
+{
+	return false;
+}
+
+
+
+
+
+bool cPlayer::IsGameModeSpectator(void) const
+{
+	return false;
+}
+
+
+
+
+
+void cMonster::Unleash(bool a_ShouldDropLeashPickup, bool a_ShouldBroadcast)
+{
+}
+
+
+
+
+
+BLOCKTYPE cChunkMap::GetBlock(Vector3i a_BlockPos)
+{
+	return E_BLOCK_AIR;
+}
+
+
+
+
+
+cChunk * cChunk::GetNeighborChunk(int a_BlockX, int a_BlockZ)
+{
+	return nullptr;
+}
+
+
+
+
+
+bool cChunk::UnboundedRelGetBlockType(Vector3i a_RelCoords, BLOCKTYPE & a_BlockType) const
+{
+	return false;
+}
+
+
+
+
+
+// The entities in the tests aren't in any chunk, they move within a standalone cEntityGrid:
+void cChunk::EntityMoved(cEntity & a_Entity, Vector3d a_OldPosition)
+{
+}
+
+
+
+
+
+void cChunk::EntityResized(cEntity & a_Entity)
+{
+}
+
+
+
+
+
+bool cWorld::HasEntity(UInt32 a_UniqueID)
+{
+	return false;
+}
+
+
+
+
+
+OwnedEntity cWorld::RemoveEntity(cEntity & a_Entity)
+{
+	return nullptr;
+}
+
+
+
+
+
+bool cWorld::DoWithEntityByID(UInt32 a_UniqueID, cEntityCallback a_Callback)
+{
+	return false;
+}
+
+
+
+
+
+void cWorld::SpawnItemPickups(const cItems & a_Pickups, Vector3d a_Pos, double a_FlyAwaySpeed, bool a_IsPlayerCreated)
+{
+}
+
+
+
+
+
+bool cWorld::IsWeatherWetAtXYZ(Vector3i a_Pos)
+{
+	return false;
+}
+
+
+
+
+
+void cWorld::BroadcastAttachEntity(const cEntity & a_Entity, const cEntity & a_Vehicle)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastDestroyEntity(const cEntity & a_Entity, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastDetachEntity(const cEntity & a_Entity, const cEntity & a_PreviousVehicle)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastEntityHeadLook(const cEntity & a_Entity, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastEntityLook(const cEntity & a_Entity, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastEntityMetadata(const cEntity & a_Entity, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastEntityPosition(const cEntity & a_Entity, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastEntityStatus(const cEntity & a_Entity, Int8 a_Status, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastEntityVelocity(const cEntity & a_Entity, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastEntityAnimation(const cEntity & a_Entity, Int8 a_Animation, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastLeashEntity(const cEntity & a_Entity, const cEntity & a_EntityLeashedTo)
+{
+}
+
+
+
+
+
+void cWorld::BroadcastSpawnEntity(cEntity & a_Entity, const cClientHandle * a_Exclude)
+{
+}
+
+
+
+
+
+
+cChunkStay::cChunkStay(void) :
+	m_ChunkMap(nullptr)
+{
+}
+
+
+
+
+
+cChunkStay::~cChunkStay()
+{
+}
+
+
+
+
+
+void cChunkStay::Disable(void)
+{
+}
+
+
+
+
+
+cEnchantments::cEnchantments(void)
+{
+}
+
+
+
+
+
+bool cPluginManager::CallHookKilled(cEntity & a_Victim, TakeDamageInfo & a_TDI, AString & a_DeathMessage)
+{
+	return false;
+}
+
+
+
+
+
+cWorld * cRoot::GetWorld(const AString & a_WorldName)
+{
+	return nullptr;
+}
+
+
+
+
+
+void cWorld::AddEntity(OwnedEntity a_Entity)
+{
+}
+
+
+
+
+
+void cWorld::QueueTask(std::function<void(cWorld &)> a_Task)
+{
+}
+
+
+
+
@@ -0,0 +1,412 @@
+
+// PickupPhysicsBenchmark.cpp
+
+// Measures the physics stepping of 20k item pickups falling onto terrain,
+// stepping each entity object in turn against stepping the same physics over contiguous position / speed arrays
+
+#include "Globals.h"
+#include "ChunkData.h"
+#include "FastRandom.h"
+#include "Entities/Entity.h"
+
+
+
+
+
+/** Number of pickups falling onto the terrain. */
+static const int NUM_PICKUPS = 20000;
+
+/** Size of the terrain, in chunks, in each direction. */
+static const int NUM_CHUNKS = 4;
+
+/** Number of ticks simulated in a single run; enough for all the pickups to land and settle. */
+static const int NUM_TICKS = 100;
+
+/** Length of a single tick, in seconds. */
+static const double DT = 0.05;
+
+/** The pickup's physics constants, as set by cPickup's constructor. */
+static const double GRAVITY = -16.0;
+static const double AIR_DRAG = 0.02;
+
+/** Number of runs measured for each of the stepping methods; the fastest one is reported. */
+static const int NUM_RUNS = 5;
+
+
+
+
+
+/** Allocates the chunk sections straight from the heap. */
+class cHeapPool:
+	public cAllocationPool<cChunkData::sChunkSection>
+{
+	virtual cChunkData::sChunkSection * Allocate() override
+	{
+		return new cChunkData::sChunkSection();
+	}
+
+	virtual void Free(cChunkData::sChunkSection * a_Ptr) override
+	{
+		delete a_Ptr;
+	}
+
+	virtual bool DoIsEqual(const cAllocationPool<cChunkData::sChunkSection> &) const noexcept override
+	{
+		return false;
+	}
+};
+
+
+
+
+
+/** Rolling hills of NUM_CHUNKS x NUM_CHUNKS chunks, with the valleys flooded by water. */
+class cTerrain
+{
+public:
+
+	cTerrain(void)
+	{
+		for (int cz = 0; cz < NUM_CHUNKS; ++cz)
+		{
+			for (int cx = 0; cx < NUM_CHUNKS; ++cx)
+			{
+				m_Chunks.emplace_back(m_Pool);
+				auto & Chunk = m_Chunks.back();
+				for (int z = 0; z < cChunkDef::Width; ++z)
+				{
+					for (int x = 0; x < cChunkDef::Width; ++x)
+					{
+						auto BlockX = cx * cChunkDef::Width + x;
+						auto BlockZ = cz * cChunkDef::Width + z;
+						auto Height = static_cast<int>(62 + 4 * std::sin(BlockX / 7.0) + 3 * std::cos(BlockZ / 5.0));
+						for (int y = 0; y < Height; ++y)
+						{
+							Chunk.SetBlock({x, y, z}, (y == Height - 1) ? E_BLOCK_GRASS : E_BLOCK_STONE);
+						}
+						for (int y = Height; y < SEA_LEVEL; ++y)
+						{
+							Chunk.SetBlock({x, y, z}, E_BLOCK_WATER);
+						}
+					}  // for x
+				}  // for z
+			}  // for cx
+		}  // for cz
+	}
+
+
+	/** Returns the block at the specified world coords.
+	Air outside of the terrain, bedrock below it. */
+	BLOCKTYPE GetBlock(Vector3i a_Pos) const
+	{
+		if (a_Pos.y < 0)
+		{
+			return E_BLOCK_BEDROCK;
+		}
+		if (
+			(a_Pos.x < 0) || (a_Pos.x >= NUM_CHUNKS * cChunkDef::Width) ||
+			(a_Pos.z < 0) || (a_Pos.z >= NUM_CHUNKS * cChunkDef::Width) ||
+			(a_Pos.y >= cChunkDef::Height)
+		)
+		{
+			return E_BLOCK_AIR;
+		}
+		const auto & Chunk = m_Chunks[static_cast<size_t>(a_Pos.x / cChunkDef::Width + NUM_CHUNKS * (a_Pos.z / cChunkDef::Width))];
+		return Chunk.GetBlock({a_Pos.x % cChunkDef::Width, a_Pos.y, a_Pos.z % cChunkDef::Width});
+	}
+
+
+	/** Returns true if the block at the specified world coords stops a falling pickup. */
+	bool IsSolid(Vector3i a_Pos) const
+	{
+		auto Block = GetBlock(a_Pos);
+		return ((Block != E_BLOCK_AIR) && (Block != E_BLOCK_WATER));
+	}
+
+protected:
+
+	static const int SEA_LEVEL = 62;
+
+	cHeapPool m_Pool;
+	std::vector<cChunkData> m_Chunks;
+};
+
+
+
+
+
+/** Slows down the horizontal speed, same as cEntity::ApplyFriction(). */
+static void ApplyFriction(Vector3d & a_Speed, double a_SlowdownMultiplier)
+{
+	if (a_Speed.SqrLength() > 0.0004)
+	{
+		a_Speed.x *= a_SlowdownMultiplier / (1 + DT);
+		if (std::abs(a_Speed.x) < 0.05)
+		{
+			a_Speed.x = 0;
+		}
+		a_Speed.z *= a_SlowdownMultiplier / (1 + DT);
+		if (std::abs(a_Speed.z) < 0.05)
+		{
+			a_Speed.z = 0;
+		}
+	}
+}
+
+
+
+
+
+/** Advances a single pickup by one tick, taking the steps that cEntity::HandlePhysics() takes for a pickup:
+falls off the ground when the block below is gone, falls under gravity and air drag (slower in water), slows down on the ground,
+and stops on the first solid block in the way. Both of the stepping methods use this, so that they only differ in the data layout. */
+static void StepPickup(const cTerrain & a_Terrain, Vector3d & a_Pos, Vector3d & a_Speed, bool & a_IsOnGround)
+{
+	auto BlockPos = a_Pos.Floor();
+	if (a_IsOnGround && !a_Terrain.IsSolid(BlockPos.addedY(-1)))
+	{
+		a_IsOnGround = false;
+	}
+	if (a_IsOnGround)
+	{
+		ApplyFriction(a_Speed, 0.7);
+	}
+	else if (a_Terrain.GetBlock(BlockPos) == E_BLOCK_WATER)
+	{
+		ApplyFriction(a_Speed, 0.7);
+		a_Speed.y += GRAVITY * DT / 3;
+	}
+	else
+	{
+		a_Speed -= a_Speed * (AIR_DRAG * 20) * DT;
+		a_Speed.y += GRAVITY * DT;
+	}
+	if (a_Speed.SqrLength() == 0)
+	{
+		return;
+	}
+
+	// Stop horizontally at a wall:
+	auto NextPos = a_Pos + a_Speed * DT;
+	if (a_Terrain.IsSolid({FloorC(NextPos.x), BlockPos.y, FloorC(NextPos.z)}))
+	{
+		NextPos.x = a_Pos.x;
+		NextPos.z = a_Pos.z;
+		a_Speed.x = 0;
+		a_Speed.z = 0;
+	}
+
+	// Land on the first solid block below:
+	auto NextBlockX = FloorC(NextPos.x);
+	auto NextBlockZ = FloorC(NextPos.z);
+	for (int y = BlockPos.y - 1; y >= FloorC(NextPos.y); --y)
+	{
+		if (a_Terrain.IsSolid({NextBlockX, y, NextBlockZ}))
+		{
+			NextPos.y = y + 1;
+			a_Speed.y = 0;
+			a_IsOnGround = true;
+			break;
+		}
+	}
+	a_Pos = NextPos;
+}
+
+
+
+
+
+/** A pickup stored and stepped the way the server does it: a separately allocated entity object, stepped through a virtual call. */
+class cBenchPickup:
+	public cEntity
+{
+	using Super = cEntity;
+
+public:
+
+	cBenchPickup(Vector3d a_Pos, Vector3d a_Speed):
+		Super(etPickup, a_Pos, 0.25, 0.25)
+	{
+		SetSpeed(a_Speed);
+	}
+
+	virtual void SpawnOn(cClientHandle & a_Client) override
+	{
+	}
+
+	/** Puts the pickup back into the air, at the specified position. */
+	void Reset(Vector3d a_Pos, Vector3d a_Speed)
+	{
+		SetPosition(a_Pos);
+		SetSpeed(a_Speed);
+		m_bOnGround = false;
+	}
+
+	virtual void StepPhysics(const cTerrain & a_Terrain)
+	{
+		auto Pos = GetPosition();
+		auto Speed = GetSpeed();
+		StepPickup(a_Terrain, Pos, Speed, m_bOnGround);
+		SetSpeed(Speed);
+		SetPosition(Pos);
+	}
+};
+
+
+
+
+
+/** The pickups' physics state in contiguous arrays, stepped in a single pass. */
+struct sPickupArrays
+{
+	std::vector<Vector3d> m_Pos;
+	std::vector<Vector3d> m_Speed;
+	std::vector<char> m_IsOnGround;  // char rather than bool, so that the elements are addressable
+
+	void Step(const cTerrain & a_Terrain)
+	{
+		for (size_t i = 0, Count = m_Pos.size(); i < Count; ++i)
+		{
+			bool IsOnGround = (m_IsOnGround[i] != 0);
+			StepPickup(a_Terrain, m_Pos[i], m_Speed[i], IsOnGround);
+			m_IsOnGround[i] = IsOnGround;
+		}
+	}
+};
+
+
+
+
+
+/** The initial positions and speeds of the pickups, the same for each run. */
+struct sDrop
+{
+	Vector3d m_Pos;
+	Vector3d m_Speed;
+};
+
+
+
+
+
+/** Returns the pickups thrown into the air above the terrain, as from blocks broken by an explosion. */
+static std::vector<sDrop> MakeDrops(void)
+{
+	cFastRandom Random;
+	std::vector<sDrop> Res;
+	Res.reserve(NUM_PICKUPS);
+	auto Size = static_cast<double>(NUM_CHUNKS * cChunkDef::Width);
+	for (int i = 0; i < NUM_PICKUPS; ++i)
+	{
+		Res.push_back({
+			{Random.RandReal(0.0, Size), Random.RandReal(70.0, 90.0), Random.RandReal(0.0, Size)},
+			{Random.RandReal(-2.0, 2.0), Random.RandReal(0.0, 4.0), Random.RandReal(-2.0, 2.0)}
+		});
+	}
+	return Res;
+}
+
+
+
+
+
+/** Runs the stepping function for NUM_TICKS ticks, NUM_RUNS times, and logs the time per tick of the fastest run.
+a_Reset is called before each run to put the pickups into their initial state, a_Step steps all of them by a single tick.
+Returns the sum of the pickups' final heights, for checking that both methods computed the same thing. */
+template <typename ResetFn, typename StepFn, typename HeightFn>
+static double Measure(const char * a_Name, ResetFn a_Reset, StepFn a_Step, HeightFn a_SumHeights)
+{
+	auto Best = std::chrono::steady_clock::duration::max();
+	for (int Run = 0; Run < NUM_RUNS; ++Run)
+	{
+		a_Reset();
+		auto Start = std::chrono::steady_clock::now();
+		for (int Tick = 0; Tick < NUM_TICKS; ++Tick)
+		{
+			a_Step();
+		}
+		Best = std::min(Best, std::chrono::steady_clock::now() - Start);
+	}
+	auto MsecPerTick = std::chrono::duration<double, std::milli>(Best).count() / NUM_TICKS;
+	LOG("%-32s %7.3f ms per tick (%.1f ns per pickup)", a_Name, MsecPerTick, MsecPerTick * 1e6 / NUM_PICKUPS);
+	return a_SumHeights();
+}
+
+
+
+
+
+int main()
+{
+	LOG("Pickup physics benchmark: %d pickups, %d ticks", NUM_PICKUPS, NUM_TICKS);
+	cTerrain Terrain;
+	auto Drops = MakeDrops();
+
+	// Step each entity object in turn, as cChunk::Tick() does. The objects are allocated interleaved with other allocations,
+	// as happens on a live server, so that they don't end up neatly packed next to each other:
+	std::vector<std::unique_ptr<cBenchPickup>> Entities;
+	std::vector<std::unique_ptr<char[]>> Padding;
+	for (const auto & Drop: Drops)
+	{
+		Entities.push_back(cpp14::make_unique<cBenchPickup>(Drop.m_Pos, Drop.m_Speed));
+		Padding.push_back(cpp14::make_unique<char[]>(512));
+	}
+	auto EntityHeights = Measure("Per entity object",
+		[&]()
+		{
+			for (size_t i = 0; i < Drops.size(); ++i)
+			{
+				Entities[i]->Reset(Drops[i].m_Pos, Drops[i].m_Speed);
+			}
+		},
+		[&]()
+		{
+			for (auto & Entity: Entities)
+			{
+				Entity->StepPhysics(Terrain);
+			}
+		},
+		[&]()
+		{
+			double Sum = 0;
+			for (const auto & Entity: Entities)
+			{
+				Sum += Entity->GetPosY();
+			}
+			return Sum;
+		}
+	);
+
+	// Step the contiguous arrays in a single pass:
+	sPickupArrays Arrays;
+	auto ArrayHeights = Measure("Structure of arrays",
+		[&]()
+		{
+			Arrays.m_Pos.clear();
+			Arrays.m_Speed.clear();
+			Arrays.m_IsOnGround.assign(Drops.size(), 0);
+			for (const auto & Drop: Drops)
+			{
+				Arrays.m_Pos.push_back(Drop.m_Pos);
+				Arrays.m_Speed.push_back(Drop.m_Speed);
+			}
+		},
+		[&]()
+		{
+			Arrays.Step(Terrain);
+		},
+		[&]()
+		{
+			double Sum = 0;
+			for (const auto & Pos: Arrays.m_Pos)
+			{
+				Sum += Pos.y;
+			}
+			return Sum;
+		}
+	);
+
+	// Both methods run the same physics, so the pickups end up in the same places:
+	LOG("Average final height: %.3f per entity object, %.3f structure of arrays", EntityHeights / NUM_PICKUPS, ArrayHeights / NUM_PICKUPS);
+	return 0;
+}
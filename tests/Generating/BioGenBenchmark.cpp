@@ -0,0 +1,96 @@
+
+// BioGenBenchmark.cpp
+
+// Measures the speed of the biome generators, generating the chunks row by row, and together with their neighbors
+// the way the height generators request them, through the default cache
+
+#include "Globals.h"
+#include "Generating/BioGen.h"
+#include "IniFile.h"
+
+
+
+
+
+/** The size of the square of chunks generated in each measurement, in chunks. */
+static const int NUM_CHUNKS = 100;
+
+
+
+
+
+/** Creates the specified biome generator through the same path as the world does.
+If a_ShouldCache is true, the generator is wrapped in the default cache that cComposableGenerator puts in front of it. */
+static cBiomeGenPtr CreateBiomeGen(const AString & a_BiomeGenName, int a_Seed, bool a_ShouldCache)
+{
+	cIniFile Ini;
+	Ini.SetValue("Generator", "BiomeGen", a_BiomeGenName);
+	bool CacheOffByDefault;
+	auto BiomeGen = cBiomeGen::CreateBiomeGen(Ini, a_Seed, CacheOffByDefault);
+	if (a_ShouldCache)
+	{
+		return std::make_shared<cBioGenMulticache>(BiomeGen, 16, 128);
+	}
+	return BiomeGen;
+}
+
+
+
+
+
+/** Generates the biomes for the chunks in the specified order, returns the chunks generated per second. */
+static double MeasureChunksPerSec(cBiomeGen & a_BiomeGen, const cChunkCoordsVector & a_Chunks)
+{
+	cChunkDef::BiomeMap Biomes;
+	auto Start = std::chrono::steady_clock::now();
+	for (const auto & Coords: a_Chunks)
+	{
+		a_BiomeGen.GenBiomes(Coords, Biomes);
+	}
+	auto Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	return a_Chunks.size() / Seconds;
+}
+
+
+
+
+
+int main()
+{
+	// The chunks row by row:
+	cChunkCoordsVector Rows;
+	for (int z = 0; z < NUM_CHUNKS; z++)
+	{
+		for (int x = 0; x < NUM_CHUNKS; x++)
+		{
+			Rows.emplace_back(x - NUM_CHUNKS / 2, z - NUM_CHUNKS / 2);
+		}
+	}
+
+	// Each chunk of the square followed by its 8 neighbors, as the height generators request the biomes around each generated chunk:
+	cChunkCoordsVector Neighbors;
+	for (const auto & Coords: Rows)
+	{
+		Neighbors.push_back(Coords);
+		for (int z = -1; z <= 1; z++)
+		{
+			for (int x = -1; x <= 1; x++)
+			{
+				if ((x != 0) || (z != 0))
+				{
+					Neighbors.emplace_back(Coords.m_ChunkX + x, Coords.m_ChunkZ + z);
+				}
+			}
+		}
+	}
+
+	LOG("Generating %d x %d chunks, chunks per second:", NUM_CHUNKS, NUM_CHUNKS);
+	for (const auto & BiomeGenName: {"MultiStepMap", "TwoLevel", "DistortedVoronoi", "Grown", "GrownProt"})
+	{
+		// A new generator for each order, so that the second one doesn't get the first one's cached tiles:
+		auto RowsPerSec = MeasureChunksPerSec(*CreateBiomeGen(BiomeGenName, 1, false), Rows);
+		auto NeighborsPerSec = MeasureChunksPerSec(*CreateBiomeGen(BiomeGenName, 1, true), Neighbors);
+		LOG("  %-16s %9.0f row by row, %9.0f with the neighbors through the cache", BiomeGenName, RowsPerSec, NeighborsPerSec);
+	}
+	return 0;
+}
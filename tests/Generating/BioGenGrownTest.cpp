@@ -0,0 +1,243 @@
+
+// BioGenGrownTest.cpp
+
+// Checks that the tiled cBioGenGrown produces the same biomes as the per-chunk cIntGen chain it replaced,
+// and compares the speed of the two
+
+#include "Globals.h"
+#include "../TestHelpers.h"
+#include "Generating/BioGen.h"
+#include "Generating/IntGen.h"
+#include "IniFile.h"
+
+
+
+
+
+/** The cBioGenGrown's chain of cIntGen layers before it was switched to generating tiles of 4x4 chunks.
+Generates a single chunk's biomes per call. */
+static std::shared_ptr<cIntGen<16, 16>> CreatePerChunkChain(int a_Seed)
+{
+	auto FinalRivers =
+
+		std::make_shared<cIntGenChoice<2, 7>>(a_Seed + 12)
+		| MakeIntGen<cIntGenZoom  <10>>(a_Seed + 11)
+		| MakeIntGen<cIntGenSmooth<8>>(a_Seed + 6)
+		| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
+		| MakeIntGen<cIntGenZoom  <8>>(a_Seed + 10)
+		| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
+		| MakeIntGen<cIntGenZoom  <8>>(a_Seed + 9)
+		| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
+		| MakeIntGen<cIntGenZoom  <8>>(a_Seed + 8)
+		| MakeIntGen<cIntGenSmooth<6>>(a_Seed + 5)
+		| MakeIntGen<cIntGenZoom  <9>>(a_Seed + 4)
+		| MakeIntGen<cIntGenRiver <7>>(a_Seed + 3)
+		| MakeIntGen<cIntGenZoom  <10>>(a_Seed + 2)
+		| MakeIntGen<cIntGenSmooth<8>>(a_Seed + 1);
+
+	auto alteration =
+		std::make_shared<cIntGenZoom     <8>>(a_Seed,
+		std::make_shared<cIntGenLandOcean<6>>(a_Seed, 20
+	));
+
+	auto alteration2 =
+		std::make_shared<cIntGenZoom     <8>>(a_Seed + 1,
+		std::make_shared<cIntGenZoom     <6>>(a_Seed + 2,
+		std::make_shared<cIntGenZoom     <5>>(a_Seed + 1,
+		std::make_shared<cIntGenZoom     <4>>(a_Seed + 2,
+		std::make_shared<cIntGenLandOcean<4>>(a_Seed + 1, 10
+	)))));
+
+	auto FinalBiomes =
+		std::make_shared<cIntGenSmooth         <8>> (a_Seed + 1,
+		std::make_shared<cIntGenZoom           <10>>(a_Seed + 15,
+		std::make_shared<cIntGenSmooth         <7>> (a_Seed + 1,
+		std::make_shared<cIntGenZoom           <9>> (a_Seed + 16,
+		std::make_shared<cIntGenBeaches        <6>> (
+		std::make_shared<cIntGenZoom           <8>> (a_Seed + 1,
+		std::make_shared<cIntGenAddIslands     <6>> (a_Seed + 2004, 10,
+		std::make_shared<cIntGenAddToOcean     <6>> (a_Seed + 10, 500, biDeepOcean,
+		std::make_shared<cIntGenReplaceRandomly<8>> (a_Seed + 1, biPlains, biSunflowerPlains, 20,
+		std::make_shared<cIntGenMBiomes        <8>> (a_Seed + 5, alteration2,
+		std::make_shared<cIntGenAlternateBiomes<8>> (a_Seed + 1, alteration,
+		std::make_shared<cIntGenBiomeEdges     <8>> (a_Seed + 3,
+		std::make_shared<cIntGenZoom           <10>>(a_Seed + 2,
+		std::make_shared<cIntGenZoom           <7>> (a_Seed + 4,
+		std::make_shared<cIntGenReplaceRandomly<5>> (a_Seed + 99, biIcePlains, biIcePlainsSpikes, 50,
+		std::make_shared<cIntGenZoom           <5>> (a_Seed + 8,
+		std::make_shared<cIntGenAddToOcean     <4>> (a_Seed + 10, 300, biDeepOcean,
+		std::make_shared<cIntGenAddToOcean     <6>> (a_Seed + 9, 8, biMushroomIsland,
+		std::make_shared<cIntGenBiomes         <8>> (a_Seed + 3000,
+		std::make_shared<cIntGenAddIslands     <8>> (a_Seed + 2000, 200,
+		std::make_shared<cIntGenZoom           <8>> (a_Seed + 5,
+		std::make_shared<cIntGenRareBiomeGroups<6>> (a_Seed + 5, 50,
+		std::make_shared<cIntGenBiomeGroupEdges<6>> (
+		std::make_shared<cIntGenAddIslands     <8>> (a_Seed + 2000, 200,
+		std::make_shared<cIntGenZoom           <8>> (a_Seed + 7,
+		std::make_shared<cIntGenSetRandomly    <6>> (a_Seed + 8, 50, bgOcean,
+		std::make_shared<cIntGenReplaceRandomly<6>> (a_Seed + 101, bgIce, bgTemperate, 150,
+		std::make_shared<cIntGenAddIslands     <6>> (a_Seed + 2000, 200,
+		std::make_shared<cIntGenSetRandomly    <6>> (a_Seed + 9, 50, bgOcean,
+		std::make_shared<cIntGenLandOcean      <5>> (a_Seed + 100, 30)
+		| MakeIntGen<cIntGenZoom           <6>> (a_Seed + 10)
+	)))))))))))))))))))))))))))));
+
+	return
+		std::make_shared<cIntGenSmooth   <16>>(a_Seed,
+		std::make_shared<cIntGenZoom     <18>>(a_Seed,
+		std::make_shared<cIntGenSmooth   <11>>(a_Seed,
+		std::make_shared<cIntGenZoom     <13>>(a_Seed,
+		std::make_shared<cIntGenMixRivers<8>> (
+		FinalBiomes, FinalRivers
+	)))));
+}
+
+
+
+
+
+/** Generates the chunk's biomes using the per-chunk chain. */
+static void GenPerChunk(cIntGen<16, 16> & a_Chain, cChunkCoords a_Coords, cChunkDef::BiomeMap & a_Biomes)
+{
+	cIntGen<16, 16>::Values Values;
+	a_Chain.GetInts(a_Coords.m_ChunkX * cChunkDef::Width, a_Coords.m_ChunkZ * cChunkDef::Width, Values);
+	for (int z = 0; z < cChunkDef::Width; z++)
+	{
+		for (int x = 0; x < cChunkDef::Width; x++)
+		{
+			cChunkDef::SetBiome(a_Biomes, x, z, static_cast<EMCSBiome>(Values[x + cChunkDef::Width * z]));
+		}
+	}
+}
+
+
+
+
+
+/** Creates the Grown biome generator through the same path as the world does, with no cache in front of it. */
+static cBiomeGenPtr CreateGrown(int a_Seed)
+{
+	cIniFile Ini;
+	Ini.SetValue("Generator", "BiomeGen", "Grown");
+	bool CacheOffByDefault;
+	return cBiomeGen::CreateBiomeGen(Ini, a_Seed, CacheOffByDefault);
+}
+
+
+
+
+
+/** Compares the biomes of the specified chunks, in the given order, generated by the per-chunk chain and the tiled generator. */
+static void CompareChunks(int a_Seed, const cChunkCoordsVector & a_Chunks)
+{
+	auto PerChunk = CreatePerChunkChain(a_Seed);
+	auto Tiled = CreateGrown(a_Seed);
+	for (const auto & Coords: a_Chunks)
+	{
+		cChunkDef::BiomeMap Expected, Actual;
+		GenPerChunk(*PerChunk, Coords, Expected);
+		Tiled->GenBiomes(Coords, Actual);
+		for (size_t i = 0; i < ARRAYCOUNT(Expected); i++)
+		{
+			if (Expected[i] != Actual[i])
+			{
+				TEST_FAIL(Printf("Seed %d, chunk [%d, %d], column %d: expected biome %d, got %d",
+					a_Seed, Coords.m_ChunkX, Coords.m_ChunkZ, static_cast<int>(i),
+					static_cast<int>(Expected[i]), static_cast<int>(Actual[i])
+				));
+			}
+		}
+	}
+}
+
+
+
+
+
+/** Checks the tiled generator against the per-chunk chain for several seeds,
+with chunks scattered far apart, chunks around the tile boundaries on both sides of zero, and a block of neighbors. */
+static void TestSameBiomes(void)
+{
+	// Chunks scattered pseudo-randomly (but the same in each run), including negative coords, so that each one lands in a different tile:
+	cNoise Rnd(0);
+	cChunkCoordsVector Scattered;
+	for (int i = 0; i < 200; i++)
+	{
+		Scattered.emplace_back(Rnd.IntNoise2DInt(i, 0) % 100000, Rnd.IntNoise2DInt(i, 1) % 100000);
+	}
+	Scattered.emplace_back(-1000000, 1000000);
+	Scattered.emplace_back(1000000, -1000000);
+
+	// Chunks on both sides of each tile boundary around zero, in an order that jumps between the tiles:
+	cChunkCoordsVector Boundaries;
+	for (int x: {-9, -8, -5, -4, -1, 0, 3, 4, 7, 8})
+	{
+		for (int z: {8, 4, 0, -4, -8, 7, 3, -1, -5, -9})
+		{
+			Boundaries.emplace_back(x, z);
+		}
+	}
+
+	// A block of neighbors in the order the generator usually requests them, served mostly from the cached tiles:
+	cChunkCoordsVector Block;
+	for (int z = -10; z < 6; z++)
+	{
+		for (int x = -13; x < 3; x++)
+		{
+			Block.emplace_back(x, z);
+		}
+	}
+
+	for (int Seed: {0, 1, 12345, -98765})
+	{
+		LOG("Comparing the biomes for seed %d...", Seed);
+		CompareChunks(Seed, Scattered);
+		CompareChunks(Seed, Boundaries);
+		CompareChunks(Seed, Block);
+	}
+}
+
+
+
+
+
+/** Logs the speed of the per-chunk chain and the tiled generator, generating a square of chunks row by row. */
+static void MeasureSpeed(void)
+{
+	const int NumChunks = 32;
+	cChunkDef::BiomeMap Biomes;
+
+	auto PerChunk = CreatePerChunkChain(0);
+	auto Start = std::chrono::steady_clock::now();
+	for (int z = 0; z < NumChunks; z++)
+	{
+		for (int x = 0; x < NumChunks; x++)
+		{
+			GenPerChunk(*PerChunk, {x - NumChunks / 2, z - NumChunks / 2}, Biomes);
+		}
+	}
+	auto PerChunkTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+	auto Tiled = CreateGrown(0);
+	Start = std::chrono::steady_clock::now();
+	for (int z = 0; z < NumChunks; z++)
+	{
+		for (int x = 0; x < NumChunks; x++)
+		{
+			Tiled->GenBiomes({x - NumChunks / 2, z - NumChunks / 2}, Biomes);
+		}
+	}
+	auto TiledTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+	LOG("Per-chunk chain: %.0f chunks per second", NumChunks * NumChunks / PerChunkTime);
+	LOG("Tiled generator: %.0f chunks per second (%.2fx)", NumChunks * NumChunks / TiledTime, PerChunkTime / TiledTime);
+}
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("BioGenGrown",
+	TestSameBiomes();
+	MeasureSpeed();
+)
@@ -0,0 +1,384 @@
+
+// GridStructGenBenchmark.cpp
+
+// Measures the cGridStructGen's structure cache lookups against walking the whole cache, as it used to be done,
+// with the grid parameters of the shipped structure generators; then measures the chunk generation time of
+// structure-heavy generator presets
+
+#include "Globals.h"
+#include "Generating/ChunkDesc.h"
+#include "Generating/ChunkGenerator.h"
+#include "Generating/GridStructGen.h"
+#include "IniFile.h"
+
+
+
+
+
+/** The view distance of the simulated player walking through the world, in chunks. */
+static const int VIEW_DISTANCE = 10;
+
+/** The number of chunks the simulated player walks. */
+static const int WALK_LENGTH = 200;
+
+/** The size of the area pregenerated in the simulated pregeneration, in chunks. */
+static const int PREGEN_SIZE = 64;
+
+/** Number of chunks generated in each measurement of the whole generator. */
+static const int NUM_GENERATED_CHUNKS = 200;
+
+
+
+
+
+/** A structure that draws nothing, so that only the cache handling is measured. */
+class cTestStructure:
+	public cGridStructGen::cStructure
+{
+	using Super = cGridStructGen::cStructure;
+
+public:
+
+	cTestStructure(int a_GridX, int a_GridZ, int a_OriginX, int a_OriginZ) :
+		Super(a_GridX, a_GridZ, a_OriginX, a_OriginZ)
+	{
+	}
+
+	virtual void DrawIntoChunk(cChunkDesc & a_ChunkDesc) override
+	{
+		// Do nothing
+	}
+};
+
+
+
+
+
+/** Exposes the structure lookups of cGridStructGen to the benchmark and adds the original linear cache walk. */
+class cTestGridStructGen:
+	public cGridStructGen
+{
+	using Super = cGridStructGen;
+
+public:
+
+	/** The grid coords of the structures returned for a single chunk. */
+	using cGridCoords = std::vector<std::pair<int, int>>;
+
+
+	cTestGridStructGen(int a_GridSize, int a_MaxOffset, int a_MaxStructureSize, size_t a_MaxCacheSize):
+		Super(0, a_GridSize, a_GridSize, a_MaxOffset, a_MaxOffset, a_MaxStructureSize, a_MaxStructureSize, a_MaxCacheSize),
+		m_NumCreated(0)
+	{
+	}
+
+
+	/** Returns the grid coords of the structures for the chunk, looked up using the cache index. */
+	cGridCoords GetIndexed(int a_ChunkX, int a_ChunkZ)
+	{
+		cStructurePtrs Structures;
+		GetStructuresForChunk(a_ChunkX, a_ChunkZ, Structures);
+		return GetGridCoords(Structures);
+	}
+
+
+	/** Returns the grid coords of the structures for the chunk, looked up by walking the whole cache. */
+	cGridCoords GetLinear(int a_ChunkX, int a_ChunkZ)
+	{
+		cStructurePtrs Structures;
+		GetStructuresForChunkLinear(a_ChunkX, a_ChunkZ, Structures);
+		return GetGridCoords(Structures);
+	}
+
+
+	/** The original GetStructuresForChunk(), before the cache index.
+	Moves the wanted structures from the cache, creates the missing ones, copies them all to the cache front and trims the cache. */
+	void GetStructuresForChunkLinear(int a_ChunkX, int a_ChunkZ, cStructurePtrs & a_Structures)
+	{
+		// Calculate the min and max grid coords of the structures to be returned:
+		int MinBlockX = a_ChunkX * cChunkDef::Width - m_MaxStructureSizeX - m_MaxOffsetX;
+		int MinBlockZ = a_ChunkZ * cChunkDef::Width - m_MaxStructureSizeZ - m_MaxOffsetZ;
+		int MaxBlockX = a_ChunkX * cChunkDef::Width + m_MaxStructureSizeX + m_MaxOffsetX + cChunkDef::Width - 1;
+		int MaxBlockZ = a_ChunkZ * cChunkDef::Width + m_MaxStructureSizeZ + m_MaxOffsetZ + cChunkDef::Width - 1;
+		int MinGridX = MinBlockX / m_GridSizeX;
+		int MinGridZ = MinBlockZ / m_GridSizeZ;
+		int MaxGridX = (MaxBlockX + m_GridSizeX - 1) / m_GridSizeX;
+		int MaxGridZ = (MaxBlockZ + m_GridSizeZ - 1) / m_GridSizeZ;
+		int MinX = MinGridX * m_GridSizeX;
+		int MaxX = MaxGridX * m_GridSizeX;
+		int MinZ = MinGridZ * m_GridSizeZ;
+		int MaxZ = MaxGridZ * m_GridSizeZ;
+
+		// Walk the cache, move each structure that we want into a_Structures:
+		for (auto itr = m_LinearCache.begin(), end = m_LinearCache.end(); itr != end;)
+		{
+			if (
+				((*itr)->m_GridX >= MinX) && ((*itr)->m_GridX < MaxX) &&
+				((*itr)->m_GridZ >= MinZ) && ((*itr)->m_GridZ < MaxZ)
+			)
+			{
+				a_Structures.push_back(*itr);
+				itr = m_LinearCache.erase(itr);
+			}
+			else
+			{
+				++itr;
+			}
+		}
+
+		// Create those structures that haven't been in the cache:
+		for (int x = MinGridX; x < MaxGridX; x++)
+		{
+			int GridX = x * m_GridSizeX;
+			for (int z = MinGridZ; z < MaxGridZ; z++)
+			{
+				int GridZ = z * m_GridSizeZ;
+				bool Found = false;
+				for (const auto & Structure: a_Structures)
+				{
+					if ((Structure->m_GridX == GridX) && (Structure->m_GridZ == GridZ))
+					{
+						Found = true;
+						break;
+					}
+				}
+				if (!Found)
+				{
+					int OriginX = GridX + ((m_Noise.IntNoise2DInt(GridX + 3, GridZ + 5) / 7) % (m_MaxOffsetX * 2)) - m_MaxOffsetX;
+					int OriginZ = GridZ + ((m_Noise.IntNoise2DInt(GridX + 5, GridZ + 3) / 7) % (m_MaxOffsetZ * 2)) - m_MaxOffsetZ;
+					a_Structures.push_back(CreateStructure(GridX, GridZ, OriginX, OriginZ));
+				}
+			}  // for z
+		}  // for x
+
+		// Copy the structures into the cache, to the beginning:
+		cStructurePtrs StructuresCopy(a_Structures);
+		m_LinearCache.splice(m_LinearCache.begin(), StructuresCopy, StructuresCopy.begin(), StructuresCopy.end());
+
+		// Trim the cache if it's too long:
+		size_t CacheSize = 0;
+		for (auto itr = m_LinearCache.begin(), end = m_LinearCache.end(); itr != end; ++itr)
+		{
+			CacheSize += (*itr)->GetCacheCost();
+			if (CacheSize > m_MaxCacheSize)
+			{
+				m_LinearCache.erase(itr, m_LinearCache.end());
+				break;
+			}
+		}
+	}
+
+
+	/** Returns the number of structures created so far, that is, the number of cache misses. */
+	size_t GetNumCreated(void) const
+	{
+		return m_NumCreated;
+	}
+
+
+	/** Returns the effective maximum cache size, after the constructor's adjustment. */
+	size_t GetMaxCacheSize(void) const
+	{
+		return m_MaxCacheSize;
+	}
+
+protected:
+
+	/** The cache used by GetStructuresForChunkLinear(), separate from the indexed one. */
+	cStructurePtrs m_LinearCache;
+
+	/** Number of the structures created so far. */
+	size_t m_NumCreated;
+
+
+	/** Returns the sorted grid coords of the structures. */
+	static cGridCoords GetGridCoords(const cStructurePtrs & a_Structures)
+	{
+		cGridCoords Res;
+		for (const auto & Structure: a_Structures)
+		{
+			Res.emplace_back(Structure->m_GridX, Structure->m_GridZ);
+		}
+		std::sort(Res.begin(), Res.end());
+		return Res;
+	}
+
+
+	// cGridStructGen overrides:
+	virtual cStructurePtr CreateStructure(int a_GridX, int a_GridZ, int a_OriginX, int a_OriginZ) override
+	{
+		m_NumCreated += 1;
+		return std::make_shared<cTestStructure>(a_GridX, a_GridZ, a_OriginX, a_OriginZ);
+	}
+};
+
+
+
+
+
+/** The grid parameters of a structure generator, as set up by cComposableGenerator or the cubeset file. */
+struct sGridParams
+{
+	const char * m_Name;
+	int m_GridSize;
+	int m_MaxOffset;
+	int m_MaxStructureSize;
+	size_t m_MaxCacheSize;
+};
+
+
+
+
+
+/** Returns the chunks generated when a player walks WALK_LENGTH chunks along the X axis,
+each step generating the newly visible column of chunks. */
+static std::vector<cChunkCoords> MakeWalk(void)
+{
+	std::vector<cChunkCoords> Res;
+	for (int x = -VIEW_DISTANCE; x <= VIEW_DISTANCE + WALK_LENGTH; x++)
+	{
+		for (int z = -VIEW_DISTANCE; z <= VIEW_DISTANCE; z++)
+		{
+			Res.emplace_back(x, z);
+		}
+	}
+	return Res;
+}
+
+
+
+
+
+/** Returns the chunks generated when pregenerating a PREGEN_SIZE * PREGEN_SIZE area, row by row. */
+static std::vector<cChunkCoords> MakePregeneration(void)
+{
+	std::vector<cChunkCoords> Res;
+	for (int z = -PREGEN_SIZE / 2; z < PREGEN_SIZE / 2; z++)
+	{
+		for (int x = -PREGEN_SIZE / 2; x < PREGEN_SIZE / 2; x++)
+		{
+			Res.emplace_back(x, z);
+		}
+	}
+	return Res;
+}
+
+
+
+
+
+/** Looks up the structures for all the chunks using both the cache index and the linear walk, logs the times per chunk.
+Returns false if the two ways return different structures for any chunk. */
+static bool MeasureCache(const sGridParams & a_Params, const char * a_WalkName, const std::vector<cChunkCoords> & a_Chunks)
+{
+	auto MakeGen = [&]()
+	{
+		return cpp14::make_unique<cTestGridStructGen>(a_Params.m_GridSize, a_Params.m_MaxOffset, a_Params.m_MaxStructureSize, a_Params.m_MaxCacheSize);
+	};
+
+	// Check that both ways return the same structures:
+	{
+		auto Gen = MakeGen();
+		for (const auto & Chunk: a_Chunks)
+		{
+			auto Indexed = Gen->GetIndexed(Chunk.m_ChunkX, Chunk.m_ChunkZ);
+			auto Linear = Gen->GetLinear(Chunk.m_ChunkX, Chunk.m_ChunkZ);
+			if (Indexed != Linear)
+			{
+				LOGERROR("%s, %s: chunk [%d, %d] got %zu structures from the index, %zu from the linear walk",
+					a_Params.m_Name, a_WalkName, Chunk.m_ChunkX, Chunk.m_ChunkZ, Indexed.size(), Linear.size()
+				);
+				return false;
+			}
+		}
+	}
+
+	size_t NumStructures = 0;
+	auto Time = [&](cTestGridStructGen::cGridCoords (cTestGridStructGen::*a_Get)(int, int), size_t & a_NumCreated)
+	{
+		auto Gen = MakeGen();
+		NumStructures = 0;
+		auto Start = std::chrono::steady_clock::now();
+		for (const auto & Chunk: a_Chunks)
+		{
+			NumStructures += ((*Gen).*a_Get)(Chunk.m_ChunkX, Chunk.m_ChunkZ).size();
+		}
+		auto Duration = std::chrono::steady_clock::now() - Start;
+		a_NumCreated = Gen->GetNumCreated();
+		return std::chrono::duration<double, std::micro>(Duration).count() / a_Chunks.size();
+	};
+	size_t IndexedCreated = 0, LinearCreated = 0;
+	auto Indexed = Time(&cTestGridStructGen::GetIndexed, IndexedCreated);
+	auto Linear = Time(&cTestGridStructGen::GetLinear, LinearCreated);
+	LOG("  %-14s %-12s %5.1f structures per chunk: index %7.2f us per chunk (%zu created), linear walk %7.2f us per chunk (%zu created)",
+		a_Params.m_Name, a_WalkName, static_cast<double>(NumStructures) / a_Chunks.size(),
+		Indexed, IndexedCreated, Linear, LinearCreated
+	);
+	return true;
+}
+
+
+
+
+
+/** Generates NUM_GENERATED_CHUNKS chunks along the X axis using the generator with the specified finishers,
+logs the time per chunk. */
+static void MeasureGenerator(const char * a_Dimension, const char * a_Finishers)
+{
+	cIniFile Ini;
+	Ini.AddValue("General", "Dimension", a_Dimension);
+	Ini.AddValueI("Seed", "Seed", 1);
+	Ini.AddValue("Generator", "Finishers", a_Finishers);
+	auto Gen = cChunkGenerator::CreateFromIniFile(Ini);
+	if (Gen == nullptr)
+	{
+		LOGERROR("Cannot create the %s generator with finishers \"%s\"", a_Dimension, a_Finishers);
+		return;
+	}
+	auto Start = std::chrono::steady_clock::now();
+	for (int x = 0; x < NUM_GENERATED_CHUNKS; x++)
+	{
+		cChunkDesc Desc({x, 0});
+		Gen->Generate(Desc);
+	}
+	auto Duration = std::chrono::steady_clock::now() - Start;
+	LOG("  %-9s \"%s\": %.2f ms per chunk",
+		a_Dimension, a_Finishers, std::chrono::duration<double, std::milli>(Duration).count() / NUM_GENERATED_CHUNKS
+	);
+}
+
+
+
+
+
+int main()
+{
+	// The defaults used by cComposableGenerator, and the shipped PieceStructures cubesets:
+	static const sGridParams Generators[] =
+	{
+		{"WormNestCaves",   96,  32,  64, 100},
+		{"RoughRavines",   256, 128, 128,  64},
+		{"Mineshafts",     512, 256, 160, 100},
+		{"Villages",       384, 128, 128, 100},
+		{"NetherFort",     512, 128, 384, 256},
+		{"TestRails",       10,   1,  20, 256},
+	};
+	auto Walk = MakeWalk();
+	auto Pregeneration = MakePregeneration();
+	LOG("Grid structure cache benchmark, %zu chunks walked, %zu chunks pregenerated:", Walk.size(), Pregeneration.size());
+	for (const auto & Params: Generators)
+	{
+		if (!MeasureCache(Params, "walk", Walk) || !MeasureCache(Params, "pregenerate", Pregeneration))
+		{
+			return 1;
+		}
+	}
+
+	// The villages and the nether forts are loaded from the Prefabs folder, so this part needs to run in the Server folder:
+	LOG("Generator presets, %d chunks each:", NUM_GENERATED_CHUNKS);
+	MeasureGenerator("Overworld", "");
+	MeasureGenerator("Overworld", "RoughRavines, WormNestCaves, Mineshafts, Villages");
+	MeasureGenerator("Nether", "");
+	MeasureGenerator("Nether", "WormNestCaves, PieceStructures: NetherFort");
+	return 0;
+}
@@ -0,0 +1,527 @@
+
+// HTTPFileCacheBenchmark.cpp
+
+// Serves the webadmin-like static files over local HTTP connections to a load generator, reading each file from disk
+// the way cWebAdmin did before cHTTPFileCache, and from the cache, with and without the conditional requests
+
+#include "Globals.h"
+#include "FastRandom.h"
+#include "StringCompression.h"
+#include "HTTP/HTTPFileCache.h"
+#include "HTTP/HTTPMessage.h"
+#include "HTTP/HTTPMessageParser.h"
+#include "HTTP/HTTPServer.h"
+#include "HTTP/HTTPServerConnection.h"
+#include "OSSupport/Event.h"
+#include "OSSupport/Network.h"
+#include "OSSupport/NetworkSingleton.h"
+
+
+
+
+
+/** The folder where the served files are created. */
+static const AString FILES_FOLDER = "HTTPFileCacheBenchmark.tmp";
+
+/** The port on which the server listens in the first measurement; each measurement uses the next port,
+because the listening socket is only freed after all its connections are gone. */
+static const UInt16 FIRST_PORT = 9781;
+
+/** Number of simultaneous client connections. */
+static const int NUM_CLIENTS = 8;
+
+/** Number of requests sent over each client connection, one after another. */
+static const int NUM_REQUESTS_PER_CLIENT = 500;
+
+
+
+
+
+/** A file served by the benchmark, with the contents that the clients expect. */
+struct sServedFile
+{
+	AString m_URL;
+	AString m_Contents;
+};
+
+
+
+
+
+/** Creates the served files in FILES_FOLDER: a stylesheet, a script and an image, sized like the webadmin's. */
+static std::vector<sServedFile> CreateFiles(void)
+{
+	std::vector<sServedFile> Res;
+	cFile::CreateFolder(FILES_FOLDER);
+
+	sServedFile Style;
+	Style.m_URL = "/style.css";
+	for (int i = 0; i < 400; i++)
+	{
+		Style.m_Contents.append(Printf(".row%d { margin: %dpx; color: #%06x; }\n", i, i % 16, i * 2654435761U % 0x1000000));
+	}
+	Res.push_back(std::move(Style));
+
+	sServedFile Script;
+	Script.m_URL = "/script.js";
+	for (int i = 0; i < 1000; i++)
+	{
+		Script.m_Contents.append(Printf("function update%d(a_Data) { document.getElementById(\"cell%d\").textContent = a_Data[%d]; }\n", i, i, i));
+	}
+	Res.push_back(std::move(Script));
+
+	// The image is incompressible, so it is always sent as-is:
+	std::seed_seq Seed{1};
+	cFastRandom Random(Seed);
+	sServedFile Image;
+	Image.m_URL = "/logo.png";
+	for (int i = 0; i < 24 * 1024; i++)
+	{
+		Image.m_Contents.push_back(static_cast<char>(Random.RandInt(255)));
+	}
+	Res.push_back(std::move(Image));
+
+	for (const auto & File: Res)
+	{
+		cFile f(FILES_FOLDER + File.m_URL, cFile::fmWrite);
+		f.Write(File.m_Contents);
+	}
+	return Res;
+}
+
+
+
+
+
+/** The server callbacks, serving the files the way cWebAdmin::HandleFileRequest() does, with or without the cache. */
+class cFileServer:
+	public cHTTPServer::cCallbacks
+{
+public:
+
+	cFileServer(bool a_ShouldUseCache):
+		m_ShouldUseCache(a_ShouldUseCache)
+	{
+	}
+
+protected:
+
+	/** If true, the files are served from m_FileCache, with the validators; otherwise they are read from disk for each request. */
+	bool m_ShouldUseCache;
+
+	cHTTPFileCache m_FileCache;
+
+
+	/** Returns the content type for the file, with the same mapping as cWebAdmin. */
+	static AString GetContentType(const AString & a_Path)
+	{
+		auto Ext = a_Path.substr(a_Path.find_last_of('.') + 1);
+		if (Ext == "css")
+		{
+			return "text/css";
+		}
+		if (Ext == "js")
+		{
+			return "text/javascript";
+		}
+		if (Ext == "png")
+		{
+			return "image/png";
+		}
+		return "application/unknown";
+	}
+
+
+	/** Serves the file the way cWebAdmin did before the cache: checked, opened and read on each request, no validators. */
+	void ServeFromDisk(cHTTPServerConnection & a_Connection, const AString & a_Path)
+	{
+		AString Content = "<h2>404 Not Found</h2>";
+		AString ContentType = "text/html";
+		if (cFile::IsFile(a_Path))
+		{
+			cFile File(a_Path, cFile::fmRead);
+			AString FileContent;
+			if (File.IsOpen() && (File.ReadRestOfFile(FileContent) != -1))
+			{
+				std::swap(Content, FileContent);
+				ContentType = GetContentType(a_Path);
+			}
+		}
+		cHTTPOutgoingResponse Resp;
+		Resp.SetContentType(ContentType);
+		a_Connection.Send(Resp);
+		a_Connection.Send(Content);
+		a_Connection.FinishResponse();
+	}
+
+
+	/** Serves the file the way cWebAdmin does now: from the cache, compressed if accepted, 304 if the client's copy is current. */
+	void ServeFromCache(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request, const AString & a_Path)
+	{
+		auto ContentType = GetContentType(a_Path);
+		auto File = m_FileCache.GetFile(a_Path, (ContentType.compare(0, 5, "text/") == 0));
+		if (File == nullptr)
+		{
+			cHTTPOutgoingResponse Resp;
+			Resp.SetContentType("text/html");
+			a_Connection.Send(Resp);
+			a_Connection.Send("<h2>404 Not Found</h2>");
+			a_Connection.FinishResponse();
+			return;
+		}
+		bool ShouldSendGzip = (!File->m_GzipContents.empty() && cHTTPFileCache::DoesAcceptGzip(a_Request));
+		const AString & ETag = ShouldSendGzip ? File->m_GzipETag : File->m_ETag;
+		cHTTPOutgoingResponse Resp;
+		Resp.SetContentType(ContentType);
+		Resp.AddHeader("ETag", ETag);
+		Resp.AddHeader("Last-Modified", File->m_LastModified);
+		Resp.AddHeader("Cache-Control", "no-cache");
+		if (!File->m_GzipContents.empty())
+		{
+			Resp.AddHeader("Vary", "Accept-Encoding");
+		}
+		if (cHTTPFileCache::IsNotModified(a_Request, ETag, File->m_LastModified))
+		{
+			a_Connection.SendNotModified(Resp);
+			return;
+		}
+		if (ShouldSendGzip)
+		{
+			Resp.AddHeader("Content-Encoding", "gzip");
+		}
+		a_Connection.Send(Resp);
+		a_Connection.Send(ShouldSendGzip ? File->m_GzipContents : File->m_Contents);
+		a_Connection.FinishResponse();
+	}
+
+
+	// cHTTPServer::cCallbacks overrides:
+	virtual void OnRequestBegun(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request) override
+	{
+		UNUSED(a_Connection);
+		UNUSED(a_Request);
+	}
+
+	virtual void OnRequestBody(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request, const char * a_Data, size_t a_Size) override
+	{
+		// The file requests have no body
+		UNUSED(a_Connection);
+		UNUSED(a_Request);
+		UNUSED(a_Data);
+		UNUSED(a_Size);
+	}
+
+	virtual void OnRequestFinished(cHTTPServerConnection & a_Connection, cHTTPIncomingRequest & a_Request) override
+	{
+		auto Path = FILES_FOLDER + a_Request.GetURL();
+		if (m_ShouldUseCache)
+		{
+			ServeFromCache(a_Connection, a_Request, Path);
+		}
+		else
+		{
+			ServeFromDisk(a_Connection, Path);
+		}
+	}
+};
+
+
+
+
+
+/** A single client connection of the load generator.
+Requests the files in turn, one request at a time, like a dashboard polling its assets, and checks each response.
+With a_IsConditional, the client sends back the ETag it received for each file, as a browser revalidating its cache does. */
+class cLoadClient:
+	public cNetwork::cConnectCallbacks,
+	public cTCPLink::cCallbacks,
+	public cHTTPMessageParser::cCallbacks
+{
+public:
+
+	cLoadClient(const std::vector<sServedFile> & a_Files, bool a_IsConditional, std::atomic<int> & a_NumClientsLeft, cEvent & a_EvtFinished):
+		m_Files(a_Files),
+		m_IsConditional(a_IsConditional),
+		m_NumClientsLeft(a_NumClientsLeft),
+		m_EvtFinished(a_EvtFinished),
+		m_Parser(*this),
+		m_NumRequestsSent(0),
+		m_StatusCode(0),
+		m_IsResponseFinished(false),
+		m_NumBytesReceived(0),
+		m_NumNotModified(0),
+		m_HasFailed(false)
+	{
+	}
+
+	size_t GetNumBytesReceived(void) const { return m_NumBytesReceived; }
+	int GetNumNotModified(void) const { return m_NumNotModified; }
+	bool HasFailed(void) const { return m_HasFailed; }
+
+protected:
+
+	const std::vector<sServedFile> & m_Files;
+	bool m_IsConditional;
+	std::atomic<int> & m_NumClientsLeft;
+	cEvent & m_EvtFinished;
+	cTCPLinkPtr m_Link;
+	cHTTPMessageParser m_Parser;
+
+	/** The number of requests sent so far; the last one is for file m_Files[(m_NumRequestsSent - 1) % m_Files.size()]. */
+	int m_NumRequestsSent;
+
+	/** The ETag received for each file, sent back in If-None-Match when m_IsConditional. */
+	std::map<AString, AString> m_ETags;
+
+	/** The current response, as parsed so far. */
+	int m_StatusCode;
+	AString m_ETag;
+	AString m_ContentEncoding;
+	AString m_Body;
+	bool m_IsResponseFinished;
+
+	/** The statistics. */
+	size_t m_NumBytesReceived;
+	int m_NumNotModified;
+	bool m_HasFailed;
+
+
+	/** Sends the next request, or finishes the client if all have been sent. */
+	void SendNextRequest(void)
+	{
+		if (m_NumRequestsSent >= NUM_REQUESTS_PER_CLIENT)
+		{
+			Finish(false);
+			return;
+		}
+		const auto & URL = m_Files[static_cast<size_t>(m_NumRequestsSent) % m_Files.size()].m_URL;
+		AString Request = Printf("GET %s HTTP/1.1\r\nHost: localhost\r\nAccept-Encoding: gzip, deflate\r\n", URL.c_str());
+		auto itr = m_ETags.find(URL);
+		if (itr != m_ETags.end())
+		{
+			Request.append(Printf("If-None-Match: %s\r\n", itr->second.c_str()));
+		}
+		Request.append("\r\n");
+		m_NumRequestsSent += 1;
+		m_Link->Send(Request);
+	}
+
+
+	/** Checks the fully received response against the file that was requested. Returns true if it is valid. */
+	bool CheckResponse(void)
+	{
+		const auto & File = m_Files[static_cast<size_t>(m_NumRequestsSent - 1) % m_Files.size()];
+		if (m_StatusCode == 304)
+		{
+			m_NumNotModified += 1;
+			return (m_ETags.find(File.m_URL) != m_ETags.end());
+		}
+		if (m_StatusCode != 200)
+		{
+			return false;
+		}
+		AString Body;
+		if (m_ContentEncoding == "gzip")
+		{
+			if (UncompressStringGZIP(m_Body.data(), m_Body.size(), Body) != Z_OK)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			std::swap(Body, m_Body);
+		}
+		if (m_IsConditional && !m_ETag.empty())
+		{
+			m_ETags[File.m_URL] = m_ETag;
+		}
+		return (Body == File.m_Contents);
+	}
+
+
+	/** Closes the link and reports the client as finished. */
+	void Finish(bool a_HasFailed)
+	{
+		m_HasFailed = m_HasFailed || a_HasFailed;
+		if (m_Link != nullptr)
+		{
+			m_Link->Close();
+			m_Link.reset();
+		}
+		if (--m_NumClientsLeft == 0)
+		{
+			m_EvtFinished.Set();
+		}
+	}
+
+
+	// cNetwork::cConnectCallbacks overrides:
+	virtual void OnConnected(cTCPLink & a_Link) override
+	{
+		UNUSED(a_Link);
+		SendNextRequest();
+	}
+
+	// cTCPLink::cCallbacks overrides:
+	virtual void OnLinkCreated(cTCPLinkPtr a_Link) override
+	{
+		m_Link = a_Link;
+	}
+
+	virtual void OnReceivedData(const char * a_Data, size_t a_Size) override
+	{
+		m_NumBytesReceived += a_Size;
+		if (m_Parser.Parse(a_Data, a_Size) == AString::npos)
+		{
+			Finish(true);
+			return;
+		}
+
+		// Reset the parser only after it has returned, the response is finished from within its callbacks:
+		if (m_IsResponseFinished)
+		{
+			bool IsValid = CheckResponse();
+			m_Parser.Reset();
+			m_StatusCode = 0;
+			m_ETag.clear();
+			m_ContentEncoding.clear();
+			m_Body.clear();
+			m_IsResponseFinished = false;
+			if (!IsValid)
+			{
+				LOGERROR("Invalid response to request %d", m_NumRequestsSent);
+				Finish(true);
+				return;
+			}
+			SendNextRequest();
+		}
+	}
+
+	virtual void OnRemoteClosed(void) override
+	{
+		LOGERROR("The server closed the connection");
+		m_Link.reset();
+		Finish(true);
+	}
+
+	virtual void OnError(int a_ErrorCode, const AString & a_ErrorMsg) override
+	{
+		LOGERROR("Network error %d: %s", a_ErrorCode, a_ErrorMsg.c_str());
+		m_Link.reset();
+		Finish(true);
+	}
+
+	// cHTTPMessageParser::cCallbacks overrides:
+	virtual void OnError(const AString & a_ErrorDescription) override
+	{
+		LOGERROR("Cannot parse the response: %s", a_ErrorDescription.c_str());
+	}
+
+	virtual void OnFirstLine(const AString & a_FirstLine) override
+	{
+		// "HTTP/1.1 200 OK"
+		auto Split = StringSplit(a_FirstLine, " ");
+		if ((Split.size() < 2) || !StringToInteger(Split[1], m_StatusCode))
+		{
+			m_StatusCode = 0;
+		}
+	}
+
+	virtual void OnHeaderLine(const AString & a_Key, const AString & a_Value) override
+	{
+		auto Key = StrToLower(a_Key);
+		if (Key == "etag")
+		{
+			m_ETag = a_Value;
+		}
+		else if (Key == "content-encoding")
+		{
+			m_ContentEncoding = a_Value;
+		}
+	}
+
+	virtual void OnHeadersFinished(void) override {}
+
+	virtual void OnBodyData(const void * a_Data, size_t a_Size) override
+	{
+		m_Body.append(static_cast<const char *>(a_Data), a_Size);
+	}
+
+	virtual void OnBodyFinished(void) override
+	{
+		m_IsResponseFinished = true;
+	}
+};
+
+
+
+
+
+/** Runs the load generator against a server with or without the cache, logs the requests per second and the transferred bytes.
+Returns false if any of the responses was invalid. */
+static bool Measure(const std::vector<sServedFile> & a_Files, UInt16 a_Port, bool a_ShouldUseCache, bool a_IsConditional)
+{
+	cFileServer ServerCallbacks(a_ShouldUseCache);
+	cHTTPServer Server;
+	if (!Server.Start(ServerCallbacks, {Printf("%u", a_Port)}))
+	{
+		LOGERROR("Cannot listen on port %u", a_Port);
+		return false;
+	}
+
+	std::atomic<int> NumClientsLeft(NUM_CLIENTS);
+	cEvent EvtFinished;
+	std::vector<std::shared_ptr<cLoadClient>> Clients;
+	auto Start = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_CLIENTS; i++)
+	{
+		auto Client = std::make_shared<cLoadClient>(a_Files, a_IsConditional, NumClientsLeft, EvtFinished);
+		Clients.push_back(Client);
+		if (!cNetwork::Connect("127.0.0.1", a_Port, Client, Client))
+		{
+			LOGERROR("Cannot queue the connection");
+			return false;
+		}
+	}
+	EvtFinished.Wait();
+	auto Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	Server.Stop();
+
+	size_t NumBytes = 0;
+	int NumNotModified = 0;
+	for (const auto & Client: Clients)
+	{
+		if (Client->HasFailed())
+		{
+			return false;
+		}
+		NumBytes += Client->GetNumBytesReceived();
+		NumNotModified += Client->GetNumNotModified();
+	}
+	int NumRequests = NUM_CLIENTS * NUM_REQUESTS_PER_CLIENT;
+	LOG("  %-45s %8.0f requests/sec, %7.0f bytes received per request, %5.1f %% answered 304",
+		a_ShouldUseCache ? (a_IsConditional ? "cache, revalidating with If-None-Match:" : "cache, full downloads:") : "disk read per request (before the cache):",
+		NumRequests / Seconds, static_cast<double>(NumBytes) / NumRequests, 100.0 * NumNotModified / NumRequests
+	);
+	return true;
+}
+
+
+
+
+
+int main()
+{
+	cNetworkSingleton::Get().Initialise();
+	auto Files = CreateFiles();
+	LOG("Serving %zu files to %d clients, %d requests each:", Files.size(), NUM_CLIENTS, NUM_REQUESTS_PER_CLIENT);
+	bool IsOk =
+		Measure(Files, FIRST_PORT,                           false, false) &&
+		Measure(Files, static_cast<UInt16>(FIRST_PORT + 1), true,  false) &&
+		Measure(Files, static_cast<UInt16>(FIRST_PORT + 2), true,  true);
+	cNetworkSingleton::Get().Terminate();
+	cFile::DeleteFolderContents(FILES_FOLDER);
+	cFile::DeleteFolder(FILES_FOLDER);
+	return IsOk ? 0 : 1;
+}
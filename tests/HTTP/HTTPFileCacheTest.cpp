@@ -0,0 +1,157 @@
+
+// HTTPFileCacheTest.cpp
+
+// Tests the cHTTPFileCache class: caching and invalidating the files, and the validators for the conditional requests
+
+#include "Globals.h"
+#include "../TestHelpers.h"
+#include "HTTP/HTTPFileCache.h"
+#include "HTTP/HTTPMessage.h"
+#include "StringCompression.h"
+
+
+
+
+
+/** The name of the temporary file used by the tests. */
+static const AString TEST_FILE_NAME = "HTTPFileCacheTest.tmp";
+
+
+
+
+
+/** Writes the data into the test file, replacing its contents. */
+static void WriteTestFile(const AString & a_Data)
+{
+	cFile f(TEST_FILE_NAME, cFile::fmWrite);
+	TEST_TRUE(f.IsOpen());
+	TEST_EQUAL(f.Write(a_Data), static_cast<int>(a_Data.size()));
+}
+
+
+
+
+
+/** Returns a new request with the specified headers. */
+static cHTTPIncomingRequest MakeRequest(const AStringMap & a_Headers)
+{
+	cHTTPIncomingRequest Request("GET", "/webadmin/files/style.css");
+	for (const auto & Header : a_Headers)
+	{
+		Request.AddHeader(Header.first, Header.second);
+	}
+	return Request;
+}
+
+
+
+
+
+static void TestFormatHTTPDate(void)
+{
+	TEST_EQUAL(cHTTPFileCache::FormatHTTPDate(784111777), "Sun, 06 Nov 1994 08:49:37 GMT");
+	TEST_EQUAL(cHTTPFileCache::FormatHTTPDate(0), "Thu, 01 Jan 1970 00:00:00 GMT");
+}
+
+
+
+
+
+/** Checks that the files are cached, re-read when changed and dropped when deleted. */
+static void TestGetFile(void)
+{
+	cHTTPFileCache Cache;
+	cFile::Delete(TEST_FILE_NAME);
+	TEST_EQUAL(Cache.GetFile(TEST_FILE_NAME, true), nullptr);
+
+	// A compressible file gets a gzipped copy, with a different entity tag:
+	AString Contents;
+	for (int i = 0; i < 200; i++)
+	{
+		Contents.append("body { color: black; }\n");
+	}
+	WriteTestFile(Contents);
+	auto File = Cache.GetFile(TEST_FILE_NAME, true);
+	TEST_NOTEQUAL(File, nullptr);
+	TEST_EQUAL(File->m_Contents, Contents);
+	TEST_FALSE(File->m_GzipContents.empty());
+	TEST_LESS_THAN_OR_EQUAL(File->m_GzipContents.size(), Contents.size());
+	AString Uncompressed;
+	TEST_EQUAL(UncompressStringGZIP(File->m_GzipContents.data(), File->m_GzipContents.size(), Uncompressed), Z_OK);
+	TEST_EQUAL(Uncompressed, Contents);
+	TEST_FALSE(File->m_ETag.empty());
+	TEST_NOTEQUAL(File->m_ETag, File->m_GzipETag);
+	TEST_EQUAL(File->m_LastModified, cHTTPFileCache::FormatHTTPDate(File->m_ModificationTime));
+
+	// An unchanged file is served from the cache:
+	TEST_EQUAL(Cache.GetFile(TEST_FILE_NAME, true), File);
+
+	// A changed file is re-read, the old copy stays valid for whoever still holds it:
+	WriteTestFile("changed");
+	auto Changed = Cache.GetFile(TEST_FILE_NAME, true);
+	TEST_NOTEQUAL(Changed, nullptr);
+	TEST_NOTEQUAL(Changed, File);
+	TEST_EQUAL(Changed->m_Contents, "changed");
+	TEST_NOTEQUAL(Changed->m_ETag, File->m_ETag);
+	TEST_EQUAL(File->m_Contents, Contents);
+
+	// Compression that doesn't save anything is dropped:
+	TEST_TRUE(Changed->m_GzipContents.empty());
+
+	// A deleted file is not served anymore:
+	cFile::Delete(TEST_FILE_NAME);
+	TEST_EQUAL(Cache.GetFile(TEST_FILE_NAME, true), nullptr);
+}
+
+
+
+
+
+static void TestDoesAcceptGzip(void)
+{
+	TEST_FALSE(cHTTPFileCache::DoesAcceptGzip(MakeRequest({})));
+	TEST_TRUE(cHTTPFileCache::DoesAcceptGzip(MakeRequest({{"Accept-Encoding", "gzip, deflate, br"}})));
+	TEST_TRUE(cHTTPFileCache::DoesAcceptGzip(MakeRequest({{"Accept-Encoding", "deflate, GZIP;q=0.5"}})));
+	TEST_FALSE(cHTTPFileCache::DoesAcceptGzip(MakeRequest({{"Accept-Encoding", "deflate, br"}})));
+	TEST_FALSE(cHTTPFileCache::DoesAcceptGzip(MakeRequest({{"Accept-Encoding", "gzip;q=0"}})));
+}
+
+
+
+
+
+static void TestIsNotModified(void)
+{
+	const AString ETag = "\"5f3a-1c2\"";
+	const AString LastModified = "Sun, 06 Nov 1994 08:49:37 GMT";
+
+	// Unconditional request:
+	TEST_FALSE(cHTTPFileCache::IsNotModified(MakeRequest({}), ETag, LastModified));
+
+	// If-None-Match, including weak tags, lists and the wildcard:
+	TEST_TRUE(cHTTPFileCache::IsNotModified(MakeRequest({{"If-None-Match", ETag}}), ETag, LastModified));
+	TEST_TRUE(cHTTPFileCache::IsNotModified(MakeRequest({{"If-None-Match", "W/" + ETag}}), ETag, LastModified));
+	TEST_TRUE(cHTTPFileCache::IsNotModified(MakeRequest({{"If-None-Match", "\"other\", " + ETag}}), ETag, LastModified));
+	TEST_TRUE(cHTTPFileCache::IsNotModified(MakeRequest({{"If-None-Match", "*"}}), ETag, LastModified));
+	TEST_FALSE(cHTTPFileCache::IsNotModified(MakeRequest({{"If-None-Match", "\"other\""}}), ETag, LastModified));
+
+	// If-Modified-Since:
+	TEST_TRUE(cHTTPFileCache::IsNotModified(MakeRequest({{"If-Modified-Since", LastModified}}), ETag, LastModified));
+	TEST_FALSE(cHTTPFileCache::IsNotModified(MakeRequest({{"If-Modified-Since", "Sat, 05 Nov 1994 08:49:37 GMT"}}), ETag, LastModified));
+
+	// If-None-Match takes precedence over If-Modified-Since:
+	TEST_FALSE(cHTTPFileCache::IsNotModified(
+		MakeRequest({{"If-None-Match", "\"other\""}, {"If-Modified-Since", LastModified}}), ETag, LastModified
+	));
+}
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("HTTPFileCache",
+	TestFormatHTTPDate();
+	TestGetFile();
+	TestDoesAcceptGzip();
+	TestIsNotModified();
+)
@@ -0,0 +1,260 @@
+
+// IniFileBenchmark.cpp
+
+// Measures loading the world.ini files of a large server setup: reading the files, and looking up the settings
+// using the name index of cIniFile and using the original linear search that lowercased each candidate name
+
+#include "Globals.h"
+#include "IniFile.h"
+
+
+
+
+
+/** Number of worlds in the measured server setup. */
+static const int NUM_WORLDS = 50;
+
+/** Number of times the lookups of the whole setup are repeated in each measurement. */
+static const int NUM_ROUNDS = 20;
+
+/** The folder where the world.ini files are created. */
+static const AString FILES_FOLDER = "IniFileBenchmark.tmp";
+
+
+
+
+
+/** The keys of the generated world.ini, with the number of values in each, about as many as a world with
+all the generator settings written out has. */
+static const std::pair<const char *, int> WORLD_KEYS[] =
+{
+	{"General",       10},
+	{"Broadcasting",   2},
+	{"SpawnPosition",  6},
+	{"Storage",        3},
+	{"Plants",        10},
+	{"Physics",        8},
+	{"Mechanics",     10},
+	{"Monsters",      14},
+	{"Weather",        3},
+	{"Seed",           1},
+	{"Generator",    140},
+	{"SpawnProtect",   2},
+	{"WorldLimit",     1},
+	{"Difficulty",     1},
+};
+
+
+
+
+
+/** The names of the keys and values in a single cIniFile, searched the way cIniFile::FindKey() and FindValue() did
+before the index: each candidate is lowercased and compared to the lowercased name, in turn. */
+class cLinearNames
+{
+public:
+
+	cLinearNames(const cIniFile & a_Ini)
+	{
+		for (int keyID = 0; keyID < a_Ini.GetNumKeys(); keyID++)
+		{
+			m_KeyNames.push_back(a_Ini.GetKeyName(keyID));
+			m_ValueNames.emplace_back();
+			for (int valueID = 0; valueID < a_Ini.GetNumValues(keyID); valueID++)
+			{
+				m_ValueNames.back().push_back(a_Ini.GetValueName(keyID, valueID));
+			}
+		}
+	}
+
+
+	int FindKey(const AString & a_KeyName) const
+	{
+		AString CaseKeyName = StrToLower(a_KeyName);
+		for (size_t keyID = 0; keyID < m_KeyNames.size(); ++keyID)
+		{
+			if (StrToLower(m_KeyNames[keyID]) == CaseKeyName)
+			{
+				return static_cast<int>(keyID);
+			}
+		}
+		return cIniFile::noID;
+	}
+
+
+	int FindValue(const int keyID, const AString & a_ValueName) const
+	{
+		if ((keyID < 0) || (keyID >= static_cast<int>(m_ValueNames.size())))
+		{
+			return cIniFile::noID;
+		}
+		const auto & Names = m_ValueNames[static_cast<size_t>(keyID)];
+		AString CaseValueName = StrToLower(a_ValueName);
+		for (size_t valueID = 0; valueID < Names.size(); ++valueID)
+		{
+			if (StrToLower(Names[valueID]) == CaseValueName)
+			{
+				return static_cast<int>(valueID);
+			}
+		}
+		return cIniFile::noID;
+	}
+
+protected:
+
+	AStringVector m_KeyNames;
+	std::vector<AStringVector> m_ValueNames;
+};
+
+
+
+
+
+/** A setting looked up when loading a world. */
+struct sLookup
+{
+	AString m_KeyName;
+	AString m_ValueName;
+};
+
+
+
+
+
+/** Returns the contents of the world.ini of the specified world.
+Fills a_Lookups with the settings that loading the world looks up: all the values in the file, in order,
+and a few that aren't in the file yet, as for the settings added by a newer server version. */
+static AString MakeWorldIni(int a_WorldIdx, std::vector<sLookup> & a_Lookups)
+{
+	AString Res;
+	for (const auto & Key: WORLD_KEYS)
+	{
+		Res.append(Printf("[%s]\n", Key.first));
+		for (int i = 0; i < Key.second; i++)
+		{
+			AString ValueName = Printf("%sSetting%d", Key.first, i);
+			Res.append(Printf("%s=%d\n", ValueName.c_str(), a_WorldIdx * 1000 + i));
+			a_Lookups.push_back({Key.first, ValueName});
+		}
+		for (int i = 0; i < (Key.second + 9) / 10; i++)
+		{
+			a_Lookups.push_back({Key.first, Printf("New%sSetting%d", Key.first, i)});
+		}
+		Res.append("\n");
+	}
+	return Res;
+}
+
+
+
+
+
+/** Returns the number of seconds taken by a_Fn. */
+template <typename Fn>
+static double MeasureSeconds(Fn a_Fn)
+{
+	auto Start = std::chrono::steady_clock::now();
+	a_Fn();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+
+
+
+
+int main()
+{
+	// Create the world.ini files:
+	cFile::CreateFolder(FILES_FOLDER);
+	std::vector<std::vector<sLookup>> Lookups(NUM_WORLDS);
+	for (int World = 0; World < NUM_WORLDS; World++)
+	{
+		cFile f(Printf("%s/world%d.ini", FILES_FOLDER.c_str(), World), cFile::fmWrite);
+		f.Write(MakeWorldIni(World, Lookups[static_cast<size_t>(World)]));
+	}
+
+	// Read them, the index is built while reading:
+	std::vector<cIniFile> Inis(NUM_WORLDS);
+	auto ReadSeconds = MeasureSeconds([&]()
+		{
+			for (int World = 0; World < NUM_WORLDS; World++)
+			{
+				Inis[static_cast<size_t>(World)].ReadFile(Printf("%s/world%d.ini", FILES_FOLDER.c_str(), World), false);
+			}
+		}
+	);
+	cFile::DeleteFolderContents(FILES_FOLDER);
+	cFile::DeleteFolder(FILES_FOLDER);
+	std::vector<cLinearNames> LinearNames;
+	int NumValues = 0;
+	for (const auto & Ini: Inis)
+	{
+		LinearNames.emplace_back(Ini);
+	}
+	for (const auto & Key: WORLD_KEYS)
+	{
+		NumValues += Key.second;
+	}
+
+	// Check that both ways find the same settings:
+	size_t NumLookups = 0;
+	for (size_t World = 0; World < Inis.size(); World++)
+	{
+		for (const auto & Lookup: Lookups[World])
+		{
+			int LinearKeyID = LinearNames[World].FindKey(Lookup.m_KeyName);
+			int LinearValueID = LinearNames[World].FindValue(LinearKeyID, Lookup.m_ValueName);
+			int KeyID = Inis[World].FindKey(Lookup.m_KeyName);
+			int ValueID = Inis[World].FindValue(KeyID, Lookup.m_ValueName);
+			if ((LinearKeyID != KeyID) || (LinearValueID != ValueID))
+			{
+				LOGERROR("World %zu, [%s] %s: the linear search found %d / %d, the index %d / %d",
+					World, Lookup.m_KeyName.c_str(), Lookup.m_ValueName.c_str(), LinearKeyID, LinearValueID, KeyID, ValueID
+				);
+				return 1;
+			}
+			NumLookups += 1;
+		}
+	}
+
+	// Measure the lookups of the whole setup, as the world loading does them, without changing the files:
+	size_t NumFound = 0;
+	auto LookupSeconds = [&](auto a_FindKey, auto a_FindValue)
+	{
+		return MeasureSeconds([&]()
+			{
+				for (int Round = 0; Round < NUM_ROUNDS; Round++)
+				{
+					for (size_t World = 0; World < Inis.size(); World++)
+					{
+						for (const auto & Lookup: Lookups[World])
+						{
+							int KeyID = a_FindKey(World, Lookup.m_KeyName);
+							int ValueID = a_FindValue(World, KeyID, Lookup.m_ValueName);
+							if (ValueID != cIniFile::noID)
+							{
+								NumFound += Inis[World].GetValue(KeyID, ValueID).empty() ? 0 : 1;
+							}
+						}
+					}
+				}
+			}
+		) / NUM_ROUNDS;
+	};
+	auto Linear = LookupSeconds(
+		[&](size_t a_World, const AString & a_KeyName) { return LinearNames[a_World].FindKey(a_KeyName); },
+		[&](size_t a_World, int a_KeyID, const AString & a_ValueName) { return LinearNames[a_World].FindValue(a_KeyID, a_ValueName); }
+	);
+	auto Indexed = LookupSeconds(
+		[&](size_t a_World, const AString & a_KeyName) { return Inis[a_World].FindKey(a_KeyName); },
+		[&](size_t a_World, int a_KeyID, const AString & a_ValueName) { return Inis[a_World].FindValue(a_KeyID, a_ValueName); }
+	);
+
+	LOG("Loading %d worlds, %d values in each world.ini, %zu settings looked up (%zu found over all the rounds):",
+		NUM_WORLDS, NumValues, NumLookups, NumFound
+	);
+	LOG("  reading the files, with the index: %7.2f ms", ReadSeconds * 1000);
+	LOG("  looking up the settings, linear:   %7.2f ms, %6.0f ns per setting", Linear * 1000, Linear * 1e9 / NumLookups);
+	LOG("  looking up the settings, indexed:  %7.2f ms, %6.0f ns per setting", Indexed * 1000, Indexed * 1e9 / NumLookups);
+	return 0;
+}
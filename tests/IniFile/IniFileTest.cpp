@@ -0,0 +1,153 @@
+
+// IniFileTest.cpp
+
+// Tests the value lookups in cIniFile, and that its name index is kept up to date by the modifying functions
+
+#include "Globals.h"
+#include "../TestHelpers.h"
+#include "IniFile.h"
+
+
+
+
+
+/** Checks that values created by SetValue() can be read back, and are updated rather than duplicated. */
+static void TestSetValue(void)
+{
+	cIniFile ini;
+	TEST_TRUE(ini.SetValue("Generator", "BiomeGen", "Constant"));
+	TEST_EQUAL(ini.GetValue("Generator", "BiomeGen"), "Constant");
+	TEST_EQUAL(ini.GetValue("generator", "biomegen"), "Constant");  // Case-insensitive by default
+	TEST_NOTEQUAL(ini.FindValue(ini.FindKey("Generator"), "BiomeGen"), cIniFile::noID);
+
+	TEST_TRUE(ini.SetValue("Generator", "BiomeGen", "Grown"));
+	TEST_EQUAL(ini.GetValue("Generator", "BiomeGen"), "Grown");
+	TEST_EQUAL(ini.GetNumValues("Generator"), 1);
+
+	// Without a_CreateIfNotExists, nothing is created:
+	TEST_FALSE(ini.SetValue("Generator", "Missing", "x", false));
+	TEST_FALSE(ini.SetValue("MissingKey", "Missing", "x", false));
+	TEST_EQUAL(ini.FindKey("MissingKey"), cIniFile::noID);
+	TEST_EQUAL(ini.GetNumValues("Generator"), 1);
+
+	TEST_TRUE(ini.SetValueI("Generator", "Seed", 1234));
+	TEST_EQUAL(ini.GetValueI("Generator", "Seed"), 1234);
+	TEST_EQUAL(ini.GetNumValues("Generator"), 2);
+}
+
+
+
+
+
+/** Checks that GetValueSet() only adds the value once. */
+static void TestGetValueSet(void)
+{
+	cIniFile ini;
+	TEST_EQUAL(ini.GetValueSet("General", "Dimension", "Nether"), "Nether");
+	TEST_EQUAL(ini.GetValueSet("General", "Dimension", "Overworld"), "Nether");
+	TEST_EQUAL(ini.GetNumValues("General"), 1);
+
+	TEST_EQUAL(ini.GetValueSetI("General", "Height", 64), 64);
+	TEST_EQUAL(ini.GetValueSetI("General", "Height", 128), 64);
+	TEST_EQUAL(ini.GetNumValues("General"), 2);
+}
+
+
+
+
+
+/** Checks that the lookups still work after the values and keys they index shift by deletion. */
+static void TestDelete(void)
+{
+	cIniFile ini;
+	ini.AddValue("Key1", "A", "1");
+	ini.AddValue("Key1", "B", "2");
+	ini.AddValue("Key1", "C", "3");
+	ini.AddValue("Key2", "D", "4");
+	ini.AddValue("Key3", "E", "5");
+
+	TEST_TRUE(ini.DeleteValue("Key1", "A"));
+	TEST_FALSE(ini.DeleteValue("Key1", "A"));
+	TEST_EQUAL(ini.GetValue("Key1", "A", "none"), "none");
+	TEST_EQUAL(ini.GetValue("Key1", "B"), "2");
+	TEST_EQUAL(ini.GetValue("Key1", "C"), "3");
+	TEST_EQUAL(ini.FindValue(ini.FindKey("Key1"), "C"), 1);
+
+	TEST_TRUE(ini.DeleteKey("Key1"));
+	TEST_FALSE(ini.DeleteKey("Key1"));
+	TEST_EQUAL(ini.FindKey("Key1"), cIniFile::noID);
+	TEST_EQUAL(ini.FindKey("Key2"), 0);
+	TEST_EQUAL(ini.FindKey("Key3"), 1);
+	TEST_EQUAL(ini.GetValue("Key2", "D"), "4");
+	TEST_EQUAL(ini.GetValue("Key3", "E"), "5");
+
+	// A key added after the deletion gets indexed properly:
+	ini.SetValue("Key4", "F", "6");
+	TEST_EQUAL(ini.FindKey("Key4"), 2);
+	TEST_EQUAL(ini.GetValue("Key4", "F"), "6");
+}
+
+
+
+
+
+/** Checks that duplicate names resolve to the first occurrence, as the original linear search did. */
+static void TestDuplicates(void)
+{
+	cIniFile ini;
+	ini.AddValue("Key", "Name", "first");
+	ini.AddValue("Key", "name", "second");
+	TEST_EQUAL(ini.GetValue("Key", "Name"), "first");
+	TEST_EQUAL(ini.GetValue("Key", "NAME"), "first");
+
+	// Deleting the first one uncovers the second:
+	TEST_TRUE(ini.DeleteValue("Key", "Name"));
+	TEST_EQUAL(ini.GetValue("Key", "Name"), "second");
+}
+
+
+
+
+
+/** Checks that switching the case sensitivity re-indexes the existing names. */
+static void TestCaseSensitivity(void)
+{
+	cIniFile ini;
+	ini.CaseSensitive();
+	ini.AddValue("Server", "Port", "25565");
+	ini.AddValue("server", "port", "25566");
+	TEST_EQUAL(ini.GetNumKeys(), 2);
+	TEST_EQUAL(ini.GetValue("Server", "Port"), "25565");
+	TEST_EQUAL(ini.GetValue("server", "port"), "25566");
+	TEST_EQUAL(ini.GetValue("SERVER", "PORT", "none"), "none");
+
+	// When case-insensitive, the first of the keys wins:
+	ini.CaseInsensitive();
+	TEST_EQUAL(ini.FindKey("server"), 0);
+	TEST_EQUAL(ini.GetValue("SERVER", "PORT"), "25565");
+	TEST_EQUAL(ini.GetValue("server", "port"), "25565");
+
+	// Values set while case-insensitive are found by any case:
+	ini.SetValue("Server", "MaxPlayers", "10");
+	TEST_EQUAL(ini.GetValue("server", "maxplayers"), "10");
+
+	// Values set while case-sensitive are indexed by their exact name:
+	ini.CaseSensitive();
+	TEST_EQUAL(ini.FindKey("server"), 1);
+	ini.SetValue("Server", "MOTD", "Hello");
+	TEST_EQUAL(ini.GetValue("Server", "MOTD"), "Hello");
+	TEST_EQUAL(ini.GetValue("Server", "motd", "none"), "none");
+	TEST_EQUAL(ini.GetValue("Server", "MaxPlayers"), "10");
+}
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("IniFile",
+	TestSetValue();
+	TestGetValueSet();
+	TestDelete();
+	TestDuplicates();
+	TestCaseSensitivity();
+)
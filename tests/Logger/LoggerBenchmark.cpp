@@ -0,0 +1,169 @@
+
+// LoggerBenchmark.cpp
+
+// Measures the messages per second logged by several threads at once, with the synchronous and the asynchronous cLogger
+
+#include "Globals.h"
+#include "Logger.h"
+
+
+
+
+
+/** Number of messages logged by each thread in a single measurement. */
+static const int NUM_MESSAGES = 20000;
+
+
+
+
+
+/** Counts the lines and checks that each thread's lines arrive in the order they were logged.
+Optionally spends some time on each line, as a console or a log file on a slow disk would. */
+class cCheckingListener:
+	public cLogger::cListener
+{
+public:
+
+	cCheckingListener(std::chrono::nanoseconds a_LineCost):
+		m_LineCost(a_LineCost),
+		m_NumLines(0),
+		m_NumOutOfOrder(0)
+	{
+	}
+
+
+	/** Prepares for a measurement with the specified number of threads. */
+	void Reset(size_t a_NumThreads)
+	{
+		m_LastSeen.assign(a_NumThreads, -1);
+		m_NumLines = 0;
+		m_NumOutOfOrder = 0;
+	}
+
+
+	/** Returns the number of the measured lines received since Reset(). */
+	int GetNumLines(void) const
+	{
+		return m_NumLines;
+	}
+
+
+	/** Returns the number of the measured lines received after a later line from the same thread. */
+	int GetNumOutOfOrder(void) const
+	{
+		return m_NumOutOfOrder;
+	}
+
+
+	virtual void Log(std::string_view a_Message, eLogLevel a_LogLevel) override
+	{
+		// Log() is called under the logger's lock, so no locking is needed here
+		auto Start = std::chrono::steady_clock::now();
+		auto Pos = a_Message.find("Thread ");
+		if (Pos != std::string_view::npos)
+		{
+			unsigned ThreadIdx;
+			int MessageIdx;
+			if (sscanf(AString(a_Message.substr(Pos)).c_str(), "Thread %u message %d", &ThreadIdx, &MessageIdx) == 2)
+			{
+				m_NumLines += 1;
+				if ((ThreadIdx < m_LastSeen.size()) && (MessageIdx <= m_LastSeen[ThreadIdx]))
+				{
+					m_NumOutOfOrder += 1;
+				}
+				m_LastSeen[ThreadIdx] = MessageIdx;
+			}
+		}
+		while (std::chrono::steady_clock::now() - Start < m_LineCost)
+		{
+			// Busy-wait, the sleep granularity is too coarse for this
+		}
+	}
+
+protected:
+
+	std::chrono::nanoseconds m_LineCost;
+
+	/** The index of the last message received from each thread. */
+	std::vector<int> m_LastSeen;
+
+	int m_NumLines;
+	int m_NumOutOfOrder;
+};
+
+
+
+
+
+/** Logs NUM_MESSAGES from each of a_NumThreads threads at once, then logs the messages per second as seen by the logging threads,
+and the time until all the lines were handed over to the listeners. */
+static void Measure(cCheckingListener & a_Listener, bool a_IsAsync, size_t a_NumThreads, eLogLevel a_LogLevel)
+{
+	auto & Logger = cLogger::GetInstance();
+	a_Listener.Reset(a_NumThreads);
+	if (a_IsAsync)
+	{
+		Logger.StartAsync();
+	}
+
+	auto Start = std::chrono::steady_clock::now();
+	std::vector<std::thread> Threads;
+	for (size_t i = 0; i < a_NumThreads; ++i)
+	{
+		Threads.emplace_back([i, a_LogLevel, &Logger]()
+			{
+				for (int Msg = 0; Msg < NUM_MESSAGES; ++Msg)
+				{
+					Logger.LogSimple(Printf("Thread %u message %d", static_cast<unsigned>(i), Msg), a_LogLevel);
+				}
+			}
+		);
+	}
+	for (auto & Thread: Threads)
+	{
+		Thread.join();
+	}
+	auto Logged = std::chrono::steady_clock::now() - Start;
+	if (a_IsAsync)
+	{
+		Logger.StopAsync();
+	}
+	auto Delivered = std::chrono::steady_clock::now() - Start;
+
+	auto NumMessages = static_cast<int>(a_NumThreads) * NUM_MESSAGES;
+	fmt::print(
+		"{0:<6} {1:<8} {2:2} threads: {3:10.0f} msg/sec logged, {4:8.1f} ms until delivered, {5:6} dropped, {6} out of order\n",
+		a_IsAsync ? "async" : "sync",
+		(a_LogLevel == eLogLevel::Warning) ? "warning" : "regular",
+		a_NumThreads,
+		static_cast<double>(NumMessages) / std::chrono::duration<double>(Logged).count(),
+		std::chrono::duration<double, std::milli>(Delivered).count(),
+		NumMessages - a_Listener.GetNumLines(),
+		a_Listener.GetNumOutOfOrder()
+	);
+}
+
+
+
+
+
+int main()
+{
+	auto & Logger = cLogger::GetInstance();
+	for (auto LineCost: {std::chrono::nanoseconds(0), std::chrono::nanoseconds(2000)})
+	{
+		auto Listener = cpp14::make_unique<cCheckingListener>(LineCost);
+		auto & ListenerRef = *Listener;
+		auto Attachment = Logger.AttachListener(std::move(Listener));
+		fmt::print("Listener taking {0} ns per line, {1} messages per thread:\n", LineCost.count(), NUM_MESSAGES);
+		for (size_t NumThreads: {1, 2, 4, 8})
+		{
+			for (auto LogLevel: {eLogLevel::Regular, eLogLevel::Warning})
+			{
+				Measure(ListenerRef, false, NumThreads, LogLevel);
+				Measure(ListenerRef, true, NumThreads, LogLevel);
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,177 @@
+// LuaContention.cpp
+
+// Implements a benchmark of hook-style calls into Lua from several threads
+// Compares all the threads sharing a single cLuaState (the default plugin mode) against each thread having its own cLuaState (the per-world plugin mode),
+// both with and without also locking the shared main cLuaState on each call
+
+#include "Globals.h"
+#include "Bindings/LuaState.h"
+#include <thread>
+
+
+
+
+
+/** Number of threads calling into Lua, each representing a world's tick thread. */
+static const int NUM_THREADS = 4;
+
+/** Number of hook calls each thread makes. */
+static const int NUM_CALLS = 100000;
+
+
+
+
+
+/** The ways the benchmark threads call into Lua. */
+enum class eMode
+{
+	/** All the threads call into a single shared cLuaState, the default plugin mode. */
+	SharedState,
+
+	/** Each thread calls into its own cLuaState, but takes the shared main cLuaState's lock first, for checking its hooks.
+	This is how cPluginLua::CallWorldHooks() used to call the per-world hooks. */
+	PerThreadStateLockingMain,
+
+	/** Each thread calls into its own cLuaState only, the main cLuaState has no hooks and is skipped. */
+	PerThreadState,
+};
+
+
+
+
+
+/** The measurements from a single benchmark thread. */
+struct sThreadResult
+{
+	/** Total time the thread spent waiting for the Lua state's lock. */
+	std::chrono::nanoseconds m_LockWait;
+
+	/** Set to true if any of the calls failed or returned a bad value. */
+	bool m_HasFailed;
+
+	sThreadResult(void):
+		m_LockWait(0),
+		m_HasFailed(false)
+	{
+	}
+};
+
+
+
+
+
+/** Runs a single benchmark thread.
+Each call locks the Lua state the same way cPluginLua::CallSimpleHooks() does, then calls a callback in it.
+If a_MainLuaState is given, its lock is taken and released before each call, the time spent waiting for it is included in the lock wait. */
+static void runCalls(cLuaState * a_LuaState, cLuaState * a_MainLuaState, unsigned a_Seed, sThreadResult * a_Result)
+{
+	cLuaState::cCallbackPtr callback;
+	{
+		cLuaState::cLock lock(*a_LuaState);
+		if (!a_LuaState->Call("getBusyCallback", a_Seed, cLuaState::Return, callback))
+		{
+			a_Result->m_HasFailed = true;
+			return;
+		}
+	}
+
+	for (unsigned i = 0; i < NUM_CALLS; ++i)
+	{
+		auto start = std::chrono::steady_clock::now();
+		if (a_MainLuaState != nullptr)
+		{
+			cLuaState::cLock mainLock(*a_MainLuaState);
+		}
+		cLuaState::cLock lock(*a_LuaState);
+		a_Result->m_LockWait += std::chrono::steady_clock::now() - start;
+		unsigned returnValue = 0;
+		if (!callback->Call(i, cLuaState::Return, returnValue) || (returnValue != i + a_Seed))
+		{
+			a_Result->m_HasFailed = true;
+			return;
+		}
+	}
+}
+
+
+
+
+
+/** Runs the benchmark in the specified mode.
+Logs the wall time and the total lock wait time.
+Returns true on success, false if any call failed. */
+static bool runBenchmark(eMode a_Mode)
+{
+	// Create the Lua states, the first one is the shared main state:
+	bool shouldShareState = (a_Mode == eMode::SharedState);
+	std::vector<std::unique_ptr<cLuaState>> states;
+	for (int i = 0; i < (shouldShareState ? 1 : NUM_THREADS + 1); ++i)
+	{
+		states.push_back(cpp14::make_unique<cLuaState>(Printf("LuaContention state %d", i)));
+		states.back()->Create();
+		if (!states.back()->LoadFile("Test.lua"))
+		{
+			return false;
+		}
+	}
+
+	// Hammer the states from all the threads:
+	sThreadResult results[NUM_THREADS];
+	std::vector<std::thread> threads;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < NUM_THREADS; ++i)
+	{
+		auto & state = *states[shouldShareState ? 0 : static_cast<size_t>(i + 1)];
+		auto mainState = (a_Mode == eMode::PerThreadStateLockingMain) ? states[0].get() : nullptr;
+		threads.emplace_back(runCalls, &state, mainState, static_cast<unsigned>(i), &results[i]);
+	}
+	for (auto & t: threads)
+	{
+		t.join();
+	}
+	auto wallTime = std::chrono::steady_clock::now() - start;
+
+	// Report:
+	std::chrono::nanoseconds lockWait(0);
+	bool hasFailed = false;
+	for (const auto & res: results)
+	{
+		lockWait += res.m_LockWait;
+		hasFailed = hasFailed || res.m_HasFailed;
+	}
+	static const char * modeNames[] =
+	{
+		"Shared Lua state                    ",
+		"Lua state per thread, locking main  ",
+		"Lua state per thread, skipping main ",
+	};
+	LOG("%s: %d threads x %d calls took %.1f ms, the threads waited for the locks for %.1f ms in total.",
+		modeNames[static_cast<int>(a_Mode)],
+		NUM_THREADS, NUM_CALLS,
+		std::chrono::duration<double, std::milli>(wallTime).count(),
+		std::chrono::duration<double, std::milli>(lockWait).count()
+	);
+	return !hasFailed;
+}
+
+
+
+
+
+int main()
+{
+	LOG("LuaContention starting.");
+
+	if (
+		!runBenchmark(eMode::SharedState) ||
+		!runBenchmark(eMode::PerThreadStateLockingMain) ||
+		!runBenchmark(eMode::PerThreadState)
+	)
+	{
+		LOG("LuaContention failed: a Lua call returned a bad value.");
+		return 1;
+	}
+
+	LOG("LuaContention finished.");
+	return 0;
+}
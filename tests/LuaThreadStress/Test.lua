@@ -15,3 +15,19 @@ function getCallback(a_Seed)
 		return a_Param + a_Seed
 	end
 end
+
+
+
+
+
+--- Returns a function that the C++ code can call, simulating a hook handler with some work in it
+-- The callback takes a single number as param and returns the sum of the param and the seed, given to this factory function (for verification)
+function getBusyCallback(a_Seed)
+	return function (a_Param)
+		local sum = 0
+		for i = 1, 100 do
+			sum = sum + i
+		end
+		return a_Param + a_Seed + sum - 5050
+	end
+end
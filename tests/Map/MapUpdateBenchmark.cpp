@@ -0,0 +1,728 @@
+
+// MapUpdateBenchmark.cpp
+
+// Measures the per-tick cost of updating and sending the maps held by 100 players:
+// the per-pixel chunk lookups and whole-map sends done before, against the chunk-by-chunk, interleaved
+// update that sends only the changed rectangle, as cMap does now
+
+#include "Globals.h"
+#include "BlockType.h"
+#include "FastRandom.h"
+#include "FunctionRef.h"
+#include "OSSupport/CriticalSection.h"
+
+
+
+
+
+/** Number of players, each holding a map. */
+static const int NUM_PLAYERS = 100;
+
+/** Number of ticks measured in each scenario. */
+static const int NUM_TICKS = 100;
+
+/** The radius around the player that is updated each tick, in blocks. Same as cItemMap::DEFAULT_RADIUS. */
+static const unsigned int UPDATE_RADIUS = 128;
+
+/** The size of the area around the spawn in which the players walk and build, in blocks. */
+static const int SPAWN_AREA_SIZE = 512;
+
+/** Number of ticks over which the new update spreads the update of the whole circle. Same as cMap::UPDATE_INTERLEAVE. */
+static const unsigned int UPDATE_INTERLEAVE = 4;
+
+/** The map size, in pixels. */
+static const unsigned int MAP_SIZE = 128;
+
+
+
+
+
+using ColorID = Byte;
+using cColorList = std::vector<ColorID>;
+
+
+
+
+
+/** A chunk in the simulated world. Stores only what the map color calculation reads: the heightmap, the top block
+in each column and, for water columns, the height of the first non-water block below the surface. */
+struct sChunk
+{
+	cChunkDef::HeightMap m_HeightMap;
+	BLOCKTYPE m_TopBlocks[cChunkDef::Width * cChunkDef::Width];
+	HEIGHTTYPE m_FloorHeights[cChunkDef::Width * cChunkDef::Width];
+};
+
+
+
+
+
+/** The simulated world. Chunks are stored in a map and looked up under a lock, same as cChunkMap::DoWithChunk(). */
+class cTestWorld
+{
+public:
+
+	/** Creates the hilly, partly flooded terrain covering the spawn area, the update radius around it and a margin for the players walking out. */
+	cTestWorld(void):
+		m_NumLookups(0)
+	{
+		int MaxChunk = (SPAWN_AREA_SIZE / 2 + static_cast<int>(UPDATE_RADIUS) + 64) / cChunkDef::Width;
+		for (int ChunkX = -MaxChunk; ChunkX <= MaxChunk; ChunkX++)
+		{
+			for (int ChunkZ = -MaxChunk; ChunkZ <= MaxChunk; ChunkZ++)
+			{
+				auto Chunk = cpp14::make_unique<sChunk>();
+				for (int z = 0; z < cChunkDef::Width; z++)
+				{
+					for (int x = 0; x < cChunkDef::Width; x++)
+					{
+						double BlockX = ChunkX * cChunkDef::Width + x;
+						double BlockZ = ChunkZ * cChunkDef::Width + z;
+						auto Height = static_cast<HEIGHTTYPE>(64 + 12 * sin(BlockX / 37) * cos(BlockZ / 29) + 4 * sin(BlockZ / 11 + BlockX / 17));
+						auto Idx = static_cast<size_t>(x + z * cChunkDef::Width);
+						Chunk->m_FloorHeights[Idx] = Height;
+						if (Height < 62)
+						{
+							Chunk->m_HeightMap[Idx] = 62;
+							Chunk->m_TopBlocks[Idx] = E_BLOCK_STATIONARY_WATER;
+						}
+						else
+						{
+							Chunk->m_HeightMap[Idx] = Height;
+							Chunk->m_TopBlocks[Idx] = (Height < 64) ? E_BLOCK_SAND : ((Height > 74) ? E_BLOCK_STONE : E_BLOCK_GRASS);
+						}
+					}
+				}
+				m_Chunks[{ChunkX, ChunkZ}] = std::move(Chunk);
+			}
+		}
+	}
+
+
+	/** Calls the callback for the chunk, under the chunk map lock. Returns false if there's no such chunk. */
+	bool DoWithChunk(int a_ChunkX, int a_ChunkZ, cFunctionRef<bool(sChunk &)> a_Callback)
+	{
+		cCSLock Lock(m_CSChunks);
+		m_NumLookups += 1;
+		auto itr = m_Chunks.find({a_ChunkX, a_ChunkZ});
+		if (itr == m_Chunks.end())
+		{
+			return false;
+		}
+		return a_Callback(*itr->second);
+	}
+
+
+	/** Places a block on top of the specified column, as a building player does. */
+	void PlaceBlock(int a_BlockX, int a_BlockZ, BLOCKTYPE a_BlockType)
+	{
+		int ChunkX, ChunkZ;
+		cChunkDef::BlockToChunk(a_BlockX, a_BlockZ, ChunkX, ChunkZ);
+		DoWithChunk(ChunkX, ChunkZ, [&](sChunk & a_Chunk)
+			{
+				auto Idx = static_cast<size_t>((a_BlockX - ChunkX * cChunkDef::Width) + (a_BlockZ - ChunkZ * cChunkDef::Width) * cChunkDef::Width);
+				if (a_Chunk.m_HeightMap[Idx] < cChunkDef::Height - 1)
+				{
+					a_Chunk.m_HeightMap[Idx] += 1;
+				}
+				a_Chunk.m_TopBlocks[Idx] = a_BlockType;
+				a_Chunk.m_FloorHeights[Idx] = a_Chunk.m_HeightMap[Idx];
+				return true;
+			}
+		);
+	}
+
+
+	/** Returns the number of chunk lookups done so far, and resets the counter. */
+	size_t TakeNumLookups(void)
+	{
+		auto Res = m_NumLookups;
+		m_NumLookups = 0;
+		return Res;
+	}
+
+protected:
+
+	cCriticalSection m_CSChunks;
+
+	std::map<std::pair<int, int>, std::unique_ptr<sChunk>> m_Chunks;
+
+	size_t m_NumLookups;
+};
+
+
+
+
+
+/** Returns the color of the map pixel for the specified column of the chunk.
+Follows cMap::CalcPixelColor(), with a fixed table of the base colours in place of the block handlers. */
+static ColorID CalcPixelColor(sChunk & a_Chunk, int a_RelX, int a_RelZ)
+{
+	static const std::array<unsigned char, 4> BrightnessID = { { 3, 0, 1, 2 } };  // Darkest to lightest
+	auto Idx = static_cast<size_t>(a_RelX + a_RelZ * cChunkDef::Width);
+	int Height = a_Chunk.m_HeightMap[Idx];
+	int ChunkHeight = cChunkDef::Height;
+	BLOCKTYPE TargetBlock = a_Chunk.m_TopBlocks[Idx];
+	ColorID ColourID;
+	switch (TargetBlock)
+	{
+		case E_BLOCK_GRASS:             ColourID = 1;  break;
+		case E_BLOCK_SAND:              ColourID = 2;  break;
+		case E_BLOCK_STONE:             ColourID = 11; break;
+		case E_BLOCK_STATIONARY_WATER:  ColourID = 12; break;
+		case E_BLOCK_PLANKS:            ColourID = 13; break;
+		default:                        ColourID = 11; break;
+	}
+	if (TargetBlock == E_BLOCK_STATIONARY_WATER)
+	{
+		ChunkHeight /= 4;
+		Height = a_Chunk.m_FloorHeights[Idx];
+	}
+	const int BrightnessIDSize = static_cast<int>(BrightnessID.size());
+	return static_cast<ColorID>(ColourID * 4 + BrightnessID[static_cast<size_t>(Clamp<int>((BrightnessIDSize * Height) / ChunkHeight, 0, BrightnessIDSize - 1))]);
+}
+
+
+
+
+
+/** Returns the size of the 1.8 map data packet with the specified number of decorators and size of the pixel rectangle,
+including the packet length and ID. */
+static size_t MapPacketSize(size_t a_NumDecorators, unsigned a_Width, unsigned a_Height)
+{
+	size_t Size = 1 + 1 + 1 + 1 + 3 * a_NumDecorators + 1;  // ID, map ID, scale, decorator count, decorators, columns
+	if (a_Width > 0)
+	{
+		size_t NumPixels = a_Width * a_Height;
+		Size += 3 + ((NumPixels < 128) ? 1 : 2) + NumPixels;  // rows, X, Z, length, pixels
+	}
+	return Size + ((Size < 128) ? 1 : ((Size < 16384) ? 2 : 3));
+}
+
+
+
+
+
+/** A player walking around the spawn area and holding a map. */
+struct sPlayer
+{
+	int m_UniqueID;
+	Vector3d m_Position;
+	Vector3d m_Speed;
+};
+
+
+
+
+
+/** The parts common to both map implementations: the pixels, the holders in the current tick, and the holders' view of the map,
+as assembled from the map data sent to them. */
+class cTestMapBase
+{
+public:
+
+	cTestMapBase(cTestWorld & a_World, int a_CenterX, int a_CenterZ, unsigned int a_Scale):
+		m_World(a_World),
+		m_CenterX(a_CenterX),
+		m_CenterZ(a_CenterZ),
+		m_Scale(a_Scale),
+		m_Data(MAP_SIZE * MAP_SIZE, 0)
+	{
+	}
+
+	virtual ~cTestMapBase() {}
+
+	/** Updates the pixels around the player and registers the player as holding the map in this tick. */
+	void UpdateHolder(const sPlayer & a_Player)
+	{
+		int PixelX, PixelZ;
+		GetHolderPixel(a_Player, PixelX, PixelZ);
+		UpdateRadius(PixelX, PixelZ, UPDATE_RADIUS);
+		m_ClientsInCurrentTick.push_back(a_Player.m_UniqueID);
+	}
+
+	/** Sends the map to the holders of this tick. Returns the number of bytes sent. */
+	virtual size_t Tick(void) = 0;
+
+	/** Returns true if each holder's view of the map is the same as the map data. */
+	bool AreViewsUpToDate(void) const
+	{
+		for (const auto & View: m_Views)
+		{
+			if (View.second != m_Data)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Returns the map data, with the pixels outside the update circles of all the specified holders set to zero.
+	Those pixels keep whatever they were last updated to, which depends on the update order. */
+	cColorList GetDataAround(const std::vector<const sPlayer *> & a_Holders) const
+	{
+		cColorList Res(m_Data.size(), 0);
+		int PixelRadius = static_cast<int>(UPDATE_RADIUS / GetPixelWidth());
+		for (const auto Holder: a_Holders)
+		{
+			int PixelX, PixelZ;
+			GetHolderPixel(*Holder, PixelX, PixelZ);
+			for (int Z = 0; Z < static_cast<int>(MAP_SIZE); Z++)
+			{
+				for (int X = 0; X < static_cast<int>(MAP_SIZE); X++)
+				{
+					if ((X - PixelX) * (X - PixelX) + (Z - PixelZ) * (Z - PixelZ) < PixelRadius * PixelRadius)
+					{
+						auto Idx = static_cast<size_t>(Z) * MAP_SIZE + static_cast<size_t>(X);
+						Res[Idx] = m_Data[Idx];
+					}
+				}
+			}
+		}
+		return Res;
+	}
+
+protected:
+
+	cTestWorld & m_World;
+	int m_CenterX;
+	int m_CenterZ;
+	unsigned int m_Scale;
+
+	/** Row-major array of colours */
+	cColorList m_Data;
+
+	/** Unique IDs of the players holding the map in the current tick. */
+	std::vector<int> m_ClientsInCurrentTick;
+
+	/** The map as seen by each player that was sent the map, assembled from the data sent. */
+	std::map<int, cColorList> m_Views;
+
+
+	virtual void UpdateRadius(int a_PixelX, int a_PixelZ, unsigned int a_Radius) = 0;
+
+	/** Returns the pixel coords of the player, as cMap::UpdateRadius(cPlayer &) calculates them. */
+	void GetHolderPixel(const sPlayer & a_Player, int & a_PixelX, int & a_PixelZ) const
+	{
+		int PixelWidth = static_cast<int>(GetPixelWidth());
+		a_PixelX = static_cast<int>(a_Player.m_Position.x - m_CenterX) / PixelWidth + static_cast<int>(MAP_SIZE / 2);
+		a_PixelZ = static_cast<int>(a_Player.m_Position.z - m_CenterZ) / PixelWidth + static_cast<int>(MAP_SIZE / 2);
+	}
+
+	unsigned int GetPixelWidth(void) const
+	{
+		return 1u << m_Scale;
+	}
+
+	/** Sends the rectangle of pixels to the player: adds it to the player's view, returns the packet size. */
+	size_t SendMapData(int a_UniqueID, unsigned a_StartX, unsigned a_StartZ, unsigned a_Width, unsigned a_Height)
+	{
+		auto & View = m_Views[a_UniqueID];
+		View.resize(m_Data.size());
+		for (unsigned z = a_StartZ; z < a_StartZ + a_Height; ++z)
+		{
+			std::copy_n(m_Data.begin() + z * MAP_SIZE + a_StartX, a_Width, View.begin() + z * MAP_SIZE + a_StartX);
+		}
+		return MapPacketSize(m_ClientsInCurrentTick.size(), a_Width, a_Height);
+	}
+};
+
+
+
+
+
+/** The map update before the chunk-by-chunk rendering: each pixel in the circle looks its chunk up, every tick,
+and the whole map is sent to each holder every tick. Mirrors the removed cMap::UpdatePixel(). */
+class cPerPixelMap:
+	public cTestMapBase
+{
+	using Super = cTestMapBase;
+
+public:
+
+	using Super::Super;
+
+	virtual size_t Tick(void) override
+	{
+		size_t NumBytes = 0;
+		for (auto Client: m_ClientsInCurrentTick)
+		{
+			NumBytes += SendMapData(Client, 0, 0, MAP_SIZE, MAP_SIZE);
+		}
+		m_ClientsInCurrentTick.clear();
+		return NumBytes;
+	}
+
+protected:
+
+	virtual void UpdateRadius(int a_PixelX, int a_PixelZ, unsigned int a_Radius) override
+	{
+		int PixelRadius = static_cast<int>(a_Radius / GetPixelWidth());
+
+		unsigned int StartX = static_cast<unsigned int>(Clamp(a_PixelX - PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+		unsigned int StartZ = static_cast<unsigned int>(Clamp(a_PixelZ - PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+
+		unsigned int EndX   = static_cast<unsigned int>(Clamp(a_PixelX + PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+		unsigned int EndZ   = static_cast<unsigned int>(Clamp(a_PixelZ + PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+
+		for (unsigned int X = StartX; X < EndX; ++X)
+		{
+			for (unsigned int Z = StartZ; Z < EndZ; ++Z)
+			{
+				int dX = static_cast<int>(X) - a_PixelX;
+				int dZ = static_cast<int>(Z) - a_PixelZ;
+
+				if ((dX * dX) + (dZ * dZ) < (PixelRadius * PixelRadius))
+				{
+					UpdatePixel(X, Z);
+				}
+			}
+		}
+	}
+
+
+	void UpdatePixel(unsigned int a_X, unsigned int a_Z)
+	{
+		int BlockX = m_CenterX + static_cast<int>((a_X - MAP_SIZE / 2) * static_cast<unsigned int>(pow(2.0, static_cast<double>(m_Scale))));
+		int BlockZ = m_CenterZ + static_cast<int>((a_Z - MAP_SIZE / 2) * static_cast<unsigned int>(pow(2.0, static_cast<double>(m_Scale))));
+
+		int ChunkX, ChunkZ;
+		cChunkDef::BlockToChunk(BlockX, BlockZ, ChunkX, ChunkZ);
+
+		int RelX = BlockX - (ChunkX * cChunkDef::Width);
+		int RelZ = BlockZ - (ChunkZ * cChunkDef::Width);
+
+		m_World.DoWithChunk(ChunkX, ChunkZ, [&](sChunk & a_Chunk)
+			{
+				m_Data[a_Z * MAP_SIZE + a_X] = CalcPixelColor(a_Chunk, RelX, RelZ);
+				return false;
+			}
+		);
+	}
+};
+
+
+
+
+
+/** The current map update: the circle is walked chunk by chunk in interleaved rows, the changed pixels are tracked,
+and each holder that has seen all the previous changes is only sent the changed rectangle. Mirrors cMap. */
+class cPerChunkMap:
+	public cTestMapBase
+{
+	using Super = cTestMapBase;
+
+public:
+
+	cPerChunkMap(cTestWorld & a_World, int a_CenterX, int a_CenterZ, unsigned int a_Scale):
+		Super(a_World, a_CenterX, a_CenterZ, a_Scale),
+		m_DirtyMinX(0),
+		m_DirtyMinZ(0),
+		m_DirtyMaxX(MAP_SIZE - 1),
+		m_DirtyMaxZ(MAP_SIZE - 1),
+		m_UpdatePhase(0)
+	{
+	}
+
+
+	virtual size_t Tick(void) override
+	{
+		size_t NumBytes = 0;
+		bool HasChanges = (m_DirtyMinX <= m_DirtyMaxX);
+		if (HasChanges)
+		{
+			// Only the clients that receive these changes now will be up to date:
+			std::set<int> UpToDateClients;
+			for (auto Client: m_ClientsInCurrentTick)
+			{
+				if (m_UpToDateClients.count(Client) > 0)
+				{
+					UpToDateClients.insert(Client);
+				}
+			}
+			std::swap(m_UpToDateClients, UpToDateClients);
+		}
+
+		for (auto Client: m_ClientsInCurrentTick)
+		{
+			if (m_UpToDateClients.insert(Client).second)
+			{
+				NumBytes += SendMapData(Client, 0, 0, MAP_SIZE, MAP_SIZE);
+			}
+			else if (HasChanges)
+			{
+				NumBytes += SendMapData(Client, m_DirtyMinX, m_DirtyMinZ, m_DirtyMaxX - m_DirtyMinX + 1, m_DirtyMaxZ - m_DirtyMinZ + 1);
+			}
+			else
+			{
+				NumBytes += SendMapData(Client, 0, 0, 0, 0);
+			}
+		}
+
+		m_DirtyMinX = MAP_SIZE;
+		m_DirtyMinZ = MAP_SIZE;
+		m_DirtyMaxX = 0;
+		m_DirtyMaxZ = 0;
+
+		m_UpdatePhase = (m_UpdatePhase + 1) % UPDATE_INTERLEAVE;
+		m_ClientsInCurrentTick.clear();
+		return NumBytes;
+	}
+
+protected:
+
+	/** The rectangle of pixels changed since the last Tick(), inclusive. Empty if m_DirtyMinX > m_DirtyMaxX. */
+	unsigned int m_DirtyMinX;
+	unsigned int m_DirtyMinZ;
+	unsigned int m_DirtyMaxX;
+	unsigned int m_DirtyMaxZ;
+
+	/** Unique IDs of the clients that have received all the changes made to the map so far. */
+	std::set<int> m_UpToDateClients;
+
+	/** The pixel rows updated in the current tick are those whose index modulo UPDATE_INTERLEAVE equals this. */
+	unsigned int m_UpdatePhase;
+
+
+	int PixelToBlock(unsigned int a_Pixel, int a_Center, unsigned int a_Size) const
+	{
+		return a_Center + (static_cast<int>(a_Pixel) - static_cast<int>(a_Size / 2)) * static_cast<int>(GetPixelWidth());
+	}
+
+
+	void MarkDirty(unsigned int a_X, unsigned int a_Z)
+	{
+		m_DirtyMinX = std::min(m_DirtyMinX, a_X);
+		m_DirtyMinZ = std::min(m_DirtyMinZ, a_Z);
+		m_DirtyMaxX = std::max(m_DirtyMaxX, a_X);
+		m_DirtyMaxZ = std::max(m_DirtyMaxZ, a_Z);
+	}
+
+
+	virtual void UpdateRadius(int a_PixelX, int a_PixelZ, unsigned int a_Radius) override
+	{
+		int PixelRadius = static_cast<int>(a_Radius / GetPixelWidth());
+
+		unsigned int StartX = static_cast<unsigned int>(Clamp(a_PixelX - PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+		unsigned int StartZ = static_cast<unsigned int>(Clamp(a_PixelZ - PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+
+		unsigned int EndX   = static_cast<unsigned int>(Clamp(a_PixelX + PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+		unsigned int EndZ   = static_cast<unsigned int>(Clamp(a_PixelZ + PixelRadius, 0, static_cast<int>(MAP_SIZE)));
+
+		unsigned int MinZ = StartZ;
+		while (MinZ < EndZ)
+		{
+			int ChunkZ = FAST_FLOOR_DIV(PixelToBlock(MinZ, m_CenterZ, MAP_SIZE), cChunkDef::Width);
+			unsigned int MaxZ = MinZ + 1;
+			bool HasRowToUpdate = ((MinZ % UPDATE_INTERLEAVE) == m_UpdatePhase);
+			while ((MaxZ < EndZ) && (FAST_FLOOR_DIV(PixelToBlock(MaxZ, m_CenterZ, MAP_SIZE), cChunkDef::Width) == ChunkZ))
+			{
+				HasRowToUpdate = HasRowToUpdate || ((MaxZ % UPDATE_INTERLEAVE) == m_UpdatePhase);
+				MaxZ++;
+			}
+			if (!HasRowToUpdate)
+			{
+				MinZ = MaxZ;
+				continue;
+			}
+
+			unsigned int MinX = StartX;
+			while (MinX < EndX)
+			{
+				int ChunkX = FAST_FLOOR_DIV(PixelToBlock(MinX, m_CenterX, MAP_SIZE), cChunkDef::Width);
+				unsigned int MaxX = MinX + 1;
+				while ((MaxX < EndX) && (FAST_FLOOR_DIV(PixelToBlock(MaxX, m_CenterX, MAP_SIZE), cChunkDef::Width) == ChunkX))
+				{
+					MaxX++;
+				}
+
+				m_World.DoWithChunk(ChunkX, ChunkZ, [&](sChunk & a_Chunk)
+					{
+						for (unsigned int Z = MinZ; Z < MaxZ; ++Z)
+						{
+							if ((Z % UPDATE_INTERLEAVE) != m_UpdatePhase)
+							{
+								continue;
+							}
+							int dZ = static_cast<int>(Z) - a_PixelZ;
+							int RelZ = PixelToBlock(Z, m_CenterZ, MAP_SIZE) - ChunkZ * cChunkDef::Width;
+							for (unsigned int X = MinX; X < MaxX; ++X)
+							{
+								int dX = static_cast<int>(X) - a_PixelX;
+								if ((dX * dX) + (dZ * dZ) >= (PixelRadius * PixelRadius))
+								{
+									continue;
+								}
+								int RelX = PixelToBlock(X, m_CenterX, MAP_SIZE) - ChunkX * cChunkDef::Width;
+								ColorID Color = CalcPixelColor(a_Chunk, RelX, RelZ);
+								auto & Pixel = m_Data[Z * MAP_SIZE + X];
+								if (Pixel != Color)
+								{
+									Pixel = Color;
+									MarkDirty(X, Z);
+								}
+							}  // for X
+						}  // for Z
+						return false;
+					}
+				);
+				MinX = MaxX;
+			}  // while (MinX < EndX)
+			MinZ = MaxZ;
+		}  // while (MinZ < EndZ)
+	}
+};
+
+
+
+
+
+/** The results of running a scenario with one of the map implementations. */
+struct sResult
+{
+	double m_MsecPerTick;
+	double m_LookupsPerTick;
+	double m_KiBPerTick;
+	cColorList m_FinalData;
+	bool m_AreViewsUpToDate;
+};
+
+
+
+
+
+/** Runs NUM_TICKS ticks of NUM_PLAYERS players walking and building around the spawn, each holding either their own map
+centered on their starting position, or all of them holding the same map centered on the spawn.
+Then runs UPDATE_INTERLEAVE more ticks without any changes, so that all the pixels around the holders are refreshed,
+and checks the holders' views. */
+template <class MapClass>
+static sResult RunScenario(unsigned int a_Scale, bool a_IsSharedMap)
+{
+	cTestWorld World;
+	std::seed_seq Seed{1};  // Both implementations need to see the same players and blocks
+	cFastRandom Random(Seed);
+	std::vector<sPlayer> Players;
+	std::vector<std::unique_ptr<cTestMapBase>> Maps;
+	for (int i = 0; i < NUM_PLAYERS; i++)
+	{
+		Vector3d Pos(Random.RandReal(-SPAWN_AREA_SIZE / 2.0, SPAWN_AREA_SIZE / 2.0), 80, Random.RandReal(-SPAWN_AREA_SIZE / 2.0, SPAWN_AREA_SIZE / 2.0));
+		Vector3d Speed(Random.RandReal(-0.2, 0.2), 0, Random.RandReal(-0.2, 0.2));
+		Players.push_back({i, Pos, Speed});
+		if (!a_IsSharedMap || Maps.empty())
+		{
+			int CenterX = a_IsSharedMap ? 0 : FloorC(Pos.x);
+			int CenterZ = a_IsSharedMap ? 0 : FloorC(Pos.z);
+			Maps.push_back(cpp14::make_unique<MapClass>(World, CenterX, CenterZ, a_Scale));
+		}
+	}
+
+	auto RunTick = [&](bool a_ShouldBuild)
+	{
+		size_t NumBytes = 0;
+		for (size_t i = 0; i < Players.size(); i++)
+		{
+			auto & Player = Players[i];
+			if (a_ShouldBuild)
+			{
+				Player.m_Position += Player.m_Speed;
+				World.PlaceBlock(
+					FloorC(Player.m_Position.x) + Random.RandInt(-8, 8),
+					FloorC(Player.m_Position.z) + Random.RandInt(-8, 8),
+					E_BLOCK_PLANKS
+				);
+			}
+			Maps[a_IsSharedMap ? 0 : i]->UpdateHolder(Player);
+		}
+		for (auto & Map: Maps)
+		{
+			NumBytes += Map->Tick();
+		}
+		return NumBytes;
+	};
+
+	World.TakeNumLookups();
+	size_t NumBytes = 0;
+	auto Start = std::chrono::steady_clock::now();
+	for (int Tick = 0; Tick < NUM_TICKS; Tick++)
+	{
+		NumBytes += RunTick(true);
+	}
+	auto Duration = std::chrono::steady_clock::now() - Start;
+	auto NumLookups = World.TakeNumLookups();
+
+	for (unsigned int Tick = 0; Tick < UPDATE_INTERLEAVE; Tick++)
+	{
+		RunTick(false);
+	}
+
+	sResult Res;
+	Res.m_MsecPerTick = std::chrono::duration<double, std::milli>(Duration).count() / NUM_TICKS;
+	Res.m_LookupsPerTick = static_cast<double>(NumLookups) / NUM_TICKS;
+	Res.m_KiBPerTick = static_cast<double>(NumBytes) / 1024 / NUM_TICKS;
+	Res.m_AreViewsUpToDate = true;
+	for (size_t i = 0; i < Maps.size(); i++)
+	{
+		std::vector<const sPlayer *> Holders;
+		for (size_t p = 0; p < Players.size(); p++)
+		{
+			if (a_IsSharedMap || (p == i))
+			{
+				Holders.push_back(&Players[p]);
+			}
+		}
+		auto Data = Maps[i]->GetDataAround(Holders);
+		Res.m_FinalData.insert(Res.m_FinalData.end(), Data.begin(), Data.end());
+		Res.m_AreViewsUpToDate = Res.m_AreViewsUpToDate && Maps[i]->AreViewsUpToDate();
+	}
+	return Res;
+}
+
+
+
+
+
+/** Runs the scenario with both map implementations and logs the results.
+Returns false if the maps end up different around the holders, or if any holder's view doesn't match its map. */
+static bool Measure(unsigned int a_Scale, bool a_IsSharedMap)
+{
+	auto PerPixel = RunScenario<cPerPixelMap>(a_Scale, a_IsSharedMap);
+	auto PerChunk = RunScenario<cPerChunkMap>(a_Scale, a_IsSharedMap);
+	if (PerPixel.m_FinalData != PerChunk.m_FinalData)
+	{
+		LOGERROR("Scale %u: the maps differ after the update", a_Scale);
+		return false;
+	}
+	if (!PerPixel.m_AreViewsUpToDate || !PerChunk.m_AreViewsUpToDate)
+	{
+		LOGERROR("Scale %u: the players' views differ from the maps", a_Scale);
+		return false;
+	}
+	LOG("  %s, scale %u (%4u blocks per pixel):", a_IsSharedMap ? "one shared map" : "own maps", a_Scale, 1u << (2 * a_Scale));
+	LOG("    per pixel: %7.2f ms per tick, %8.0f chunk lookups per tick, %7.1f KiB sent per tick",
+		PerPixel.m_MsecPerTick, PerPixel.m_LookupsPerTick, PerPixel.m_KiBPerTick
+	);
+	LOG("    per chunk: %7.2f ms per tick, %8.0f chunk lookups per tick, %7.1f KiB sent per tick",
+		PerChunk.m_MsecPerTick, PerChunk.m_LookupsPerTick, PerChunk.m_KiBPerTick
+	);
+	return true;
+}
+
+
+
+
+
+int main()
+{
+	LOG("Map update benchmark, %d players walking and building, %d ticks:", NUM_PLAYERS, NUM_TICKS);
+	for (bool IsSharedMap: {false, true})
+	{
+		for (unsigned int Scale: {0u, 2u, 3u, 4u})
+		{
+			if (!Measure(Scale, IsSharedMap))
+			{
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
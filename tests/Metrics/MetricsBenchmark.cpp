@@ -0,0 +1,317 @@
+
+// MetricsBenchmark.cpp
+
+// Measures the overhead of the metrics instrumentation: the cost of the individual metric updates,
+// the cost added to queueing the packets for a client, the per-second world gauge update and the export
+
+#include "Globals.h"
+#include "ByteBuffer.h"
+#include "Metrics.h"
+#include "OSSupport/CriticalSection.h"
+
+
+
+
+
+/** Number of operations in each single-threaded measurement. */
+static const int NUM_OPS = 10000000;
+
+/** Number of packets queued in each measurement of the packet path. */
+static const int NUM_PACKETS = 1000000;
+
+/** Number of packets queued for a client between two flushes to the socket, about a tick's worth for a busy client. */
+static const int PACKETS_PER_FLUSH = 50;
+
+/** Number of worlds registered in the export measurement. */
+static const int NUM_WORLDS = 10;
+
+
+
+
+
+/** The accessors of the network metrics, with the function-local statics used by cClientHandle and cProtocol_1_8_0. */
+static cMetricCounter & GetPacketsSentMetric(void)
+{
+	static cMetricCounter & Metric = cMetrics::Get().GetCounter("cuberite_network_sent_packets_total", "Number of packets sent to the clients.");
+	return Metric;
+}
+
+static cMetricCounter & GetBytesSentMetric(void)
+{
+	static cMetricCounter & Metric = cMetrics::Get().GetCounter("cuberite_network_sent_bytes_total", "Number of bytes sent to the clients.");
+	return Metric;
+}
+
+static cMetricGauge & GetSendBacklogMetric(void)
+{
+	static cMetricGauge & Metric = cMetrics::Get().GetGauge("cuberite_network_send_backlog_bytes", "Number of bytes queued for sending to the clients.");
+	return Metric;
+}
+
+
+
+
+
+/** Returns the time taken by a_NumOps calls of a_Op, in nanoseconds per call. */
+template <typename Op>
+static double NsecPerOp(int a_NumOps, Op a_Op)
+{
+	auto Start = std::chrono::steady_clock::now();
+	for (int i = 0; i < a_NumOps; i++)
+	{
+		a_Op(i);
+	}
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count() / a_NumOps;
+}
+
+
+
+
+
+/** Measures the single metric updates against a plain increment of a non-atomic variable. */
+static void MeasureUpdates(void)
+{
+	volatile UInt64 Plain = 0;
+	auto & Counter = cMetrics::Get().GetCounter("benchmark_counter", "Counter");
+	auto & Gauge = cMetrics::Get().GetGauge("benchmark_gauge", "Gauge");
+	auto & Histogram = cMetrics::Get().GetHistogram("benchmark_histogram", "Histogram", {0.005, 0.01, 0.025, 0.05, 0.075, 0.1, 0.25, 0.5, 1});
+
+	auto PlainNs = NsecPerOp(NUM_OPS, [&](int) { Plain = Plain + 1; });
+	auto CounterNs = NsecPerOp(NUM_OPS, [&](int) { Counter.Add(); });
+	auto AccessorNs = NsecPerOp(NUM_OPS, [&](int) { GetPacketsSentMetric().Add(); });
+	auto GaugeNs = NsecPerOp(NUM_OPS, [&](int a_Idx) { Gauge.Add((a_Idx % 2 == 0) ? 100 : -100); });
+	auto HistogramNs = NsecPerOp(NUM_OPS, [&](int a_Idx) { Histogram.Observe(0.04 + (a_Idx % 100) * 0.0002); });
+	LOG("Single metric updates, %d each:", NUM_OPS);
+	LOG("  plain volatile increment:              %6.2f ns", PlainNs);
+	LOG("  counter Add():                         %6.2f ns", CounterNs);
+	LOG("  counter Add() through static accessor: %6.2f ns", AccessorNs);
+	LOG("  gauge Add():                           %6.2f ns", GaugeNs);
+	LOG("  histogram Observe(), 9 buckets:        %6.2f ns", HistogramNs);
+}
+
+
+
+
+
+/** Models queueing packets for a client: the packet is written into a cByteBuffer, read out as cProtocol_1_8_0::SendPacket() does,
+and appended to the outgoing data under a lock, as cClientHandle::SendData() does. Every PACKETS_PER_FLUSH packets,
+the outgoing data is taken away, as cClientHandle::ProcessProtocolInOut() does.
+With a_IsInstrumented, the metrics are updated in the same places as the server does. */
+class cClientModel
+{
+public:
+
+	cClientModel(bool a_IsInstrumented):
+		m_IsInstrumented(a_IsInstrumented),
+		m_OutPacketBuffer(512 KiB),
+		m_NumBytesFlushed(0)
+	{
+	}
+
+
+	/** Queues an entity relative move packet. */
+	void SendEntityRelMove(UInt32 a_EntityID)
+	{
+		if (m_IsInstrumented)
+		{
+			GetPacketsSentMetric().Add();
+		}
+		m_OutPacketBuffer.WriteVarInt32(0x15);
+		m_OutPacketBuffer.WriteVarInt32(a_EntityID);
+		m_OutPacketBuffer.WriteBEInt8(1);
+		m_OutPacketBuffer.WriteBEInt8(0);
+		m_OutPacketBuffer.WriteBEInt8(-1);
+		m_OutPacketBuffer.WriteBool(true);
+		AString PacketData;
+		m_OutPacketBuffer.ReadAll(PacketData);
+		m_OutPacketBuffer.CommitRead();
+		SendData(PacketData.data(), PacketData.size());
+	}
+
+
+	/** Takes the queued outgoing data away, as if it was sent to the socket. */
+	void Flush(void)
+	{
+		AString OutgoingData;
+		{
+			cCSLock Lock(m_CSOutgoingData);
+			std::swap(OutgoingData, m_OutgoingData);
+		}
+		if (m_IsInstrumented)
+		{
+			GetSendBacklogMetric().Add(-static_cast<Int64>(OutgoingData.size()));
+			GetBytesSentMetric().Add(OutgoingData.size());
+		}
+		m_NumBytesFlushed += OutgoingData.size();
+	}
+
+
+	size_t GetNumBytesFlushed(void) const { return m_NumBytesFlushed; }
+
+protected:
+
+	bool m_IsInstrumented;
+	cByteBuffer m_OutPacketBuffer;
+	cCriticalSection m_CSOutgoingData;
+	AString m_OutgoingData;
+	size_t m_NumBytesFlushed;
+
+
+	void SendData(const char * a_Data, size_t a_Size)
+	{
+		cCSLock Lock(m_CSOutgoingData);
+		m_OutgoingData.append(a_Data, a_Size);
+		if (m_IsInstrumented)
+		{
+			GetSendBacklogMetric().Add(static_cast<Int64>(a_Size));
+		}
+	}
+};
+
+
+
+
+
+/** Queues NUM_PACKETS packets on each of a_NumThreads threads, each thread with its own client, all sharing the metrics.
+Adds the number of bytes flushed to a_NumBytesFlushed.
+Returns the time per packet, in nanoseconds, as seen by a single thread. */
+static double MeasurePackets(bool a_IsInstrumented, int a_NumThreads, std::atomic<UInt64> & a_NumBytesFlushed)
+{
+	std::vector<std::thread> Threads;
+	std::vector<double> Times(static_cast<size_t>(a_NumThreads));
+	for (int t = 0; t < a_NumThreads; t++)
+	{
+		Threads.emplace_back([a_IsInstrumented, &Times, &a_NumBytesFlushed, t]()
+			{
+				cClientModel Client(a_IsInstrumented);
+				Times[static_cast<size_t>(t)] = NsecPerOp(NUM_PACKETS, [&](int a_Idx)
+					{
+						Client.SendEntityRelMove(static_cast<UInt32>(a_Idx));
+						if (a_Idx % PACKETS_PER_FLUSH == PACKETS_PER_FLUSH - 1)
+						{
+							Client.Flush();
+						}
+					}
+				);
+				Client.Flush();
+				a_NumBytesFlushed += Client.GetNumBytesFlushed();
+			}
+		);
+	}
+	for (auto & Thread: Threads)
+	{
+		Thread.join();
+	}
+	return *std::max_element(Times.begin(), Times.end());
+}
+
+
+
+
+
+/** Registers the metrics of NUM_WORLDS worlds, the way cWorld and its threads do.
+Returns the time of a single cWorld::UpdateMetrics()-like update of the world gauges, in microseconds. */
+static double RegisterWorlds(void)
+{
+	auto & Metrics = cMetrics::Get();
+	double UpdateUsec = 0;
+	for (int World = 0; World < NUM_WORLDS; World++)
+	{
+		auto Labels = cMetrics::Label("world", Printf("world_%d", World));
+		Metrics.GetHistogram(
+			"cuberite_world_tick_duration_seconds", "Duration of the world ticks, in seconds.",
+			{0.005, 0.01, 0.025, 0.05, 0.075, 0.1, 0.25, 0.5, 1}, Labels
+		).Observe(0.02);
+		static const char * CounterNames[] =
+		{
+			"cuberite_chunks_sent_total",
+			"cuberite_chunks_lit_total",
+			"cuberite_chunk_lighting_microseconds_total",
+			"cuberite_chunks_generated_total",
+			"cuberite_chunk_generating_microseconds_total",
+			"cuberite_chunks_loaded_total",
+			"cuberite_chunk_loading_microseconds_total",
+		};
+		for (auto Name: CounterNames)
+		{
+			Metrics.GetCounter(Name, "Counter.", Labels).Add(100);
+		}
+
+		// The per-second update of the world gauges, each looked up in the registry by its name and labels:
+		static const char * GaugeNames[] =
+		{
+			"cuberite_world_chunks_loaded",
+			"cuberite_world_chunks_dirty",
+			"cuberite_world_players",
+			"cuberite_world_generator_queue_length",
+			"cuberite_world_lighting_queue_length",
+			"cuberite_world_storage_load_queue_length",
+			"cuberite_world_storage_save_queue_length",
+			"cuberite_world_chunk_send_queue_length",
+			"cuberite_world_path_queue_length",
+		};
+		UpdateUsec = NsecPerOp(1000, [&](int a_Idx)
+			{
+				auto UpdateLabels = cMetrics::Label("world", Printf("world_%d", World));
+				for (auto Name: GaugeNames)
+				{
+					Metrics.GetGauge(Name, "Gauge.", UpdateLabels).Set(a_Idx);
+				}
+			}
+		) / 1000;
+	}
+	return UpdateUsec;
+}
+
+
+
+
+
+int main()
+{
+	MeasureUpdates();
+
+	LOG("Queueing %d packets per thread, flushed every %d packets:", NUM_PACKETS, PACKETS_PER_FLUSH);
+	std::atomic<UInt64> NumPlainBytes(0), NumInstrumentedBytes(0);
+	for (int NumThreads: {1, 2, 4})
+	{
+		// Alternate the two, and take the best of a few runs, to cancel out the warm-up and the noise:
+		double Plain = std::numeric_limits<double>::max();
+		double Instrumented = std::numeric_limits<double>::max();
+		for (int Run = 0; Run < 3; Run++)
+		{
+			Plain = std::min(Plain, MeasurePackets(false, NumThreads, NumPlainBytes));
+			Instrumented = std::min(Instrumented, MeasurePackets(true, NumThreads, NumInstrumentedBytes));
+		}
+		LOG("  %d thread(s): %6.2f ns per packet without the metrics, %6.2f ns with them (%+.1f %%)",
+			NumThreads, Plain, Instrumented, 100 * (Instrumented - Plain) / Plain
+		);
+	}
+
+	// The instrumented runs must have counted every byte and left nothing in the backlog:
+	if (
+		(NumPlainBytes != NumInstrumentedBytes) ||
+		(GetBytesSentMetric().GetValue() != NumInstrumentedBytes) ||
+		(GetSendBacklogMetric().GetValue() != 0)
+	)
+	{
+		LOGERROR("The metrics disagree with the data sent: %llu bytes sent, %llu bytes counted, %lld bytes left in the backlog",
+			static_cast<unsigned long long>(NumInstrumentedBytes.load()),
+			static_cast<unsigned long long>(GetBytesSentMetric().GetValue()),
+			static_cast<long long>(GetSendBacklogMetric().GetValue())
+		);
+		return 1;
+	}
+
+	auto UpdateUsec = RegisterWorlds();
+	LOG("Updating the gauges of a world, done once per second: %.2f us", UpdateUsec);
+
+	size_t Size = 0;
+	auto ExportUsec = NsecPerOp(1000, [&](int)
+		{
+			Size = cMetrics::Get().GetPrometheusText().size();
+		}
+	) / 1000;
+	LOG("Exporting the registry with %d worlds: %.1f us, %zu bytes", NUM_WORLDS, ExportUsec, Size);
+	return 0;
+}
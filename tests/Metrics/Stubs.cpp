@@ -0,0 +1,16 @@
+
+// Stubs.cpp
+
+// Implements stubs of various Cuberite methods that are needed for linking but not for runtime
+// This is required so that we don't bring in the entire Cuberite via dependencies
+
+#include "Globals.h"
+#include "UUID.h"
+
+
+
+
+
+void cUUID::FromRaw(const std::array<Byte, 16> &)
+{
+}
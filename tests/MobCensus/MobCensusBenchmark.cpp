@@ -0,0 +1,363 @@
+
+// MobCensusBenchmark.cpp
+
+// Measures the per-tick cost of the mob census on a crowded server:
+// the incrementally maintained cMobCensus against the full recount done every tick before it
+
+#include "Globals.h"
+#include "FastRandom.h"
+#include "MobCensus.h"
+
+
+
+
+
+/** The players' view distance, in chunks. */
+static const int VIEW_DISTANCE = 10;
+
+/** Number of ticks measured in each scenario. */
+static const int NUM_TICKS = 200;
+
+
+
+
+
+struct sChunk;
+
+/** A mob in the simulated world. */
+struct sMob
+{
+	cMonster::eFamily m_Family;
+	Vector3d m_Position;
+	sChunk * m_Chunk;
+};
+
+
+/** A player in the simulated world, loading the chunks around it. */
+struct sPlayer
+{
+	Vector3d m_Position;
+	int m_ChunkX;
+	int m_ChunkZ;
+};
+
+
+/** A chunk in the simulated world, with the players that have it loaded, same as cChunk::m_LoadedByClient. */
+struct sChunk
+{
+	std::vector<sMob *> m_Mobs;
+	std::vector<sPlayer *> m_Clients;
+};
+
+
+
+
+
+/** The census as it was collected before it was kept incrementally: every tick, each mob in each chunk loaded by a client
+is collected along with its distance to each of the chunk's clients, and the families' mobs and the eligible chunks are gathered into sets.
+Mirrors the removed cChunk::CollectMobCensus(), cMobProximityCounter and cMobFamilyCollecter. */
+class cRecountedCensus
+{
+public:
+
+	/** Collects a single chunk, as the removed cChunk::CollectMobCensus() did. */
+	void CollectChunk(sChunk & a_Chunk)
+	{
+		m_EligibleForSpawnChunks.insert(&a_Chunk);
+		std::vector<Vector3d> PlayerPositions;
+		PlayerPositions.reserve(a_Chunk.m_Clients.size());
+		for (auto Player: a_Chunk.m_Clients)
+		{
+			PlayerPositions.push_back(Player->m_Position);
+		}
+		for (auto Mob: a_Chunk.m_Mobs)
+		{
+			for (const auto & PlayerPos: PlayerPositions)
+			{
+				CollectMob(*Mob, a_Chunk, (Mob->m_Position - PlayerPos).SqrLength());
+			}
+		}
+	}
+
+
+	int GetNumMobs(cMonster::eFamily a_Family) const
+	{
+		return static_cast<int>(m_Mobs[static_cast<size_t>(a_Family)].size());
+	}
+
+
+	int GetNumChunks(void) const
+	{
+		return static_cast<int>(m_EligibleForSpawnChunks.size());
+	}
+
+protected:
+
+	struct sDistanceAndChunk
+	{
+		double m_Distance;
+		sChunk * m_Chunk;
+	};
+
+	std::map<sMob *, sDistanceAndChunk> m_MonsterToDistance;
+	std::set<sChunk *> m_EligibleForSpawnChunks;
+	std::array<std::set<sMob *>, cMonster::mfUnhandled + 1> m_Mobs;
+
+
+	void CollectMob(sMob & a_Mob, sChunk & a_Chunk, double a_Distance)
+	{
+		auto itr = m_MonsterToDistance.find(&a_Mob);
+		if (itr == m_MonsterToDistance.end())
+		{
+			m_MonsterToDistance.emplace(&a_Mob, sDistanceAndChunk{a_Distance, &a_Chunk});
+		}
+		else if (a_Distance < itr->second.m_Distance)
+		{
+			itr->second.m_Distance = a_Distance;
+			itr->second.m_Chunk = &a_Chunk;
+		}
+		m_EligibleForSpawnChunks.insert(&a_Chunk);
+		m_Mobs[static_cast<size_t>(a_Mob.m_Family)].insert(&a_Mob);
+	}
+};
+
+
+
+
+
+/** The simulated world: players in groups, mobs in the chunks the players load.
+Moves the mobs and players between the chunks and keeps an incremental cMobCensus up to date, the way cChunk does. */
+class cWorldModel
+{
+public:
+
+	cWorldModel(int a_NumPlayers, int a_NumMobs):
+		m_NumMobs(a_NumMobs)
+	{
+		// The players stand in groups of 10 (towns, farms), the groups are scattered over the world:
+		m_Players.resize(static_cast<size_t>(a_NumPlayers));
+		Vector3d GroupCenter;
+		for (size_t i = 0; i < m_Players.size(); ++i)
+		{
+			if (i % 10 == 0)
+			{
+				GroupCenter.Set(m_Random.RandReal(-5000.0, 5000.0), 64, m_Random.RandReal(-5000.0, 5000.0));
+			}
+			auto & Player = m_Players[i];
+			Player.m_Position = GroupCenter + Vector3d(m_Random.RandReal(-64.0, 64.0), 0, m_Random.RandReal(-64.0, 64.0));
+			cChunkDef::BlockToChunk(FloorC(Player.m_Position.x), FloorC(Player.m_Position.z), Player.m_ChunkX, Player.m_ChunkZ);
+			for (int x = -VIEW_DISTANCE; x <= VIEW_DISTANCE; ++x)
+			{
+				for (int z = -VIEW_DISTANCE; z <= VIEW_DISTANCE; ++z)
+				{
+					AddClient(Player.m_ChunkX + x, Player.m_ChunkZ + z, Player);
+				}
+			}
+		}
+
+		// The mobs are spread over the loaded chunks:
+		static const cMonster::eFamily Families[] = {cMonster::mfHostile, cMonster::mfHostile, cMonster::mfPassive, cMonster::mfAmbient, cMonster::mfWater};
+		std::vector<std::pair<int, int>> ChunkCoords;
+		for (const auto & Chunk: m_Chunks)
+		{
+			ChunkCoords.push_back(Chunk.first);
+		}
+		m_Mobs.resize(static_cast<size_t>(a_NumMobs));
+		for (auto & Mob: m_Mobs)
+		{
+			auto Coords = ChunkCoords[static_cast<size_t>(m_Random.RandInt(static_cast<int>(ChunkCoords.size()) - 1))];
+			Mob.m_Family = Families[m_Random.RandInt(4)];
+			Mob.m_Position.Set(Coords.first * cChunkDef::Width + 8, 64, Coords.second * cChunkDef::Width + 8);
+			MoveMobTo(Mob, m_Chunks[Coords]);
+		}
+	}
+
+
+	/** Moves some of the mobs and players to the neighboring chunks, as happens during a single tick. */
+	void Tick(void)
+	{
+		// About 1 % of the mobs cross into a neighbor chunk each tick:
+		for (int i = m_NumMobs / 100; i > 0; --i)
+		{
+			auto & Mob = m_Mobs[static_cast<size_t>(m_Random.RandInt(m_NumMobs - 1))];
+			int ChunkX, ChunkZ;
+			cChunkDef::BlockToChunk(FloorC(Mob.m_Position.x), FloorC(Mob.m_Position.z), ChunkX, ChunkZ);
+			auto Neighbor = m_Chunks.find({ChunkX + m_Random.RandInt(-1, 1), ChunkZ + m_Random.RandInt(-1, 1)});
+			if (Neighbor != m_Chunks.end())
+			{
+				Mob.m_Position.Set(Neighbor->first.first * cChunkDef::Width + 8, 64, Neighbor->first.second * cChunkDef::Width + 8);
+				MoveMobTo(Mob, Neighbor->second);
+			}
+		}
+
+		// About 1 in 20 players walks into a neighbor chunk each tick, the chunks at the edges of its view change:
+		for (auto & Player: m_Players)
+		{
+			if (m_Random.RandInt(19) == 0)
+			{
+				MovePlayer(Player, m_Random.RandBool() ? 1 : -1);
+			}
+		}
+	}
+
+
+	/** Returns the census as the world kept it incrementally. */
+	const cMobCensus & GetCensus(void) const
+	{
+		return m_Census;
+	}
+
+
+	/** Returns the census recounted from scratch, as every tick did before. */
+	cRecountedCensus Recount(void)
+	{
+		cRecountedCensus Res;
+		for (auto & Chunk: m_Chunks)
+		{
+			if (!Chunk.second.m_Clients.empty())
+			{
+				Res.CollectChunk(Chunk.second);
+			}
+		}
+		return Res;
+	}
+
+protected:
+
+	cFastRandom m_Random;
+	int m_NumMobs;
+	std::vector<sPlayer> m_Players;
+	std::vector<sMob> m_Mobs;
+	std::map<std::pair<int, int>, sChunk> m_Chunks;
+	cMobCensus m_Census;
+
+
+	/** Adds the player to the chunk's clients; makes the chunk eligible, with its mobs, if it is its first client. */
+	void AddClient(int a_ChunkX, int a_ChunkZ, sPlayer & a_Player)
+	{
+		auto & Chunk = m_Chunks[{a_ChunkX, a_ChunkZ}];
+		Chunk.m_Clients.push_back(&a_Player);
+		if (Chunk.m_Clients.size() == 1)
+		{
+			m_Census.AddSpawnableChunk();
+			for (auto Mob: Chunk.m_Mobs)
+			{
+				m_Census.AddMob(Mob->m_Family);
+			}
+		}
+	}
+
+
+	/** Removes the player from the chunk's clients; makes the chunk ineligible, with its mobs, if it was its last client. */
+	void RemoveClient(int a_ChunkX, int a_ChunkZ, sPlayer & a_Player)
+	{
+		auto & Chunk = m_Chunks[{a_ChunkX, a_ChunkZ}];
+		Chunk.m_Clients.erase(std::find(Chunk.m_Clients.begin(), Chunk.m_Clients.end(), &a_Player));
+		if (Chunk.m_Clients.empty())
+		{
+			m_Census.RemoveSpawnableChunk();
+			for (auto Mob: Chunk.m_Mobs)
+			{
+				m_Census.RemoveMob(Mob->m_Family);
+			}
+		}
+	}
+
+
+	/** Moves the mob into the specified chunk, updating the census if the chunks' eligibility differs. */
+	void MoveMobTo(sMob & a_Mob, sChunk & a_Chunk)
+	{
+		if (a_Mob.m_Chunk != nullptr)
+		{
+			auto & Mobs = a_Mob.m_Chunk->m_Mobs;
+			Mobs.erase(std::find(Mobs.begin(), Mobs.end(), &a_Mob));
+			if (!a_Mob.m_Chunk->m_Clients.empty())
+			{
+				m_Census.RemoveMob(a_Mob.m_Family);
+			}
+		}
+		a_Mob.m_Chunk = &a_Chunk;
+		a_Chunk.m_Mobs.push_back(&a_Mob);
+		if (!a_Chunk.m_Clients.empty())
+		{
+			m_Census.AddMob(a_Mob.m_Family);
+		}
+	}
+
+
+	/** Moves the player by a single chunk along the X axis; the columns at the edges of its view are loaded and unloaded. */
+	void MovePlayer(sPlayer & a_Player, int a_Dir)
+	{
+		int OldEdgeX = a_Player.m_ChunkX - a_Dir * VIEW_DISTANCE;
+		int NewEdgeX = a_Player.m_ChunkX + a_Dir * (VIEW_DISTANCE + 1);
+		for (int z = -VIEW_DISTANCE; z <= VIEW_DISTANCE; ++z)
+		{
+			AddClient(NewEdgeX, a_Player.m_ChunkZ + z, a_Player);
+			RemoveClient(OldEdgeX, a_Player.m_ChunkZ + z, a_Player);
+		}
+		a_Player.m_ChunkX += a_Dir;
+		a_Player.m_Position.x += a_Dir * cChunkDef::Width;
+	}
+};
+
+
+
+
+
+/** Ticks the world, measuring the census used for the spawning decisions both ways; checks that they agree. */
+static bool Measure(int a_NumPlayers, int a_NumMobs)
+{
+	static const cMonster::eFamily Families[] = {cMonster::mfHostile, cMonster::mfPassive, cMonster::mfAmbient, cMonster::mfWater};
+	cWorldModel World(a_NumPlayers, a_NumMobs);
+	std::chrono::steady_clock::duration Incremental{}, Recounted{};
+	int NumCapped = 0;
+	for (int Tick = 0; Tick < NUM_TICKS; ++Tick)
+	{
+		// The incremental census pays for the changes as they happen, measure them along with the cap checks:
+		auto Start = std::chrono::steady_clock::now();
+		World.Tick();
+		for (auto Family: Families)
+		{
+			NumCapped += World.GetCensus().IsCapped(Family) ? 1 : 0;
+		}
+		Incremental += std::chrono::steady_clock::now() - Start;
+
+		Start = std::chrono::steady_clock::now();
+		auto Census = World.Recount();
+		Recounted += std::chrono::steady_clock::now() - Start;
+
+		for (auto Family: Families)
+		{
+			if (Census.GetNumMobs(Family) != World.GetCensus().GetNumMobs(Family))
+			{
+				LOG("The incremental census disagrees with the recount for family %d: %d vs %d",
+					Family, World.GetCensus().GetNumMobs(Family), Census.GetNumMobs(Family)
+				);
+				return false;
+			}
+		}
+	}
+
+	auto PerTick = [](std::chrono::steady_clock::duration a_Duration)
+	{
+		return std::chrono::duration<double, std::micro>(a_Duration).count() / NUM_TICKS;
+	};
+	LOG("%3d players, %5d mobs: incremental %8.1f us/tick (including the moves), recounted %8.1f us/tick (%d capped checks)",
+		a_NumPlayers, a_NumMobs, PerTick(Incremental), PerTick(Recounted), NumCapped
+	);
+	return true;
+}
+
+
+
+
+
+int main()
+{
+	LOG("Mob census benchmark, %d ticks per scenario:", NUM_TICKS);
+	bool IsOk =
+		Measure(10, 500) &&
+		Measure(100, 3000) &&
+		Measure(300, 10000);
+	return IsOk ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+
+// NoiseBenchmark.cpp
+
+// Measures the generating speed of each noise type, in 2D and 3D, for several octave counts
+
+#include "Globals.h"
+#include "Noise/Noise.h"
+#include "Noise/InterpolNoise.h"
+
+
+
+
+
+/** Size of the generated 2D arrays, in each direction. Matches the size used by the biome and height generators. */
+static const int SIZE_2D = 256;
+
+/** Size of the generated 3D arrays, in each direction. */
+static const int SIZE_3D = 32;
+
+/** Minimum time that each measurement runs for. */
+static const std::chrono::milliseconds MIN_DURATION(500);
+
+
+
+
+
+/** Generates the arrays over and over again for at least MIN_DURATION, then logs the number of values per second. */
+template <typename GenerateFn>
+static void Measure(const AString & a_Name, int a_NumValues, GenerateFn a_Generate)
+{
+	// Warm up the caches:
+	a_Generate(0);
+
+	Int64 NumValues = 0;
+	auto Start = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::duration Elapsed;
+	int Iteration = 0;
+	do
+	{
+		a_Generate(++Iteration);
+		NumValues += a_NumValues;
+		Elapsed = std::chrono::steady_clock::now() - Start;
+	} while (Elapsed < MIN_DURATION);
+
+	auto Seconds = std::chrono::duration<double>(Elapsed).count();
+	LOG("%-48s %8.2f Msamples/sec", a_Name.c_str(), static_cast<double>(NumValues) / Seconds / 1e6);
+}
+
+
+
+
+
+/** Measures the specified noise in 2D and 3D.
+Each iteration moves the generated area, so that the noise doesn't keep hitting the same cells. */
+template <typename NoiseType>
+static void Benchmark2D3D(const AString & a_Name, const NoiseType & a_Noise)
+{
+	std::vector<NOISE_DATATYPE> Values(SIZE_2D * SIZE_2D);
+	Measure(a_Name + " 2D", SIZE_2D * SIZE_2D, [&](int a_Iteration)
+		{
+			auto Start = static_cast<NOISE_DATATYPE>(a_Iteration % 1000) * 4;
+			a_Noise.Generate2D(Values.data(), SIZE_2D, SIZE_2D, Start, Start + 25.6f, 0, 25.6f);
+		}
+	);
+	Values.resize(SIZE_3D * SIZE_3D * SIZE_3D);
+	Measure(a_Name + " 3D", SIZE_3D * SIZE_3D * SIZE_3D, [&](int a_Iteration)
+		{
+			auto Start = static_cast<NOISE_DATATYPE>(a_Iteration % 1000) * 4;
+			a_Noise.Generate3D(Values.data(), SIZE_3D, SIZE_3D, SIZE_3D, Start, Start + 3.2f, 0, 3.2f, 0, 3.2f);
+		}
+	);
+}
+
+
+
+
+
+/** Measures the specified octaved noise type with 1, 2, 4 and 8 octaves.
+The octaves start at a low frequency and double, so that even the finest of 8 octaves has less than one noise cell per value. */
+template <typename NoiseType>
+static void BenchmarkOctaves(const AString & a_Name)
+{
+	for (int NumOctaves = 1; NumOctaves <= 8; NumOctaves *= 2)
+	{
+		NoiseType Noise(0);
+		NOISE_DATATYPE Frequency = 0.0625f;
+		NOISE_DATATYPE Amplitude = 1;
+		for (int i = 0; i < NumOctaves; i++)
+		{
+			Noise.AddOctave(Frequency, Amplitude);
+			Frequency *= 2;
+			Amplitude /= 2;
+		}
+		Benchmark2D3D(Printf("%s, %d octaves", a_Name.c_str(), NumOctaves), Noise);
+	}
+}
+
+
+
+
+
+int main()
+{
+	LOG("NoiseBenchmark started, measuring each noise type for at least %d ms.", static_cast<int>(MIN_DURATION.count()));
+
+	Benchmark2D3D("cCubicNoise", cCubicNoise(0));
+	Benchmark2D3D("cImprovedNoise", cImprovedNoise(0));
+	Benchmark2D3D("cInterp5DegNoise", cInterp5DegNoise(0));
+	BenchmarkOctaves<cPerlinNoise>("cPerlinNoise");
+	BenchmarkOctaves<cOctavedNoise<cInterp5DegNoise>>("cOctavedNoise<cInterp5DegNoise>");
+
+	// cRidgedNoise doesn't compile its Generate3D(), so cRidgedMultiNoise cannot be measured here
+
+	LOG("NoiseBenchmark finished.");
+	return 0;
+}
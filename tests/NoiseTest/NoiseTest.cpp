@@ -1,32 +1,99 @@
 
 // NoiseTest.cpp
 
-// Implements the main app entrypoint
+// Checks the outputs of all the noise types against the values produced by the original (pre-vectorization) implementation
 
 #include "Globals.h"
-#include <time.h>
-#include "Noise.h"
+#include "../TestHelpers.h"
+#include "Noise/Noise.h"
+#include "Noise/InterpolNoise.h"
 
 
 
 
 
-void SaveValues(NOISE_DATATYPE * a_Values, const AString & a_FileName)
+/** Number of values sampled from each generated array. */
+static const int NUM_SAMPLES = 8;
+
+/** Maximum allowed difference from the expected value, relative to the value's magnitude (at least 1).
+The outputs are bit-identical with the same compiler and flags; this allows for FMA contraction and different math libs. */
+static const double TOLERANCE = 1e-4;
+
+
+
+
+
+/** The values generated by a noise with the original implementation. */
+struct sExpected
 {
-	cFile f;
-	if (!f.Open(a_FileName, cFile::fmWrite))
-	{
-		LOGWARNING("Cannot write file %s", a_FileName.c_str());
-		return;
-	}
-	for (int y = 0; y < 256; y++)
+	/** Name of the noise and the dimension, used for logging. */
+	const char * m_Name;
+
+	/** Sum of all the values in the generated array. */
+	double m_Sum;
+
+	/** Values sampled from the generated array, at the indices given by GetSampleIndex(). */
+	NOISE_DATATYPE m_Samples[NUM_SAMPLES];
+};
+
+static const sExpected g_Expected[] =
+{
+	{"cCubicNoise 2D", -13.8981628, {1.0321852f, 0.0844459832f, 0.503900468f, -0.287077606f, -0.00670884363f, -0.059235502f, 0.815642416f, 0.531155765f}},
+	{"cCubicNoise 3D", 1.66606714, {0.16899693f, -0.04398885f, -0.268362522f, 0.998836815f, -0.000622197986f, 0.401366949f, -0.0255954433f, 0.710317731f}},
+	{"cImprovedNoise 2D", 3.38999569, {0.045145154f, -0.0172310155f, -0.127043962f, -0.354577243f, -0.178663194f, -0.203435361f, -0.0203842521f, 0.150091767f}},
+	{"cImprovedNoise 3D", -11.2941906, {-0.256388336f, 0.138222769f, -0.342372596f, 0.0337762646f, 0.285627455f, -0.275186837f, 0.0276114941f, 0.505572438f}},
+	{"cInterp5DegNoise 2D", -13.8852745, {0.839745522f, 0.148587808f, 0.50727129f, -0.45920217f, -0.0601933002f, 0.0502854437f, 0.582363844f, 0.541210473f}},
+	{"cInterp5DegNoise 3D", 6.96740972, {0.274622262f, -0.205135092f, -0.234847739f, 0.79880482f, 0.0448232777f, 0.417052209f, 0.125329733f, 0.358809799f}},
+	{"cPerlinNoise 2D", 5.68849419, {0.260963529f, -0.312528849f, 0.0100287199f, 0.845593095f, 0.308230042f, -0.767837882f, 0.538621366f, -0.88835305f}},
+	{"cPerlinNoise 3D", -89.3580048, {0.765903711f, -0.782117724f, -0.546140909f, -0.68091321f, -0.24468717f, -0.14629069f, -0.470013767f, -1.00045455f}},
+	{"cRidgedMultiNoise 2D", 462.94921, {0.301070243f, 0.519271135f, 0.162428856f, 0.845593095f, 0.473834574f, 0.767837882f, 0.893004715f, 1.49193609f}},
+};
+
+
+
+
+
+/** Returns the index into the generated array of the specified sample.
+The sample indices are spread over the whole array, offset so that they don't all fall on the array's edge. */
+static size_t GetSampleIndex(size_t a_ArraySize, int a_SampleIdx)
+{
+	return a_ArraySize * static_cast<size_t>(a_SampleIdx) / NUM_SAMPLES + 3;
+}
+
+
+
+
+
+static bool IsClose(double a_Actual, double a_Expected)
+{
+	return (std::abs(a_Actual - a_Expected) <= TOLERANCE * std::max(1.0, std::abs(a_Expected)));
+}
+
+
+
+
+
+/** Compares the generated values to the expected ones. */
+static void CheckValues(const std::vector<NOISE_DATATYPE> & a_Values, size_t a_ExpectedIdx)
+{
+	const auto & Expected = g_Expected[a_ExpectedIdx];
+	LOG("Checking %s...", Expected.m_Name);
+	for (int i = 0; i < NUM_SAMPLES; i++)
 	{
-		unsigned char val[256];
-		for (int x = 0; x < 256; x++)
+		auto Actual = a_Values[GetSampleIndex(a_Values.size(), i)];
+		if (!IsClose(Actual, Expected.m_Samples[i]))
 		{
-			val[x] = std::min(255, std::max(0, (int)(256 * a_Values[x + 256 * y])));
+			TEST_FAIL(Printf("%s: sample %d is %.9g, expected %.9g", Expected.m_Name, i, Actual, Expected.m_Samples[i]));
 		}
-		f.Write(val, 256);
+	}
+	double Sum = 0;
+	for (auto v: a_Values)
+	{
+		Sum += v;
+	}
+	if (!IsClose(Sum, Expected.m_Sum))
+	{
+		TEST_FAIL(Printf("%s: the sum is %.9g, expected %.9g", Expected.m_Name, Sum, Expected.m_Sum));
 	}
 }
 
@@ -34,68 +101,76 @@ void SaveValues(NOISE_DATATYPE * a_Values, const AString & a_FileName)
 
 
 
-clock_t TestCubicNoise(void)
+/** Generates a 2D array with the specified noise and checks it against the expected values.
+The array's dimensions and coords are chosen so that they include negative coords and are not aligned to the noise cells. */
+template <typename NoiseType>
+static void Check2D(const NoiseType & a_Noise, size_t a_ExpectedIdx)
 {
-	cCubicNoise Cubic(0);
-	NOISE_DATATYPE Values[256 * 256];
-	
-	// Do a speed test:
-	clock_t Begin = clock();
-	for (int i = 0; i < 1000; i++)
-	{
-		Cubic.Generate2D(Values, 256, 256, 0, (NOISE_DATATYPE)25.6, 0, (NOISE_DATATYPE)25.6);
-	}
-	clock_t Ticks = clock() - Begin;
-	LOG("cCubicNoise generating 1000 * 256x256 values took %d ticks (%.02f sec)", Ticks, (double)Ticks / CLOCKS_PER_SEC);
-	
-	// Save the results into a file for visual comparison:
-	SaveValues(Values, "NoiseCubic.raw");
-	
-	return Ticks;
+	std::vector<NOISE_DATATYPE> Values(33 * 17);
+	a_Noise.Generate2D(Values.data(), 33, 17, -40.3f, 12.7f, -7.1f, 25.9f);
+	CheckValues(Values, a_ExpectedIdx);
 }
 
 
 
 
 
-clock_t TestOldNoise(void)
+/** Generates a 3D array with the specified noise and checks it against the expected values. */
+template <typename NoiseType>
+static void Check3D(const NoiseType & a_Noise, size_t a_ExpectedIdx)
 {
-	cNoise Noise(0);
-	NOISE_DATATYPE Values[256 * 256];
+	std::vector<NOISE_DATATYPE> Values(9 * 13 * 7);
+	a_Noise.Generate3D(Values.data(), 9, 13, 7, -3.3f, 5.2f, -17.75f, -1.5f, 100.1f, 104.6f);
+	CheckValues(Values, a_ExpectedIdx);
+}
 
-	// Do a speed test:
-	clock_t Begin = clock();
-	for (int i = 0; i < 1000; i++)
-	{
-		for (int y = 0; y < 256; y++)
-		{
-			float fy = (float)y / 10;
-			for (int x = 0; x < 256; x++)
-			{
-				Values[x + 256 * y] = Noise.CubicNoise2D((float)x / 10, fy);
-			}  // for x
-		}  // for y
-	}
-	clock_t Ticks = clock() - Begin;
-	LOG("cNoise generating 1000 * 256x256 values took %d ticks (%.02f sec)", Ticks, (double)Ticks / CLOCKS_PER_SEC);
-	
-	// Save the results into a file for visual comparison:
-	SaveValues(Values, "NoiseOld.raw");
-	
-	return Ticks;
+
+
+
+
+/** Adds the same four octaves to the specified octaved noise. */
+template <typename NoiseType>
+static void AddOctaves(NoiseType & a_Noise)
+{
+	a_Noise.AddOctave(0.13f, 1.0f);
+	a_Noise.AddOctave(0.26f, 0.5f);
+	a_Noise.AddOctave(0.52f, 0.25f);
+	a_Noise.AddOctave(1.04f, 0.125f);
 }
 
 
 
 
 
-int main(int argc, char * argv[])
+static void TestNoises(void)
 {
-	new cMCLogger();  // Create a logger (will set itself as the main instance
-	
-	clock_t NewTicks = TestCubicNoise();
-	clock_t OldTicks = TestOldNoise();
-	LOG("New method is %.02fx faster", (double)OldTicks / NewTicks);
-	LOG("Press Enter to quit program");
-	getchar();
+	cCubicNoise Cubic(42);
+	Check2D(Cubic, 0);
+	Check3D(Cubic, 1);
+
+	cImprovedNoise Improved(42);
+	Check2D(Improved, 2);
+	Check3D(Improved, 3);
+
+	cInterp5DegNoise Interp(42);
+	Check2D(Interp, 4);
+	Check3D(Interp, 5);
+
+	cPerlinNoise Perlin(42);
+	AddOctaves(Perlin);
+	Check2D(Perlin, 6);
+	Check3D(Perlin, 7);
+
+	// cRidgedNoise doesn't compile its Generate3D(), so only 2D is checked:
+	cRidgedMultiNoise Ridged(42);
+	AddOctaves(Ridged);
+	Check2D(Ridged, 8);
 }
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("NoiseTest",
+	TestNoises();
+)
@@ -0,0 +1,138 @@
+
+// PathBenchmark.cpp
+
+// Measures the cost of N mobs requesting their paths at once, calculated on the tick thread and on the cPathCalculatorThread
+
+#include "Globals.h"
+#include "TestWorld.h"
+#include "FastRandom.h"
+#include "Mobs/Path.h"
+#include "Mobs/PathCalculatorThread.h"
+
+
+
+
+
+/** The number of steps that cPathFinder gives each path. */
+static const int MAX_STEPS = 20;
+
+
+
+
+
+/** The starting points and destinations of the paths requested by a single batch of mobs. */
+struct sRequest
+{
+	Vector3d m_Source;
+	Vector3d m_Destination;
+};
+
+using sRequests = std::vector<sRequest>;
+
+
+
+
+
+/** Returns a_NumPaths requests for the paths of mobs scattered over 6 x 6 chunks, each to a random target up to 24 blocks away. */
+static sRequests CreateRequests(size_t a_NumPaths)
+{
+	cFastRandom Random;
+	sRequests Res;
+	for (size_t i = 0; i < a_NumPaths; ++i)
+	{
+		Vector3d Source(Random.RandInt(0, 95) + 0.5, cTestWorld::SURFACE_Y, Random.RandInt(0, 95) + 0.5);
+		Vector3d Destination(Source.x + Random.RandInt(-24, 24), cTestWorld::SURFACE_Y, Source.z + Random.RandInt(-24, 24));
+		Res.push_back({Source, Destination});
+	}
+	return Res;
+}
+
+
+
+
+
+/** Creates and calculates all the paths on the calling thread, as the tick thread did before cPathCalculatorThread.
+Returns the time spent. */
+static std::chrono::steady_clock::duration MeasureSynchronous(cTestWorld & a_World, const sRequests & a_Requests)
+{
+	auto Start = std::chrono::steady_clock::now();
+	for (const auto & Request: a_Requests)
+	{
+		cPath Path(a_World.GetSource(), Request.m_Source, Request.m_Destination, MAX_STEPS, 0.6, 1.8);
+		Path.Calculate();
+	}
+	return std::chrono::steady_clock::now() - Start;
+}
+
+
+
+
+
+/** Creates all the paths on the calling thread and queues them to a_Thread.
+Outputs the time spent on the calling thread (snapshots and queueing) and the time until all the paths are calculated. */
+static void MeasureThreaded(
+	cTestWorld & a_World, cPathCalculatorThread & a_Thread, const sRequests & a_Requests,
+	std::chrono::steady_clock::duration & a_TickThreadTime, std::chrono::steady_clock::duration & a_TotalTime
+)
+{
+	std::vector<std::shared_ptr<cPath>> Paths;
+	Paths.reserve(a_Requests.size());
+	auto Start = std::chrono::steady_clock::now();
+	for (const auto & Request: a_Requests)
+	{
+		Paths.push_back(std::make_shared<cPath>(a_World.GetSource(), Request.m_Source, Request.m_Destination, MAX_STEPS, 0.6, 1.8));
+		a_Thread.QueuePath(Paths.back());
+	}
+	a_TickThreadTime = std::chrono::steady_clock::now() - Start;
+
+	for (const auto & Path: Paths)
+	{
+		while (!Path->IsCalculated())
+		{
+			std::this_thread::yield();
+		}
+	}
+	a_TotalTime = std::chrono::steady_clock::now() - Start;
+}
+
+
+
+
+
+static double ToMsec(std::chrono::steady_clock::duration a_Duration)
+{
+	return std::chrono::duration<double, std::milli>(a_Duration).count();
+}
+
+
+
+
+
+int main()
+{
+	LOG("Path benchmark: mobs requesting their paths in the same tick, %u hardware threads", std::thread::hardware_concurrency());
+	cTestWorld World(true);
+	cPathCalculatorThread Thread;
+	if (!Thread.Start())
+	{
+		LOGERROR("Cannot start the path calculator thread");
+		return 1;
+	}
+
+	// Generate all the chunks beforehand, so that the first measurement doesn't include the generation:
+	MeasureSynchronous(World, CreateRequests(1000));
+
+	for (size_t NumPaths: {1, 10, 100, 1000})
+	{
+		auto Requests = CreateRequests(NumPaths);
+		auto Synchronous = MeasureSynchronous(World, Requests);
+		std::chrono::steady_clock::duration TickThread, Total;
+		MeasureThreaded(World, Thread, Requests, TickThread, Total);
+		LOG("%5zu paths: synchronous %8.2f ms; threaded: tick thread %8.2f ms, all calculated after %8.2f ms",
+			NumPaths, ToMsec(Synchronous), ToMsec(TickThread), ToMsec(Total)
+		);
+	}
+
+	Thread.Stop();
+	return 0;
+}
@@ -0,0 +1,139 @@
+
+// PathTest.cpp
+
+// Tests the cPath calculation over a snapshot of the chunks, and the cPathCalculatorThread
+
+#include "Globals.h"
+#include "../TestHelpers.h"
+#include "TestWorld.h"
+#include "Mobs/Path.h"
+#include "Mobs/PathCalculatorThread.h"
+
+
+
+
+
+/** The number of steps that cPathFinder gives each path. */
+static const int MAX_STEPS = 20;
+
+
+
+
+
+/** Returns the position of the walkable block at the specified X and Z, as the mobs stand on it. */
+static Vector3d WalkPos(double a_X, double a_Z)
+{
+	return {a_X + 0.5, static_cast<double>(cTestWorld::SURFACE_Y), a_Z + 0.5};
+}
+
+
+
+
+
+/** Checks that a path to a nearby point is found. */
+static void TestNearTarget(void)
+{
+	cTestWorld World(false);
+	cPath Path(World.GetSource(), WalkPos(3, 3), WalkPos(10, 12), MAX_STEPS, 0.6, 1.8);
+	Path.Calculate();
+	TEST_TRUE(Path.IsCalculated());
+	TEST_EQUAL(Path.GetStatus(), ePathFinderStatus::PATH_FOUND);
+	TEST_TRUE(Path.WayPointsLeft() > 0);
+}
+
+
+
+
+
+/** Checks that a path to a point far beyond the neighboring chunks is found, rather than ending nearby. */
+static void TestFarTarget(void)
+{
+	cTestWorld World(false);
+	cPath Path(World.GetSource(), WalkPos(3, 3), WalkPos(3, 63), MAX_STEPS, 0.6, 1.8);
+	Path.Calculate();
+	TEST_EQUAL(Path.GetStatus(), ePathFinderStatus::PATH_FOUND);
+
+	// The snapshot spans the chunks between the source and the destination, plus a chunk of margin:
+	TEST_EQUAL(World.GetNumChunks(), 3U * 6U);
+
+	// The path ends at the destination:
+	Vector3d Last;
+	while (!Path.NoMoreWayPoints())
+	{
+		Last = Path.GetNextPoint();
+	}
+	TEST_EQUAL(Vector3i(Last.Floor()), Vector3i(WalkPos(3, 63).Floor()));
+}
+
+
+
+
+
+/** Checks that an abandoned path stops without a result. */
+static void TestAbandoned(void)
+{
+	cTestWorld World(true);
+	cPath Path(World.GetSource(), WalkPos(3, 3), WalkPos(40, 40), MAX_STEPS, 0.6, 1.8);
+	Path.Abandon();
+	Path.Calculate();
+	TEST_TRUE(Path.IsCalculated());
+	TEST_EQUAL(Path.GetStatus(), ePathFinderStatus::PATH_NOT_FOUND);
+}
+
+
+
+
+
+/** Checks that the calculator thread calculates the queued paths, and skips those abandoned meanwhile. */
+static void TestCalculatorThread(void)
+{
+	cTestWorld World(true);
+	std::vector<std::shared_ptr<cPath>> Paths;
+	for (int i = 0; i < 50; ++i)
+	{
+		Paths.push_back(std::make_shared<cPath>(World.GetSource(), WalkPos(3, 3), WalkPos(i, 40 - i), MAX_STEPS, 0.6, 1.8));
+	}
+
+	// Abandon every other path before the thread gets to them:
+	for (size_t i = 0; i < Paths.size(); i += 2)
+	{
+		Paths[i]->Abandon();
+	}
+	cPathCalculatorThread Thread;
+	TEST_TRUE(Thread.Start());
+	for (const auto & Path: Paths)
+	{
+		Thread.QueuePath(Path);
+	}
+	Thread.QueuePath(std::make_shared<cPath>(World.GetSource(), WalkPos(3, 3), WalkPos(5, 5), MAX_STEPS, 0.6, 1.8));
+	while (Thread.GetQueueLength() > 0)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	for (size_t i = 1; i < Paths.size(); i += 2)
+	{
+		while (!Paths[i]->IsCalculated())
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		TEST_TRUE(Paths[i]->GetStatus() != ePathFinderStatus::CALCULATING);
+	}
+	Thread.Stop();
+
+	// The abandoned paths were never calculated:
+	for (size_t i = 0; i < Paths.size(); i += 2)
+	{
+		TEST_TRUE(!Paths[i]->IsCalculated());
+	}
+}
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("Path",
+	TestNearTarget();
+	TestFarTarget();
+	TestAbandoned();
+	TestCalculatorThread();
+)
@@ -0,0 +1,111 @@
+
+// TestWorld.h
+
+// Declares the cTestWorld class providing the chunks that the path tests and benchmarks calculate the paths over
+
+
+
+
+
+#pragma once
+
+#include "BlockType.h"
+#include "ChunkData.h"
+#include "ChunkDataCallback.h"
+#include "Mobs/Path.h"
+
+
+
+
+
+/** A flat stone world with the surface at SURFACE_Y, optionally scattered with walls that the paths need to go around.
+The chunks are generated on demand and kept, and the paths' snapshots share their sections, same as with the live chunks. */
+class cTestWorld
+{
+public:
+
+	/** The Y coord of the air block right above the surface, where the mobs walk. */
+	static const int SURFACE_Y = 64;
+
+
+	/** Creates the world. If a_HasWalls is true, each chunk gets a few walls, 3 blocks high, with gaps. */
+	cTestWorld(bool a_HasWalls):
+		m_HasWalls(a_HasWalls),
+		m_Pool(cpp14::make_unique<cChunkDataCopyCollector::MemCallbacks>(), 0, 0)
+	{
+	}
+
+
+	/** Returns a source of the chunk data for the cPath constructor. */
+	cPath::cChunkDataSource GetSource(void)
+	{
+		return *this;
+	}
+
+
+	/** The chunk data source: copies the specified chunk into a_Dest. */
+	bool operator () (int a_ChunkX, int a_ChunkZ, cChunkData & a_Dest)
+	{
+		a_Dest.Assign(GetChunk(a_ChunkX, a_ChunkZ));
+		return true;
+	}
+
+
+	/** Returns the number of chunks generated so far. */
+	size_t GetNumChunks(void) const
+	{
+		return m_Chunks.size();
+	}
+
+protected:
+
+	bool m_HasWalls;
+
+	cListAllocationPool<cChunkData::sChunkSection> m_Pool;
+
+	/** The chunks generated so far. */
+	std::map<std::pair<int, int>, std::unique_ptr<cChunkData>> m_Chunks;
+
+
+	/** Returns the specified chunk, generating it if needed. */
+	const cChunkData & GetChunk(int a_ChunkX, int a_ChunkZ)
+	{
+		auto & Chunk = m_Chunks[{a_ChunkX, a_ChunkZ}];
+		if (Chunk != nullptr)
+		{
+			return *Chunk;
+		}
+		Chunk = cpp14::make_unique<cChunkData>(m_Pool);
+		for (int y = 0; y < SURFACE_Y; ++y)
+		{
+			for (int z = 0; z < cChunkDef::Width; ++z)
+			{
+				for (int x = 0; x < cChunkDef::Width; ++x)
+				{
+					Chunk->SetBlock({x, y, z}, E_BLOCK_STONE);
+				}
+			}
+		}
+		if (m_HasWalls)
+		{
+			// A wall along X and another along Z, each with a gap whose position depends on the chunk coords:
+			int GapX = (a_ChunkX * 7 + a_ChunkZ * 3) & 0x0f;
+			int GapZ = (a_ChunkX * 5 + a_ChunkZ * 11) & 0x0f;
+			for (int y = SURFACE_Y; y < SURFACE_Y + 3; ++y)
+			{
+				for (int i = 0; i < cChunkDef::Width; ++i)
+				{
+					if (std::abs(i - GapX) > 1)
+					{
+						Chunk->SetBlock({i, y, 8}, E_BLOCK_STONE);
+					}
+					if (std::abs(i - GapZ) > 1)
+					{
+						Chunk->SetBlock({8, y, i}, E_BLOCK_STONE);
+					}
+				}
+			}
+		}
+		return *Chunk;
+	}
+};
@@ -0,0 +1,205 @@
+
+// PermissionBenchmark.cpp
+
+// Measures the permission checks using the original split-and-compare scan over all the templates,
+// using the tries alone, and using cPermissionChecker with its decision cache
+
+#include "Globals.h"
+#include "FastRandom.h"
+#include "PermissionTrie.h"
+
+
+
+
+
+/** Number of permission checks in each measurement. */
+static const int NUM_CHECKS = 200000;
+
+
+
+
+
+/** The original matching of a split permission against a split template, from cPlayer::PermissionMatches(). */
+static bool PermissionMatchesReference(const AStringVector & a_Permission, const AStringVector & a_Template)
+{
+	size_t lenP = a_Permission.size();
+	size_t lenT = a_Template.size();
+	size_t minLen = std::min(lenP, lenT);
+	for (size_t i = 0; i < minLen; i++)
+	{
+		if (a_Template[i] == "*")
+		{
+			return true;
+		}
+		if (a_Permission[i] != a_Template[i])
+		{
+			return false;
+		}
+	}
+	return (lenP == lenT);
+}
+
+
+
+
+
+/** The original cPlayer::HasPermission(), before the tries: the permission is split and compared to each split template. */
+static bool HasPermissionReference(const AString & a_Permission, const std::vector<AStringVector> & a_SplitPermissions, const std::vector<AStringVector> & a_SplitRestrictions)
+{
+	if (a_Permission.empty())
+	{
+		return true;
+	}
+	AStringVector Split = StringSplit(a_Permission, ".");
+	for (const auto & Restriction: a_SplitRestrictions)
+	{
+		if (PermissionMatchesReference(Split, Restriction))
+		{
+			return false;
+		}
+	}
+	for (const auto & Permission: a_SplitPermissions)
+	{
+		if (PermissionMatchesReference(Split, Permission))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+
+
+
+/** A player's permissions and restrictions, and the permissions requested by the plugins. */
+struct sScenario
+{
+	AString m_Name;
+	AStringVector m_Permissions;
+	AStringVector m_Restrictions;
+	AStringVector m_Requests;
+};
+
+
+
+
+
+/** Returns a scenario with a_NumPlugins plugins, each granting a few commands and a wildcard for its admin commands.
+The plugins request a_NumDistinct distinct permissions, about half of them granted. */
+static sScenario MakeScenario(int a_NumPlugins, int a_NumDistinct)
+{
+	cFastRandom Random;
+	sScenario Res;
+	Res.m_Name = Printf("%d plugins, %d distinct permissions requested", a_NumPlugins, a_NumDistinct);
+	for (int Plugin = 0; Plugin < a_NumPlugins; Plugin++)
+	{
+		for (int Cmd = 0; Cmd < 8; Cmd++)
+		{
+			Res.m_Permissions.push_back(Printf("plugin%d.command.cmd%d", Plugin, Cmd));
+		}
+		Res.m_Permissions.push_back(Printf("plugin%d.admin.*", Plugin));
+		Res.m_Restrictions.push_back(Printf("plugin%d.admin.dangerous", Plugin));
+	}
+	for (int i = 0; i < a_NumDistinct; i++)
+	{
+		auto Plugin = Random.RandInt(a_NumPlugins * 2);  // Half of the plugins aren't granted anything
+		switch (Random.RandInt(3))
+		{
+			case 0:  Res.m_Requests.push_back(Printf("plugin%d.command.cmd%d", Plugin, Random.RandInt(15))); break;
+			case 1:  Res.m_Requests.push_back(Printf("plugin%d.admin.sub%d", Plugin, Random.RandInt(15))); break;
+			case 2:  Res.m_Requests.push_back(Printf("plugin%d.admin.dangerous", Plugin)); break;
+			default: Res.m_Requests.push_back(Printf("plugin%d.build.place.block%d", Plugin, Random.RandInt(100))); break;
+		}
+	}
+	return Res;
+}
+
+
+
+
+
+/** Runs NUM_CHECKS checks of the scenario's requested permissions in turn using each of the ways, logs the checks per second.
+Returns false if the ways disagree on any permission. */
+static bool Measure(const sScenario & a_Scenario)
+{
+	std::vector<AStringVector> SplitPermissions, SplitRestrictions;
+	cPermissionTrie PermissionTrie, RestrictionTrie;
+	for (const auto & Permission: a_Scenario.m_Permissions)
+	{
+		SplitPermissions.push_back(StringSplit(Permission, "."));
+		PermissionTrie.Add(Permission);
+	}
+	for (const auto & Restriction: a_Scenario.m_Restrictions)
+	{
+		SplitRestrictions.push_back(StringSplit(Restriction, "."));
+		RestrictionTrie.Add(Restriction);
+	}
+	cPermissionChecker Checker;
+	Checker.SetPermissions(a_Scenario.m_Permissions, a_Scenario.m_Restrictions);
+
+	// Check that all the ways agree:
+	size_t NumGranted = 0;
+	for (const auto & Request: a_Scenario.m_Requests)
+	{
+		bool Reference = HasPermissionReference(Request, SplitPermissions, SplitRestrictions);
+		bool Tries = !RestrictionTrie.Matches(Request) && PermissionTrie.Matches(Request);
+		bool Cached = Checker.HasPermission(Request);
+		if ((Reference != Tries) || (Reference != Cached))
+		{
+			LOGERROR("%s: \"%s\" is %d in the scan, %d in the tries, %d in the checker",
+				a_Scenario.m_Name.c_str(), Request.c_str(), Reference, Tries, Cached
+			);
+			return false;
+		}
+		NumGranted += Reference ? 1 : 0;
+	}
+
+	auto ChecksPerSec = [&](auto a_HasPermission)
+	{
+		size_t NumRequests = a_Scenario.m_Requests.size();
+		size_t Dummy = 0;
+		auto Start = std::chrono::steady_clock::now();
+		for (int i = 0; i < NUM_CHECKS; i++)
+		{
+			Dummy += a_HasPermission(a_Scenario.m_Requests[static_cast<size_t>(i) % NumRequests]) ? 1 : 0;
+		}
+		auto Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		return (Dummy > static_cast<size_t>(NUM_CHECKS)) ? 0 : NUM_CHECKS / Seconds;
+	};
+	auto Scan = ChecksPerSec([&](const AString & a_Permission)
+		{
+			return HasPermissionReference(a_Permission, SplitPermissions, SplitRestrictions);
+		}
+	);
+	auto Tries = ChecksPerSec([&](const AString & a_Permission)
+		{
+			return !RestrictionTrie.Matches(a_Permission) && PermissionTrie.Matches(a_Permission);
+		}
+	);
+	auto Cached = ChecksPerSec([&](const AString & a_Permission)
+		{
+			return Checker.HasPermission(a_Permission);
+		}
+	);
+	LOG("%s (%zu templates, %zu of the requests granted):",
+		a_Scenario.m_Name.c_str(), a_Scenario.m_Permissions.size() + a_Scenario.m_Restrictions.size(), NumGranted
+	);
+	LOG("  scan %10.0f checks/sec, tries %10.0f checks/sec, checker with cache %10.0f checks/sec", Scan, Tries, Cached);
+	return true;
+}
+
+
+
+
+
+int main()
+{
+	LOG("Permission check benchmark, %d checks per measurement:", NUM_CHECKS);
+	bool IsOk =
+		Measure(MakeScenario(5, 50)) &&
+		Measure(MakeScenario(50, 200)) &&
+		Measure(MakeScenario(200, 500)) &&
+		Measure(MakeScenario(200, 5000));  // More distinct permissions than the cache holds
+	return IsOk ? 0 : 1;
+}
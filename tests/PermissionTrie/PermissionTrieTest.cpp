@@ -0,0 +1,218 @@
+
+// PermissionTrieTest.cpp
+
+// Tests the cPermissionTrie matching against the original per-template matching, and the cPermissionChecker decisions
+
+#include "Globals.h"
+#include "../TestHelpers.h"
+#include "PermissionTrie.h"
+
+
+
+
+
+/** The original matching of a split permission against a split template, from cPlayer::PermissionMatches().
+The trie must give the same results as checking each template in turn with this. */
+static bool PermissionMatchesReference(const AStringVector & a_Permission, const AStringVector & a_Template)
+{
+	size_t lenP = a_Permission.size();
+	size_t lenT = a_Template.size();
+	size_t minLen = std::min(lenP, lenT);
+	for (size_t i = 0; i < minLen; i++)
+	{
+		if (a_Template[i] == "*")
+		{
+			return true;
+		}
+		if (a_Permission[i] != a_Template[i])
+		{
+			return false;
+		}
+	}
+	return (lenP == lenT);
+}
+
+
+
+
+
+/** Templates and permissions covering the wildcards, the prefixes and the empty, leading and trailing dot-separated parts. */
+static const char * g_Strings[] =
+{
+	"",
+	".",
+	"..",
+	"*",
+	"*.*",
+	"core",
+	"core.",
+	"core..",
+	".core",
+	"core.*",
+	"core.*.",
+	"core.*.build",
+	"core.build",
+	"core.build.",
+	"core.build.*",
+	"core.build.self",
+	"core.build.other",
+	"core..build",
+	"core.buildx",
+	"core.*x",
+	"corex.build",
+	"worldedit.*",
+	"worldedit.selection.pos",
+	"worldedit",
+};
+
+
+
+
+
+/** Checks that a trie with each single template, and with all the templates, matches the same as the reference. */
+static void TestMatchesReference()
+{
+	// Each template on its own:
+	for (auto Template: g_Strings)
+	{
+		cPermissionTrie Trie;
+		Trie.Add(Template);
+		for (auto Permission: g_Strings)
+		{
+			bool Expected = PermissionMatchesReference(StringSplit(Permission, "."), StringSplit(Template, "."));
+			TEST_EQUAL_MSG(Trie.Matches(Permission), Expected, Printf("Template \"%s\", permission \"%s\"", Template, Permission));
+		}
+	}
+
+	// Several templates at once match if any single one does:
+	for (size_t Skip = 0; Skip < ARRAYCOUNT(g_Strings); ++Skip)
+	{
+		cPermissionTrie Trie;
+		for (size_t i = 0; i < ARRAYCOUNT(g_Strings); i += 1 + (Skip % 3))
+		{
+			if (i != Skip)
+			{
+				Trie.Add(g_Strings[i]);
+			}
+		}
+		for (auto Permission: g_Strings)
+		{
+			bool Expected = false;
+			for (size_t i = 0; i < ARRAYCOUNT(g_Strings); i += 1 + (Skip % 3))
+			{
+				if ((i != Skip) && PermissionMatchesReference(StringSplit(Permission, "."), StringSplit(g_Strings[i], ".")))
+				{
+					Expected = true;
+					break;
+				}
+			}
+			TEST_EQUAL_MSG(Trie.Matches(Permission), Expected, Printf("Skip %u, permission \"%s\"", static_cast<unsigned>(Skip), Permission));
+		}
+	}
+}
+
+
+
+
+
+/** Checks that Clear() removes all the templates, including the wildcards. */
+static void TestClear()
+{
+	cPermissionTrie Trie;
+	Trie.Add("*");
+	Trie.Add("core.build");
+	TEST_TRUE(Trie.Matches("anything"));
+	Trie.Clear();
+	TEST_FALSE(Trie.Matches("anything"));
+	TEST_FALSE(Trie.Matches("core.build"));
+	Trie.Add("core.build");
+	TEST_TRUE(Trie.Matches("core.build"));
+	TEST_FALSE(Trie.Matches("anything"));
+}
+
+
+
+
+
+/** Checks that the restrictions override the granted permissions. */
+static void TestRestrictions()
+{
+	cPermissionChecker Checker;
+	Checker.SetPermissions({"core.*", "worldedit.selection.pos"}, {"core.ban", "core.kick.*"});
+	TEST_TRUE(Checker.HasPermission(""));
+	TEST_TRUE(Checker.HasPermission("core.build"));
+	TEST_TRUE(Checker.HasPermission("core.kick"));
+	TEST_FALSE(Checker.HasPermission("core.ban"));
+	TEST_TRUE(Checker.HasPermission("core.ban.list"));
+	TEST_FALSE(Checker.HasPermission("core.kick.other"));
+	TEST_TRUE(Checker.HasPermission("worldedit.selection.pos"));
+	TEST_FALSE(Checker.HasPermission("worldedit.selection"));
+	TEST_FALSE(Checker.HasPermission("core"));
+
+	// A restriction wildcard overrides everything:
+	Checker.SetPermissions({"*"}, {"*"});
+	TEST_FALSE(Checker.HasPermission("core.build"));
+	TEST_TRUE(Checker.HasPermission(""));
+}
+
+
+
+
+
+/** Checks that the cached decisions are dropped when the permissions change, e.g. when the player's rank or the rank's groups change. */
+static void TestCacheInvalidation()
+{
+	cPermissionChecker Checker;
+	Checker.SetPermissions({"core.build"}, {});
+	TEST_TRUE(Checker.HasPermission("core.build"));
+	TEST_FALSE(Checker.HasPermission("core.ban"));
+
+	// Permission removed, another one granted:
+	Checker.SetPermissions({"core.ban"}, {});
+	TEST_FALSE(Checker.HasPermission("core.build"));
+	TEST_TRUE(Checker.HasPermission("core.ban"));
+
+	// Restriction added:
+	Checker.SetPermissions({"core.ban"}, {"core.ban"});
+	TEST_FALSE(Checker.HasPermission("core.ban"));
+
+	// Restriction removed again:
+	Checker.SetPermissions({"core.ban"}, {});
+	TEST_TRUE(Checker.HasPermission("core.ban"));
+
+	// Everything removed:
+	Checker.SetPermissions({}, {});
+	TEST_FALSE(Checker.HasPermission("core.ban"));
+}
+
+
+
+
+
+/** Checks that the decisions stay correct after the cache overflows and starts over. */
+static void TestCacheOverflow()
+{
+	cPermissionChecker Checker;
+	Checker.SetPermissions({"plugin.*"}, {"plugin.secret"});
+	for (int Round = 0; Round < 2; ++Round)
+	{
+		for (int i = 0; i < 2500; ++i)
+		{
+			TEST_TRUE(Checker.HasPermission(Printf("plugin.perm%d", i)));
+			TEST_FALSE(Checker.HasPermission(Printf("other.perm%d", i)));
+			TEST_FALSE(Checker.HasPermission("plugin.secret"));
+		}
+	}
+}
+
+
+
+
+
+IMPLEMENT_TEST_MAIN("PermissionTrie",
+	TestMatchesReference();
+	TestClear();
+	TestRestrictions();
+	TestCacheInvalidation();
+	TestCacheOverflow();
+)